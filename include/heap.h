@@ -38,6 +38,17 @@ extern "C" {
 #define HP_MAX_LEVELS	4		/* 128^5 records is enough */
 #define HP_PTRS_IN_NOD	128
 
+	/* How a row operation latches a CONCURRENT_ACCESS table */
+
+enum hp_latch_mode
+{
+  HP_LATCH_NONE,			/* Not latched */
+  HP_LATCH_READ,			/* Shared latch */
+  HP_LATCH_WRITE,			/* Shared latch and write_mutex, or */
+					/* exclusive if the table grows */
+  HP_LATCH_EXCLUSIVE			/* Exclusive latch */
+};
+
 	/* struct used with heap_funktions */
 
 typedef struct st_heapinfo		/* Struct from heap_info */
@@ -108,6 +119,23 @@ typedef struct st_heap_block
 } HP_BLOCK;
 
 struct st_heap_info;			/* For referense */
+struct st_hp_oa_table;
+struct st_hp_row_lock;
+
+/*
+  Open addressing hash index, used instead of HP_BLOCK for unique HASH
+  keys. Slots are probed in groups of HP_OA_GROUP, a group is first
+  filtered by comparing one tag byte per slot. See hp_oa_hash.c
+*/
+
+typedef struct st_hp_oa_hash
+{
+  struct st_hp_oa_table *table;		/* Slots and tags, 0 if no keys yet */
+  struct st_hp_oa_table *retired;	/* Tables replaced by hp_oa_resize() */
+  ulong records;			/* Keys in the index */
+  ulong deleted;			/* Slots marked as deleted */
+  uint inline_length;			/* Key image kept in the slot, or 0 */
+} HP_OA_HASH;
 
 typedef struct st_hp_keydef		/* Key definition with open */
 {
@@ -122,6 +150,8 @@ typedef struct st_hp_keydef		/* Key definition with open */
     #records estimates for heap key scans.
   */
   ha_rows hash_buckets; 
+  my_bool open_addressing;		/* Use oa instead of block */
+  HP_OA_HASH oa;
   TREE rb_tree;
   int (*write_key)(struct st_heap_info *info, struct st_hp_keydef *keyinfo,
 		   const uchar *record, uchar *recpos);
@@ -155,6 +185,19 @@ typedef struct st_heap_share
   THR_LOCK lock;
   my_bool delete_on_close;
   my_bool internal;                     /* Internal temporary table */
+  my_bool concurrent;                   /* Latch row operations */
+  my_bool shared_writes;                /* All keys use open addressing */
+  /*
+    For CONCURRENT_ACCESS tables THR_LOCK lets readers and writers in
+    together, see heap_latch() and heap_row_lock(). Lookups on open
+    addressing keys take neither the latch nor write_mutex.
+  */
+  mysql_rwlock_t latch;
+  mysql_mutex_t write_mutex;            /* Writers under a shared latch */
+  struct st_hp_row_lock *row_locks;     /* HP_ROW_LOCKS buckets of rows */
+  mysql_mutex_t row_lock_mutex;         /* Owners of row_locks */
+  mysql_cond_t row_lock_cond;           /* Signaled when a row is unlocked */
+  uint row_lock_waiters;
   LIST open_list;
   uint auto_key;
   uint auto_key_type;			/* real type of the auto key segment */
@@ -180,6 +223,14 @@ typedef struct st_heap_info
   uint file_version;                    /* Version at scan */
   uint lastkey_len;
   my_bool implicit_emptied;
+  /*
+    Rows found by heap_rkey() on a non-unique hash key of a concurrent
+    table; heap_rnext() and heap_rprev() return them if they still match.
+  */
+  DYNAMIC_ARRAY key_matches;
+  ulong key_match;
+  uint latched;                         /* enum hp_latch_mode held */
+  struct st_hp_row_lock *row_lock;      /* Held by heap_row_lock() */
   THR_LOCK_DATA lock;
   LIST open_list;
 } HP_INFO;
@@ -198,6 +249,7 @@ typedef struct st_heap_create_info
   ulonglong auto_increment;
   my_bool with_auto_increment;
   my_bool internal_table;
+  my_bool concurrent;                   /* CONCURRENT_ACCESS=YES */
   /*
     TRUE if heap_create should 'pin' the created share by setting
     open_count to 1. Is only looked at if not internal_table.
@@ -229,6 +281,11 @@ extern int heap_reset(HP_INFO *info);
 extern int heap_rename(const char *old_name,const char *new_name);
 extern int heap_panic(enum ha_panic_function flag);
 extern int heap_rsame(HP_INFO *info,uchar *record,int inx);
+extern void heap_latch(HP_INFO *info, enum hp_latch_mode mode);
+extern void heap_unlatch(HP_INFO *info);
+extern int heap_row_lock(HP_INFO *info, uchar *record, const void *owner,
+                         ulong timeout_ms);
+extern void heap_row_unlock(HP_INFO *info);
 extern int heap_rnext(HP_INFO *info,uchar *record);
 extern int heap_rprev(HP_INFO *info,uchar *record);
 extern int heap_rfirst(HP_INFO *info,uchar *record,int inx);
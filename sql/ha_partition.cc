@@ -78,7 +78,8 @@
                                         HA_DUPLICATE_POS | \
                                         HA_CAN_INSERT_DELAYED | \
                                         HA_READ_BEFORE_WRITE_REMOVAL |\
-                                        HA_CAN_TABLES_WITHOUT_ROLLBACK)
+                                        HA_CAN_TABLES_WITHOUT_ROLLBACK |\
+                                        HA_CAN_SCAN_IN_THREADS)
 
 static const char *ha_par_ext= PAR_EXT;
 
@@ -164,14 +165,29 @@ static PSI_memory_key key_memory_Partition_admin;
 static PSI_memory_key key_memory_ha_partition_file;
 //static PSI_memory_key key_memory_ha_partition_engine_array;
 static PSI_memory_key key_memory_ha_partition_part_ids;
+static PSI_memory_key key_memory_Partition_prefetch;
 
 #ifdef HAVE_PSI_INTERFACE
 PSI_mutex_key key_partition_auto_inc_mutex;
+PSI_mutex_key key_partition_prefetch_mutex;
+PSI_cond_key key_partition_prefetch_work_cond;
+PSI_cond_key key_partition_prefetch_read_cond;
+PSI_thread_key key_thread_partition_prefetch;
 PSI_file_key key_file_ha_partition_par;
 
 static PSI_mutex_info all_partition_mutexes[]=
 {
-  { &key_partition_auto_inc_mutex, "Partition_share::auto_inc_mutex", 0}
+  { &key_partition_auto_inc_mutex, "Partition_share::auto_inc_mutex", 0},
+  { &key_partition_prefetch_mutex, "Partition_prefetch::mutex", 0}
+};
+static PSI_cond_info all_partition_conds[]=
+{
+  { &key_partition_prefetch_work_cond, "Partition_prefetch::work_cond", 0},
+  { &key_partition_prefetch_read_cond, "Partition_prefetch::read_cond", 0}
+};
+static PSI_thread_info all_partition_threads[]=
+{
+  { &key_thread_partition_prefetch, "partition_prefetch", 0}
 };
 static PSI_memory_info all_partitioning_memory[]=
 { { &key_memory_Partition_share, "Partition_share", 0},
@@ -179,7 +195,8 @@ static PSI_memory_info all_partitioning_memory[]=
   { &key_memory_Partition_admin, "Partition_admin", 0},
   { &key_memory_ha_partition_file, "ha_partition::file", 0},
 //  { &key_memory_ha_partition_engine_array, "ha_partition::engine_array", 0},
-  { &key_memory_ha_partition_part_ids, "ha_partition::part_ids", 0} };
+  { &key_memory_ha_partition_part_ids, "ha_partition::part_ids", 0},
+  { &key_memory_Partition_prefetch, "Partition_prefetch", 0} };
 static PSI_file_info all_partition_file[]=
 { { &key_file_ha_partition_par, "ha_partition::parfile", 0} };
 
@@ -192,6 +209,10 @@ static void init_partition_psi_keys(void)
   mysql_memory_register(category, all_partitioning_memory, count);
   count= array_elements(all_partition_mutexes);
   mysql_mutex_register(category, all_partition_mutexes, count);
+  count= array_elements(all_partition_conds);
+  mysql_cond_register(category, all_partition_conds, count);
+  count= array_elements(all_partition_threads);
+  mysql_thread_register(category, all_partition_threads, count);
   count= array_elements(all_partition_file);
   mysql_file_register(category, all_partition_file, count);
 }
@@ -402,6 +423,9 @@ void ha_partition::init_handler_variables()
   m_handler_status= handler_not_initialized;
   m_part_field_array= NULL;
   m_ordered_rec_buffer= NULL;
+  m_prefetch= NULL;
+  m_prefetch_countdown= 0;
+  m_prefetch_ref= m_prefetch_ref_buffer= NULL;
   m_top_entry= NO_CURRENT_PART_ID;
   m_rec_length= 0;
   m_last_part= 0;
@@ -3935,6 +3959,7 @@ int ha_partition::close(void)
   DBUG_ASSERT(table->s == table_share);
   DBUG_ASSERT(m_part_info);
 
+  end_prefetch();
   destroy_record_priority_queue();
 
   for (; ft_first ; ft_first= tmp_ft_info)
@@ -5141,6 +5166,8 @@ int ha_partition::rnd_init(bool scan)
   m_part_spec.start_part= part_id;
   m_part_spec.end_part= m_tot_parts - 1;
   m_rnd_init_and_first= TRUE;
+  m_prefetch_countdown= scan && can_prefetch() ?
+                         Partition_prefetch::START_AFTER_ROWS : 0;
   DBUG_PRINT("info", ("m_scan_value: %u", m_scan_value));
   DBUG_RETURN(0);
 
@@ -5180,8 +5207,17 @@ int ha_partition::rnd_end()
   case 2:                                       // Error
     break;
   case 1:                                       // Table scan
-    if (m_part_spec.start_part != NO_CURRENT_PART_ID)
+    if (m_prefetch)
+    {
+      /* Later partitions than the current one are handled by m_prefetch */
+      end_prefetch();
+      if (m_part_spec.start_part != NO_CURRENT_PART_ID &&
+          m_part_spec.start_part == m_extra_cache_part_id)
+        late_extra_no_cache(m_part_spec.start_part);
+    }
+    else if (m_part_spec.start_part != NO_CURRENT_PART_ID)
       late_extra_no_cache(m_part_spec.start_part);
+    m_prefetch_countdown= 0;
     /* fall through */
   case 0:
     uint i;
@@ -5250,6 +5286,11 @@ int ha_partition::rnd_next(uchar *buf)
       DBUG_RETURN(error);
   }
 
+  if (m_prefetch_countdown && !--m_prefetch_countdown)
+    start_prefetch(Partition_prefetch::RND_NEXT);
+  if (m_prefetch)
+    DBUG_RETURN(prefetch_rnd_next(buf));
+
   file= m_file[part_id];
 
   while (TRUE)
@@ -5294,6 +5335,67 @@ int ha_partition::rnd_next(uchar *buf)
 }
 
 
+/**
+  Read the next rows of a table scan from the current partition
+
+  @see handler::rnd_next_batch()
+
+  The rows of one call come from one partition. The first call of a scan
+  and scans that are read by the prefetch threads read one row with
+  rnd_next().
+*/
+
+int ha_partition::rnd_next_batch(uchar *buf, size_t stride, uint max_rows,
+                                 uint *rows)
+{
+  handler *file;
+  int result;
+  uint part_id= m_part_spec.start_part;
+  DBUG_ENTER("ha_partition::rnd_next_batch");
+
+  if (part_id == NO_CURRENT_PART_ID || m_rnd_init_and_first ||
+      m_prefetch || m_prefetch_countdown)
+    DBUG_RETURN(handler::rnd_next_batch(buf, stride, max_rows, rows));
+
+  DBUG_ASSERT(m_scan_value == 1);
+  /* upper level will increment this once again at end of call */
+  decrement_statistics(&SSV::ha_read_rnd_next_count);
+  file= m_file[part_id];
+
+  while (TRUE)
+  {
+    result= file->ha_rnd_next_batch(buf, stride, max_rows, rows);
+    if (!result)
+    {
+      /* and once for each of the other rows */
+      for (uint i= 1; i < *rows; i++)
+        decrement_statistics(&SSV::ha_read_rnd_next_count);
+      m_last_part= part_id;
+      m_part_spec.start_part= part_id;
+      table->status= 0;
+      DBUG_RETURN(0);
+    }
+
+    if (result != HA_ERR_END_OF_FILE)
+      DBUG_RETURN(result);
+
+    /* End current partition */
+    late_extra_no_cache(part_id);
+    /* Shift to next partition */
+    part_id= bitmap_get_next_set(&m_part_info->read_partitions, part_id);
+    if (part_id >= m_tot_parts)
+      break;
+    m_last_part= part_id;
+    m_part_spec.start_part= part_id;
+    file= m_file[part_id];
+    late_extra_cache(part_id);
+  }
+
+  m_part_spec.start_part= NO_CURRENT_PART_ID;
+  DBUG_RETURN(HA_ERR_END_OF_FILE);
+}
+
+
 /*
   Save position of current row
 
@@ -5326,9 +5428,17 @@ void ha_partition::position(const uchar *record)
   DBUG_ASSERT(bitmap_is_set(&(m_part_info->read_partitions), m_last_part));
   DBUG_ENTER("ha_partition::position");
 
-  file->position(record);
   int2store(ref, m_last_part);
-  memcpy((ref + PARTITION_BYTES_IN_POS), file->ref, file->ref_length);
+  if (m_prefetch)
+  {
+    /* The handler of the partition may have read further rows already */
+    memcpy((ref + PARTITION_BYTES_IN_POS), m_prefetch_ref, file->ref_length);
+  }
+  else
+  {
+    file->position(record);
+    memcpy((ref + PARTITION_BYTES_IN_POS), file->ref, file->ref_length);
+  }
   pad_length= m_ref_length - PARTITION_BYTES_IN_POS - file->ref_length;
   if (pad_length)
     memset((ref + PARTITION_BYTES_IN_POS + file->ref_length), 0, pad_length);
@@ -5646,6 +5756,7 @@ int ha_partition::index_end()
   handler **file;
   DBUG_ENTER("ha_partition::index_end");
 
+  end_prefetch();
   active_index= MAX_KEY;
   m_part_spec.start_part= NO_CURRENT_PART_ID;
   file= m_file;
@@ -6034,6 +6145,48 @@ int ha_partition::index_next(uchar * buf)
 }
 
 
+/**
+  Read the next rows of an unordered index scan from the current partition
+
+  @see handler::index_next_batch()
+
+  Ordered scans merge the partitions one row at a time, and range scans
+  read through read_range_next(). Both read one row with index_next().
+*/
+
+int ha_partition::index_next_batch(uchar *buf, size_t stride, uint max_rows,
+                                   uint *rows)
+{
+  handler *file;
+  int error;
+  DBUG_ENTER("ha_partition::index_next_batch");
+
+  if (m_ordered_scan_ongoing || m_part_spec.start_part >= m_tot_parts ||
+      (m_index_scan_type != partition_index_first &&
+       m_index_scan_type != partition_index_read))
+    DBUG_RETURN(handler::index_next_batch(buf, stride, max_rows, rows));
+
+  decrement_statistics(&SSV::ha_read_next_count);
+  file= m_file[m_part_spec.start_part];
+  if (likely(!(error= file->ha_index_next_batch(buf, stride, max_rows,
+                                                rows))))
+  {
+    for (uint i= 1; i < *rows; i++)
+      decrement_statistics(&SSV::ha_read_next_count);
+    m_last_part= m_part_spec.start_part;
+    DBUG_RETURN(0);
+  }
+
+  if (error == HA_ERR_END_OF_FILE)
+  {
+    m_part_spec.start_part++;                    // Start using next part
+    error= handle_unordered_scan_next_partition(buf);
+    *rows= !error;
+  }
+  DBUG_RETURN(error);
+}
+
+
 /*
   Read next record special
 
@@ -6296,14 +6449,8 @@ int ha_partition::multi_range_key_create_key(RANGE_SEQ_IF *seq,
     m_mrr_range_current->ptr= m_mrr_range_current->key_multi_range.ptr;
     m_mrr_range_current->key_multi_range.ptr= m_mrr_range_current;
 
-    if (start_key->key && (start_key->flag & HA_READ_KEY_EXACT))
-      get_partition_set(table, table->record[0], active_index,
-                        start_key, &m_part_spec);
-    else
-    {
-      m_part_spec.start_part= 0;
-      m_part_spec.end_part= m_tot_parts - 1;
-    }
+    get_partition_set_for_range(table, table->record[0], active_index,
+                                start_key, end_key, &m_part_spec);
 
     /* Copy key to those partitions that needs it */
     for (i= m_part_spec.start_part; i <= m_part_spec.end_part; i++)
@@ -6357,6 +6504,18 @@ int ha_partition::multi_range_key_create_key(RANGE_SEQ_IF *seq,
     DBUG_RETURN(HA_ERR_END_OF_FILE);
   }
 
+  if (bitmap_is_clear_all(&m_mrr_used_partitions))
+  {
+    /*
+      All ranges were pruned away. Scan one partition without ranges, so
+      that the scan has a partition to start on and finds no rows.
+    */
+    i= bitmap_get_first_set(&m_part_info->read_partitions);
+    if (i == MY_BIT_NONE)
+      DBUG_RETURN(HA_ERR_END_OF_FILE);
+    bitmap_set_bit(&m_mrr_used_partitions, i);
+  }
+
   /* set start and end part */
   m_part_spec.start_part= bitmap_get_first_set(&m_mrr_used_partitions);
 
@@ -7190,7 +7349,10 @@ int ha_partition::partition_scan_set_up(uchar * buf, bool idx_read_flag)
   DBUG_ENTER("ha_partition::partition_scan_set_up");
 
   if (idx_read_flag)
-    get_partition_set(table, buf, active_index, &m_start_key, &m_part_spec);
+    get_partition_set_for_range(table, buf, active_index, &m_start_key,
+                                m_index_scan_type == partition_read_range ?
+                                end_range : NULL,
+                                &m_part_spec);
   else
   {
     m_part_spec.start_part= 0;
@@ -7650,6 +7812,8 @@ int ha_partition::handle_ordered_index_scan(uchar *buf, bool reverse_order)
   DBUG_ENTER("ha_partition::handle_ordered_index_scan");
   DBUG_PRINT("enter", ("partition this: %p", this));
 
+  end_prefetch();
+
    if (m_pre_calling)
      error= handle_pre_scan(reverse_order, m_pre_call_use_parallel);
    else
@@ -7838,6 +8002,9 @@ int ha_partition::handle_ordered_index_scan(uchar *buf, bool reverse_order)
     m_queue.elements= j - queue_first_element(&m_queue);
     queue_fix(&m_queue);
     return_top_record(buf);
+    if (m_index_scan_type == partition_index_first && !m_key_not_found &&
+        !m_using_extended_keys && can_prefetch())
+      m_prefetch_countdown= Partition_prefetch::START_AFTER_ROWS;
     DBUG_PRINT("info", ("Record returned from partition %u", m_top_entry));
     DBUG_RETURN(0);
   }
@@ -7869,6 +8036,8 @@ void ha_partition::return_top_record(uchar *buf)
   m_last_part= part_id;
   DBUG_PRINT("info", ("partition m_last_part: %u", m_last_part));
   m_top_entry= part_id;
+  if (m_prefetch)
+    m_prefetch_ref= rec_buffer + m_rec_length;
   table->status= 0;                             // Found an existing row
   m_file[part_id]->return_record_by_parent();
   DBUG_VOID_RETURN;
@@ -7967,6 +8136,9 @@ int ha_partition::handle_ordered_next(uchar *buf, bool is_next_same)
   if (m_top_entry == NO_CURRENT_PART_ID)
     DBUG_RETURN(HA_ERR_END_OF_FILE);
 
+  if (m_prefetch_countdown && !is_next_same && !--m_prefetch_countdown)
+    start_prefetch(Partition_prefetch::INDEX_NEXT);
+
   uint part_id= m_top_entry;
   uchar *rec_buf= queue_top(&m_queue) + PARTITION_BYTES_IN_POS;
   handler *file;
@@ -8128,6 +8300,16 @@ int ha_partition::handle_ordered_next(uchar *buf, bool is_next_same)
       }
     }
   }
+  else if (m_prefetch)
+  {
+    DBUG_ASSERT(!is_next_same);
+    if (likely(!(error= m_prefetch->read(part_id, rec_buf,
+                                         rec_buf + m_rec_length))))
+    {
+      file->update_index_statistics();
+      increment_statistics(&SSV::ha_read_next_count);
+    }
+  }
   else if (!is_next_same)
     error= file->ha_index_next(rec_buf);
   else
@@ -8152,7 +8334,7 @@ int ha_partition::handle_ordered_next(uchar *buf, bool is_next_same)
     DBUG_RETURN(error);
   }
 
-  if (!m_using_extended_keys)
+  if (!m_using_extended_keys && !m_prefetch)
   {
     file->position(rec_buf);
     memcpy(rec_buf + m_rec_length, file->ref, file->ref_length);
@@ -8184,6 +8366,10 @@ int ha_partition::handle_ordered_prev(uchar *buf)
   DBUG_ENTER("ha_partition::handle_ordered_prev");
   DBUG_PRINT("enter", ("partition: %p", this));
 
+  /* The handlers of the partitions are positioned ahead of the queue */
+  if (m_prefetch && (error= end_prefetch_index_scan()))
+    DBUG_RETURN(error);
+
   if (m_top_entry == NO_CURRENT_PART_ID)
     DBUG_RETURN(HA_ERR_END_OF_FILE);
 
@@ -8214,6 +8400,482 @@ int ha_partition::handle_ordered_prev(uchar *buf)
 }
 
 
+/****************************************************************************
+                MODULE prefetch
+****************************************************************************/
+
+Partition_prefetch::Partition_prefetch(ha_partition *owner, scan_type type,
+                                       uint tot_parts, uint rec_length,
+                                       uint ref_length)
+  :m_owner(owner), m_type(type), m_tot_parts(tot_parts),
+   m_rec_length(rec_length), m_ref_length(ref_length),
+   m_slot_length(rec_length + ref_length), m_threads(NULL), m_n_threads(0),
+   m_stop(false)
+{
+  m_parts= (Part*) my_malloc(key_memory_Partition_prefetch,
+                             tot_parts * sizeof(Part), MYF(MY_ZEROFILL));
+  mysql_mutex_init(key_partition_prefetch_mutex, &m_mutex,
+                   MY_MUTEX_INIT_FAST);
+  mysql_cond_init(key_partition_prefetch_work_cond, &m_work_cond, NULL);
+  mysql_cond_init(key_partition_prefetch_read_cond, &m_read_cond, NULL);
+}
+
+
+Partition_prefetch::~Partition_prefetch()
+{
+  stop();
+  if (m_parts)
+  {
+    for (uint i= 0; i < m_tot_parts; i++)
+    {
+      if (m_parts[i].cached)
+        m_owner->prefetch_read_cache(i, false);
+      my_free(m_parts[i].rows);
+    }
+    my_free(m_parts);
+  }
+  my_free(m_threads);
+  mysql_cond_destroy(&m_read_cond);
+  mysql_cond_destroy(&m_work_cond);
+  mysql_mutex_destroy(&m_mutex);
+}
+
+
+bool Partition_prefetch::add_partition(uint part_id, uint n_rows, bool cached)
+{
+  DBUG_ASSERT(!m_n_threads);
+  if (!m_parts)
+    return true;
+  Part *part= &m_parts[part_id];
+  if (!(part->rows= (uchar*) my_malloc(key_memory_Partition_prefetch,
+                                       (size_t) n_rows * m_slot_length,
+                                       MYF(MY_WME))))
+    return true;
+  part->n_slots= n_rows;
+  part->started= cached;
+  return false;
+}
+
+
+bool Partition_prefetch::start(uint n_threads)
+{
+  DBUG_ENTER("Partition_prefetch::start");
+  if (!(m_threads= (pthread_t*) my_malloc(key_memory_Partition_prefetch,
+                                          n_threads * sizeof(pthread_t),
+                                          MYF(MY_WME))))
+    DBUG_RETURN(true);
+  for (; m_n_threads < n_threads; m_n_threads++)
+  {
+    if (mysql_thread_create(key_thread_partition_prefetch,
+                            &m_threads[m_n_threads], NULL, worker_thread,
+                            this))
+      break;
+  }
+  DBUG_PRINT("info", ("threads: %u", m_n_threads));
+  DBUG_RETURN(!m_n_threads);
+}
+
+
+void Partition_prefetch::stop()
+{
+  if (!m_n_threads)
+    return;
+  mysql_mutex_lock(&m_mutex);
+  m_stop= true;
+  mysql_cond_broadcast(&m_work_cond);
+  mysql_mutex_unlock(&m_mutex);
+  for (uint i= 0; i < m_n_threads; i++)
+    pthread_join(m_threads[i], NULL);
+  m_n_threads= 0;
+}
+
+
+/** Read a row and its position into a slot */
+
+int Partition_prefetch::read_row(uint part_id, uchar *slot)
+{
+  Part *part= &m_parts[part_id];
+  if (!part->started)
+  {
+    part->started= true;
+    m_owner->prefetch_read_cache(part_id, true);
+    part->cached= true;
+  }
+  return m_owner->prefetch_read_row(part_id, m_type, slot,
+                                    slot + m_rec_length);
+}
+
+
+/** Free the read cache of a partition that has no more rows */
+
+void Partition_prefetch::end_part(uint part_id)
+{
+  Part *part= &m_parts[part_id];
+  if (part->cached)
+  {
+    m_owner->prefetch_read_cache(part_id, false);
+    part->cached= false;
+  }
+}
+
+
+/**
+  Find the partition to read rows of next.
+  @return partition id, or m_tot_parts if there is none
+*/
+
+uint Partition_prefetch::next_work() const
+{
+  mysql_mutex_assert_owner(&m_mutex);
+  for (uint i= 0; i < m_tot_parts; i++)
+  {
+    const Part *part= &m_parts[i];
+    if (part->rows && !part->busy && !part->status &&
+        part->count < part->n_slots)
+      return i;
+  }
+  return m_tot_parts;
+}
+
+
+void Partition_prefetch::run()
+{
+  mysql_mutex_lock(&m_mutex);
+  while (!m_stop)
+  {
+    uint part_id= next_work();
+    if (part_id == m_tot_parts)
+    {
+      mysql_cond_wait(&m_work_cond, &m_mutex);
+      continue;
+    }
+    Part *part= &m_parts[part_id];
+    /* Read up to a quarter of the buffer, after the buffered rows */
+    uint slot= (part->first + part->count) % part->n_slots;
+    uint n_rows= MY_MIN(part->n_slots - part->count,
+                        MY_MAX(part->n_slots / 4, 1));
+    part->busy= true;
+    mysql_mutex_unlock(&m_mutex);
+
+    uint n_read= 0;
+    int error= 0;
+    while (n_read < n_rows &&
+           !(error= read_row(part_id, part->rows + slot * m_slot_length)))
+    {
+      n_read++;
+      if (++slot == part->n_slots)
+        slot= 0;
+    }
+    if (error)
+      end_part(part_id);
+
+    mysql_mutex_lock(&m_mutex);
+    part->status= error;
+    part->count+= n_read;
+    part->busy= false;
+    mysql_cond_broadcast(&m_read_cond);
+  }
+  mysql_mutex_unlock(&m_mutex);
+}
+
+
+void *Partition_prefetch::worker_thread(void *arg)
+{
+  my_thread_init();
+  static_cast<Partition_prefetch*>(arg)->run();
+  my_thread_end();
+  return 0;
+}
+
+
+int Partition_prefetch::read(uint part_id, uchar *buf, uchar *ref)
+{
+  Part *part= &m_parts[part_id];
+  DBUG_ASSERT(part->rows);
+
+  if (!m_n_threads)
+  {
+    /* The worker threads were stopped: continue the scan here */
+    if (!part->count)
+    {
+      if (part->status)
+        return part->status;
+      int error= read_row(part_id, part->rows);
+      if (error)
+      {
+        end_part(part_id);
+        return part->status= error;
+      }
+      part->first= 0;
+      part->count= 1;
+    }
+  }
+  else
+  {
+    mysql_mutex_lock(&m_mutex);
+    while (!part->count && !part->status)
+    {
+      /* Make sure that a worker reads the partition */
+      mysql_cond_signal(&m_work_cond);
+      mysql_cond_wait(&m_read_cond, &m_mutex);
+    }
+    bool end= !part->count;
+    mysql_mutex_unlock(&m_mutex);
+    if (end)
+      return part->status;
+  }
+
+  /* Workers only write to the slots after the buffered rows */
+  const uchar *slot= part->rows + part->first * m_slot_length;
+  memcpy(buf, slot, m_rec_length);
+  memcpy(ref, slot + m_rec_length, m_ref_length);
+
+  if (m_n_threads)
+    mysql_mutex_lock(&m_mutex);
+  if (++part->first == part->n_slots)
+    part->first= 0;
+  if (part->count-- == part->n_slots)
+    mysql_cond_signal(&m_work_cond);
+  if (m_n_threads)
+    mysql_mutex_unlock(&m_mutex);
+  return 0;
+}
+
+
+/**
+  Check if rows of the current scan may be read ahead by worker threads.
+
+  The handlers of the partitions must support being used by other threads,
+  and the rows must be self-contained: blobs point into buffers that the
+  next read overwrites, and pushed conditions and virtual columns are
+  evaluated on table->record[0].
+*/
+
+bool ha_partition::can_prefetch() const
+{
+  THD *thd= ha_thd();
+  return thd->variables.partition_prefetch_threads &&
+         (get_open_file_sample()->ha_table_flags() &
+          HA_CAN_SCAN_IN_THREADS) &&
+         get_lock_type() != F_WRLCK && !table->s->blob_fields &&
+         !table->vfield && !table->open_by_handler &&
+         !pushed_cond && !pushed_idx_cond &&
+         !pushed_rowid_filter && !m_pre_calling &&
+         bitmap_bits_set(&m_part_info->read_partitions) > 1;
+}
+
+
+/**
+  Start reading ahead the rest of the current scan in worker threads.
+
+  For a table scan, these are the partitions from the current one on.
+  For an ordered index scan, these are the partitions in the priority
+  queue, whose handlers are positioned on the queued rows.
+*/
+
+void ha_partition::start_prefetch(Partition_prefetch::scan_type type)
+{
+  THD *thd= ha_thd();
+  uint n_threads= thd->variables.partition_prefetch_threads;
+  uint ref_length, n_parts, i;
+  DBUG_ENTER("ha_partition::start_prefetch");
+  DBUG_ASSERT(!m_prefetch);
+
+  if (type == Partition_prefetch::RND_NEXT)
+  {
+    ref_length= m_ref_length - PARTITION_BYTES_IN_POS;
+    n_parts= bitmap_bits_set(&m_part_info->read_partitions);
+  }
+  else
+  {
+    /* Rows and positions are read into the records of the queue */
+    ref_length= m_priority_queue_rec_len - PARTITION_BYTES_IN_POS -
+                m_rec_length;
+    n_parts= m_queue.elements;
+  }
+  if (n_parts < 2)
+    DBUG_VOID_RETURN;
+
+  /* Buffer twice the read buffer per thread, spread over the partitions */
+  size_t slot_length= m_rec_length + ref_length;
+  size_t budget= (size_t) thd->variables.read_buff_size * n_threads * 2;
+  uint n_rows= (uint) MY_MAX(MY_MIN(budget / (slot_length * n_parts),
+                                    Partition_prefetch::MAX_ROWS),
+                             Partition_prefetch::MIN_ROWS);
+
+  if (!(m_prefetch= new Partition_prefetch(this, type, m_tot_parts,
+                                           m_rec_length, ref_length)))
+    DBUG_VOID_RETURN;
+
+  if (type == Partition_prefetch::RND_NEXT)
+  {
+    if (!(m_prefetch_ref_buffer=
+          (uchar*) my_malloc(key_memory_Partition_prefetch, ref_length,
+                             MYF(MY_WME))))
+      goto err;
+    m_prefetch_ref= m_prefetch_ref_buffer;
+    for (i= m_part_spec.start_part;
+         i < m_tot_parts;
+         i= bitmap_get_next_set(&m_part_info->read_partitions, i))
+    {
+      /* The scan of the current partition is under way */
+      if (m_prefetch->add_partition(i, n_rows, i == m_part_spec.start_part))
+        goto err;
+    }
+  }
+  else
+  {
+    for (i= queue_first_element(&m_queue);
+         i <= queue_last_element(&m_queue);
+         i++)
+    {
+      if (m_prefetch->add_partition(uint2korr(queue_element(&m_queue, i)),
+                                    n_rows, true))
+        goto err;
+    }
+  }
+  if (m_prefetch->start(n_threads))
+    goto err;
+  DBUG_VOID_RETURN;
+
+err:
+  end_prefetch();
+  DBUG_VOID_RETURN;
+}
+
+
+void ha_partition::end_prefetch()
+{
+  m_prefetch_countdown= 0;
+  delete m_prefetch;
+  m_prefetch= NULL;
+  my_free(m_prefetch_ref_buffer);
+  m_prefetch_ref= m_prefetch_ref_buffer= NULL;
+}
+
+
+/**
+  Stop reading ahead an ordered index scan, and position the handlers of
+  the partitions on the rows in the priority queue again, so that the scan
+  can continue in either direction.
+*/
+
+int ha_partition::end_prefetch_index_scan()
+{
+  KEY *key_info= table->key_info + active_index;
+  uchar key[MAX_KEY_LENGTH];
+  DBUG_ENTER("ha_partition::end_prefetch_index_scan");
+  DBUG_ASSERT(m_prefetch && m_index_scan_type == partition_index_first);
+
+  end_prefetch();
+  for (uint i= queue_first_element(&m_queue);
+       i <= queue_last_element(&m_queue);
+       i++)
+  {
+    uchar *part_buf= queue_element(&m_queue, i);
+    uchar *rec_buf= part_buf + PARTITION_BYTES_IN_POS;
+    /* The position of the row, see return_top_record() */
+    uchar *ref= rec_buf + m_rec_length;
+    handler *file= m_file[uint2korr(part_buf)];
+    int error;
+
+    /* Find the queued row among the rows with the same key */
+    key_copy(key, rec_buf, key_info, key_info->key_length);
+    for (error= file->ha_index_read_map(rec_buf, key, HA_WHOLE_KEY,
+                                        HA_READ_KEY_EXACT);
+         !error;
+         error= file->ha_index_next_same(rec_buf, key,
+                                         key_info->key_length))
+    {
+      file->position(rec_buf);
+      if (!file->cmp_ref(file->ref, ref))
+        break;
+    }
+    if (unlikely(error))
+      DBUG_RETURN(error == HA_ERR_END_OF_FILE ? HA_ERR_KEY_NOT_FOUND : error);
+  }
+  DBUG_RETURN(0);
+}
+
+
+/** rnd_next() from the rows read ahead */
+
+int ha_partition::prefetch_rnd_next(uchar *buf)
+{
+  uint part_id= m_part_spec.start_part;
+  int error;
+
+  while ((error= m_prefetch->read(part_id, buf, m_prefetch_ref)) ==
+         HA_ERR_END_OF_FILE)
+  {
+    /* The read cache of later partitions is handled by m_prefetch */
+    if (part_id == m_extra_cache_part_id)
+      late_extra_no_cache(part_id);
+    part_id= bitmap_get_next_set(&m_part_info->read_partitions, part_id);
+    if (part_id >= m_tot_parts)
+    {
+      m_part_spec.start_part= NO_CURRENT_PART_ID;
+      return HA_ERR_END_OF_FILE;
+    }
+    m_part_spec.start_part= part_id;
+  }
+  if (unlikely(error))
+    return error;
+
+  m_last_part= part_id;
+  m_file[part_id]->update_rows_read();
+  increment_statistics(&SSV::ha_read_rnd_next_count);
+  table->status= 0;
+  return 0;
+}
+
+
+/**
+  Read the next row of a partition and its position.
+  Called by the worker threads of m_prefetch.
+*/
+
+int ha_partition::prefetch_read_row(uint part_id,
+                                    Partition_prefetch::scan_type type,
+                                    uchar *buf, uchar *ref)
+{
+  handler *file= m_file[part_id];
+  int error;
+  while ((error= type == Partition_prefetch::RND_NEXT
+                 ? file->rnd_next(buf) : file->index_next(buf)) ==
+         HA_ERR_RECORD_DELETED)
+  {
+    if (table->in_use->killed)
+      return HA_ERR_ABORTED_BY_USER;
+  }
+  if (likely(!error))
+  {
+    file->position(buf);
+    memcpy(ref, file->ref, file->ref_length);
+  }
+  return error;
+}
+
+
+/**
+  Set up or free the read cache of a table scan on a partition that
+  m_prefetch reads rows of. See late_extra_cache().
+*/
+
+void ha_partition::prefetch_read_cache(uint part_id, bool enable)
+{
+  handler *file= m_file[part_id];
+  if (m_index_scan_type != partition_no_index_scan || !m_extra_cache)
+    return;
+  if (!enable)
+    (void) file->extra(HA_EXTRA_NO_CACHE);
+  else if (m_extra_cache_size == 0)
+    (void) file->extra(HA_EXTRA_CACHE);
+  else
+    (void) file->extra_opt(HA_EXTRA_CACHE, m_extra_cache_size);
+}
+
+
 /****************************************************************************
                 MODULE information calls
 ****************************************************************************/
@@ -8312,6 +8974,9 @@ int ha_partition::info(uint flag)
   uint extra_var_flag= flag & HA_STATUS_VARIABLE_EXTRA;
   DBUG_ENTER("ha_partition::info");
 
+  /* The handlers of the partitions must not be used concurrently */
+  if (m_prefetch)
+    m_prefetch->stop();
 #ifndef DBUG_OFF
   if (bitmap_is_set_all(&(m_part_info->read_partitions)))
     DBUG_PRINT("info", ("All partitions are used"));
@@ -9035,6 +9700,9 @@ int ha_partition::extra(enum ha_extra_function operation)
   DBUG_ENTER("ha_partition:extra");
   DBUG_PRINT("enter", ("operation: %d", (int) operation));
 
+  if (m_prefetch)
+    m_prefetch->stop();
+
   switch (operation) {
     /* Category 1), used by most handlers */
   case HA_EXTRA_NO_KEYREAD:
@@ -9216,6 +9884,7 @@ int ha_partition::reset(void)
   uint i;
   DBUG_ENTER("ha_partition::reset");
 
+  end_prefetch();
   for (i= bitmap_get_first_set(&m_partitions_to_reset);
        i < m_tot_parts;
        i= bitmap_get_next_set(&m_partitions_to_reset, i))
@@ -9254,6 +9923,9 @@ int ha_partition::extra_opt(enum ha_extra_function operation, ulong arg)
 {
   DBUG_ENTER("ha_partition::extra_opt");
 
+  if (m_prefetch)
+    m_prefetch->stop();
+
   switch (operation)
   {
     case HA_EXTRA_KEYREAD:
@@ -269,6 +269,86 @@ typedef struct st_partition_part_key_multi_range_hld
 extern "C" int cmp_key_part_id(void *key_p, uchar *ref1, uchar *ref2);
 extern "C" int cmp_key_rowid_part_id(void *ptr, uchar *ref1, uchar *ref2);
 
+
+/**
+  Rows of partitions read ahead by worker threads.
+
+  A worker thread takes a partition that has room in its buffer, reads a
+  batch of rows with the handler of the partition and gives the partition
+  back. The partition with the lowest id is served first, so the
+  partition that a table scan currently returns rows from is not starved
+  by the partitions after it. The handler of a partition is only used by
+  one thread at a time.
+*/
+
+class Partition_prefetch
+{
+public:
+  enum scan_type { RND_NEXT, INDEX_NEXT };
+
+  /** Number of rows a scan returns before prefetching starts */
+  static const uint START_AFTER_ROWS= 1024;
+  /** Limits of the number of rows buffered per partition */
+  static const uint MIN_ROWS= 16, MAX_ROWS= 1024;
+
+  Partition_prefetch(ha_partition *owner, scan_type type, uint tot_parts,
+                     uint rec_length, uint ref_length);
+  ~Partition_prefetch();
+
+  /**
+    Allocate a buffer for rows of a partition.
+    @param cached  whether the caller has set up a read cache for the
+                   partition already
+    @return whether out of memory
+  */
+  bool add_partition(uint part_id, uint n_rows, bool cached);
+  /**
+    Create the worker threads.
+    @return whether no thread could be created
+  */
+  bool start(uint n_threads);
+  /** Stop the worker threads. Further rows are read by read() itself */
+  void stop();
+  /**
+    Get the next row of a partition.
+    @return 0, HA_ERR_END_OF_FILE or another error code
+  */
+  int read(uint part_id, uchar *buf, uchar *ref);
+
+private:
+  struct Part
+  {
+    uchar *rows;                        /* ring buffer of row slots */
+    uint n_slots;
+    uint first;                         /* first buffered row */
+    uint count;                         /* number of buffered rows */
+    int status;                         /* error that ended the scan, or 0 */
+    bool busy;                          /* a worker is reading rows */
+    bool started;                       /* the scan was set up */
+    bool cached;                        /* we set up a read cache */
+  };
+
+  ha_partition *m_owner;
+  scan_type m_type;
+  uint m_tot_parts;
+  uint m_rec_length, m_ref_length, m_slot_length;
+  Part *m_parts;                        /* indexed by partition id */
+  pthread_t *m_threads;
+  uint m_n_threads;
+  bool m_stop;
+  mysql_mutex_t m_mutex;
+  mysql_cond_t m_work_cond;             /* signalled when there is room */
+  mysql_cond_t m_read_cond;             /* signalled when rows are read */
+
+  int read_row(uint part_id, uchar *slot);
+  void end_part(uint part_id);
+  uint next_work() const;
+  void run();
+  static void *worker_thread(void *arg);
+};
+
+
+
 class ha_partition :public handler
 {
 private:
@@ -448,6 +528,13 @@ class ha_partition :public handler
   /** This is one of the m_file-s that it guaranteed to be opened. */
   /**  It is set in open_read_partitions() */
   handler *m_file_sample;
+  /** Rows read ahead by worker threads, or NULL */
+  Partition_prefetch *m_prefetch;
+  /** Rows to return before starting m_prefetch, 0 to never start it */
+  uint m_prefetch_countdown;
+  /** Position of the last row returned from m_prefetch */
+  uchar *m_prefetch_ref;
+  uchar *m_prefetch_ref_buffer;
 public:
   handler **get_child_handlers()
   {
@@ -768,6 +855,8 @@ class ha_partition :public handler
   int rnd_init(bool scan) override;
   int rnd_end() override;
   int rnd_next(uchar * buf) override;
+  int rnd_next_batch(uchar *buf, size_t stride, uint max_rows,
+                     uint *rows) override;
   int rnd_pos(uchar * buf, uchar * pos) override;
   int rnd_pos_by_record(uchar *record) override;
   void position(const uchar * record) override;
@@ -824,6 +913,8 @@ class ha_partition :public handler
     scan. There are also methods to jump to first and last entry.
   */
   int index_next(uchar * buf) override;
+  int index_next_batch(uchar *buf, size_t stride, uint max_rows,
+                       uint *rows) override;
   int index_prev(uchar * buf) override;
   int index_first(uchar * buf) override;
   int index_last(uchar * buf) override;
@@ -938,6 +1029,15 @@ class ha_partition :public handler
   int handle_ordered_next(uchar * buf, bool next_same);
   int handle_ordered_prev(uchar * buf);
   void return_top_record(uchar * buf);
+  bool can_prefetch() const;
+  void start_prefetch(Partition_prefetch::scan_type type);
+  void end_prefetch();
+  int end_prefetch_index_scan();
+  int prefetch_rnd_next(uchar *buf);
+  int prefetch_read_row(uint part_id, Partition_prefetch::scan_type type,
+                        uchar *buf, uchar *ref);
+  void prefetch_read_cache(uint part_id, bool enable);
+  friend class Partition_prefetch;
 public:
   /*
     -------------------------------------------------------------------------
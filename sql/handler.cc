@@ -3087,6 +3087,52 @@ int handler::ha_rnd_next(uchar *buf)
   DBUG_RETURN(result);
 }
 
+/**
+  Read up to max_rows rows of a table scan with one call to the engine.
+  Virtual columns are not computed, the caller must not use this for
+  tables that have them.
+*/
+
+int handler::ha_rnd_next_batch(uchar *buf, size_t stride, uint max_rows,
+                               uint *rows)
+{
+  int result;
+  DBUG_ENTER("handler::ha_rnd_next_batch");
+  DBUG_ASSERT(table_share->tmp_table != NO_TMP_TABLE ||
+              m_lock_type != F_UNLCK);
+  DBUG_ASSERT(inited == RND);
+  DBUG_ASSERT(max_rows > 0);
+  DBUG_ASSERT(!table->vfield);
+
+  do
+  {
+    TABLE_IO_WAIT(tracker, PSI_TABLE_FETCH_ROW, MAX_KEY, result,
+      { result= rnd_next_batch(buf, stride, max_rows, rows); })
+    if (result != HA_ERR_RECORD_DELETED)
+      break;
+    status_var_increment(table->in_use->status_var.ha_read_rnd_deleted_count);
+  } while (!table->in_use->check_killed(1));
+
+  if (result == HA_ERR_RECORD_DELETED)
+    result= HA_ERR_ABORTED_BY_USER;
+  else if (!result)
+  {
+    DBUG_ASSERT(*rows > 0 && *rows <= max_rows);
+    for (uint i= 0; i < *rows; i++)
+    {
+      update_rows_read();
+      increment_statistics(&SSV::ha_read_rnd_next_count);
+    }
+  }
+  else
+    increment_statistics(&SSV::ha_read_rnd_next_count);
+
+  if (result)
+    *rows= 0;
+  table->status=result ? STATUS_NOT_FOUND: 0;
+  DBUG_RETURN(result);
+}
+
 int handler::ha_rnd_pos(uchar *buf, uchar *pos)
 {
   int result;
@@ -3186,6 +3232,42 @@ int handler::ha_index_next(uchar * buf)
   DBUG_RETURN(result);
 }
 
+/**
+  Read up to max_rows rows of an index scan with one call to the engine.
+  Virtual columns are not computed, @see ha_rnd_next_batch()
+*/
+
+int handler::ha_index_next_batch(uchar *buf, size_t stride, uint max_rows,
+                                 uint *rows)
+{
+  int result;
+  DBUG_ENTER("handler::ha_index_next_batch");
+  DBUG_ASSERT(table_share->tmp_table != NO_TMP_TABLE ||
+              m_lock_type != F_UNLCK);
+  DBUG_ASSERT(inited==INDEX);
+  DBUG_ASSERT(max_rows > 0);
+  DBUG_ASSERT(!table->vfield);
+
+  TABLE_IO_WAIT(tracker, PSI_TABLE_FETCH_ROW, active_index, result,
+    { result= index_next_batch(buf, stride, max_rows, rows); })
+  if (!result)
+  {
+    DBUG_ASSERT(*rows > 0 && *rows <= max_rows);
+    for (uint i= 0; i < *rows; i++)
+    {
+      increment_statistics(&SSV::ha_read_next_count);
+      update_index_statistics();
+    }
+  }
+  else
+  {
+    increment_statistics(&SSV::ha_read_next_count);
+    *rows= 0;
+  }
+  table->status=result ? STATUS_NOT_FOUND: 0;
+  DBUG_RETURN(result);
+}
+
 int handler::ha_index_prev(uchar * buf)
 {
   int result;
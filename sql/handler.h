@@ -349,7 +349,21 @@ enum chf_create_flags {
  */
 #define HA_ONLINE_ANALYZE             (1ULL << 59)
 
-#define HA_LAST_TABLE_FLAG HA_ONLINE_ANALYZE
+/*
+  Different handler objects of a table may read rows with rnd_next() and
+  index_next() in different threads at the same time. Used by partitioning
+  to read ahead rows of several partitions in parallel.
+*/
+#define HA_CAN_SCAN_IN_THREADS        (1ULL << 60)
+
+/*
+  rnd_next_batch() and index_next_batch() may return more than one row
+  per call. position() of such an engine only looks at the record passed
+  to it, so it works for rows that were not the last one read.
+*/
+#define HA_CAN_READ_BATCH             (1ULL << 61)
+
+#define HA_LAST_TABLE_FLAG HA_CAN_READ_BATCH
 
 
 /* bits in index_flags(index_number) for what you can do with index */
@@ -3815,6 +3829,18 @@ class handler :public Sql_alloc
   virtual int index_last(uchar * buf)
    { return  HA_ERR_WRONG_COMMAND; }
   virtual int index_next_same(uchar *buf, const uchar *key, uint keylen);
+  /**
+    Read the next rows of an index scan into buf, buf + stride, ...
+    At least one row is read, unless an error is returned.
+    @param[out] rows   number of rows read, at most max_rows
+  */
+  virtual int index_next_batch(uchar *buf, size_t stride, uint max_rows,
+                               uint *rows)
+  {
+    int error= index_next(buf);
+    *rows= error ? 0 : 1;
+    return error;
+  }
   /**
      @brief
      The following functions works like index_read, but it find the last
@@ -3849,6 +3875,8 @@ class handler :public Sql_alloc
                             key_part_map keypart_map,
                             enum ha_rkey_function find_flag);
   int ha_index_next(uchar * buf);
+  int ha_index_next_batch(uchar *buf, size_t stride, uint max_rows,
+                          uint *rows);
   int ha_index_prev(uchar * buf);
   int ha_index_first(uchar * buf);
   int ha_index_last(uchar * buf);
@@ -3908,9 +3936,25 @@ class handler :public Sql_alloc
   virtual int pre_ft_end() { return 0; }
   virtual FT_INFO *ft_init_ext(uint flags, uint inx,String *key)
     { return NULL; }
+  /**
+    Like ft_init_ext(), for a search whose rows are read in the order of
+    relevance and of which at most limit rows are needed. The engine may
+    then leave out documents that are ranked below the first limit ones.
+  */
+  virtual FT_INFO *ft_init_ext_with_limit(uint flags, uint inx, String *key,
+                                          ha_rows limit)
+    { return ft_init_ext(flags, inx, key); }
 public:
   virtual int ft_read(uchar *buf) { return HA_ERR_WRONG_COMMAND; }
   virtual int rnd_next(uchar *buf)=0;
+  /** Read the next rows of a table scan, @see index_next_batch() */
+  virtual int rnd_next_batch(uchar *buf, size_t stride, uint max_rows,
+                             uint *rows)
+  {
+    int error= rnd_next(buf);
+    *rows= error ? 0 : 1;
+    return error;
+  }
   virtual int rnd_pos(uchar * buf, uchar *pos)=0;
   /**
     This function only works for handlers having
@@ -3938,6 +3982,8 @@ class handler :public Sql_alloc
   inline int ha_ft_read(uchar *buf);
   inline void ha_ft_end() { ft_end(); ft_handler=NULL; }
   int ha_rnd_next(uchar *buf);
+  int ha_rnd_next_batch(uchar *buf, size_t stride, uint max_rows,
+                        uint *rows);
   int ha_rnd_pos(uchar *buf, uchar *pos);
   inline int ha_rnd_pos_by_record(uchar *buf);
   inline int ha_read_first_row(uchar *buf, uint primary_key);
@@ -4035,6 +4081,14 @@ class handler :public Sql_alloc
   /* end of the list of admin commands */
 
   virtual int indexes_are_disabled(void) {return 0;}
+  /**
+    Exchange the rows of two internal temporary tables of the same
+    structure, opened by the same engine, without copying them.
+    Used to pass work tables between iterations of recursive CTEs.
+
+    @retval true  not supported, the rows have to be copied
+  */
+  virtual bool exchange_tmp_table_rows(handler *other) { return true; }
   virtual char *update_table_comment(const char * comment)
   { return (char*) comment;}
   virtual void append_create_info(String *packet) {}
@@ -112,6 +112,7 @@ struct SARGABLE_PARAM;
 class RANGE_OPT_PARAM;
 class SEL_TREE;
 class With_sum_func_cache;
+class Batch_cond;
 
 enum precedence {
   LOWEST_PRECEDENCE,
@@ -1785,6 +1786,11 @@ class Item: public Value_source,
                           with one of the partN evaluating to SEL_TREE::ALWAYS.
    */
    virtual SEL_TREE *get_mm_tree(RANGE_OPT_PARAM *param, Item **cond_ptr);
+  /*
+    Add this condition to a compiled table condition, see Batch_cond.
+    Returns true if the condition can not be compiled.
+  */
+  virtual bool add_to_batch_cond(THD *thd, Batch_cond *cond) { return true; }
   /*
     Checks whether the item is:
     - a simple equality (field=field_item or field=constant_item), or
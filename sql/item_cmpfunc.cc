@@ -32,6 +32,7 @@
 #include "sql_select.h"
 #include "sql_parse.h"                          // check_stack_overrun
 #include "sql_base.h"                  // dynamic_column_error_message
+#include "sql_batch_cond.h"
 
 #define PCRE2_STATIC 1             /* Important on Windows */
 #include "pcre2.h"                 /* pcre2 header file */
@@ -453,6 +454,13 @@ bool Item_bool_rowready_func2::fix_length_and_dec()
 }
 
 
+bool Item_bool_rowready_func2::add_to_batch_cond(THD *thd, Batch_cond *cond)
+{
+  return cond->add_comparison(thd, functype(), args[0], args[1],
+                              compare_type_handler());
+}
+
+
 /**
   Prepare the comparator (set the comparison function) for comparing
   items *a1 and *a2 in the context of 'type'.
@@ -2307,6 +2315,16 @@ longlong Item_func_between::val_int_cmp_decimal()
 }
 
 
+bool Item_func_between::add_to_batch_cond(THD *thd, Batch_cond *cond)
+{
+  if (negated)
+    return true;
+  const Type_handler *handler= m_comparator.type_handler();
+  return cond->add_comparison(thd, GE_FUNC, args[0], args[1], handler) ||
+         cond->add_comparison(thd, LE_FUNC, args[0], args[2], handler);
+}
+
+
 longlong Item_func_between::val_int_cmp_real()
 {
   double value= args[0]->val_real(),a,b;
@@ -5436,6 +5454,19 @@ longlong Item_cond_and::val_int()
 }
 
 
+bool Item_cond_and::add_to_batch_cond(THD *thd, Batch_cond *cond)
+{
+  List_iterator_fast<Item> li(list);
+  Item *item;
+  while ((item= li++))
+  {
+    if (item->add_to_batch_cond(thd, cond))
+      return true;
+  }
+  return false;
+}
+
+
 longlong Item_cond_or::val_int()
 {
   DBUG_ASSERT(fixed == 1);
@@ -5535,6 +5566,15 @@ bool Item_func_isnull::find_not_null_fields(table_map allowed)
 }
 
 
+bool Item_func_isnull::add_to_batch_cond(THD *thd, Batch_cond *cond)
+{
+  /* Item_is_not_null_test has side effects on its subquery */
+  if (functype() != ISNULL_FUNC)
+    return true;
+  return cond->add_null_check(args[0], true);
+}
+
+
 void Item_func_isnull::print(String *str, enum_query_type query_type)
 {
   if (const_item() && !args[0]->maybe_null &&
@@ -5581,6 +5621,12 @@ longlong Item_func_isnotnull::val_int()
 }
 
 
+bool Item_func_isnotnull::add_to_batch_cond(THD *thd, Batch_cond *cond)
+{
+  return cond->add_null_check(args[0], false);
+}
+
+
 void Item_func_isnotnull::print(String *str, enum_query_type query_type)
 {
   args[0]->print_parenthesised(str, query_type, precedence());
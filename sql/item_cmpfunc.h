@@ -551,6 +551,7 @@ class Item_bool_rowready_func2 :public Item_bool_func2_with_rev
     Item_bool_func2::cleanup();
     cmp.cleanup();
   }
+  bool add_to_batch_cond(THD *thd, Batch_cond *cond);
   void add_key_fields(JOIN *join, KEY_FIELD **key_fields,
                       uint *and_level, table_map usable_tables,
                       SARGABLE_PARAM **sargables)
@@ -949,6 +950,7 @@ class Item_func_between :public Item_func_opt_neg
                                       cond);
     return this;
   }
+  bool add_to_batch_cond(THD *thd, Batch_cond *cond);
   Item *get_copy(THD *thd)
   { return get_item_copy<Item_func_between>(thd, this); }
 
@@ -2617,6 +2619,7 @@ class Item_func_isnull :public Item_func_null_predicate
   table_map not_null_tables() const { return 0; }
   bool find_not_null_fields(table_map allowed);
   Item *neg_transformer(THD *thd);
+  bool add_to_batch_cond(THD *thd, Batch_cond *cond);
   Item *get_copy(THD *thd)
   { return get_item_copy<Item_func_isnull>(thd, this); }
 };
@@ -2665,6 +2668,7 @@ class Item_func_isnotnull :public Item_func_null_predicate
   Item *neg_transformer(THD *thd);
   void print(String *str, enum_query_type query_type);
   void top_level_item() { abort_on_null=1; }
+  bool add_to_batch_cond(THD *thd, Batch_cond *cond);
   Item *get_copy(THD *thd)
   { return get_item_copy<Item_func_isnotnull>(thd, this); }
 };
@@ -3376,6 +3380,7 @@ class Item_cond_and final :public Item_cond
   void add_key_fields(JOIN *join, KEY_FIELD **key_fields, uint *and_level,
                       table_map usable_tables, SARGABLE_PARAM **sargables);
   SEL_TREE *get_mm_tree(RANGE_OPT_PARAM *param, Item **cond_ptr);
+  bool add_to_batch_cond(THD *thd, Batch_cond *cond);
   Item *get_copy(THD *thd)
   { return get_item_copy<Item_cond_and>(thd, this); }
 };
@@ -6181,7 +6181,11 @@ bool Item_func_match::init_search(THD *thd, bool no_order)
   if (key != NO_SUCH_KEY)
     THD_STAGE_INFO(table->in_use, stage_fulltext_initialization);
 
-  ft_handler= table->file->ft_init_ext(flags, key, ft_tmp);
+  if (ft_limit != HA_POS_ERROR)
+    ft_handler= table->file->ft_init_ext_with_limit(flags, key, ft_tmp,
+                                                    ft_limit);
+  else
+    ft_handler= table->file->ft_init_ext(flags, key, ft_tmp);
 
   if (join_key)
     table->file->ft_handler=ft_handler;
@@ -3239,10 +3239,12 @@ class Item_func_match :public Item_real_func
   Item *concat_ws;           // Item_func_concat_ws
   String value;              // value of concat_ws
   String search_value;       // key_item()'s value converted to cmp_collation
+  ha_rows ft_limit;          // rows read in the order of relevance, or
+                             // HA_POS_ERROR
 
   Item_func_match(THD *thd, List<Item> &a, uint b):
     Item_real_func(thd, a), key(0), flags(b), join_key(0), ft_handler(0),
-    table(0), master(0), concat_ws(0) { }
+    table(0), master(0), concat_ws(0), ft_limit(HA_POS_ERROR) { }
   void cleanup()
   {
     DBUG_ENTER("Item_func_match::cleanup");
@@ -3252,6 +3254,7 @@ class Item_func_match :public Item_real_func
     ft_handler= 0;
     concat_ws= 0;
     table= 0;           // required by Item_func_match::eq()
+    ft_limit= HA_POS_ERROR;
     DBUG_VOID_RETURN;
   }
   bool is_expensive_processor(void *arg) { return TRUE; }
@@ -2721,6 +2721,214 @@ bool Item_sum_and::add()
   return 0;
 }
 
+/*
+  APPROX_COUNT_DISTINCT(), APPROX_COUNT_DISTINCT_SKETCH() and
+  APPROX_COUNT_DISTINCT_MERGE()
+*/
+
+bool Item_sum_hll::fix_fields(THD *thd, Item **ref)
+{
+  DBUG_ASSERT(fixed == 0);
+
+  if (init_sum_func_check(thd))
+    return TRUE;
+
+  if (args[0]->fix_fields_if_needed_for_scalar(thd, &args[0]))
+    return TRUE;
+  m_with_subquery|= args[0]->with_subquery();
+  with_param|= args[0]->with_param;
+  with_window_func|= args[0]->with_window_func;
+
+  precision= (uint) thd->variables.approx_count_distinct_precision;
+  result_field= 0;
+  null_value= 1;
+  if (fix_length_and_dec() ||
+      check_sum_func(thd, ref))
+    return TRUE;
+
+  memcpy(orig_args, args, sizeof(Item *) * arg_count);
+  fixed= 1;
+  return FALSE;
+}
+
+
+bool Item_sum_hll::setup(THD *thd)
+{
+  DBUG_ENTER("Item_sum_hll::setup");
+  if (!sketch.is_inited() && sketch.init(thd->mem_root, precision))
+    DBUG_RETURN(TRUE);
+  DBUG_RETURN(FALSE);
+}
+
+
+void Item_sum_hll::clear()
+{
+  if (sketch.is_inited())
+    sketch.clear();
+}
+
+
+void Item_sum_hll::cleanup()
+{
+  DBUG_ENTER("Item_sum_hll::cleanup");
+  /* The registers were allocated on the execution mem_root */
+  sketch= Hyperloglog();
+  tmp_value.free();
+  Item_sum::cleanup();
+  DBUG_VOID_RETURN;
+}
+
+
+/**
+  Hash the current value of the argument so that values which are equal
+  for COUNT(DISTINCT) get the same hash.
+*/
+
+bool Item_sum_hll::add_value_hash()
+{
+  Item *arg= args[0];
+  ulonglong hash;
+
+  switch (arg->cmp_type()) {
+  case INT_RESULT:
+  {
+    longlong value= arg->val_int();
+    if (arg->null_value)
+      return 0;
+    hash= Hyperloglog::mix((ulonglong) value ^ 0x9e3779b97f4a7c15ULL);
+    break;
+  }
+  case REAL_RESULT:
+  {
+    double value= arg->val_real();
+    uchar buff[8];
+    if (arg->null_value)
+      return 0;
+    if (value == 0.0)
+      value= 0.0;                               // -0.0 is equal to 0.0
+    float8store(buff, value);
+    hash= Hyperloglog::hash_bytes(buff, sizeof(buff));
+    break;
+  }
+  case DECIMAL_RESULT:
+  {
+    my_decimal value_buff, *value= arg->val_decimal(&value_buff);
+    uchar buff[DECIMAL_MAX_FIELD_SIZE];
+    if (arg->null_value)
+      return 0;
+    uint prec= arg->decimal_precision();
+    /* Same values have the same binary image at the same scale */
+    value->to_binary(buff, prec, arg->decimals, E_DEC_OK);
+    hash= Hyperloglog::hash_bytes(buff, my_decimal_get_binary_size(prec,
+                                                                arg->decimals));
+    break;
+  }
+  case TIME_RESULT:
+  {
+    THD *thd= current_thd;
+    longlong value=
+      arg->type_handler()->mysql_timestamp_type() == MYSQL_TIMESTAMP_TIME ?
+      arg->val_time_packed(thd) : arg->val_datetime_packed(thd);
+    if (arg->null_value)
+      return 0;
+    hash= Hyperloglog::mix((ulonglong) value ^ 0x9e3779b97f4a7c15ULL);
+    break;
+  }
+  case STRING_RESULT:
+  {
+    String *res= arg->val_str(&tmp_value);
+    if (arg->null_value)
+      return 0;
+    CHARSET_INFO *cs= res->charset();
+    if (cs->state & MY_CS_BINSORT)
+      hash= Hyperloglog::hash_bytes((const uchar *) res->ptr(), res->length());
+    else
+    {
+      /* Strings equal according to the collation must collide */
+      ulong nr1= 1, nr2= 4;
+      cs->hash_sort((const uchar *) res->ptr(), res->length(), &nr1, &nr2);
+      hash= Hyperloglog::mix((ulonglong) nr1 ^ ((ulonglong) nr2 << 32));
+    }
+    break;
+  }
+  case ROW_RESULT:
+  default:
+    DBUG_ASSERT(0);
+    return 0;
+  }
+
+  if (likely(sketch.is_inited()))
+    sketch.add_hash(hash);
+  return 0;
+}
+
+
+bool Item_sum_hll::add_sketch()
+{
+  String *res= args[0]->val_str(&tmp_value);
+  if (args[0]->null_value)
+    return 0;
+  if (sketch.merge((const uchar *) res->ptr(), res->length()))
+  {
+    my_error(ER_WRONG_ARGUMENTS, MYF(0), "APPROX_COUNT_DISTINCT_MERGE");
+    return 1;
+  }
+  return 0;
+}
+
+
+Item *Item_sum_approx_count_distinct::copy_or_same(THD* thd)
+{
+  return new (thd->mem_root) Item_sum_approx_count_distinct(thd, this);
+}
+
+
+longlong Item_sum_approx_count_distinct::val_int()
+{
+  DBUG_ASSERT(fixed == 1);
+  null_value= 0;
+  if (!sketch.is_inited())
+    return 0;
+  return (longlong) sketch.estimate();
+}
+
+
+Item *Item_sum_approx_count_distinct_sketch::copy_or_same(THD* thd)
+{
+  return new (thd->mem_root) Item_sum_approx_count_distinct_sketch(thd, this);
+}
+
+
+bool Item_sum_approx_count_distinct_sketch::fix_length_and_dec()
+{
+  collation.set(&my_charset_bin, DERIVATION_COERCIBLE);
+  decimals= 0;
+  max_length= (uint32) Hyperloglog::max_serialized_length(precision);
+  maybe_null= null_value= 0;
+  return FALSE;
+}
+
+
+String *Item_sum_approx_count_distinct_sketch::val_str(String *str)
+{
+  DBUG_ASSERT(fixed == 1);
+  null_value= 0;
+  if (!sketch.is_inited())
+  {
+    /* No rows were aggregated: return an empty sketch */
+    Hyperloglog empty;
+    if (empty.init(current_thd->mem_root, precision))
+      return NULL;
+    sketch= empty;
+  }
+  if (result.alloc(sketch.serialized_length()))
+    return NULL;
+  result.length(sketch.serialize((uchar *) result.ptr()));
+  result.set_charset(&my_charset_bin);
+  return &result;
+}
+
+
 /************************************************************************
 ** reset result of a Item_sum with is saved in a tmp_table
 *************************************************************************/
@@ -3057,6 +3265,79 @@ void Item_sum_avg::update_field()
 }
 
 
+/**
+  Add the partial sum stored at result_field->ptr + diff to result_field.
+*/
+
+void Item_sum_sum::merge_field(my_ptrdiff_t diff)
+{
+  if (result_field->is_null(diff))
+    return;
+  if (result_type() == DECIMAL_RESULT)
+  {
+    result_field->move_field_offset(diff);
+    my_decimal partial(result_field);
+    result_field->move_field_offset(-diff);
+    if (!result_field->is_null())
+    {
+      my_decimal field_value(result_field);
+      my_decimal_add(E_DEC_FATAL_ERROR, dec_buffs, &partial, &field_value);
+      result_field->store_decimal(dec_buffs);
+    }
+    else
+      result_field->store_decimal(&partial);
+  }
+  else
+  {
+    double old_nr, nr;
+    uchar *res= result_field->ptr;
+    float8get(nr, res + diff);
+    if (!result_field->is_null())
+    {
+      float8get(old_nr, res);
+      nr+= old_nr;
+    }
+    float8store(res, nr);
+  }
+  result_field->set_notnull();
+}
+
+
+void Item_sum_count::merge_field(my_ptrdiff_t diff)
+{
+  uchar *res= result_field->ptr;
+  int8store(res, sint8korr(res) + sint8korr(res + diff));
+}
+
+
+void Item_sum_avg::merge_field(my_ptrdiff_t diff)
+{
+  uchar *res= result_field->ptr;
+
+  if (result_type() == DECIMAL_RESULT)
+  {
+    my_decimal sum;
+    binary2my_decimal(E_DEC_FATAL_ERROR, res,
+                      dec_buffs, f_precision, f_scale);
+    binary2my_decimal(E_DEC_FATAL_ERROR, res + diff,
+                      dec_buffs + 1, f_precision, f_scale);
+    my_decimal_add(E_DEC_FATAL_ERROR, &sum, dec_buffs, dec_buffs + 1);
+    sum.to_binary(res, f_precision, f_scale);
+    res+= dec_bin_size;
+  }
+  else
+  {
+    double old_nr, nr;
+    float8get(old_nr, res);
+    float8get(nr, res + diff);
+    old_nr+= nr;
+    float8store(res, old_nr);
+    res+= sizeof(double);
+  }
+  int8store(res, sint8korr(res) + sint8korr(res + diff));
+}
+
+
 Item *Item_sum_avg::result_item(THD *thd, Field *field)
 {
   return
@@ -3145,6 +3426,26 @@ Item_sum_min_max::min_max_update_native_field()
 }
 
 
+/**
+  Keep the smaller (MIN) or the bigger (MAX) of result_field and the
+  partial value stored at result_field->ptr + diff.
+*/
+
+void Item_sum_min_max::merge_field(my_ptrdiff_t diff)
+{
+  uchar *res= result_field->ptr;
+
+  if (result_field->is_null(diff))
+    return;
+  if (result_field->is_null() ||
+      cmp_sign * result_field->cmp(res + diff, res) < 0)
+  {
+    memcpy(res, res + diff, result_field->pack_length());
+    result_field->set_notnull();
+  }
+}
+
+
 void
 Item_sum_min_max::min_max_update_str_field()
 {
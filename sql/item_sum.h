@@ -25,6 +25,7 @@
 
 #include <my_tree.h>
 #include "sql_udf.h"                            /* udf_handler */
+#include "sql_hll.h"                            /* Hyperloglog */
 
 class Item_sum;
 class Aggregator_distinct;
@@ -356,7 +357,7 @@ class Item_sum :public Item_func_or_sum
     CUME_DIST_FUNC, NTILE_FUNC, FIRST_VALUE_FUNC, LAST_VALUE_FUNC,
     NTH_VALUE_FUNC, LEAD_FUNC, LAG_FUNC, PERCENTILE_CONT_FUNC,
     PERCENTILE_DISC_FUNC, SP_AGGREGATE_FUNC, JSON_ARRAYAGG_FUNC,
-    JSON_OBJECTAGG_FUNC
+    JSON_OBJECTAGG_FUNC, APPROX_COUNT_DISTINCT_FUNC
   };
 
   Item **ref_by; /* pointer to a ref to the object used to register it */
@@ -430,6 +431,7 @@ class Item_sum :public Item_func_or_sum
     case UDF_SUM_FUNC:
     case GROUP_CONCAT_FUNC:
     case JSON_ARRAYAGG_FUNC:
+    case APPROX_COUNT_DISTINCT_FUNC:
       return true;
     default:
       return false;
@@ -461,6 +463,17 @@ class Item_sum :public Item_func_or_sum
     Updated value is then saved in the field.
   */
   virtual void update_field()=0;
+  /*
+    Whether two partial aggregates of the same group kept in result_field
+    can be combined with merge_field(). Used to aggregate groups that were
+    spilled to disk in several pieces.
+  */
+  virtual bool supports_field_merge() const { return false; }
+  /*
+    Combine the partial aggregate stored at result_field->ptr + diff into
+    result_field.
+  */
+  virtual void merge_field(my_ptrdiff_t diff) { DBUG_ASSERT(0); }
   virtual bool fix_length_and_dec()
   { maybe_null=1; null_value=1; return FALSE; }
   virtual Item *result_item(THD *thd, Field *field);
@@ -830,6 +843,8 @@ class Item_sum_sum :public Item_sum_num,
   void fix_length_and_dec_decimal();
   void reset_field();
   void update_field();
+  bool supports_field_merge() const { return !has_with_distinct(); }
+  void merge_field(my_ptrdiff_t diff);
   void no_rows_in_result() {}
   const char *func_name() const 
   { 
@@ -903,6 +918,8 @@ class Item_sum_count :public Item_sum_int
   longlong val_int();
   void reset_field();
   void update_field();
+  bool supports_field_merge() const { return !has_with_distinct(); }
+  void merge_field(my_ptrdiff_t diff);
   void direct_add(longlong add_count);
   const char *func_name() const 
   { 
@@ -952,6 +969,7 @@ class Item_sum_avg :public Item_sum_sum
   String *val_str(String *str);
   void reset_field();
   void update_field();
+  void merge_field(my_ptrdiff_t diff);
   Item *result_item(THD *thd, Field *field);
   void no_rows_in_result() {}
   const char *func_name() const 
@@ -1143,6 +1161,8 @@ class Item_sum_min_max :public Item_sum_hybrid
   }
   const TYPELIB *get_typelib() const { return args[0]->get_typelib(); }
   void update_field();
+  bool supports_field_merge() const { return true; }
+  void merge_field(my_ptrdiff_t diff);
   void min_max_update_str_field();
   void min_max_update_real_field();
   void min_max_update_int_field();
@@ -1308,6 +1328,127 @@ class Item_sum_xor final :public Item_sum_bit
   void set_bits_from_counters();
 };
 
+/**
+  Common part of the HyperLogLog based approximate distinct counting:
+  APPROX_COUNT_DISTINCT(expr), APPROX_COUNT_DISTINCT_SKETCH(expr) and
+  APPROX_COUNT_DISTINCT_MERGE(sketch).
+
+  Unlike COUNT(DISTINCT) the memory used does not depend on the number
+  of distinct values: every group keeps a sketch of
+  2^approx_count_distinct_precision bytes.
+*/
+
+class Item_sum_hll :public Item_sum
+{
+protected:
+  Hyperloglog sketch;
+  /* approx_count_distinct_precision at the time of fix_fields() */
+  uint precision;
+  /* The argument is a serialized sketch rather than a value to count */
+  bool merge_sketches;
+  String tmp_value;
+
+  bool add_value_hash();
+  bool add_sketch();
+public:
+  Item_sum_hll(THD *thd, Item *item_par, bool merge_sketches_arg):
+    Item_sum(thd, item_par), precision(Hyperloglog::DEFAULT_PRECISION),
+    merge_sketches(merge_sketches_arg)
+  {
+    quick_group= FALSE;
+  }
+  Item_sum_hll(THD *thd, Item_sum_hll *item):
+    Item_sum(thd, item), precision(item->precision),
+    merge_sketches(item->merge_sketches)
+  {
+    quick_group= FALSE;
+  }
+  enum Sumfunctype sum_func () const { return APPROX_COUNT_DISTINCT_FUNC; }
+  bool fix_fields(THD *thd, Item **ref);
+  bool setup(THD *thd);
+  void clear();
+  bool add() { return merge_sketches ? add_sketch() : add_value_hash(); }
+  void reset_field() { DBUG_ASSERT(0); }        // not used
+  void update_field() { DBUG_ASSERT(0); }       // not used
+  void cleanup();
+};
+
+
+class Item_sum_approx_count_distinct final :public Item_sum_hll
+{
+public:
+  Item_sum_approx_count_distinct(THD *thd, Item *item_par,
+                                 bool merge_sketches_arg):
+    Item_sum_hll(thd, item_par, merge_sketches_arg) {}
+  Item_sum_approx_count_distinct(THD *thd, Item_sum_approx_count_distinct *item)
+    :Item_sum_hll(thd, item) {}
+  const char *func_name() const
+  {
+    return merge_sketches ? "approx_count_distinct_merge(" :
+                            "approx_count_distinct(";
+  }
+  const Type_handler *type_handler() const { return &type_handler_slonglong; }
+  bool fix_length_and_dec()
+  { decimals=0; max_length=21; maybe_null=null_value=0; return FALSE; }
+  longlong val_int();
+  double val_real() { DBUG_ASSERT(fixed == 1); return (double) val_int(); }
+  String *val_str(String *str) { return val_string_from_int(str); }
+  my_decimal *val_decimal(my_decimal *to) { return val_decimal_from_int(to); }
+  bool get_date(THD *thd, MYSQL_TIME *ltime, date_mode_t fuzzydate)
+  {
+    return get_date_from_int(thd, ltime, fuzzydate);
+  }
+  void no_rows_in_result() { clear(); }
+  Item *copy_or_same(THD* thd);
+  Item *get_copy(THD *thd)
+  { return get_item_copy<Item_sum_approx_count_distinct>(thd, this); }
+};
+
+
+class Item_sum_approx_count_distinct_sketch final :public Item_sum_hll
+{
+  String result;
+public:
+  Item_sum_approx_count_distinct_sketch(THD *thd, Item *item_par):
+    Item_sum_hll(thd, item_par, false) {}
+  Item_sum_approx_count_distinct_sketch(THD *thd,
+                                        Item_sum_approx_count_distinct_sketch
+                                        *item)
+    :Item_sum_hll(thd, item) {}
+  const char *func_name() const { return "approx_count_distinct_sketch("; }
+  const Type_handler *type_handler() const
+  {
+    if (too_big_for_varchar())
+      return &type_handler_blob;
+    return &type_handler_varchar;
+  }
+  bool fix_length_and_dec();
+  String *val_str(String *str);
+  double val_real()
+  {
+    String *res= val_str(&str_value);
+    return res ? double_from_string_with_check(res) : 0.0;
+  }
+  longlong val_int()
+  {
+    int error;
+    return val_int_from_str(&error);
+  }
+  my_decimal *val_decimal(my_decimal *to)
+  {
+    return val_decimal_from_string(to);
+  }
+  bool get_date(THD *thd, MYSQL_TIME *ltime, date_mode_t fuzzydate)
+  {
+    return get_date_from_string(thd, ltime, fuzzydate);
+  }
+  void no_rows_in_result() { clear(); }
+  Item *copy_or_same(THD* thd);
+  Item *get_copy(THD *thd)
+  { return get_item_copy<Item_sum_approx_count_distinct_sketch>(thd, this); }
+};
+
+
 class sp_head;
 class sp_name;
 class Query_arena;
@@ -737,6 +737,9 @@ static SYMBOL symbols[] = {
 
 static SYMBOL sql_functions[] = {
   { "ADDDATE",		SYM(ADDDATE_SYM)},
+  { "APPROX_COUNT_DISTINCT", SYM(APPROX_COUNT_DISTINCT_SYM)},
+  { "APPROX_COUNT_DISTINCT_MERGE", SYM(APPROX_COUNT_DISTINCT_MERGE_SYM)},
+  { "APPROX_COUNT_DISTINCT_SKETCH", SYM(APPROX_COUNT_DISTINCT_SKETCH_SYM)},
   { "BIT_AND",		SYM(BIT_AND)},
   { "BIT_OR",		SYM(BIT_OR)},
   { "BIT_XOR",		SYM(BIT_XOR)},
@@ -913,6 +913,7 @@ PSI_mutex_key key_LOCK_ack_receiver;
 
 PSI_mutex_key key_TABLE_SHARE_LOCK_rotation;
 PSI_cond_key key_TABLE_SHARE_COND_rotation;
+PSI_mutex_key key_LOCK_load_data_pipeline;
 
 static PSI_mutex_info all_server_mutexes[]=
 {
@@ -990,7 +991,8 @@ static PSI_mutex_info all_server_mutexes[]=
   { &key_LOCK_parallel_entry, "LOCK_parallel_entry", 0},
   { &key_LOCK_ack_receiver, "Ack_receiver::mutex", 0},
   { &key_LOCK_rpl_semi_sync_master_enabled, "LOCK_rpl_semi_sync_master_enabled", 0},
-  { &key_LOCK_binlog, "LOCK_binlog", 0}
+  { &key_LOCK_binlog, "LOCK_binlog", 0},
+  { &key_LOCK_load_data_pipeline, "Load_data_pipeline::mutex", 0}
 };
 
 PSI_rwlock_key key_rwlock_LOCK_grant, key_rwlock_LOCK_logger,
@@ -1052,6 +1054,8 @@ PSI_cond_key key_COND_rpl_thread_queue, key_COND_rpl_thread,
   key_COND_prepare_ordered, key_COND_slave_background;
 PSI_cond_key key_COND_wait_gtid, key_COND_gtid_ignore_duplicates;
 PSI_cond_key key_COND_ack_receiver;
+PSI_cond_key key_COND_load_data_pipeline_work,
+  key_COND_load_data_pipeline_done;
 
 static PSI_cond_info all_server_conds[]=
 {
@@ -1101,14 +1105,18 @@ static PSI_cond_info all_server_conds[]=
   { &key_COND_gtid_ignore_duplicates, "COND_gtid_ignore_duplicates", 0},
   { &key_COND_ack_receiver, "Ack_receiver::cond", 0},
   { &key_COND_binlog_send, "COND_binlog_send", 0},
-  { &key_TABLE_SHARE_COND_rotation, "TABLE_SHARE::COND_rotation", 0}
+  { &key_TABLE_SHARE_COND_rotation, "TABLE_SHARE::COND_rotation", 0},
+  { &key_COND_load_data_pipeline_work, "Load_data_pipeline::work_cond", 0},
+  { &key_COND_load_data_pipeline_done, "Load_data_pipeline::done_cond", 0}
 };
 
 PSI_thread_key key_thread_delayed_insert,
   key_thread_handle_manager, key_thread_main,
   key_thread_one_connection, key_thread_signal_hand,
-  key_thread_slave_background, key_rpl_parallel_thread;
+  key_thread_slave_background, key_rpl_parallel_thread,
+  key_thread_tdc_load;
 PSI_thread_key key_thread_ack_receiver;
+PSI_thread_key key_thread_load_data_parser;
 
 static PSI_thread_info all_server_threads[]=
 {
@@ -1119,7 +1127,9 @@ static PSI_thread_info all_server_threads[]=
   { &key_thread_signal_hand, "signal_handler", PSI_FLAG_GLOBAL},
   { &key_thread_slave_background, "slave_background", PSI_FLAG_GLOBAL},
   { &key_thread_ack_receiver, "Ack_receiver", PSI_FLAG_GLOBAL},
-  { &key_rpl_parallel_thread, "rpl_parallel_thread", 0}
+  { &key_rpl_parallel_thread, "rpl_parallel_thread", 0},
+  { &key_thread_tdc_load, "tdc_load", 0},
+  { &key_thread_load_data_parser, "load_data_parser", 0}
 };
 
 #ifdef HAVE_MMAP
@@ -1974,6 +1984,8 @@ static void clean_up(bool print_message)
   item_func_sleep_free();
   lex_free();				/* Free some memory */
   item_create_cleanup();
+  if (tdc_dump_at_shutdown && !opt_bootstrap)
+    tdc_dump();
   tdc_start_shutdown();
 #ifdef HAVE_REPLICATION
   semi_sync_master_deinit();
@@ -5630,6 +5642,9 @@ int mysqld_main(int argc, char **argv)
     }
   }
 
+  if (tdc_load_at_startup)
+    tdc_load();
+
   start_handle_manager();
 
   /* Copy default global rpl_filter to global_rpl_filter */
@@ -7280,6 +7295,8 @@ SHOW_VAR status_vars[]= {
   */
   {"Subquery_cache_hit",       (char*) &subquery_cache_hit,     SHOW_LONG},
   {"Subquery_cache_miss",      (char*) &subquery_cache_miss,    SHOW_LONG},
+  {"Table_definition_cache_load_pending", (char*) &show_tdc_load_pending, SHOW_SIMPLE_FUNC},
+  {"Table_definition_cache_loaded", (char*) &show_tdc_loaded, SHOW_SIMPLE_FUNC},
   {"Table_locks_immediate",    (char*) &locks_immediate,        SHOW_LONG},
   {"Table_locks_waited",       (char*) &locks_waited,           SHOW_LONG},
   {"Table_open_cache_active_instances", (char*) &show_tc_active_instances, SHOW_SIMPLE_FUNC},
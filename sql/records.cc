@@ -525,6 +525,42 @@ int rr_sequential(READ_RECORD *info)
 }
 
 
+bool READ_RECORD::can_read_batch() const
+{
+  return (read_record_func == rr_sequential ||
+          read_record_func == rr_index) &&
+         (table->file->ha_table_flags() & HA_CAN_READ_BATCH) &&
+         !table->vfield && !table->s->blob_fields;
+}
+
+
+/**
+  Read up to max_rows records into buf, buf + stride, ... instead of
+  table->record[0].
+
+  @param[out] rows  number of records read, 0 unless 0 is returned
+
+  @retval
+    0   Ok
+  @retval
+    -1   End of records
+  @retval
+    1   Error
+*/
+
+int READ_RECORD::read_batch(uchar *buf, size_t stride, uint max_rows,
+                            uint *rows)
+{
+  DBUG_ASSERT(can_read_batch());
+  int tmp= read_record_func == rr_sequential ?
+    table->file->ha_rnd_next_batch(buf, stride, max_rows, rows) :
+    table->file->ha_index_next_batch(buf, stride, max_rows, rows);
+  if (tmp)
+    tmp= rr_handle_error(this, tmp);
+  return tmp;
+}
+
+
 static int rr_from_tempfile(READ_RECORD *info)
 {
   int tmp;
@@ -81,6 +81,14 @@ struct READ_RECORD
   int read_record() { return read_record_func(this); }
   uchar *record() const { return table->record[0]; }
 
+  /*
+    Table and index scans of engines with HA_CAN_READ_BATCH can read
+    several records at once into a caller's buffer, when the records
+    need no processing after they are read.
+  */
+  bool can_read_batch() const;
+  int read_batch(uchar *buf, size_t stride, uint max_rows, uint *rows);
+
   /* 
     SJ-Materialization runtime may need to read fields from the materialized
     table and unpack them into original table fields:
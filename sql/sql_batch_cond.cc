@@ -0,0 +1,453 @@
+/*
+   Copyright (c) 2021, MariaDB
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; version 2 of
+   the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301  USA
+*/
+
+#include "mariadb.h"
+#include "sql_batch_cond.h"
+#include "sql_time.h"
+
+/**
+  Catches any condition raised while constants are evaluated at compile
+  time. Such a constant (a truncated or invalid value) is left to the
+  regular evaluation, which reports it the usual way.
+*/
+
+class Batch_cond_error_handler :public Internal_error_handler
+{
+public:
+  bool raised;
+  Batch_cond_error_handler(): raised(false) {}
+  bool handle_condition(THD *thd,
+                        uint sql_errno,
+                        const char* sqlstate,
+                        Sql_condition::enum_warning_level *level,
+                        const char* msg,
+                        Sql_condition ** cond_hdl)
+  {
+    raised= true;
+    return true;
+  }
+};
+
+
+Batch_cond *Batch_cond::create(THD *thd, TABLE *table, Item *cond)
+{
+  if (cond->used_tables() & ~table->map)
+    return NULL;
+
+  Batch_cond *res= new (thd->mem_root) Batch_cond(table);
+  if (!res)
+    return NULL;
+
+  Batch_cond_error_handler handler;
+  thd->push_internal_handler(&handler);
+  bool failed= cond->add_to_batch_cond(thd, res);
+  thd->pop_internal_handler();
+
+  if (failed || handler.raised || !res->count)
+    return NULL;
+  return res;
+}
+
+
+Field *Batch_cond::table_field(Item *item) const
+{
+  item= item->real_item();
+  if (item->type() != Item::FIELD_ITEM)
+    return NULL;
+  Field *field= ((Item_field *) item)->field;
+  if (field->table != table ||
+      field->ptr < table->record[0] ||
+      field->ptr + field->pack_length() > table->record[0] + table->s->reclength)
+    return NULL;
+  return field;
+}
+
+
+Batch_cond::Predicate *Batch_cond::new_predicate(Field *field, cmp_op op)
+{
+  if (count == MAX_PREDICATES)
+    return NULL;
+  Predicate *pred= predicates + count;
+  pred->op= op;
+  pred->kind= KIND_SIGNED;
+  pred->offset= (uint) (field->ptr - table->record[0]);
+  pred->length= field->pack_length();
+  pred->null_offset= field->null_ptr ?
+                     (uint) (field->null_ptr - table->record[0]) : 0;
+  pred->null_bit= field->null_ptr ? field->null_bit : 0;
+  pred->value= 0;
+  return pred;
+}
+
+
+bool Batch_cond::add_null_check(Item *arg, bool is_null)
+{
+  Field *field= table_field(arg);
+  if (!field || !field->null_ptr)
+    return true;
+  if (!new_predicate(field, is_null ? OP_IS_NULL : OP_IS_NOT_NULL))
+    return true;
+  count++;
+  return false;
+}
+
+
+bool Batch_cond::add_comparison(THD *thd, Item_func::Functype functype,
+                                Item *left, Item *right,
+                                const Type_handler *cmp)
+{
+  cmp_op op;
+  switch (functype) {
+  case Item_func::EQ_FUNC: op= OP_EQ; break;
+  case Item_func::NE_FUNC: op= OP_NE; break;
+  case Item_func::LT_FUNC: op= OP_LT; break;
+  case Item_func::LE_FUNC: op= OP_LE; break;
+  case Item_func::GT_FUNC: op= OP_GT; break;
+  case Item_func::GE_FUNC: op= OP_GE; break;
+  default:
+    return true;
+  }
+
+  Field *field;
+  Item *value;
+  if ((field= table_field(left)))
+    value= right;
+  else if ((field= table_field(right)))
+  {
+    /* const <op> col  =>  col <swapped op> const */
+    static const cmp_op swapped[]= { OP_EQ, OP_NE, OP_GT, OP_GE, OP_LT, OP_LE };
+    value= left;
+    op= swapped[op];
+  }
+  else
+    return true;
+
+  if (!value->const_item() || value->is_expensive())
+    return true;
+
+  Predicate *pred;
+  if (!(pred= new_predicate(field, op)))
+    return true;
+
+  switch (field->real_type()) {
+  case MYSQL_TYPE_TINY:
+  case MYSQL_TYPE_SHORT:
+  case MYSQL_TYPE_INT24:
+  case MYSQL_TYPE_LONG:
+  case MYSQL_TYPE_LONGLONG:
+  {
+    if (cmp->cmp_type() != INT_RESULT)
+      return true;
+    longlong nr= value->val_int();
+    if (value->null_value)
+      return true;
+    /*
+      A constant outside of the range of the comparison type is left to
+      Arg_comparator, which knows how to compare mixed signedness.
+    */
+    if (field->flags & UNSIGNED_FLAG)
+    {
+      if (!value->unsigned_flag && nr < 0)
+        return true;
+      pred->kind= KIND_UNSIGNED;
+    }
+    else
+    {
+      if (value->unsigned_flag && nr < 0)
+        return true;
+      pred->kind= KIND_SIGNED;
+    }
+    pred->value= nr;
+    break;
+  }
+  case MYSQL_TYPE_NEWDATE:
+  {
+    if (cmp->cmp_type() != TIME_RESULT ||
+        cmp->mysql_timestamp_type() == MYSQL_TIMESTAMP_TIME ||
+        value->type_handler()->mysql_timestamp_type() == MYSQL_TIMESTAMP_TIME)
+      return true;
+    longlong packed= value->val_datetime_packed(thd);
+    if (value->null_value)
+      return true;
+    MYSQL_TIME ltime;
+    unpack_time(packed, &ltime, MYSQL_TIMESTAMP_DATETIME);
+    /* A DATE is never equal to a DATETIME with a time part */
+    if (ltime.neg || ltime.hour || ltime.minute || ltime.second ||
+        ltime.second_part)
+      return true;
+    /* Same layout as Field_newdate::store_TIME() */
+    pred->kind= KIND_UNSIGNED;
+    pred->value= ltime.day + ltime.month * 32 + ltime.year * 16 * 32;
+    break;
+  }
+  case MYSQL_TYPE_NEWDECIMAL:
+  {
+    if (cmp->cmp_type() != DECIMAL_RESULT)
+      return true;
+    my_decimal buf, *dec= value->val_decimal(&buf);
+    if (value->null_value || !dec)
+      return true;
+    Field_new_decimal *dec_field= (Field_new_decimal *) field;
+    if (dec->to_binary(pred->image, dec_field->precision, dec_field->dec,
+                       E_DEC_OK))
+      return true;
+    /* The binary image must represent the constant exactly */
+    my_decimal check(pred->image, dec_field->precision, dec_field->dec);
+    if (my_decimal_cmp(&check, dec))
+      return true;
+    pred->kind= KIND_BINARY;
+    break;
+  }
+  default:
+    return true;
+  }
+  count++;
+  return false;
+}
+
+
+inline bool Batch_cond::Predicate::eval(const uchar *record) const
+{
+  bool is_null= null_bit && (record[null_offset] & null_bit);
+  switch (op) {
+  case OP_IS_NULL:
+    return is_null;
+  case OP_IS_NOT_NULL:
+    return !is_null;
+  default:
+    break;
+  }
+  if (is_null)
+    return false;
+
+  const uchar *ptr= record + offset;
+  int cmp;
+  switch (kind) {
+  case KIND_SIGNED:
+  {
+    longlong nr;
+    switch (length) {
+    case 1: nr= (signed char) *ptr; break;
+    case 2: nr= sint2korr(ptr); break;
+    case 3: nr= sint3korr(ptr); break;
+    case 4: nr= sint4korr(ptr); break;
+    default: nr= sint8korr(ptr); break;
+    }
+    cmp= nr < value ? -1 : nr > value;
+    break;
+  }
+  case KIND_UNSIGNED:
+  {
+    ulonglong nr;
+    switch (length) {
+    case 1: nr= *ptr; break;
+    case 2: nr= uint2korr(ptr); break;
+    case 3: nr= uint3korr(ptr); break;
+    case 4: nr= uint4korr(ptr); break;
+    default: nr= uint8korr(ptr); break;
+    }
+    cmp= nr < (ulonglong) value ? -1 : nr > (ulonglong) value;
+    break;
+  }
+  default:
+    cmp= memcmp(ptr, image, length);
+    break;
+  }
+
+  switch (op) {
+  case OP_EQ: return cmp == 0;
+  case OP_NE: return cmp != 0;
+  case OP_LT: return cmp < 0;
+  case OP_LE: return cmp <= 0;
+  case OP_GT: return cmp > 0;
+  default:    return cmp >= 0;
+  }
+}
+
+
+bool Batch_cond::eval(const uchar *record) const
+{
+  for (const Predicate *pred= predicates; pred < predicates + count; pred++)
+    if (!pred->eval(record))
+      return false;
+  return true;
+}
+
+
+/*
+  Block evaluation. Column values of the selected records are first
+  gathered into a dense array, then compared with the constant in a loop
+  without branches, which the compiler turns into SIMD code. The result
+  is a byte mask used to compact the selection vector.
+*/
+
+static void gather_signed(longlong *to, const uchar *base, size_t stride,
+                          uint length, const uint16 *selection, uint n)
+{
+  switch (length) {
+  case 1:
+    for (uint i= 0; i < n; i++)
+      to[i]= (signed char) base[selection[i] * stride];
+    break;
+  case 2:
+    for (uint i= 0; i < n; i++)
+      to[i]= sint2korr(base + selection[i] * stride);
+    break;
+  case 3:
+    for (uint i= 0; i < n; i++)
+      to[i]= sint3korr(base + selection[i] * stride);
+    break;
+  case 4:
+    for (uint i= 0; i < n; i++)
+      to[i]= sint4korr(base + selection[i] * stride);
+    break;
+  default:
+    for (uint i= 0; i < n; i++)
+      to[i]= sint8korr(base + selection[i] * stride);
+    break;
+  }
+}
+
+
+static void gather_unsigned(ulonglong *to, const uchar *base, size_t stride,
+                            uint length, const uint16 *selection, uint n)
+{
+  switch (length) {
+  case 1:
+    for (uint i= 0; i < n; i++)
+      to[i]= base[selection[i] * stride];
+    break;
+  case 2:
+    for (uint i= 0; i < n; i++)
+      to[i]= uint2korr(base + selection[i] * stride);
+    break;
+  case 3:
+    for (uint i= 0; i < n; i++)
+      to[i]= uint3korr(base + selection[i] * stride);
+    break;
+  case 4:
+    for (uint i= 0; i < n; i++)
+      to[i]= uint4korr(base + selection[i] * stride);
+    break;
+  default:
+    for (uint i= 0; i < n; i++)
+      to[i]= uint8korr(base + selection[i] * stride);
+    break;
+  }
+}
+
+
+template <typename T>
+static void compare_block(Batch_cond::cmp_op op, const T *values, T value,
+                          uchar *keep, uint n)
+{
+  switch (op) {
+  case Batch_cond::OP_EQ:
+    for (uint i= 0; i < n; i++) keep[i]&= values[i] == value;
+    break;
+  case Batch_cond::OP_NE:
+    for (uint i= 0; i < n; i++) keep[i]&= values[i] != value;
+    break;
+  case Batch_cond::OP_LT:
+    for (uint i= 0; i < n; i++) keep[i]&= values[i] < value;
+    break;
+  case Batch_cond::OP_LE:
+    for (uint i= 0; i < n; i++) keep[i]&= values[i] <= value;
+    break;
+  case Batch_cond::OP_GT:
+    for (uint i= 0; i < n; i++) keep[i]&= values[i] > value;
+    break;
+  default:
+    for (uint i= 0; i < n; i++) keep[i]&= values[i] >= value;
+    break;
+  }
+}
+
+
+uint Batch_cond::Predicate::filter(const uchar *records, size_t stride,
+                                   uint16 *selection, uint n) const
+{
+  uchar keep[MAX_BATCH];
+
+  if (null_bit)
+  {
+    const uchar *base= records + null_offset;
+    bool want_null= op == OP_IS_NULL;
+    for (uint i= 0; i < n; i++)
+      keep[i]= ((base[selection[i] * stride] & null_bit) != 0) == want_null;
+  }
+  else
+    memset(keep, op != OP_IS_NULL, n);
+
+  switch (op) {
+  case OP_IS_NULL:
+  case OP_IS_NOT_NULL:
+    break;
+  default:
+    /* NULL values are compared too, keep[] already rejects them */
+    switch (kind) {
+    case KIND_SIGNED:
+    {
+      longlong values[MAX_BATCH];
+      gather_signed(values, records + offset, stride, length, selection, n);
+      compare_block(op, values, value, keep, n);
+      break;
+    }
+    case KIND_UNSIGNED:
+    {
+      ulonglong values[MAX_BATCH];
+      gather_unsigned(values, records + offset, stride, length, selection, n);
+      compare_block(op, values, (ulonglong) value, keep, n);
+      break;
+    }
+    default:
+    {
+      int values[MAX_BATCH];
+      for (uint i= 0; i < n; i++)
+      {
+        int cmp= memcmp(records + selection[i] * stride + offset, image,
+                        length);
+        values[i]= (cmp > 0) - (cmp < 0);
+      }
+      compare_block(op, values, 0, keep, n);
+      break;
+    }
+    }
+  }
+
+  uint selected= 0;
+  for (uint i= 0; i < n; i++)
+  {
+    selection[selected]= selection[i];
+    selected+= keep[i];
+  }
+  return selected;
+}
+
+
+uint Batch_cond::eval_batch(const uchar *records, size_t stride, uint n,
+                            uint16 *selection) const
+{
+  DBUG_ASSERT(n <= MAX_BATCH);
+  for (uint i= 0; i < n; i++)
+    selection[i]= (uint16) i;
+  for (const Predicate *pred= predicates; n && pred < predicates + count;
+       pred++)
+    n= pred->filter(records, stride, selection, n);
+  return n;
+}
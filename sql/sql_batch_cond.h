@@ -0,0 +1,121 @@
+#ifndef SQL_BATCH_COND_INCLUDED
+#define SQL_BATCH_COND_INCLUDED
+/*
+   Copyright (c) 2021, MariaDB
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; version 2 of
+   the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301  USA
+*/
+
+/**
+  @file
+
+  Compiled evaluation of simple table conditions.
+
+  A condition attached to a table that is a conjunction of comparisons of
+  the table's fixed-width columns (integers, DATE, DECIMAL) with constants
+  is compiled into a flat array of predicates that are evaluated directly
+  on the record images, without walking the Item tree:
+
+    cond:    <pred> [AND <pred> ...]
+    pred:    col {=|<>|<|<=|>|>=} const | const {=|<>|<|<=|>|>=} col |
+             col BETWEEN const AND const | col IS [NOT] NULL
+
+  Besides single record evaluation, a block of records can be filtered at
+  once, producing a selection vector of the qualifying records. Every
+  predicate is then applied to the whole block in tight loops over
+  gathered column values that the compiler can vectorize.
+
+  Items take part in the compilation through
+  Item::add_to_batch_cond(); anything that does not support it makes the
+  whole condition fall back to Item::val_int().
+*/
+
+#include "sql_class.h"
+
+class Batch_cond :public Sql_alloc
+{
+public:
+  /** Largest number of records eval_batch() can filter at once */
+  static const uint MAX_BATCH= 1024;
+  static const uint MAX_PREDICATES= 16;
+
+  enum cmp_op
+  {
+    OP_EQ, OP_NE, OP_LT, OP_LE, OP_GT, OP_GE, OP_IS_NULL, OP_IS_NOT_NULL
+  };
+
+  /**
+    Compile a condition over a single table.
+    @return the compiled condition, or NULL if cond is not supported
+  */
+  static Batch_cond *create(THD *thd, TABLE *table, Item *cond);
+
+  /* Interface for Item::add_to_batch_cond() */
+  bool add_comparison(THD *thd, Item_func::Functype op,
+                      Item *left, Item *right, const Type_handler *cmp);
+  bool add_null_check(Item *arg, bool is_null);
+
+  /** Evaluate the condition on one record image */
+  bool eval(const uchar *record) const;
+
+  /**
+    Filter a block of records.
+
+    @param records  first record image
+    @param stride   distance between record images
+    @param n        number of records, at most MAX_BATCH
+    @param[out] selection  numbers of the qualifying records, ascending
+
+    @return number of qualifying records
+  */
+  uint eval_batch(const uchar *records, size_t stride, uint n,
+                  uint16 *selection) const;
+
+  uint predicate_count() const { return count; }
+
+private:
+  enum value_kind
+  {
+    KIND_SIGNED,      // sign-extended little-endian integer
+    KIND_UNSIGNED,    // zero-extended little-endian integer, also DATE
+    KIND_BINARY       // memcmp-comparable image, DECIMAL
+  };
+
+  struct Predicate
+  {
+    cmp_op op;
+    value_kind kind;
+    uint offset;                      // field offset in the record
+    uint length;                      // field image length
+    uint null_offset;
+    uchar null_bit;                   // 0 for NOT NULL fields
+    longlong value;                   // KIND_SIGNED / KIND_UNSIGNED
+    uchar image[DECIMAL_MAX_FIELD_SIZE]; // KIND_BINARY
+
+    inline bool eval(const uchar *record) const;
+    uint filter(const uchar *records, size_t stride,
+                uint16 *selection, uint n) const;
+  };
+
+  explicit Batch_cond(TABLE *table_arg): table(table_arg), count(0) {}
+  Predicate *new_predicate(Field *field, cmp_op op);
+  Field *table_field(Item *item) const;
+
+  TABLE *table;
+  Predicate predicates[MAX_PREDICATES];
+  uint count;
+};
+
+#endif /* SQL_BATCH_COND_INCLUDED */
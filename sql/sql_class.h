@@ -734,6 +734,9 @@ typedef struct system_variables
   uint64     gtid_seq_no;
 
   uint group_concat_max_len;
+  uint approx_count_distinct_precision;
+  uint load_data_parser_threads;
+  uint partition_prefetch_threads;
 
   /**
     Default transaction access mode. READ ONLY (true) or READ WRITE (false).
@@ -0,0 +1,326 @@
+/*
+   Copyright (c) 2021, MariaDB
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; version 2 of
+   the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301  USA
+*/
+
+#include "mariadb.h"
+#include "sql_group_spill.h"
+#include "key.h"
+
+#define INITIAL_CAPACITY 1024
+
+
+bool Group_spill::is_applicable(JOIN *join, JOIN_TAB *tab)
+{
+  TABLE_SHARE *share= tab->table->s;
+
+  if (share->db_type() != heap_hton || share->blob_fields ||
+      share->keys != 1 || share->uniques)
+    return FALSE;
+  if (join->sum_funcs)
+  {
+    for (Item_sum **func= join->sum_funcs; *func; func++)
+      if (!(*func)->supports_field_merge())
+        return FALSE;
+  }
+  return TRUE;
+}
+
+
+Group_spill::Group_spill(JOIN *join_arg, JOIN_TAB *tab)
+  :join(join_arg), join_tab(tab), table(tab->table),
+   key_info(tab->table->key_info),
+   key_length(tab->table->key_info->key_length),
+   reclength(tab->table->s->reclength),
+   levels(NULL), key_buff(NULL), row_buff(NULL), slots(NULL),
+   capacity(0), used(0), spilled(0), written(0)
+{
+  THD *thd= join->thd;
+  memory_limit= MY_MIN(thd->variables.tmp_memory_table_size,
+                       thd->variables.max_heap_table_size);
+  init_alloc_root(PSI_INSTRUMENT_ME, &mem_root, 64 * 1024, 0,
+                  MYF(MY_THREAD_SPECIFIC));
+}
+
+
+bool Group_spill::init()
+{
+  if (!(levels= (Partition (*)[PARTITIONS])
+        my_malloc(PSI_INSTRUMENT_ME, sizeof(*levels) * MAX_LEVELS,
+                  MYF(MY_WME | MY_ZEROFILL | MY_THREAD_SPECIFIC))) ||
+      !(key_buff= (uchar*) my_malloc(PSI_INSTRUMENT_ME,
+                                     key_length + reclength,
+                                     MYF(MY_WME | MY_THREAD_SPECIFIC))) ||
+      !(slots= (Slot*) my_malloc(PSI_INSTRUMENT_ME,
+                                 INITIAL_CAPACITY * sizeof(Slot),
+                                 MYF(MY_WME | MY_ZEROFILL |
+                                     MY_THREAD_SPECIFIC))))
+    return TRUE;
+  row_buff= key_buff + key_length;
+  capacity= INITIAL_CAPACITY;
+  return FALSE;
+}
+
+
+Group_spill::~Group_spill()
+{
+  if (levels)
+  {
+    for (uint level= 0; level < MAX_LEVELS; level++)
+      for (uint i= 0; i < PARTITIONS; i++)
+        close_cached_file(&levels[level][i].file);
+    my_free(levels);
+  }
+  my_free(key_buff);
+  my_free(slots);
+  free_root(&mem_root, MYF(0));
+}
+
+
+/**
+  Put the group key of a record into key_buff.
+  @return hash value of the key
+*/
+
+ulong Group_spill::make_key(const uchar *record)
+{
+  key_copy(key_buff, record, key_info, key_length);
+  return key_hashnr(key_info, key_info->user_defined_key_parts, key_buff);
+}
+
+
+bool Group_spill::write_to(Partition *part, const uchar *record)
+{
+  if (!my_b_inited(&part->file) &&
+      open_cached_file(&part->file, mysql_tmpdir, TEMP_PREFIX,
+                       DISK_BUFFER_SIZE, MYF(MY_WME)))
+    return TRUE;
+  if (my_b_write(&part->file, record, reclength))
+    return TRUE;
+  part->records++;
+  return FALSE;
+}
+
+
+bool Group_spill::add()
+{
+  ulong hash= make_key(table->record[0]);
+  spilled++;
+  return write_to(&levels[0][partition_of(hash, 0)], table->record[0]);
+}
+
+
+/**
+  Find the slot of the group with the key in key_buff, or the empty slot
+  where it is to be inserted.
+*/
+
+Group_spill::Slot *Group_spill::find_slot(ulong hash)
+{
+  size_t mask= capacity - 1;
+  /*
+    The low bits of the hash are the same for all groups of a partition,
+    multiplication spreads the others over the slot number.
+  */
+  size_t i= (size_t) (((ulonglong) hash * 0x9E3779B97F4A7C15ULL) >> 32) & mask;
+
+  for (;; i= (i + 1) & mask)
+  {
+    Slot *slot= slots + i;
+    if (!slot->group ||
+        (slot->hash == hash &&
+         !key_buf_cmp(key_info, key_info->user_defined_key_parts,
+                      slot->group, key_buff)))
+      return slot;
+  }
+}
+
+
+bool Group_spill::grow()
+{
+  size_t new_capacity= capacity * 2, mask= new_capacity - 1;
+  Slot *new_slots;
+
+  if (!(new_slots= (Slot*) my_malloc(PSI_INSTRUMENT_ME,
+                                     new_capacity * sizeof(Slot),
+                                     MYF(MY_WME | MY_ZEROFILL |
+                                         MY_THREAD_SPECIFIC))))
+    return TRUE;
+  for (Slot *slot= slots; slot < slots + capacity; slot++)
+  {
+    if (!slot->group)
+      continue;
+    size_t i= (size_t) (((ulonglong) slot->hash *
+                         0x9E3779B97F4A7C15ULL) >> 32) & mask;
+    while (new_slots[i].group)
+      i= (i + 1) & mask;
+    new_slots[i]= *slot;
+  }
+  my_free(slots);
+  slots= new_slots;
+  capacity= new_capacity;
+  return FALSE;
+}
+
+
+bool Group_spill::insert_group(ulong hash, const uchar *record)
+{
+  uchar *group;
+
+  if ((used + 1) * 2 > capacity && grow())
+    return TRUE;
+  if (!(group= (uchar*) alloc_root(&mem_root, key_length + reclength)))
+    return TRUE;
+  memcpy(group, key_buff, key_length);
+  memcpy(group + key_length, record, reclength);
+
+  Slot *slot= find_slot(hash);
+  DBUG_ASSERT(!slot->group);
+  slot->hash= hash;
+  slot->group= group;
+  used++;
+  return FALSE;
+}
+
+
+/**
+  Merge the partial group in record into the group record in memory.
+  The aggregate functions merge in table->record[0].
+*/
+
+void Group_spill::merge_into(uchar *group_record, const uchar *record)
+{
+  my_ptrdiff_t diff= record - table->record[0];
+
+  memcpy(table->record[0], group_record, reclength);
+  if (join->sum_funcs)
+  {
+    for (Item_sum **func= join->sum_funcs; *func; func++)
+      (*func)->merge_field(diff);
+  }
+  memcpy(group_record, table->record[0], reclength);
+}
+
+
+/**
+  Append the group in table->record[0] to the temporary table, converting
+  it to a disk table when it is full.
+*/
+
+bool Group_spill::write_group()
+{
+  TMP_TABLE_PARAM *param= join_tab->tmp_table_param;
+  int error;
+
+  if (likely(!(error= table->file->ha_write_tmp_row(table->record[0]))))
+  {
+    written++;
+    return FALSE;
+  }
+  if (create_internal_tmp_table_from_heap(join->thd, table,
+                                          param->start_recinfo,
+                                          &param->recinfo, error, 0, NULL))
+    return TRUE;
+  written++;
+  if (unlikely((error= table->file->ha_index_init(0, 0))))
+  {
+    table->file->print_error(error, MYF(0));
+    return TRUE;
+  }
+  return FALSE;
+}
+
+
+/**
+  Aggregate the rows of one partition and write its groups.
+
+  Groups are kept in memory until memory_limit is reached; the rows of
+  other groups are distributed to the partitions of the next level, which
+  are processed after the groups in memory have been written.
+*/
+
+bool Group_spill::process(Partition *part, uint level)
+{
+  Partition *children= level + 1 < MAX_LEVELS ? levels[level + 1] : NULL;
+  bool overflow= FALSE;
+  THD *thd= join->thd;
+
+  if (reinit_io_cache(&part->file, READ_CACHE, 0L, 0, 0))
+    return TRUE;
+  free_root(&mem_root, MYF(MY_MARK_BLOCKS_FREE));
+  bzero(slots, capacity * sizeof(Slot));
+  used= 0;
+
+  for (ha_rows i= 0; i < part->records; i++)
+  {
+    if (my_b_read(&part->file, row_buff, reclength) ||
+        unlikely(thd->check_killed()))
+      return TRUE;
+    ulong hash= make_key(row_buff);
+    Slot *slot= find_slot(hash);
+    if (slot->group)
+      merge_into(slot->group + key_length, row_buff);
+    else if (!children || (!overflow && !over_limit()))
+    {
+      if (insert_group(hash, row_buff))
+        return TRUE;
+    }
+    else
+    {
+      /* Groups that were not in memory by now are never added to it */
+      overflow= TRUE;
+      if (write_to(&children[partition_of(hash, level + 1)], row_buff))
+        return TRUE;
+    }
+  }
+
+  for (Slot *slot= slots; slot < slots + capacity; slot++)
+  {
+    if (!slot->group)
+      continue;
+    memcpy(table->record[0], slot->group + key_length, reclength);
+    if (write_group())
+      return TRUE;
+  }
+
+  /* The file is reused for the next partition of this level */
+  part->records= 0;
+  if (reinit_io_cache(&part->file, WRITE_CACHE, 0L, 0, 0))
+    return TRUE;
+
+  if (overflow)
+  {
+    for (uint i= 0; i < PARTITIONS; i++)
+      if (children[i].records && process(&children[i], level + 1))
+        return TRUE;
+  }
+  return FALSE;
+}
+
+
+bool Group_spill::finish(ha_rows *groups)
+{
+  DBUG_ENTER("Group_spill::finish");
+  DBUG_PRINT("info", ("spilled rows: %llu", (ulonglong) spilled));
+  written= 0;
+  for (uint i= 0; i < PARTITIONS; i++)
+  {
+    if (levels[0][i].records && process(&levels[0][i], 0))
+      DBUG_RETURN(TRUE);
+  }
+  *groups= written;
+  DBUG_RETURN(FALSE);
+}
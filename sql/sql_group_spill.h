@@ -0,0 +1,133 @@
+#ifndef SQL_GROUP_SPILL_INCLUDED
+#define SQL_GROUP_SPILL_INCLUDED
+/*
+   Copyright (c) 2021, MariaDB
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; version 2 of
+   the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301  USA
+*/
+
+/**
+  @file
+
+  Spilling of GROUP BY groups that do not fit into the in-memory
+  temporary table.
+
+  end_update() aggregates the rows into a HEAP table that is indexed on the
+  group columns. When the table is full and all aggregate functions can
+  merge partial results (Item_sum::supports_field_merge()), the table is
+  not converted to a disk table. Instead every row of a group that is not
+  in the HEAP table is turned into a one-row partial group and appended to
+  one of PARTITIONS files, selected by the hash of the group key. The
+  groups already in the HEAP table keep being updated in place.
+
+  At the end of the input each file is aggregated separately in an
+  in-memory open-addressing hash table. If the groups of a file do not fit
+  into tmp_memory_table_size, the rows of the groups that are not in memory
+  are partitioned again by the next bits of the hash and processed after
+  the groups in memory are complete. Every group ends up in exactly one
+  partition, so the finished groups are simply appended to the temporary
+  table, which is converted to a disk table once it is full.
+*/
+
+#include "sql_select.h"
+
+class Group_spill :public Sql_alloc
+{
+public:
+  static const uint PARTITION_BITS= 4;
+  static const uint PARTITIONS= 1 << PARTITION_BITS;
+  /**
+    Number of times a partition can be split. A partition at the last
+    level is aggregated in memory regardless of its size: its groups share
+    PARTITION_BITS * MAX_LEVELS bits of the hash.
+  */
+  static const uint MAX_LEVELS= 4;
+
+  /** Whether the groups of tab->table can be spilled */
+  static bool is_applicable(JOIN *join, JOIN_TAB *tab);
+
+  Group_spill(JOIN *join_arg, JOIN_TAB *tab);
+  ~Group_spill();
+  /** @return TRUE on out of memory */
+  bool init();
+
+  /** Append the partial group in table->record[0] to its partition */
+  bool add();
+
+  /**
+    Aggregate the spilled rows and write the groups to the temporary table.
+
+    @param[out] groups  number of groups written
+
+    @return TRUE on error, which has been reported
+  */
+  bool finish(ha_rows *groups);
+
+  ha_rows spilled_rows() const { return spilled; }
+
+private:
+  struct Partition
+  {
+    IO_CACHE file;
+    ha_rows records;
+  };
+
+  /* An entry of the in-memory hash table */
+  struct Slot
+  {
+    ulong hash;
+    uchar *group;                       // key image followed by the record
+  };
+
+  uint partition_of(ulong hash, uint level) const
+  {
+    return (uint) (hash >> (level * PARTITION_BITS)) & (PARTITIONS - 1);
+  }
+  ulong make_key(const uchar *record);
+  bool write_to(Partition *part, const uchar *record);
+  bool process(Partition *part, uint level);
+  Slot *find_slot(ulong hash);
+  bool insert_group(ulong hash, const uchar *record);
+  bool grow();
+  bool over_limit() const
+  {
+    return used * (key_length + reclength + 2 * sizeof(Slot)) > memory_limit;
+  }
+  void merge_into(uchar *group_record, const uchar *record);
+  bool write_group();
+
+  JOIN *join;
+  JOIN_TAB *join_tab;
+  TABLE *table;
+  KEY *key_info;
+  uint key_length;
+  uint reclength;
+  ulonglong memory_limit;
+
+  /*
+    The partitions being written at each level. The processing is depth
+    first, so one set of partitions per level is enough.
+  */
+  Partition (*levels)[PARTITIONS];
+  uchar *key_buff;
+  uchar *row_buff;
+
+  MEM_ROOT mem_root;                    // groups of the current partition
+  Slot *slots;
+  size_t capacity, used;
+  ha_rows spilled, written;
+};
+
+#endif /* SQL_GROUP_SPILL_INCLUDED */
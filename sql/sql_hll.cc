@@ -0,0 +1,225 @@
+/*
+   Copyright (c) 2021, MariaDB
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; version 2 of
+   the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301  USA
+*/
+
+#include "mariadb.h"
+#include "sql_hll.h"
+#include <math.h>
+
+bool Hyperloglog::init(MEM_ROOT *root, uint precision)
+{
+  DBUG_ASSERT(precision >= MIN_PRECISION && precision <= MAX_PRECISION);
+  m_precision= m_max_precision= precision;
+  if (!(m_registers= (uchar *) alloc_root(root, register_count())))
+    return true;
+  clear();
+  return false;
+}
+
+
+ulonglong Hyperloglog::hash_bytes(const uchar *data, size_t length)
+{
+  ulonglong h= 0x9e3779b97f4a7c15ULL ^ length;
+  for (; length >= 8; data+= 8, length-= 8)
+    h= mix(h ^ uint8korr(data));
+  if (length)
+  {
+    ulonglong tail= 0;
+    for (uint i= 0; i < length; i++)
+      tail|= (ulonglong) data[i] << (i * 8);
+    h= mix(h ^ tail);
+  }
+  return mix(h ^ 0x2545f4914f6cdd1dULL);
+}
+
+
+/**
+  Put a register value of a sketch of the given precision into this sketch,
+  folding it down if the precision is higher than ours.
+*/
+
+void Hyperloglog::merge_register(uint precision, uint idx, uchar value)
+{
+  DBUG_ASSERT(precision >= m_precision);
+  if (!value)
+    return;
+  if (uint shift= precision - m_precision)
+  {
+    /*
+      The low <shift> bits of the register number become the leading bits
+      of the rank in the coarser sketch.
+    */
+    uint low= idx & ((1U << shift) - 1);
+    idx>>= shift;
+    value= low ? (uchar) (shift - my_bit_log2_uint32(low))
+               : (uchar) (value + shift);
+  }
+  if (m_registers[idx] < value)
+    m_registers[idx]= value;
+}
+
+
+void Hyperloglog::reduce_precision(uint precision)
+{
+  DBUG_ASSERT(precision < m_precision);
+  uint shift= m_precision - precision;
+  size_t count= (size_t) 1 << precision;
+  /*
+    Register i of the coarse sketch is built from registers
+    [i << shift, (i + 1) << shift) of the current one, so it can be
+    written in place once those have been read.
+  */
+  for (size_t i= 0; i < count; i++)
+  {
+    uchar max_value= 0;
+    for (uint low= 0; low < (1U << shift); low++)
+    {
+      uchar value= m_registers[(i << shift) | low];
+      if (!value)
+        continue;
+      value= low ? (uchar) (shift - my_bit_log2_uint32(low))
+                 : (uchar) (value + shift);
+      set_if_bigger(max_value, value);
+    }
+    m_registers[i]= max_value;
+  }
+  m_precision= precision;
+}
+
+
+bool Hyperloglog::merge(const uchar *sketch, size_t length)
+{
+  if (length < HEADER_SIZE)
+    return true;
+  uint precision= sketch[1];
+  if (precision < MIN_PRECISION || precision > MAX_PRECISION)
+    return true;
+  uchar max_value= (uchar) (64 - precision + 1);
+  size_t count= (size_t) 1 << precision;
+  const uchar *data= sketch + HEADER_SIZE;
+  length-= HEADER_SIZE;
+
+  switch (sketch[0]) {
+  case HLL_FORMAT_DENSE:
+    if (length != count)
+      return true;
+    for (size_t i= 0; i < count; i++)
+      if (data[i] > max_value)
+        return true;
+    break;
+  case HLL_FORMAT_SPARSE:
+    if (length % 4)
+      return true;
+    for (size_t i= 0; i < length; i+= 4)
+    {
+      uint32 entry= uint4korr(data + i);
+      if ((entry >> 8) >= count || (entry & 0xff) > max_value)
+        return true;
+    }
+    break;
+  default:
+    return true;
+  }
+
+  if (precision < m_precision)
+    reduce_precision(precision);
+
+  if (sketch[0] == HLL_FORMAT_DENSE)
+  {
+    for (size_t i= 0; i < count; i++)
+      merge_register(precision, (uint) i, data[i]);
+  }
+  else
+  {
+    for (size_t i= 0; i < length; i+= 4)
+    {
+      uint32 entry= uint4korr(data + i);
+      merge_register(precision, entry >> 8, (uchar) (entry & 0xff));
+    }
+  }
+  return false;
+}
+
+
+ulonglong Hyperloglog::estimate() const
+{
+  size_t count= register_count();
+  size_t zeros= 0;
+  double sum= 0;
+  for (size_t i= 0; i < count; i++)
+  {
+    sum+= ldexp(1.0, -(int) m_registers[i]);
+    zeros+= !m_registers[i];
+  }
+
+  double m= (double) count;
+  double alpha;
+  switch (count) {
+  case 16: alpha= 0.673; break;
+  case 32: alpha= 0.697; break;
+  case 64: alpha= 0.709; break;
+  default: alpha= 0.7213 / (1.0 + 1.079 / m);
+  }
+  double raw= alpha * m * m / sum;
+
+  /*
+    The raw estimate is strongly biased for small cardinalities, where
+    linear counting over the empty registers is more accurate.
+  */
+  if (raw <= 2.5 * m && zeros)
+    return (ulonglong) (m * log(m / (double) zeros) + 0.5);
+  return (ulonglong) (raw + 0.5);
+}
+
+
+size_t Hyperloglog::nonzero_registers() const
+{
+  size_t count= register_count(), nonzero= 0;
+  for (size_t i= 0; i < count; i++)
+    nonzero+= m_registers[i] != 0;
+  return nonzero;
+}
+
+
+size_t Hyperloglog::serialized_length() const
+{
+  return HEADER_SIZE + MY_MIN(register_count(), nonzero_registers() * 4);
+}
+
+
+size_t Hyperloglog::serialize(uchar *to) const
+{
+  size_t count= register_count();
+  to[1]= (uchar) m_precision;
+  if (nonzero_registers() * 4 < count)
+  {
+    uchar *pos= to + HEADER_SIZE;
+    to[0]= HLL_FORMAT_SPARSE;
+    for (size_t i= 0; i < count; i++)
+    {
+      if (m_registers[i])
+      {
+        int4store(pos, (uint32) (i << 8 | m_registers[i]));
+        pos+= 4;
+      }
+    }
+    return (size_t) (pos - to);
+  }
+  to[0]= HLL_FORMAT_DENSE;
+  memcpy(to + HEADER_SIZE, m_registers, count);
+  return HEADER_SIZE + count;
+}
@@ -0,0 +1,142 @@
+#ifndef SQL_HLL_INCLUDED
+#define SQL_HLL_INCLUDED
+/*
+   Copyright (c) 2021, MariaDB
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; version 2 of
+   the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301  USA
+*/
+
+#include "my_global.h"
+#include "my_sys.h"
+#include "my_bit.h"
+
+/**
+  HyperLogLog cardinality sketch (HLL++ flavour).
+
+  The sketch keeps 2^precision one-byte registers. Every added value is
+  represented by a 64-bit hash: the top <precision> bits select a register,
+  and the register remembers the longest run of leading zeros (plus one)
+  seen in the remaining bits.
+
+  Differences from the original HyperLogLog, following HLL++:
+  - 64-bit hashes, so no large range correction is needed;
+  - linear counting is used for small cardinalities, where the raw
+    estimate is biased (the empirical bias tables of HLL++ are not used);
+  - small sketches are serialized in a sparse form.
+
+  Sketches are mergeable. Merging two sketches of different precision
+  produces a sketch with the lower of the two precisions.
+
+  Serialized format (all integers little-endian):
+
+    byte  0       format: HLL_FORMAT_DENSE or HLL_FORMAT_SPARSE
+    byte  1       precision
+    dense:        2^precision register bytes
+    sparse:       a sequence of 4-byte entries (register << 8 | value),
+                  ordered by register number, one for every non-empty
+                  register
+*/
+
+class Hyperloglog
+{
+public:
+  static const uint MIN_PRECISION= 4;
+  static const uint MAX_PRECISION= 18;
+  static const uint DEFAULT_PRECISION= 14;
+
+  static const uchar HLL_FORMAT_DENSE= 1;
+  static const uchar HLL_FORMAT_SPARSE= 2;
+  static const size_t HEADER_SIZE= 2;
+
+  Hyperloglog(): m_registers(NULL), m_precision(0), m_max_precision(0) {}
+
+  /**
+    Allocate the registers on the given MEM_ROOT.
+    @retval true  out of memory
+  */
+  bool init(MEM_ROOT *root, uint precision);
+  bool is_inited() const { return m_registers != NULL; }
+
+  /** Forget all added values, restoring the configured precision */
+  void clear()
+  {
+    m_precision= m_max_precision;
+    bzero(m_registers, register_count());
+  }
+
+  void add_hash(ulonglong hash)
+  {
+    uint idx= (uint) (hash >> (64 - m_precision));
+    /*
+      The sentinel bit bounds the rank by (64 - precision + 1) when all
+      remaining bits are zero.
+    */
+    ulonglong rest= (hash << m_precision) | (1ULL << (m_precision - 1));
+    uchar rank= (uchar) (leading_zeros(rest) + 1);
+    if (m_registers[idx] < rank)
+      m_registers[idx]= rank;
+  }
+
+  /**
+    Merge a serialized sketch into this one.
+    @retval true  the argument is not a valid serialized sketch
+  */
+  bool merge(const uchar *sketch, size_t length);
+
+  /** Estimated number of distinct hashes added */
+  ulonglong estimate() const;
+
+  /** Upper bound of serialized_length() for the given precision */
+  static size_t max_serialized_length(uint precision)
+  { return HEADER_SIZE + ((size_t) 1 << precision); }
+  size_t serialized_length() const;
+  /**
+    Write the sketch to the buffer.
+    @param to  at least serialized_length() bytes
+    @return number of bytes written
+  */
+  size_t serialize(uchar *to) const;
+
+  uint precision() const { return m_precision; }
+  size_t register_count() const { return (size_t) 1 << m_precision; }
+
+  /** Finalizer of MurmurHash3, used to spread value hashes over 64 bits */
+  static ulonglong mix(ulonglong h)
+  {
+    h^= h >> 33;
+    h*= 0xff51afd7ed558ccdULL;
+    h^= h >> 33;
+    h*= 0xc4ceb9fe1a85ec53ULL;
+    h^= h >> 33;
+    return h;
+  }
+  static ulonglong hash_bytes(const uchar *data, size_t length);
+
+private:
+  static uint leading_zeros(ulonglong value)
+  {
+    DBUG_ASSERT(value);
+    return 63 - my_bit_log2_uint64(value);
+  }
+  size_t nonzero_registers() const;
+  void reduce_precision(uint precision);
+  void merge_register(uint precision, uint idx, uchar value);
+
+  uchar *m_registers;
+  uint m_precision;
+  uint m_max_precision;
+};
+
+#endif /* SQL_HLL_INCLUDED */
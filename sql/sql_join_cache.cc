@@ -32,6 +32,7 @@
 #include "sql_base.h"
 #include "sql_select.h"
 #include "opt_subselect.h"
+#include "sql_batch_cond.h"
 
 #define NO_MORE_RECORDS_IN_BUFFER  (uint)(-1)
 
@@ -3352,10 +3353,149 @@ uint JOIN_CACHE_HASHED::get_next_key(uchar ** key)
 
 int JOIN_TAB_SCAN::open()
 {
+  int err;
   save_or_restore_used_tabs(join_tab, FALSE);
   is_first_record= TRUE;
   join_tab->tracker->r_scans++;
-  return join_init_read_record(join_tab);
+  if ((err= join_init_read_record(join_tab)))
+    return err;
+  batch_selected= batch_pos= 0;
+  batch_error= 0;
+  use_batch= FALSE;
+  if (join_tab->read_record.can_read_batch())
+  {
+    if (!batch_buff && init_batch())
+      return 1;
+    use_batch= batch_size > 0;
+  }
+  return 0;
+}
+
+
+/*
+  Allocate the buffer for batches of records of join_tab
+
+  DESCRIPTION
+    The buffer takes about 64K, but not more than Batch_cond::MAX_BATCH
+    records. Tables with records so long that less than 16 records fit
+    into it are not read in batches.
+
+  RETURN VALUE
+    TRUE   out of memory
+    FALSE  otherwise, batch_size is 0 if batches cannot be used
+*/
+
+bool JOIN_TAB_SCAN::init_batch()
+{
+  TABLE *table= join_tab->table;
+  size_t size;
+
+  batch_stride= table->s->rec_buff_length;
+  batch_size= (uint) MY_MIN(Batch_cond::MAX_BATCH, 65536 / batch_stride);
+  if (batch_size < 16)
+  {
+    batch_size= 0;
+    return FALSE;
+  }
+  size= batch_stride * batch_size;
+  if (!(batch_buff= (uchar*) join->thd->alloc(size)) ||
+      !(batch_selection= (uint16*) join->thd->alloc(batch_size *
+                                                    sizeof(uint16))))
+  {
+    batch_size= 0;
+    return TRUE;
+  }
+  /* Columns that the engine does not read keep their default values */
+  for (uchar *rec= batch_buff; rec < batch_buff + size; rec+= batch_stride)
+    memcpy(rec, table->s->default_values, table->s->reclength);
+  return FALSE;
+}
+
+
+/*
+  Read the next batch of records of join_tab and select those of them that
+  can match
+
+  RETURN VALUE
+    0            some records have been read
+    -1           end of records
+    1            an error occurred
+*/
+
+int JOIN_TAB_SCAN::read_batch()
+{
+  READ_RECORD *info= &join_tab->read_record;
+  SQL_SELECT *select= join_tab->cache_select;
+  uint rows, n_rows= 0;
+
+  batch_selected= batch_pos= 0;
+  do
+  {
+    batch_error= info->read_batch(batch_buff + n_rows * batch_stride,
+                                  batch_stride, batch_size - n_rows, &rows);
+    n_rows+= rows;
+  } while (!batch_error && n_rows < batch_size);
+
+  if (!n_rows)
+    return batch_error;
+  join_tab->tracker->r_rows+= n_rows;
+
+  Item *cond= select ? select->cond : NULL;
+  if (cond && cond != batch_cond_src)
+  {
+    batch_cond_src= cond;
+    batch_cond= Batch_cond::create(join->thd, join_tab->table, cond);
+  }
+  if (cond && batch_cond)
+    batch_selected= batch_cond->eval_batch(batch_buff, batch_stride, n_rows,
+                                           batch_selection);
+  else
+  {
+    for (uint i= 0; i < n_rows; i++)
+      batch_selection[i]= (uint16) i;
+    batch_selected= n_rows;
+  }
+  return 0;
+}
+
+
+/*
+  Read the next record that can match from the current batch of records,
+  reading the next batch when the current one is exhausted
+*/
+
+int JOIN_TAB_SCAN::next_from_batch()
+{
+  TABLE *table= join_tab->table;
+  SQL_SELECT *select= join_tab->cache_select;
+  THD *thd= join->thd;
+  int err;
+
+  for (;;)
+  {
+    while (batch_pos < batch_selected)
+    {
+      uchar *rec= batch_buff +
+                  batch_selection[batch_pos++] * batch_stride;
+      memcpy(table->record[0], rec, table->s->reclength);
+      if (select && select->cond && !batch_cond)
+      {
+        int skip_rc= select->skip_record(thd);
+        if (skip_rc < 0)
+          return 1;
+        if (!skip_rc)
+          continue;
+      }
+      join_tab->tracker->r_rows_after_where++;
+      return 0;
+    }
+    if (batch_error)
+      return batch_error;
+    if (unlikely(thd->check_killed()))
+      return 1;
+    if ((err= read_batch()))
+      return err;
+  }
 }
 
 
@@ -3390,6 +3530,8 @@ int JOIN_TAB_SCAN::next()
 
   if (is_first_record)
     is_first_record= FALSE;
+  else if (use_batch)
+    return next_from_batch();
   else
     err= info->read_record();
 
@@ -3402,6 +3544,8 @@ int JOIN_TAB_SCAN::next()
   {
     if (unlikely(thd->check_killed()) || skip_rc < 0)
       return 1;
+    if (use_batch)
+      return next_from_batch();
     /* 
       Move to the next record if the last retrieved record does not
       meet the condition pushed to the table join_tab.
@@ -62,6 +62,7 @@ typedef struct st_cache_field {
 
 
 class JOIN_TAB_SCAN;
+class Batch_cond;
 
 class EXPLAIN_BKA_TYPE;
 
@@ -1042,6 +1043,28 @@ class JOIN_TAB_SCAN: public Sql_alloc
   /* TRUE if this is the first record from the joined table to iterate over */
   bool is_first_record;
 
+  /*
+    Records read ahead from join_tab with READ_RECORD::read_batch().
+    The condition of cache_select is applied to a whole batch at once
+    when it can be compiled into batch_cond.
+  */
+  bool use_batch;
+  uchar *batch_buff;
+  size_t batch_stride;
+  uint batch_size;
+  /* Numbers of the records in the batch that can match */
+  uint16 *batch_selection;
+  uint batch_selected;
+  uint batch_pos;
+  /* The result of the last read into the batch */
+  int batch_error;
+  Batch_cond *batch_cond;
+  Item *batch_cond_src;
+
+  bool init_batch();
+  int read_batch();
+  int next_from_batch();
+
 protected:
 
   /* The joined table to be iterated over */
@@ -1057,6 +1080,9 @@ class JOIN_TAB_SCAN: public Sql_alloc
 public:
   
   JOIN_TAB_SCAN(JOIN *j, JOIN_TAB *tab)
+    :use_batch(FALSE), batch_buff(0), batch_stride(0), batch_size(0), batch_selection(0),
+     batch_selected(0), batch_pos(0), batch_error(0), batch_cond(0),
+     batch_cond_src(0)
   {
     join= j;
     join_tab= tab;
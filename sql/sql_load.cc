@@ -43,6 +43,11 @@
 #include "sql_show.h"
 
 #include "wsrep_mysqld.h"
+#include "sql_array.h"
+#include <my_bit.h>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
 
 extern "C" int _my_b_net_read(IO_CACHE *info, uchar *Buffer, size_t Count);
 
@@ -99,6 +104,163 @@ class Term_string
 #define GET (stack_pos != stack ? *--stack_pos : my_b_get(&cache))
 #define PUSH(A) *(stack_pos++)=(A)
 
+/**
+  Finder of the bytes that READ_INFO::read_field() must look at one by one:
+  the escape and enclosing characters, the initial bytes of the terminators
+  and, in a multi-byte character set, the initial bytes of multi-byte
+  characters. All bytes in between are copied to the field as they are.
+*/
+class Field_byte_finder
+{
+  uchar m_bytes[4];
+  uint m_count;
+  bool m_non_ascii;                     /* whether bytes >= 0x80 are special */
+  bool m_disabled;                      /* whether all bytes are special */
+#ifdef __SSE2__
+  __m128i m_vectors[4];
+#endif
+public:
+  Field_byte_finder(): m_count(0), m_non_ascii(false), m_disabled(false) {}
+
+  /** Initialize for a character set and a set of special bytes */
+  void init(CHARSET_INFO *cs, int byte1, int byte2, int byte3)
+  {
+    m_count= 0;
+    /* Bytes of the ASCII range are only single-byte characters if
+       the minimum character length is 1 */
+    m_disabled= cs->mbminlen > 1;
+    m_non_ascii= cs->use_mb();
+    add(byte1);
+    add(byte2);
+    add(byte3);
+#ifdef __SSE2__
+    for (uint i= 0; i < m_count; i++)
+      m_vectors[i]= _mm_set1_epi8((char) m_bytes[i]);
+#endif
+  }
+
+  /** @return the first special byte in [ptr, end), or end if none */
+  const uchar *find(const uchar *ptr, const uchar *end) const
+  {
+    if (m_disabled)
+      return ptr;
+#ifdef __SSE2__
+    for (; end - ptr >= 16; ptr+= 16)
+    {
+      __m128i chunk= _mm_loadu_si128((const __m128i*) ptr);
+      int mask= m_non_ascii ? _mm_movemask_epi8(chunk) : 0;
+      for (uint i= 0; i < m_count; i++)
+        mask|= _mm_movemask_epi8(_mm_cmpeq_epi8(chunk, m_vectors[i]));
+      if (mask)
+        return ptr + my_find_first_bit((ulonglong) mask);
+    }
+#endif
+    for (; ptr < end; ptr++)
+    {
+      if (m_non_ascii && *ptr >= 0x80)
+        return ptr;
+      for (uint i= 0; i < m_count; i++)
+        if (*ptr == m_bytes[i])
+          return ptr;
+    }
+    return end;
+  }
+
+private:
+  void add(int byte)
+  {
+    if (byte > 0xff)
+      return;                                   /* INT_MAX: not used */
+    for (uint i= 0; i < m_count; i++)
+      if (m_bytes[i] == byte)
+        return;
+    m_bytes[m_count++]= (uchar) byte;
+  }
+};
+
+
+/*
+  Parallel parsing of LOAD DATA input.
+
+  The thread that executes the statement reads the input in chunks that
+  are cut after the last line terminator of the chunk, and queues them to
+  parser threads. A parser thread splits a chunk into rows and fields by
+  the same READ_INFO::read_field() and READ_INFO::next_line() calls that
+  read_sep_field() would make, each with its own READ_INFO that reads
+  from the chunk. read_sep_field() then consumes the parsed rows in the
+  order of the input.
+
+  A chunk is parsed on the assumption that it starts at the beginning of
+  a line. This does not hold if the previous chunk was cut inside an
+  enclosed field or after an escaped line terminator; its last line is
+  then incomplete: the parser ran out of input in the middle of it. In
+  that case, the incomplete line is parsed again together with the next
+  chunk, by the thread that executes the statement.
+*/
+
+/** A field split by a parser thread */
+struct Load_data_field
+{
+  size_t offset;                        /* in Load_data_chunk::values */
+  uint length;
+  bool enclosed;
+  bool found_null;
+};
+
+/** A row split by a parser thread */
+struct Load_data_row
+{
+  size_t first_field;                   /* in Load_data_chunk::fields */
+  uint n_fields;                        /* fields that read_field() read */
+  bool next_line_eof;                   /* what next_line() returned */
+  bool line_cuted;
+};
+
+struct Load_data_chunk
+{
+  /** Size of the chunks that the input is split into */
+  static const size_t SIZE= 256 * 1024;
+
+  enum state_t { FREE, QUEUED, PARSED };
+
+  String raw;                           /* input */
+  bool last;                            /* whether raw ends at end of input */
+  state_t state;
+
+  /* Result of parsing */
+  String values;                        /* fields, each followed by a byte */
+  Dynamic_array<Load_data_field> fields;
+  Dynamic_array<Load_data_row> rows;
+  /** offset of the incomplete last line in raw, or raw.length() */
+  size_t tail;
+  bool error;
+
+  Load_data_chunk()
+    : last(false), state(FREE), fields(PSI_INSTRUMENT_MEM, 1024, 1024),
+      rows(PSI_INSTRUMENT_MEM, 256, 256), tail(0), error(false)
+  {}
+
+  void reset()
+  {
+    values.length(0);
+    fields.elements(0);
+    rows.elements(0);
+    tail= 0;
+    error= false;
+  }
+
+  bool add_field(const uchar *start, const uchar *end, bool enclosed,
+                 bool found_null)
+  {
+    Load_data_field field= { values.length(), (uint) (end - start),
+                             enclosed, found_null };
+    return values.append((const char *) start, field.length) ||
+           values.append('\0') || fields.append(field);
+  }
+};
+
+class Load_data_pipeline;
+
 #ifdef WITH_WSREP
 /** If requested by wsrep_load_data_splitting and streaming replication is
     not enabled, replicate a streaming fragment every 10,000 rows.*/
@@ -146,6 +308,31 @@ class READ_INFO: public Load_data_param
   int	*stack,*stack_pos;
   bool	found_end_of_line,start_of_line,eof;
   int level; /* for load xml */
+  /* Special bytes outside and inside of an enclosed field */
+  Field_byte_finder m_plain_bytes, m_enclosed_bytes;
+  Load_data_pipeline *m_pipeline;       /* parser threads, or NULL */
+  const Load_data_row *m_parsed_row;    /* row from m_pipeline, or NULL */
+  uint m_parsed_field;                  /* next field of m_parsed_row */
+
+  uint stack_length(uint line_start_length) const
+  {
+    uint length= MY_MAX(charset()->mbmaxlen, MY_MAX(m_field_term.length(),
+                                                    m_line_term.length())) + 1;
+    return MY_MAX(length, line_start_length);
+  }
+  void init_byte_finders();
+  /** Whether the end of a chunk was reached, maybe by a lookahead */
+  bool read_past_end() const
+  {
+    if (eof)
+      return true;
+    for (const int *pos= stack; pos != stack_pos; pos++)
+      if (*pos == my_b_EOF)
+        return true;
+    return false;
+  }
+  int read_parsed_field();
+  int next_parsed_line();
 
   bool getbyte(char *to)
   {
@@ -228,7 +415,14 @@ class READ_INFO: public Load_data_param
   READ_INFO(THD *thd, File file, const Load_data_param &param,
 	    String &field_term,String &line_start,String &line_term,
 	    String &enclosed,int escape,bool get_it_from_net, bool is_fifo);
+  READ_INFO(THD *thd, const READ_INFO &input);
   ~READ_INFO();
+  /* Parallel parsing */
+  bool start_parser_threads(THD *thd, uint n_threads, uint n_columns);
+  void stop_parser_threads();
+  bool read_block(String *to);
+  size_t last_line_end(const uchar *data, size_t from, size_t to) const;
+  bool parse_chunk(Load_data_chunk *chunk, uint n_columns);
   int read_field();
   int read_fixed_length(void);
   int next_line(void);
@@ -258,6 +452,77 @@ class READ_INFO: public Load_data_param
   }
 };
 
+
+/** Parser threads of LOAD DATA, see Load_data_chunk */
+class Load_data_pipeline
+{
+  struct Worker
+  {
+    Load_data_pipeline *pipeline;
+    READ_INFO *reader;
+    pthread_t thread;
+  };
+
+  READ_INFO *m_input;                   /* reader of the input file */
+  READ_INFO *m_reader;                  /* for reparsing incomplete lines */
+  uint m_n_columns;
+  Worker *m_workers;
+  uint m_n_workers;
+  Load_data_chunk *m_chunks;
+  uint m_n_chunks;
+  /* Sequence numbers of chunks */
+  ulonglong m_queued, m_dispatched, m_consumed;
+  Load_data_chunk *m_current;           /* chunk being consumed */
+  size_t m_current_row;
+  String m_carry;                       /* input after the last cut */
+  String m_tail;                        /* incomplete line to reparse */
+  bool m_end_of_input;
+  bool m_stop;
+  bool m_error;
+  mysql_mutex_t m_mutex;
+  mysql_cond_t m_work_cond;             /* signalled when a chunk is queued */
+  mysql_cond_t m_done_cond;             /* signalled when a chunk is parsed */
+
+  bool fill_chunk(Load_data_chunk *chunk);
+  bool queue_chunks();
+  void run(READ_INFO *reader);
+  static void *worker_thread(void *arg);
+
+public:
+  Load_data_pipeline(READ_INFO *input, uint n_columns)
+    : m_input(input), m_reader(NULL), m_n_columns(n_columns),
+      m_workers(NULL), m_n_workers(0), m_chunks(NULL), m_n_chunks(0),
+      m_queued(0), m_dispatched(0), m_consumed(0), m_current(NULL),
+      m_current_row(0), m_end_of_input(false), m_stop(false), m_error(false)
+  {
+    mysql_mutex_init(key_LOCK_load_data_pipeline, &m_mutex,
+                     MY_MUTEX_INIT_FAST);
+    mysql_cond_init(key_COND_load_data_pipeline_work, &m_work_cond, NULL);
+    mysql_cond_init(key_COND_load_data_pipeline_done, &m_done_cond, NULL);
+  }
+  ~Load_data_pipeline();
+
+  /**
+    Create the parser threads.
+    @return whether no thread could be created
+  */
+  bool start(THD *thd, uint n_threads);
+
+  /** @return the next parsed row, or NULL at end of input or on error */
+  const Load_data_row *next_row();
+  const Load_data_field &field(const Load_data_row *row, uint i) const
+  {
+    DBUG_ASSERT(i < row->n_fields);
+    return m_current->fields.at(row->first_field + i);
+  }
+  uchar *value(const Load_data_field &field) const
+  {
+    return (uchar *) m_current->values.ptr() + field.offset;
+  }
+  bool error() const { return m_error; }
+};
+
+
 static int read_fixed_length(THD *thd, COPY_INFO &info, TABLE_LIST *table_list,
                              List<Item> &fields_vars, List<Item> &set_fields,
                              List<Item> &set_values, READ_INFO &read_info,
@@ -1076,6 +1341,10 @@ read_sep_field(THD *thd, COPY_INFO &info, TABLE_LIST *table_list,
   if ((thd->progress.max_counter= read_info.file_length()) == ~(my_off_t) 0)
     progress_reports= 0;
 
+  if (!skip_lines)
+    read_info.start_parser_threads(thd, thd->variables.load_data_parser_threads,
+                                   fields_vars.elements);
+
   for (;;it.rewind())
   {
     if (thd->killed)
@@ -1192,6 +1461,7 @@ read_sep_field(THD *thd, COPY_INFO &info, TABLE_LIST *table_list,
     thd->get_stmt_da()->inc_current_row_for_warning();
 continue_loop:;
   }
+  read_info.stop_parser_threads();
   DBUG_RETURN(MY_TEST(read_info.error));
 }
 
@@ -1344,6 +1614,7 @@ READ_INFO::READ_INFO(THD *thd, File file_par,
    file(file_par),
    m_field_term(field_term), m_line_term(line_term), m_line_start(line_start),
    escape_char(escape), found_end_of_line(false), eof(false),
+   m_pipeline(NULL), m_parsed_row(NULL), m_parsed_field(0),
    error(false), line_cuted(false), found_null(false)
 {
   data.set_thread_specific();
@@ -1361,10 +1632,9 @@ READ_INFO::READ_INFO(THD *thd, File file_par,
   enclosed_char= enclosed_par.length() ? (uchar) enclosed_par[0] : INT_MAX;
 
   /* Set of a stack for unget if long terminators */
-  uint length= MY_MAX(charset()->mbmaxlen, MY_MAX(m_field_term.length(),
-                                                  m_line_term.length())) + 1;
-  set_if_bigger(length,line_start.length());
+  uint length= stack_length(line_start.length());
   stack= stack_pos= (int*) thd->alloc(sizeof(int) * length);
+  init_byte_finders();
 
   DBUG_ASSERT(m_fixed_length < UINT_MAX32);
   if (data.reserve((size_t) m_fixed_length))
@@ -1395,8 +1665,55 @@ READ_INFO::READ_INFO(THD *thd, File file_par,
 }
 
 
+/** IO_CACHE::read_function of the readers of parse_chunk() */
+static int read_end_of_chunk(IO_CACHE *, uchar *, size_t)
+{
+  return 1;
+}
+
+
+/**
+  Create a reader of chunks of the input of another reader,
+  for parse_chunk().
+*/
+
+READ_INFO::READ_INFO(THD *thd, const READ_INFO &input)
+  :Load_data_param(input),
+   file(-1),
+   m_field_term(input.m_field_term), m_line_term(input.m_line_term),
+   m_line_start(input.m_line_start),
+   enclosed_char(input.enclosed_char), escape_char(input.escape_char),
+   found_end_of_line(false), start_of_line(false), eof(false), level(0),
+   m_plain_bytes(input.m_plain_bytes),
+   m_enclosed_bytes(input.m_enclosed_bytes),
+   m_pipeline(NULL), m_parsed_row(NULL), m_parsed_field(0),
+   error(false), line_cuted(false), found_null(false)
+{
+  stack= stack_pos= (int*) thd->alloc(sizeof(int) *
+                                      stack_length(m_line_start.length()));
+  bzero((char*) &cache, sizeof(cache));
+  cache.read_function= read_end_of_chunk;
+  if (!stack || data.reserve(IO_SIZE))
+    error= true;
+}
+
+
+void READ_INFO::init_byte_finders()
+{
+  m_plain_bytes.init(charset(), escape_char, m_field_term.initial_byte(),
+                     m_line_term.initial_byte());
+#ifdef ALLOW_LINESEPARATOR_IN_STRINGS
+  m_enclosed_bytes.init(charset(), escape_char, enclosed_char,
+                        m_line_term.initial_byte());
+#else
+  m_enclosed_bytes.init(charset(), escape_char, enclosed_char, INT_MAX);
+#endif
+}
+
+
 READ_INFO::~READ_INFO()
 {
+  stop_parser_threads();
   ::end_io_cache(&cache);
   List_iterator<XML_TAG> xmlit(taglist);
   XML_TAG *t;
@@ -1477,6 +1794,9 @@ int READ_INFO::read_field()
 {
   int chr,found_enclosed_char;
 
+  if (m_pipeline)
+    return read_parsed_field();
+
   found_null=0;
   if (found_end_of_line)
     return 1;					// One have to call next_line
@@ -1511,6 +1831,20 @@ int READ_INFO::read_field()
     // Make sure we have enough space for the longest multi-byte character.
     while (data.length() + charset()->mbmaxlen <= data.alloced_length())
     {
+      if (stack_pos == stack)
+      {
+        /* Copy the bytes up to the next special byte at once */
+        const Field_byte_finder &finder= found_enclosed_char == INT_MAX
+                                         ? m_plain_bytes : m_enclosed_bytes;
+        const uchar *run_end= finder.find(cache.read_pos, cache.read_end);
+        if (size_t run_length= (size_t) (run_end - cache.read_pos))
+        {
+          if (data.append((const char *) cache.read_pos, run_length))
+            return (error= 1);
+          cache.read_pos+= run_length;
+          continue;
+        }
+      }
       chr = GET;
       if (chr == my_b_EOF)
 	goto found_eof;
@@ -1676,6 +2010,8 @@ int READ_INFO::read_fixed_length()
 
 int READ_INFO::next_line()
 {
+  if (m_pipeline)
+    return next_parsed_line();
   line_cuted=0;
   start_of_line= m_line_start.length() != 0;
   if (found_end_of_line || eof)
@@ -1775,6 +2111,390 @@ bool READ_INFO::find_start_of_fields()
 }
 
 
+/**
+  Start parsing the rest of the input in parser threads.
+
+  @param n_threads  number of parser threads
+  @param n_columns  number of fields that read_sep_field() reads per line
+
+  @retval false  read_field() and next_line() now return parsed rows
+  @retval true   the input will be parsed by this thread
+*/
+
+bool READ_INFO::start_parser_threads(THD *thd, uint n_threads,
+                                     uint n_columns)
+{
+  /* Chunks are cut after line terminators */
+  if (!n_threads || !n_columns || !m_line_term.length() ||
+      stack_pos != stack || found_end_of_line || eof || error)
+    return true;
+
+  m_pipeline= new Load_data_pipeline(this, n_columns);
+  if (!m_pipeline || m_pipeline->start(thd, n_threads))
+  {
+    delete m_pipeline;
+    m_pipeline= NULL;
+    return true;
+  }
+  m_parsed_row= NULL;
+  return false;
+}
+
+
+void READ_INFO::stop_parser_threads()
+{
+  delete m_pipeline;
+  m_pipeline= NULL;
+  m_parsed_row= NULL;
+}
+
+
+/**
+  Append the next block of buffered input.
+  @return false at end of input
+*/
+
+bool READ_INFO::read_block(String *to)
+{
+  if (cache.read_pos == cache.read_end)
+  {
+    /* Refill the buffer, possibly through log_loaded_block() */
+    int chr= my_b_get(&cache);
+    if (chr == my_b_EOF)
+      return false;
+    if (to->append((char) chr))
+      return !(error= true);
+  }
+  if (to->append((const char *) cache.read_pos,
+                 (size_t) (cache.read_end - cache.read_pos)))
+    return !(error= true);
+  cache.read_pos= cache.read_end;
+  return true;
+}
+
+
+/**
+  Find the last line terminator in data[from..to).
+  @return the offset after the terminator, or 0 if none
+*/
+
+size_t READ_INFO::last_line_end(const uchar *data, size_t from,
+                                size_t to) const
+{
+  const size_t length= m_line_term.length();
+  for (size_t end= to; end >= from + length; end--)
+    if (data[end - 1] == m_line_term.ptr()[length - 1] &&
+        !memcmp(data + end - length, m_line_term.ptr(), length))
+      return end;
+  return 0;
+}
+
+
+/**
+  Split a chunk of input into rows and fields, by the same sequence of
+  read_field() and next_line() calls that read_sep_field() makes.
+
+  @param chunk      chunk that starts at the beginning of a line
+  @param n_columns  number of fields that read_sep_field() reads per line
+
+  @return whether an error occurred
+*/
+
+bool READ_INFO::parse_chunk(Load_data_chunk *chunk, uint n_columns)
+{
+  uchar *begin= (uchar *) chunk->raw.ptr();
+  uchar *end= begin + chunk->raw.length();
+
+  cache.read_pos= begin;
+  cache.read_end= end;
+  stack_pos= stack;
+  found_end_of_line= eof= line_cuted= error= false;
+  start_of_line= m_line_start.length() != 0;
+  chunk->reset();
+
+  while (cache.read_pos != end || stack_pos != stack)
+  {
+    /* Bytes that were pushed back precede read_pos in the input */
+    const uchar *line= cache.read_pos - (stack_pos - stack);
+    size_t values_length= chunk->values.length();
+    Load_data_row row= { chunk->fields.elements(), 0, false, false };
+
+    while (row.n_fields < n_columns && !read_field())
+    {
+      if (chunk->add_field(row_start, row_end, enclosed, found_null))
+        return true;
+      row.n_fields++;
+    }
+    if (error)
+      return true;
+    if (row.n_fields && (chunk->last || !read_past_end()))
+    {
+      row.next_line_eof= next_line();
+      row.line_cuted= line_cuted;
+    }
+    if (!chunk->last && read_past_end())
+    {
+      /* The input of the last line continues in the next chunk */
+      chunk->values.length(values_length);
+      chunk->fields.elements(row.first_field);
+      chunk->tail= (size_t) (line - begin);
+      return false;
+    }
+    if (!row.n_fields)
+      break;                                    // End of input
+    if (chunk->rows.append(row))
+      return true;
+    if (row.next_line_eof)
+      break;
+  }
+  chunk->tail= chunk->raw.length();
+  return false;
+}
+
+
+int READ_INFO::read_parsed_field()
+{
+  if (!m_parsed_row)
+  {
+    if (!(m_parsed_row= m_pipeline->next_row()))
+    {
+      error= m_pipeline->error();
+      found_end_of_line= eof= true;
+      return 1;
+    }
+    m_parsed_field= 0;
+  }
+  if (m_parsed_field == m_parsed_row->n_fields)
+    return 1;                                   // One has to call next_line
+  const Load_data_field &field= m_pipeline->field(m_parsed_row,
+                                                  m_parsed_field++);
+  row_start= m_pipeline->value(field);
+  row_end= row_start + field.length;
+  enclosed= field.enclosed;
+  found_null= field.found_null;
+  return 0;
+}
+
+
+int READ_INFO::next_parsed_line()
+{
+  if (!m_parsed_row)
+    return eof;
+  line_cuted= m_parsed_row->line_cuted;
+  int result= m_parsed_row->next_line_eof;
+  m_parsed_row= NULL;
+  return result;
+}
+
+
+bool Load_data_pipeline::start(THD *thd, uint n_threads)
+{
+  m_n_chunks= 2 * n_threads;
+  if (!(m_reader= new READ_INFO(thd, *m_input)) || m_reader->error ||
+      !(m_chunks= new Load_data_chunk[m_n_chunks]) ||
+      !(m_workers= new Worker[n_threads]))
+    return true;
+
+  for (uint i= 0; i < n_threads; i++)
+  {
+    Worker *worker= &m_workers[m_n_workers];
+    worker->pipeline= this;
+    if (!(worker->reader= new READ_INFO(thd, *m_input)) ||
+        worker->reader->error)
+    {
+      delete worker->reader;
+      break;
+    }
+    if (mysql_thread_create(key_thread_load_data_parser, &worker->thread,
+                            NULL, worker_thread, worker))
+    {
+      delete worker->reader;
+      break;
+    }
+    m_n_workers++;
+  }
+  return !m_n_workers;
+}
+
+
+Load_data_pipeline::~Load_data_pipeline()
+{
+  mysql_mutex_lock(&m_mutex);
+  m_stop= true;
+  mysql_cond_broadcast(&m_work_cond);
+  mysql_mutex_unlock(&m_mutex);
+  for (uint i= 0; i < m_n_workers; i++)
+  {
+    pthread_join(m_workers[i].thread, NULL);
+    delete m_workers[i].reader;
+  }
+  delete[] m_workers;
+  delete[] m_chunks;
+  delete m_reader;
+  mysql_cond_destroy(&m_done_cond);
+  mysql_cond_destroy(&m_work_cond);
+  mysql_mutex_destroy(&m_mutex);
+}
+
+
+void *Load_data_pipeline::worker_thread(void *arg)
+{
+  Worker *worker= static_cast<Worker*>(arg);
+  my_thread_init();
+  worker->pipeline->run(worker->reader);
+  my_thread_end();
+  return 0;
+}
+
+
+void Load_data_pipeline::run(READ_INFO *reader)
+{
+  mysql_mutex_lock(&m_mutex);
+  while (!m_stop)
+  {
+    if (m_dispatched == m_queued)
+    {
+      mysql_cond_wait(&m_work_cond, &m_mutex);
+      continue;
+    }
+    Load_data_chunk *chunk= &m_chunks[m_dispatched++ % m_n_chunks];
+    mysql_mutex_unlock(&m_mutex);
+    bool error= reader->parse_chunk(chunk, m_n_columns);
+    mysql_mutex_lock(&m_mutex);
+    chunk->error= error;
+    chunk->state= Load_data_chunk::PARSED;
+    mysql_cond_broadcast(&m_done_cond);
+  }
+  mysql_mutex_unlock(&m_mutex);
+}
+
+
+/**
+  Read the next chunk of input, up to the last line terminator in it.
+  @return whether an error occurred
+*/
+
+bool Load_data_pipeline::fill_chunk(Load_data_chunk *chunk)
+{
+  String *raw= &chunk->raw;
+  raw->length(0);
+  if (raw->append(m_carry))
+    return true;
+  m_carry.length(0);
+
+  size_t searched= 0;
+  for (;;)
+  {
+    while (raw->length() < Load_data_chunk::SIZE)
+    {
+      if (!m_input->read_block(raw))
+      {
+        if (m_input->error)
+          return true;
+        chunk->last= m_end_of_input= true;
+        return false;
+      }
+    }
+    const uchar *data= (const uchar *) raw->ptr();
+    if (size_t cut= m_input->last_line_end(data, searched, raw->length()))
+    {
+      chunk->last= false;
+      if (m_carry.append((const char *) data + cut, raw->length() - cut))
+        return true;
+      raw->length(cut);
+      return false;
+    }
+    /* A line longer than the chunk: read more */
+    searched= raw->length();
+    if (!m_input->read_block(raw))
+    {
+      if (m_input->error)
+        return true;
+      chunk->last= m_end_of_input= true;
+      return false;
+    }
+  }
+}
+
+
+/** Queue chunks for all free slots */
+
+bool Load_data_pipeline::queue_chunks()
+{
+  while (!m_end_of_input && m_queued - m_consumed < m_n_chunks)
+  {
+    Load_data_chunk *chunk= &m_chunks[m_queued % m_n_chunks];
+    DBUG_ASSERT(chunk->state == Load_data_chunk::FREE);
+    if (fill_chunk(chunk))
+      return true;
+    mysql_mutex_lock(&m_mutex);
+    chunk->state= Load_data_chunk::QUEUED;
+    m_queued++;
+    mysql_cond_signal(&m_work_cond);
+    mysql_mutex_unlock(&m_mutex);
+  }
+  return false;
+}
+
+
+const Load_data_row *Load_data_pipeline::next_row()
+{
+  while (!m_current || m_current_row == m_current->rows.elements())
+  {
+    if (m_current)
+    {
+      if (m_current->tail != m_current->raw.length() &&
+          m_tail.append(m_current->raw.ptr() + m_current->tail,
+                        m_current->raw.length() - m_current->tail))
+        m_error= true;
+      mysql_mutex_lock(&m_mutex);
+      m_current->state= Load_data_chunk::FREE;
+      mysql_mutex_unlock(&m_mutex);
+      m_current= NULL;
+    }
+    if (m_error || queue_chunks())
+    {
+      m_error= true;
+      return NULL;
+    }
+    if (m_consumed == m_queued)
+      return NULL;                              // End of input
+
+    Load_data_chunk *chunk= &m_chunks[m_consumed++ % m_n_chunks];
+    mysql_mutex_lock(&m_mutex);
+    while (chunk->state != Load_data_chunk::PARSED)
+      mysql_cond_wait(&m_done_cond, &m_mutex);
+    mysql_mutex_unlock(&m_mutex);
+    m_current= chunk;
+    m_current_row= 0;
+
+    if (m_tail.length())
+    {
+      /*
+        The previous chunk was not cut at the end of a line.
+        Parse its last line again, followed by this chunk.
+      */
+      if (m_tail.append(chunk->raw))
+        m_error= true;
+      else
+      {
+        chunk->raw.swap(m_tail);
+        m_tail.length(0);
+        chunk->error= m_reader->parse_chunk(chunk, m_n_columns);
+      }
+    }
+    if (chunk->error)
+      m_error= true;
+    else if (chunk->last && chunk->tail != chunk->raw.length())
+    {
+      DBUG_ASSERT(0);                           // parse_chunk() reads to EOF
+      m_error= true;
+    }
+  }
+  return &m_current->rows.at(m_current_row++);
+}
+
+
 /*
   Clear taglist from tags with a specified level
 */
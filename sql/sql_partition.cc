@@ -4319,6 +4319,81 @@ void get_partition_set(const TABLE *table, uchar *buf, const uint index,
   DBUG_VOID_RETURN;
 }
 
+
+/*
+  Get the set of partitions to use in a range scan.
+
+  SYNOPSIS
+    get_partition_set_for_range()
+    table         The table object
+    buf           A buffer that can be used to evaluate the partition function
+    index         The index of the key used
+    start_key     Start of the range, or NULL
+    end_key       End of the range, or NULL
+    out:part_spec Contains start part and end part
+
+  DESCRIPTION
+    Like get_partition_set(), but also for ranges that are not a single key
+    value. All rows of a range have the key parts that are equal in its
+    start and end key in common, so if these bind the partition function,
+    only the partitions they map to need to be scanned. This prunes the
+    partitions at execution time for ranges that are built from the
+    current row of an outer table, like ranges checked for each record
+    and the keys that a batched key access join reads.
+*/
+
+void get_partition_set_for_range(const TABLE *table, uchar *buf,
+                                 const uint index,
+                                 const key_range *start_key,
+                                 const key_range *end_key,
+                                 part_id_range *part_spec)
+{
+  DBUG_ENTER("get_partition_set_for_range");
+
+  if (start_key && start_key->key && start_key->flag == HA_READ_KEY_EXACT)
+  {
+    get_partition_set(table, buf, index, start_key, part_spec);
+    DBUG_VOID_RETURN;
+  }
+  part_spec->start_part= 0;
+  part_spec->end_part= table->part_info->get_tot_partitions() - 1;
+  if (index < MAX_KEY && start_key && start_key->key &&
+      end_key && end_key->key &&
+      table->part_info->some_fields_in_PF.is_set(index))
+  {
+    KEY *key_info= table->key_info + index;
+    KEY_PART_INFO *key_part= key_info->key_part;
+    uint min_length= MY_MIN(start_key->length, end_key->length);
+    uint length= 0, part;
+    key_range prefix;
+
+    for (part= 0; part < key_info->ext_key_parts; part++, key_part++)
+    {
+      if (length + key_part->store_length > min_length ||
+          memcmp(start_key->key + length, end_key->key + length,
+                 key_part->store_length))
+        break;
+      length+= key_part->store_length;
+    }
+    /*
+      A range that excludes the whole common prefix at either end is
+      empty; leave it to the storage engine.
+    */
+    if (!length ||
+        (length == start_key->length &&
+         start_key->flag == HA_READ_AFTER_KEY) ||
+        (length == end_key->length && end_key->flag == HA_READ_BEFORE_KEY))
+      DBUG_VOID_RETURN;
+
+    prefix.key= start_key->key;
+    prefix.length= length;
+    prefix.keypart_map= (key_part_map(1) << part) - 1;
+    prefix.flag= HA_READ_KEY_EXACT;
+    get_partition_set(table, buf, index, &prefix, part_spec);
+  }
+  DBUG_VOID_RETURN;
+}
+
 /*
    If the table is partitioned we will read the partition info into the
    .frm file here.
@@ -97,6 +97,11 @@ bool fix_partition_func(THD *thd, TABLE *table, bool create_table_ind);
 void get_partition_set(const TABLE *table, uchar *buf, const uint index,
                        const key_range *key_spec,
                        part_id_range *part_spec);
+void get_partition_set_for_range(const TABLE *table, uchar *buf,
+                                 const uint index,
+                                 const key_range *start_key,
+                                 const key_range *end_key,
+                                 part_id_range *part_spec);
 uint get_partition_field_store_length(Field *field);
 void get_full_part_id_from_key(const TABLE *table, uchar *buf,
                                KEY *key_info,
@@ -67,6 +67,8 @@
 #include "select_handler.h"
 #include "my_json_writer.h"
 #include "opt_trace.h"
+#include "sql_batch_cond.h"
+#include "sql_group_spill.h"
 
 /*
   A key part number that means we're using a fulltext scan.
@@ -2285,6 +2287,53 @@ JOIN::optimize_inner()
 }
 
 
+/**
+  Get the MATCH function that creates the full-text search handler
+  of a MATCH function, @see setup_ftfuncs()
+*/
+
+static Item_func_match *get_ft_master(Item *item)
+{
+  if (item->type() != Item::FUNC_ITEM ||
+      ((Item_func*) item)->functype() != Item_func::FT_FUNC)
+    return NULL;
+  Item_func_match *match= (Item_func_match*) item;
+  while (match->master)
+    match= match->master;
+  return match;
+}
+
+
+/**
+  Pass the LIMIT of a single table query
+
+    SELECT ... FROM t1 WHERE MATCH (...) AGAINST (...)
+    ORDER BY MATCH (...) AGAINST (...) DESC LIMIT n
+
+  to the full-text search. The query returns the n best ranked documents
+  of the search, so the storage engine does not have to find the
+  documents that rank below them.
+*/
+
+static void set_ft_limit(JOIN *join)
+{
+  Item_func_match *match;
+
+  if (join->table_count != 1 || join->const_tables ||
+      join->join_tab->type != JT_FT ||
+      !join->conds || !join->order || join->order->next ||
+      join->order->direction != ORDER::ORDER_DESC ||
+      join->group_list || join->select_distinct || join->having ||
+      join->select_lex->have_window_funcs() ||
+      join->select_limit == HA_POS_ERROR)
+    return;
+  if (!(match= get_ft_master(join->conds)) ||
+      match != get_ft_master((*join->order->item)->real_item()))
+    return;
+  match->ft_limit= join->select_limit;
+}
+
+
 int JOIN::optimize_stage2()
 {
   ulonglong select_opts_for_readinfo;
@@ -2798,8 +2847,11 @@ int JOIN::optimize_stage2()
 
   /* Perform FULLTEXT search before all regular searches */
   if (!(select_options & SELECT_DESCRIBE))
+  {
+    set_ft_limit(this);
     if (init_ftfuncs(thd, select_lex, MY_TEST(order)))
       DBUG_RETURN(1);
+  }
 
   /*
     It's necessary to check const part of HAVING cond as
@@ -4512,6 +4564,7 @@ JOIN::destroy()
     {
       if (tab->aggr)
       {
+        delete tab->aggr->group_spill;
         free_tmp_table(thd, tab->table);
         delete tab->tmp_table_param;
         tab->tmp_table_param= NULL;
@@ -13462,6 +13515,19 @@ void JOIN_TAB::build_range_rowid_filter_if_needed()
 }
 
 
+/**
+  Compile select_cond for evaluation without the Item tree, if it is simple
+  enough. See Batch_cond.
+*/
+
+void JOIN_TAB::prepare_batch_cond()
+{
+  batch_cond_src= select_cond;
+  batch_cond= select_cond && table ?
+              Batch_cond::create(join->thd, table, select_cond) : NULL;
+}
+
+
 /**
   cleanup JOIN_TAB.
 
@@ -13481,6 +13547,8 @@ void JOIN_TAB::cleanup()
   select= 0;
   delete quick;
   quick= 0;
+  batch_cond= 0;
+  batch_cond_src= 0;
   if (rowid_filter)
   {
     delete rowid_filter;
@@ -13949,6 +14017,7 @@ void JOIN::cleanup(bool full)
         {
           if (curr_tab->aggr)
           {
+            delete curr_tab->aggr->group_spill;
             free_tmp_table(thd, curr_tab->table);
             delete curr_tab->tmp_table_param;
             curr_tab->tmp_table_param= NULL;
@@ -20754,11 +20823,19 @@ evaluate_join_record(JOIN *join, JOIN_TAB *join_tab,
 
   if (select_cond)
   {
-    select_cond_result= MY_TEST(select_cond->val_int());
+    if (unlikely(join_tab->batch_cond_src != select_cond))
+      join_tab->prepare_batch_cond();
+    if (join_tab->batch_cond && !join_tab->table->null_row)
+      select_cond_result=
+        join_tab->batch_cond->eval(join_tab->table->record[0]);
+    else
+    {
+      select_cond_result= MY_TEST(select_cond->val_int());
 
-    /* check for errors evaluating the condition */
-    if (unlikely(join->thd->is_error()))
-      DBUG_RETURN(NESTED_LOOP_ERROR);
+      /* check for errors evaluating the condition */
+      if (unlikely(join->thd->is_error()))
+        DBUG_RETURN(NESTED_LOOP_ERROR);
+    }
   }
 
   if (!select_cond || select_cond_result)
@@ -22154,7 +22231,23 @@ end_update(JOIN *join, JOIN_TAB *join_tab __attribute__((unused)),
   DBUG_ENTER("end_update");
 
   if (end_of_records)
+  {
+    Group_spill *spill= join_tab->aggr->group_spill;
+    if (spill)
+    {
+      ha_rows groups;
+      bool res= spill->finish(&groups);
+      delete spill;
+      join_tab->aggr->group_spill= NULL;
+      if (res)
+        DBUG_RETURN(NESTED_LOOP_ERROR);
+      join_tab->send_records+= groups;
+      /* The table was converted to a disk table while writing the groups */
+      if (table->s->db_type() != heap_hton)
+        join_tab->aggr->set_write_func(end_unique_update);
+    }
     DBUG_RETURN(NESTED_LOOP_OK);
+  }
 
   join->found_records++;
   copy_fields(join_tab->tmp_table_param);	// Groups are copied twice.
@@ -22196,8 +22289,27 @@ end_update(JOIN *join, JOIN_TAB *join_tab __attribute__((unused)),
   if (unlikely(copy_funcs(join_tab->tmp_table_param->items_to_copy,
                           join->thd)))
     DBUG_RETURN(NESTED_LOOP_ERROR);           /* purecov: inspected */
+  if (join_tab->aggr->group_spill)
+  {
+    /* The table is full, the group is aggregated at the end of records */
+    if (join_tab->aggr->group_spill->add())
+      DBUG_RETURN(NESTED_LOOP_ERROR);
+    goto end;
+  }
   if (unlikely((error= table->file->ha_write_tmp_row(table->record[0]))))
   {
+    if (error == HA_ERR_RECORD_FILE_FULL &&
+        Group_spill::is_applicable(join, join_tab))
+    {
+      Group_spill *spill= new Group_spill(join, join_tab);
+      if (!spill || spill->init() || spill->add())
+      {
+        delete spill;
+        DBUG_RETURN(NESTED_LOOP_ERROR);
+      }
+      join_tab->aggr->group_spill= spill;
+      goto end;
+    }
     if (create_internal_tmp_table_from_heap(join->thd, table,
                                        join_tab->tmp_table_param->start_recinfo,
                                             &join_tab->tmp_table_param->recinfo,
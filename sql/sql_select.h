@@ -240,9 +240,11 @@ class JOIN_CACHE;
 class SJ_TMP_TABLE;
 class JOIN_TAB_RANGE;
 class AGGR_OP;
+class Group_spill;
 class Filesort;
 struct SplM_plan_info;
 class SplM_opt_info;
+class Batch_cond;
 
 typedef struct st_join_table {
   TABLE		*table;
@@ -263,6 +265,13 @@ typedef struct st_join_table {
     NULL means no index condition pushdown was performed.
   */
   Item          *pre_idx_push_select_cond;
+  /*
+    select_cond compiled for evaluation on the record image, or NULL if it
+    can not be compiled. batch_cond_src is the select_cond it was built
+    for, the compilation is redone when select_cond changes.
+  */
+  Batch_cond    *batch_cond;
+  Item          *batch_cond_src;
   /*
     Pointer to the associated ON expression. on_expr_ref=!NULL except for
     degenerate joins. 
@@ -610,6 +619,7 @@ typedef struct st_join_table {
       select->cond= new_cond;
     return tmp_select_cond;
   }
+  void prepare_batch_cond();
   void calc_used_field_length(bool max_fl);
   ulong get_used_fieldlength()
   {
@@ -1043,8 +1053,10 @@ class AGGR_OP :public Sql_alloc
 {
 public:
   JOIN_TAB *join_tab;
+  /* Groups that did not fit into the temporary table, see end_update() */
+  Group_spill *group_spill;
 
-  AGGR_OP(JOIN_TAB *tab) : join_tab(tab), write_func(NULL)
+  AGGR_OP(JOIN_TAB *tab) : join_tab(tab), group_spill(NULL), write_func(NULL)
   {};
 
   enum_nested_loop_state put_record() { return put_record(false); };
@@ -2448,6 +2448,7 @@ bool st_select_lex_unit::exec_recursive()
   ha_rows examined_rows= 0;
   bool was_executed= executed;
   TABLE_LIST *rec_tbl;
+  TABLE *swap_table= NULL;
 
   DBUG_ENTER("st_select_lex_unit::exec_recursive");
 
@@ -2525,18 +2526,44 @@ bool st_select_lex_unit::exec_recursive()
   else
     with_element->level++;
 
+  /*
+    Pass the increment to the recursive references. For a restricted
+    specification every reference reads only the increment, so instead of
+    copying it, its storage can be handed over to one reference without
+    indexes: that reference gets the new rows and incr_table gets the old
+    ones, which are removed at the start of the next iteration.
+  */
   while ((rec_tbl= li++))
   {
     TABLE *rec_table= rec_tbl->table;
-    saved_error=
-      incr_table->insert_all_rows_into_tmp_table(thd, rec_table,
-                                                 tmp_table_param,
-                                                 !is_unrestricted);
+    if (!is_unrestricted && !swap_table && !rec_table->s->keys &&
+        !rec_table->no_rows &&
+        rec_table->s->db_type() == incr_table->s->db_type())
+      swap_table= rec_table;
+    else
+      saved_error=
+        incr_table->insert_all_rows_into_tmp_table(thd, rec_table,
+                                                   tmp_table_param,
+                                                   !is_unrestricted);
     if (!with_element->rec_result->first_rec_table_to_update)
       with_element->rec_result->first_rec_table_to_update= rec_table;
     if (with_element->level == 1 && rec_table->reginfo.join_tab)
       rec_table->reginfo.join_tab->preread_init_done= true;
   }
+  if (swap_table)
+  {
+    incr_table->file->ha_index_or_rnd_end();
+    swap_table->file->ha_index_or_rnd_end();
+    if (swap_table->file->exchange_tmp_table_rows(incr_table->file))
+      saved_error=
+        incr_table->insert_all_rows_into_tmp_table(thd, swap_table,
+                                                   tmp_table_param, true);
+    else
+    {
+      incr_table->file->info(HA_STATUS_VARIABLE);
+      swap_table->file->info(HA_STATUS_VARIABLE);
+    }
+  }
   for (Item_subselect *sq= with_element->sq_with_rec_ref.first;
        sq;
        sq= sq->next_with_rec_ref)
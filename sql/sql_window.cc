@@ -2944,6 +2944,10 @@ bool Window_func_runner::add_function_to_run(Item_window_func *win_func)
       my_error(ER_NOT_SUPPORTED_YET, MYF(0),
                "JSON_OBJECTAGG() aggregate as window function");
       return true;
+    case Item_sum::APPROX_COUNT_DISTINCT_FUNC:
+      my_error(ER_NOT_SUPPORTED_YET, MYF(0),
+               "APPROX_COUNT_DISTINCT() aggregate as window function");
+      return true;
     default:
       break;
   }
@@ -441,6 +441,9 @@ End SQL_MODE_ORACLE_SPECIFIC */
 %token  <kwd> ALTER                         /* SQL-2003-R */
 %token  <kwd> ANALYZE_SYM
 %token  <kwd> AND_SYM                       /* SQL-2003-R */
+%token  <kwd> APPROX_COUNT_DISTINCT_SYM
+%token  <kwd> APPROX_COUNT_DISTINCT_MERGE_SYM
+%token  <kwd> APPROX_COUNT_DISTINCT_SKETCH_SYM
 %token  <kwd> ASC                           /* SQL-2003-N */
 %token  <kwd> ASENSITIVE_SYM                /* FUTURE-USE */
 %token  <kwd> AS                            /* SQL-2003-R */
@@ -10779,6 +10782,27 @@ sum_expr:
             if (unlikely($$ == NULL))
               MYSQL_YYABORT;
           }
+        | APPROX_COUNT_DISTINCT_SYM '(' in_sum_expr ')'
+          {
+            $$= new (thd->mem_root)
+                  Item_sum_approx_count_distinct(thd, $3, false);
+            if (unlikely($$ == NULL))
+              MYSQL_YYABORT;
+          }
+        | APPROX_COUNT_DISTINCT_MERGE_SYM '(' in_sum_expr ')'
+          {
+            $$= new (thd->mem_root)
+                  Item_sum_approx_count_distinct(thd, $3, true);
+            if (unlikely($$ == NULL))
+              MYSQL_YYABORT;
+          }
+        | APPROX_COUNT_DISTINCT_SKETCH_SYM '(' in_sum_expr ')'
+          {
+            $$= new (thd->mem_root)
+                  Item_sum_approx_count_distinct_sketch(thd, $3);
+            if (unlikely($$ == NULL))
+              MYSQL_YYABORT;
+          }
         | COUNT_SYM '(' opt_all '*' ')'
           {
             Item *item= new (thd->mem_root) Item_int(thd, (int32) 0L, 1);
@@ -15865,6 +15889,9 @@ reserved_keyword_udt_not_param_type:
         | ALTER
         | ANALYZE_SYM
         | AND_SYM
+        | APPROX_COUNT_DISTINCT_SYM
+        | APPROX_COUNT_DISTINCT_MERGE_SYM
+        | APPROX_COUNT_DISTINCT_SKETCH_SYM
         | AS
         | ASC
         | ASENSITIVE_SYM
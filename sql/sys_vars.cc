@@ -53,6 +53,7 @@
 #include "debug_sync.h"                         // DEBUG_SYNC
 #include "sql_show.h"
 #include "opt_trace_context.h"
+#include "sql_hll.h"                            // Hyperloglog
 
 #include "log_event.h"
 #ifdef WITH_PERFSCHEMA_STORAGE_ENGINE
@@ -1384,6 +1385,14 @@ static Sys_var_charptr_fscs Sys_language(
        READ_ONLY GLOBAL_VAR(lc_messages_dir_ptr), CMD_LINE(REQUIRED_ARG, 'L'),
        DEFAULT(0));
 
+static Sys_var_uint Sys_load_data_parser_threads(
+       "load_data_parser_threads",
+       "Number of threads that split the input of LOAD DATA INFILE into "
+       "fields while the rows are being inserted. 0 means that the input "
+       "is parsed by the connection thread",
+       SESSION_VAR(load_data_parser_threads), CMD_LINE(REQUIRED_ARG),
+       VALID_RANGE(0, 256), DEFAULT(0), BLOCK_SIZE(1));
+
 static Sys_var_mybool Sys_local_infile(
        "local_infile", "Enable LOAD DATA LOCAL INFILE",
        GLOBAL_VAR(opt_local_infile), CMD_LINE(OPT_ARG), DEFAULT(TRUE));
@@ -2785,6 +2794,14 @@ static Sys_var_uint Sys_port(
        READ_ONLY GLOBAL_VAR(mysqld_port), CMD_LINE(REQUIRED_ARG, 'P'),
        VALID_RANGE(0, UINT_MAX32), DEFAULT(0), BLOCK_SIZE(1));
 
+static Sys_var_uint Sys_partition_prefetch_threads(
+       "partition_prefetch_threads",
+       "Number of threads that read ahead rows of the partitions of a "
+       "MyISAM table during long table scans and ordered index scans. "
+       "0 means that rows are only read when they are needed",
+       SESSION_VAR(partition_prefetch_threads), CMD_LINE(REQUIRED_ARG),
+       VALID_RANGE(0, 256), DEFAULT(0), BLOCK_SIZE(1));
+
 static Sys_var_ulong Sys_preload_buff_size(
        "preload_buffer_size",
        "The size of the buffer that is allocated when preloading indexes",
@@ -3817,6 +3834,28 @@ static Sys_var_ulong Sys_table_def_size(
        VALID_RANGE(TABLE_DEF_CACHE_MIN, 2*1024*1024),
        DEFAULT(TABLE_DEF_CACHE_DEFAULT), BLOCK_SIZE(1));
 
+#ifndef EMBEDDED_LIBRARY
+static Sys_var_mybool Sys_table_def_dump_at_shutdown(
+       "table_definition_cache_dump_at_shutdown",
+       "Save the names of the tables in the table definition cache at "
+       "shutdown, for table_definition_cache_load_at_startup",
+       GLOBAL_VAR(tdc_dump_at_shutdown), CMD_LINE(OPT_ARG), DEFAULT(FALSE));
+
+static Sys_var_mybool Sys_table_def_load_at_startup(
+       "table_definition_cache_load_at_startup",
+       "Open the tables saved by table_definition_cache_dump_at_shutdown "
+       "in the background at startup",
+       READ_ONLY GLOBAL_VAR(tdc_load_at_startup), CMD_LINE(OPT_ARG),
+       DEFAULT(FALSE));
+
+static Sys_var_uint Sys_table_def_load_threads(
+       "table_definition_cache_load_threads",
+       "Number of threads that open the tables saved in the table "
+       "definition cache at startup",
+       READ_ONLY GLOBAL_VAR(tdc_load_threads), CMD_LINE(REQUIRED_ARG),
+       VALID_RANGE(1, 64), DEFAULT(4), BLOCK_SIZE(1));
+#endif
+
 
 static bool fix_table_open_cache(sys_var *, THD *, enum_var_type)
 {
@@ -4791,6 +4830,15 @@ static Sys_var_uint Sys_group_concat_max_len(
        SESSION_VAR(group_concat_max_len), CMD_LINE(REQUIRED_ARG),
        VALID_RANGE(4, UINT_MAX32), DEFAULT(1024*1024), BLOCK_SIZE(1));
 
+static Sys_var_uint Sys_approx_count_distinct_precision(
+       "approx_count_distinct_precision",
+       "Precision of the HyperLogLog sketches used by "
+       "APPROX_COUNT_DISTINCT(). A sketch takes 2^precision bytes, the "
+       "standard error of the estimate is 1.04/sqrt(2^precision)",
+       SESSION_VAR(approx_count_distinct_precision), CMD_LINE(REQUIRED_ARG),
+       VALID_RANGE(Hyperloglog::MIN_PRECISION, Hyperloglog::MAX_PRECISION),
+       DEFAULT(Hyperloglog::DEFAULT_PRECISION), BLOCK_SIZE(1));
+
 static char *glob_hostname_ptr;
 static Sys_var_charptr Sys_hostname(
        "hostname", "Server host name",
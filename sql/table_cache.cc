@@ -26,6 +26,8 @@
   - purge unused TABLE_SHARE objects from cache (tdc_purge())
   - remove TABLE_SHARE object from cache (tdc_remove_table())
   - get number of TABLE_SHARE objects in cache (tdc_records())
+  - save names of cached TABLE_SHARE objects at shutdown (tdc_dump())
+  - load saved TABLE_SHARE objects in background threads (tdc_load())
 
   Table cache actions:
   - add new TABLE object to cache (tc_add_table())
@@ -56,6 +58,9 @@
 ulong tdc_size; /**< Table definition cache threshold for LRU eviction. */
 ulong tc_size; /**< Table cache threshold for LRU eviction. */
 uint32 tc_instances;
+my_bool tdc_dump_at_shutdown; /**< Save cached table names at shutdown. */
+my_bool tdc_load_at_startup; /**< Load saved table names at startup. */
+uint tdc_load_threads; /**< Number of threads loading table definitions. */
 static std::atomic<uint32_t> tc_active_instances(1);
 static std::atomic<bool> tc_contention_warning_reported;
 
@@ -1202,6 +1207,265 @@ int show_tc_active_instances(THD *thd, SHOW_VAR *var, char *buff,
 }
 
 
+/*
+  Saving and loading of the table definition cache.
+
+  At shutdown the keys (db\0table_name\0) of the cached table definitions
+  are written to TDC_DUMP_FILE in the data directory. At startup
+  tdc_load_threads threads open these tables in the background, so that
+  the first statements after a restart find their table definitions in
+  the cache. Tables that are locked by DDL when their turn comes are
+  skipped, as are tables that no longer exist.
+*/
+
+#define TDC_DUMP_FILE "tdc_dump"
+
+static const char **tdc_load_keys;      /**< Keys of tables to load */
+static uint32_t tdc_load_count;
+static std::atomic<uint32_t> tdc_load_next, tdc_load_running;
+static std::atomic<uint32_t> tdc_load_pending_count, tdc_loaded_count;
+static uchar *tdc_load_buff;
+
+
+static my_bool tdc_dump_callback(TDC_element *element, File *file)
+{
+  bool cached;
+
+  mysql_mutex_lock(&element->LOCK_table_share);
+  cached= element->share && !element->share->error;
+  mysql_mutex_unlock(&element->LOCK_table_share);
+  if (!cached)
+    return FALSE;
+  return mysql_file_write(*file, element->m_key, element->m_key_length,
+                          MYF(MY_WME | MY_NABP)) != 0;
+}
+
+
+/**
+  Save the names of the tables in the table definition cache.
+
+  The file is written under a temporary name and renamed, so that a crash
+  during the dump leaves the previous dump in place.
+*/
+
+void tdc_dump(void)
+{
+  char path[FN_REFLEN], tmp_path[FN_REFLEN];
+  File file;
+  int error;
+  DBUG_ENTER("tdc_dump");
+
+  if (!tdc_inited)
+    DBUG_VOID_RETURN;
+  fn_format(path, TDC_DUMP_FILE, mysql_data_home, "", MYF(0));
+  fn_format(tmp_path, TDC_DUMP_FILE, mysql_data_home, ".tmp", MYF(0));
+  if ((file= mysql_file_create(key_file_misc, tmp_path, CREATE_MODE,
+                               O_WRONLY | O_TRUNC | O_BINARY,
+                               MYF(MY_WME))) < 0)
+    DBUG_VOID_RETURN;
+  error= tdc_iterate(0, (my_hash_walk_action) tdc_dump_callback, &file);
+  error|= mysql_file_close(file, MYF(MY_WME));
+  if (error ||
+      mysql_file_rename(key_file_misc, tmp_path, path, MYF(MY_WME)))
+  {
+    mysql_file_delete(key_file_misc, tmp_path, MYF(0));
+    sql_print_warning("Could not save the table definition cache to '%s'",
+                      path);
+  }
+  DBUG_VOID_RETURN;
+}
+
+
+/**
+  Read TDC_DUMP_FILE into tdc_load_buff and make tdc_load_keys point to
+  the keys in it, at most tdc_size of them.
+
+  @return number of keys
+*/
+
+static uint32_t tdc_read_dump(void)
+{
+  char path[FN_REFLEN];
+  MY_STAT stat_info;
+  File file;
+  size_t length;
+  uint32_t count= 0;
+
+  fn_format(path, TDC_DUMP_FILE, mysql_data_home, "", MYF(0));
+  if (!mysql_file_stat(key_file_misc, path, &stat_info, MYF(0)) ||
+      !(length= (size_t) stat_info.st_size))
+    return 0;
+  if (!(tdc_load_buff= (uchar*) my_malloc(PSI_INSTRUMENT_ME, length + 1,
+                                          MYF(MY_WME))))
+    return 0;
+  if ((file= mysql_file_open(key_file_misc, path, O_RDONLY | O_BINARY,
+                             MYF(MY_WME))) < 0)
+    return 0;
+  if (mysql_file_read(file, tdc_load_buff, length, MYF(MY_WME | MY_NABP)))
+    length= 0;
+  mysql_file_close(file, MYF(0));
+  tdc_load_buff[length]= 0;
+
+  /* Every key is two null terminated strings */
+  const char *end= (char*) tdc_load_buff + length;
+  uint32_t max_count= (uint32_t) MY_MIN(tdc_size, length / 4);
+  if (!(tdc_load_keys= (const char**) my_malloc(PSI_INSTRUMENT_ME,
+                                                max_count * sizeof(char*),
+                                                MYF(MY_WME))))
+    return 0;
+  for (const char *key= (char*) tdc_load_buff;
+       key < end && count < max_count; )
+  {
+    const char *table_name= strend(key) + 1;
+    if (table_name >= end || !*key || !*table_name)
+      break;
+    tdc_load_keys[count++]= key;
+    key= strend(table_name) + 1;
+  }
+  return count;
+}
+
+
+/**
+  Open the table definition of a saved key without waiting for locks.
+
+  @return whether the table definition is in the cache
+*/
+
+static bool tdc_load_share(THD *thd, const char *key)
+{
+  LEX_CSTRING db= { key, strlen(key) };
+  LEX_CSTRING table_name= { db.str + db.length + 1, 0 };
+  TABLE_LIST tl;
+  TABLE_SHARE *share;
+
+  table_name.length= strlen(table_name.str);
+  tl.init_one_table(&db, &table_name, 0, TL_READ);
+  MDL_REQUEST_INIT(&tl.mdl_request, MDL_key::TABLE, db.str, table_name.str,
+                   MDL_SHARED_HIGH_PRIO, MDL_EXPLICIT);
+  if (thd->mdl_context.try_acquire_lock(&tl.mdl_request) ||
+      !tl.mdl_request.ticket)
+  {
+    thd->clear_error();
+    return false;
+  }
+  share= tdc_acquire_share(thd, &tl, GTS_TABLE | GTS_VIEW | GTS_NOLOCK);
+  /* Leave the definition in the cache as unused, so that it can be evicted */
+  if (share)
+    tdc_release_share(share);
+  thd->mdl_context.release_lock(tl.mdl_request.ticket);
+  thd->clear_error();
+  return share != 0;
+}
+
+
+static void tdc_load_end(void)
+{
+  sql_print_information("Loaded %u of %u saved table definitions",
+                        tdc_loaded_count.load(std::memory_order_relaxed),
+                        tdc_load_count);
+  tdc_load_pending_count.store(0, std::memory_order_relaxed);
+  my_free(tdc_load_keys);
+  my_free(tdc_load_buff);
+  tdc_load_keys= 0;
+  tdc_load_buff= 0;
+}
+
+
+pthread_handler_t tdc_load_thread(void *arg __attribute__((unused)))
+{
+  THD *thd;
+  uint32_t i;
+
+  my_thread_init();
+  thd= new THD(next_thread_id());
+  thd->thread_stack= (char*) &thd;
+  thd->system_thread= SYSTEM_THREAD_GENERIC;
+  thd->store_globals();
+  thd->security_ctx->skip_grants();
+  thd->set_command(COM_DAEMON);
+  thd->set_psi(PSI_CALL_get_thread());
+  server_threads.insert(thd);
+  thd_proc_info(thd, "Loading table definitions");
+
+  while ((i= tdc_load_next++) < tdc_load_count)
+  {
+    /* Do not evict the definitions that are already loaded */
+    if (thd->killed || tdc_records() >= tdc_size)
+      break;
+    if (tdc_load_share(thd, tdc_load_keys[i]))
+      tdc_loaded_count++;
+    tdc_load_pending_count--;
+  }
+
+  if (!--tdc_load_running)
+    tdc_load_end();
+  server_threads.erase(thd);
+  delete thd;
+  my_thread_end();
+  return 0;
+}
+
+
+/**
+  Start loading the table definitions saved by tdc_dump().
+*/
+
+void tdc_load(void)
+{
+  uint threads;
+  DBUG_ENTER("tdc_load");
+
+  if (!(tdc_load_count= tdc_read_dump()))
+  {
+    my_free(tdc_load_keys);
+    my_free(tdc_load_buff);
+    tdc_load_keys= 0;
+    tdc_load_buff= 0;
+    DBUG_VOID_RETURN;
+  }
+  tdc_load_pending_count= tdc_load_count;
+  threads= MY_MIN(tdc_load_threads, tdc_load_count);
+  tdc_load_running= threads;
+  for (uint i= 0; i < threads; i++)
+  {
+    pthread_t th;
+    int error;
+    if ((error= mysql_thread_create(key_thread_tdc_load, &th,
+                                    &connection_attrib, tdc_load_thread, 0)))
+    {
+      sql_print_warning("Can't create table definition load thread "
+                        "(errno= %d)", error);
+      if (!--tdc_load_running)
+        tdc_load_end();
+    }
+  }
+  DBUG_VOID_RETURN;
+}
+
+
+int show_tdc_load_pending(THD *thd, SHOW_VAR *var, char *buff,
+                          enum enum_var_type scope)
+{
+  var->type= SHOW_UINT;
+  var->value= buff;
+  *(reinterpret_cast<uint32_t*>(buff))=
+    tdc_load_pending_count.load(std::memory_order_relaxed);
+  return 0;
+}
+
+
+int show_tdc_loaded(THD *thd, SHOW_VAR *var, char *buff,
+                    enum enum_var_type scope)
+{
+  var->type= SHOW_UINT;
+  var->value= buff;
+  *(reinterpret_cast<uint32_t*>(buff))=
+    tdc_loaded_count.load(std::memory_order_relaxed);
+  return 0;
+}
+
+
 /**
   Waits until ref_count goes down to given number
 
@@ -64,6 +64,8 @@ struct TDC_element
 extern ulong tdc_size;
 extern ulong tc_size;
 extern uint32 tc_instances;
+extern my_bool tdc_dump_at_shutdown, tdc_load_at_startup;
+extern uint tdc_load_threads;
 
 extern bool tdc_init(void);
 extern void tdc_start_shutdown(void);
@@ -85,6 +87,12 @@ extern int tdc_wait_for_old_version(THD *thd, const char *db,
                                     ulong wait_timeout, uint deadlock_weight);
 extern int tdc_iterate(THD *thd, my_hash_walk_action action, void *argument,
                        bool no_dups= false);
+extern void tdc_dump(void);
+extern void tdc_load(void);
+int show_tdc_load_pending(THD *thd, SHOW_VAR *var, char *buff,
+                          enum enum_var_type scope);
+int show_tdc_loaded(THD *thd, SHOW_VAR *var, char *buff,
+                    enum enum_var_type scope);
 
 extern uint tc_records(void);
 int show_tc_active_instances(THD *thd, SHOW_VAR *var, char *buff,
@@ -51,6 +51,9 @@ int heap_check_heap(const HP_INFO *info, my_bool print_status)
   {
     if (share->keydef[key].algorithm == HA_KEY_ALG_BTREE)
       error|= check_one_rb_key(info, key, share->records, print_status);
+    else if (share->keydef[key].open_addressing)
+      error|= hp_oa_check(share->keydef + key, key, share->records,
+                          print_status);
     else
       error|= check_one_key(share->keydef + key, key, share->records,
 			    share->blength, print_status);
@@ -28,6 +28,52 @@
 
 static handler *heap_create_handler(handlerton *, TABLE_SHARE *, MEM_ROOT *);
 static int heap_prepare_hp_create_info(TABLE *, bool, HP_CREATE_INFO *);
+extern "C" int thd_binlog_format(const MYSQL_THD thd);
+
+struct ha_table_option_struct
+{
+  bool concurrent_access;
+};
+
+/*
+  CONCURRENT_ACCESS=YES lets readers and writers use the table at the same
+  time. THR_LOCK does not serialize the statements, every row operation
+  latches the table instead, see heap_latch(). Statements that change the
+  table lock the rows they read until they have changed them, see
+  ha_heap::lock_row().
+*/
+ha_create_table_option heap_table_option_list[]=
+{
+  HA_TOPTION_BOOL("CONCURRENT_ACCESS", concurrent_access, 0),
+  HA_TOPTION_END
+};
+
+
+/*
+  Latch of a CONCURRENT_ACCESS table, held for one row operation.
+  Does nothing for other tables or with HP_LATCH_NONE.
+*/
+
+class Heap_latch
+{
+  HP_INFO *info;
+public:
+  Heap_latch(HP_INFO *info_arg, enum hp_latch_mode mode) :info(info_arg)
+  {
+    if (mode != HP_LATCH_NONE)
+      heap_latch(info, mode);
+  }
+  ~Heap_latch() { heap_unlatch(info); }
+};
+
+
+/* Lookups on open addressing keys of CONCURRENT_ACCESS tables don't latch */
+
+static enum hp_latch_mode heap_read_latch(HP_INFO *info, uint inx)
+{
+  return (info->s->concurrent && info->s->keydef[inx].open_addressing ?
+          HP_LATCH_NONE : HP_LATCH_READ);
+}
 
 
 static int heap_panic(handlerton *hton, ha_panic_function flag)
@@ -54,6 +100,7 @@ int heap_init(void *p)
   heap_hton->panic=      heap_panic;
   heap_hton->drop_table= heap_drop_table;
   heap_hton->flags=      HTON_CAN_RECREATE;
+  heap_hton->table_options= heap_table_option_list;
 
   return 0;
 }
@@ -72,7 +119,7 @@ static handler *heap_create_handler(handlerton *hton,
 
 ha_heap::ha_heap(handlerton *hton, TABLE_SHARE *table_arg)
   :handler(hton, table_arg), file(0), records_changed(0), key_stat_version(0), 
-  internal_table(0)
+  internal_table(0), lock_rows(0)
 {}
 
 /*
@@ -236,13 +283,14 @@ int ha_heap::write_row(const uchar * buf)
     if ((res= update_auto_increment()))
       return res;
   }
+  Heap_latch latch(file, HP_LATCH_WRITE);
   res= heap_write(file,buf);
   if (!res && (++records_changed*HEAP_STATS_UPDATE_THRESHOLD > 
                file->s->records))
   {
     /*
        We can perform this safely since only one writer at the time is
-       allowed on the table.
+       allowed on the table, or the table is latched.
     */
     records_changed= 0;
     file->s->key_stat_version++;
@@ -253,13 +301,14 @@ int ha_heap::write_row(const uchar * buf)
 int ha_heap::update_row(const uchar * old_data, const uchar * new_data)
 {
   int res;
+  Heap_latch latch(file, HP_LATCH_WRITE);
   res= heap_update(file,old_data,new_data);
   if (!res && ++records_changed*HEAP_STATS_UPDATE_THRESHOLD > 
               file->s->records)
   {
     /*
        We can perform this safely since only one writer at the time is
-       allowed on the table.
+       allowed on the table, or the table is latched.
     */
     records_changed= 0;
     file->s->key_stat_version++;
@@ -270,13 +319,14 @@ int ha_heap::update_row(const uchar * old_data, const uchar * new_data)
 int ha_heap::delete_row(const uchar * buf)
 {
   int res;
+  Heap_latch latch(file, HP_LATCH_WRITE);
   res= heap_delete(file,buf);
   if (!res && table->s->tmp_table == NO_TMP_TABLE && 
       ++records_changed*HEAP_STATS_UPDATE_THRESHOLD > file->s->records)
   {
     /*
        We can perform this safely since only one writer at the time is
-       allowed on the table.
+       allowed on the table, or the table is latched.
     */
     records_changed= 0;
     file->s->key_stat_version++;
@@ -289,7 +339,14 @@ int ha_heap::index_read_map(uchar *buf, const uchar *key,
                             enum ha_rkey_function find_flag)
 {
   DBUG_ASSERT(inited==INDEX);
-  int error = heap_rkey(file,buf,active_index, key, keypart_map, find_flag);
+  int error;
+  heap_row_unlock(file);
+  do
+  {
+    Heap_latch latch(file, heap_read_latch(file, active_index));
+    error= heap_rkey(file,buf,active_index, key, keypart_map, find_flag);
+  } while (!error && lock_rows && (error= lock_row(buf)) ==
+           HA_ERR_RECORD_DELETED);
   return error;
 }
 
@@ -297,8 +354,15 @@ int ha_heap::index_read_last_map(uchar *buf, const uchar *key,
                                  key_part_map keypart_map)
 {
   DBUG_ASSERT(inited==INDEX);
-  int error= heap_rkey(file, buf, active_index, key, keypart_map,
-		       HA_READ_PREFIX_LAST);
+  int error;
+  heap_row_unlock(file);
+  do
+  {
+    Heap_latch latch(file, heap_read_latch(file, active_index));
+    error= heap_rkey(file, buf, active_index, key, keypart_map,
+                     HA_READ_PREFIX_LAST);
+  } while (!error && lock_rows && (error= lock_row(buf)) ==
+           HA_ERR_RECORD_DELETED);
   return error;
 }
 
@@ -306,24 +370,52 @@ int ha_heap::index_read_idx_map(uchar *buf, uint index, const uchar *key,
                                 key_part_map keypart_map,
                                 enum ha_rkey_function find_flag)
 {
-  int error = heap_rkey(file, buf, index, key, keypart_map, find_flag);
+  int error;
+  heap_row_unlock(file);
+  do
+  {
+    Heap_latch latch(file, heap_read_latch(file, index));
+    error= heap_rkey(file, buf, index, key, keypart_map, find_flag);
+  } while (!error && lock_rows && (error= lock_row(buf)) ==
+           HA_ERR_RECORD_DELETED);
   return error;
 }
 
 int ha_heap::index_next(uchar * buf)
 {
   DBUG_ASSERT(inited==INDEX);
-  int error=heap_rnext(file,buf);
+  int error;
+  heap_row_unlock(file);
+  do
+  {
+    Heap_latch latch(file, HP_LATCH_READ);
+    error=heap_rnext(file,buf);
+  } while (!error && lock_rows && (error= lock_row(buf)) ==
+           HA_ERR_RECORD_DELETED);
   return error;
 }
 
 int ha_heap::index_prev(uchar * buf)
 {
   DBUG_ASSERT(inited==INDEX);
-  int error=heap_rprev(file,buf);
+  int error;
+  heap_row_unlock(file);
+  do
+  {
+    Heap_latch latch(file, HP_LATCH_READ);
+    error=heap_rprev(file,buf);
+  } while (!error && lock_rows && (error= lock_row(buf)) ==
+           HA_ERR_RECORD_DELETED);
   return error;
 }
 
+int ha_heap::index_end()
+{
+  heap_row_unlock(file);
+  active_index= MAX_KEY;
+  return 0;
+}
+
 int ha_heap::index_first(uchar * buf)
 {
   DBUG_ASSERT(inited==INDEX);
@@ -343,9 +435,23 @@ int ha_heap::rnd_init(bool scan)
   return scan ? heap_scan_init(file) : 0;
 }
 
+int ha_heap::rnd_end()
+{
+  heap_row_unlock(file);
+  return 0;
+}
+
 int ha_heap::rnd_next(uchar *buf)
 {
-  int error=heap_scan(file, buf);
+  int error;
+  heap_row_unlock(file);
+  {
+    Heap_latch latch(file, HP_LATCH_READ);
+    error=heap_scan(file, buf);
+  }
+  /* A row deleted before it was locked is skipped like other deleted rows */
+  if (!error && lock_rows)
+    error= lock_row(buf);
   return error;
 }
 
@@ -354,7 +460,13 @@ int ha_heap::rnd_pos(uchar * buf, uchar *pos)
   int error;
   HEAP_PTR heap_position;
   memcpy(&heap_position, pos, sizeof(HEAP_PTR));
-  error=heap_rrnd(file, buf, heap_position);
+  heap_row_unlock(file);
+  {
+    Heap_latch latch(file, HP_LATCH_READ);
+    error=heap_rrnd(file, buf, heap_position);
+  }
+  if (!error && lock_rows)
+    error= lock_row(buf);
   return error;
 }
 
@@ -363,9 +475,49 @@ void ha_heap::position(const uchar *record)
   *(HEAP_PTR*) ref= heap_position(file);	// Ref is aligned
 }
 
+
+/*
+  Lock the row just read by a statement that changes a CONCURRENT_ACCESS
+  table, so that no other connection changes it before update_row() or
+  delete_row(). The lock is released by the next read, unlock_row() or
+  the end of the scan.
+
+  RETURN
+    0                         Ok, the row is read again into buf
+    HA_ERR_RECORD_DELETED     The row was changed while waiting, read again
+    HA_ERR_LOCK_WAIT_TIMEOUT  Waited for lock_wait_timeout seconds
+    HA_ERR_ABORTED_BY_USER    The connection was killed while waiting
+*/
+
+int ha_heap::lock_row(uchar *buf)
+{
+  THD *thd= ha_thd();
+  ulonglong wait_ms= thd->variables.lock_wait_timeout * 1000ULL;
+
+  /* Wait in slices of a second to notice KILL */
+  for (;;)
+  {
+    ulong slice= (ulong) MY_MIN(wait_ms, 1000);
+    int error= heap_row_lock(file, buf, thd, slice);
+    if (error != HA_ERR_LOCK_WAIT_TIMEOUT)
+      return error;
+    if (thd_kill_level(thd))
+      return HA_ERR_ABORTED_BY_USER;
+    if (!(wait_ms-= slice))
+      return error;
+  }
+}
+
+
+void ha_heap::unlock_row()
+{
+  heap_row_unlock(file);
+}
+
 int ha_heap::info(uint flag)
 {
   HEAPINFO hp_info;
+  Heap_latch latch(file, HP_LATCH_READ);
 
   (void) heap_info(file,&hp_info,flag);
 
@@ -399,12 +551,16 @@ int ha_heap::extra(enum ha_extra_function operation)
 
 int ha_heap::reset()
 {
+  heap_row_unlock(file);
   return heap_reset(file);
 }
 
 
 int ha_heap::delete_all_rows()
 {
+  /* Other threads may be reading the rows, delete them one by one */
+  if (file->s->concurrent)
+    return HA_ERR_WRONG_COMMAND;
   heap_clear(file);
   if (table->s->tmp_table == NO_TMP_TABLE)
   {
@@ -418,8 +574,33 @@ int ha_heap::delete_all_rows()
 }
 
 
+/*
+  Swap the storage of two internal tables without keys. Such tables are
+  private to the statement and their HP_INFO/HP_SHARE are not shared with
+  anyone, so it's enough to exchange the pointers.
+*/
+
+bool ha_heap::exchange_tmp_table_rows(handler *other)
+{
+  if (other->ht != ht)
+    return true;
+  ha_heap *heap= (ha_heap *) other;
+  DBUG_ASSERT(inited == NONE && heap->inited == NONE);
+  if (!internal_table || !heap->internal_table ||
+      file->s->keys || heap->file->s->keys ||
+      file->s->reclength != heap->file->s->reclength)
+    return true;
+  swap_variables(HP_INFO *, file, heap->file);
+  swap_variables(HP_SHARE *, internal_share, heap->internal_share);
+  swap_variables(ulong, records_changed, heap->records_changed);
+  swap_variables(uint, key_stat_version, heap->key_stat_version);
+  return false;
+}
+
+
 int ha_heap::reset_auto_increment(ulonglong value)
 {
+  Heap_latch latch(file, HP_LATCH_EXCLUSIVE);
   file->s->auto_increment= value;
   return 0;
 }
@@ -427,9 +608,17 @@ int ha_heap::reset_auto_increment(ulonglong value)
 
 int ha_heap::external_lock(THD *thd, int lock_type)
 {
+  /* Other statements change the rows at the same time, see lock_row() */
+  lock_rows= lock_type == F_WRLCK && file->s->concurrent;
+  if (lock_type == F_UNLCK)
+    heap_row_unlock(file);
 #ifndef DBUG_OFF
-  if (lock_type == F_UNLCK && file->s->changed && heap_check_heap(file, 0))
-    return HA_ERR_CRASHED;
+  if (lock_type == F_UNLCK && file->s->changed)
+  {
+    Heap_latch latch(file, HP_LATCH_EXCLUSIVE);
+    if (heap_check_heap(file, 0))
+      return HA_ERR_CRASHED;
+  }
 #endif
   return 0;					// No external locking
 }
@@ -546,6 +735,20 @@ THR_LOCK_DATA **ha_heap::store_lock(THD *thd,
 				    THR_LOCK_DATA **to,
 				    enum thr_lock_type lock_type)
 {
+  /*
+    Writers of a CONCURRENT_ACCESS table latch every row operation and
+    lock the rows they change, so they can let other readers and writers
+    in, like InnoDB does. As in InnoDB, this is only done if the changes
+    are logged as rows or not logged at all: statements logged as text
+    would be replayed in another order than they changed the table.
+    LOCK TABLES and INSERT DELAYED keep the requested lock.
+  */
+  if (file->s->concurrent && !thd_in_lock_tables(thd) &&
+      lock_type >= TL_WRITE_CONCURRENT_INSERT && lock_type <= TL_WRITE &&
+      lock_type != TL_WRITE_DELAYED &&
+      (thd_binlog_format(thd) == BINLOG_FORMAT_ROW ||
+       thd_binlog_format(thd) == BINLOG_FORMAT_UNSPEC))
+    lock_type= TL_WRITE_ALLOW_WRITE;
   if (lock_type != TL_IGNORE && file->lock.type == TL_UNLOCK)
     file->lock.type=lock_type;
   *to++= &file->lock;
@@ -715,6 +918,8 @@ static int heap_prepare_hp_create_info(TABLE *table_arg, bool internal_table,
   hp_create_info->max_table_size=current_thd->variables.max_heap_table_size;
   hp_create_info->with_auto_increment= found_real_auto_increment;
   hp_create_info->internal_table= internal_table;
+  hp_create_info->concurrent= (!internal_table && share->option_struct &&
+                               share->option_struct->concurrent_access);
 
   max_rows= (ha_rows) (hp_create_info->max_table_size / mem_per_row);
   if (share->max_rows && share->max_rows < max_rows)
@@ -736,6 +941,20 @@ int ha_heap::create(const char *name, TABLE *table_arg,
   my_bool created;
   HP_CREATE_INFO hp_create_info;
 
+  /* Readers of a BTREE index can not resume after a concurrent change */
+  if (table_arg->s->option_struct &&
+      table_arg->s->option_struct->concurrent_access)
+  {
+    for (uint i= 0; i < table_arg->s->keys; i++)
+    {
+      if (table_arg->key_info[i].algorithm == HA_KEY_ALG_BTREE)
+      {
+        my_error(ER_ILLEGAL_HA_CREATE_OPTION, MYF(0), "MEMORY",
+                 "CONCURRENT_ACCESS with BTREE indexes");
+        return HA_WRONG_CREATE_OPTION;
+      }
+    }
+  }
   error= heap_prepare_hp_create_info(table_arg, internal_table,
                                      &hp_create_info);
   if (error)
@@ -761,6 +980,19 @@ void ha_heap::get_auto_increment(ulonglong offset, ulonglong increment,
                                  ulonglong *first_value,
                                  ulonglong *nb_reserved_values)
 {
+  if (file->s->concurrent && table->s->next_number_keypart == 0)
+  {
+    /*
+      Other threads insert at the same time: reserve the values, the
+      server uses at most nb_desired_values steps of increment from
+      first_value.
+    */
+    Heap_latch latch(file, HP_LATCH_EXCLUSIVE);
+    *first_value= file->s->auto_increment + 1;
+    *nb_reserved_values= MY_MAX(nb_desired_values, 1);
+    file->s->auto_increment+= *nb_reserved_values * increment;
+    return;
+  }
   ha_heap::info(HA_STATUS_AUTO);
   *first_value= stats.auto_increment_value;
   /* such table has only table-level locking so reserves up to +inf */
@@ -772,7 +1004,10 @@ bool ha_heap::check_if_incompatible_data(HA_CREATE_INFO *info,
 					 uint table_changes)
 {
   /* Check that auto_increment value was not changed */
-  if ((info->used_fields & HA_CREATE_USED_AUTO &&
+  if ((info->option_struct && table_share->option_struct &&
+       info->option_struct->concurrent_access !=
+       table_share->option_struct->concurrent_access) ||
+      (info->used_fields & HA_CREATE_USED_AUTO &&
        info->auto_increment_value != 0) ||
       table_changes == IS_EQUAL_NO ||
       table_changes & IS_EQUAL_PACK_LENGTH) // Not implemented yet
@@ -805,6 +1040,17 @@ int ha_heap::find_unique_row(uchar *record, uint unique_idx)
   DBUG_ASSERT(keyinfo->flag & HA_NOSAME);
   if (!share->records)
     DBUG_RETURN(1); // not found
+  if (keyinfo->open_addressing)
+  {
+    uchar *rec= hp_oa_find_record(keyinfo, record);
+    if (!rec)
+      DBUG_RETURN(1); // not found
+    file->current_hash_ptr= 0;
+    file->current_ptr= rec;
+    file->update= HA_STATE_AKTIV;
+    memcpy(record, rec, (size_t) share->reclength);
+    DBUG_RETURN(0); // found and position set
+  }
   HASH_INFO *pos= hp_find_hash(&keyinfo->block,
                                hp_mask(hp_rec_hashnr(keyinfo, record),
                                        share->blength, share->records));
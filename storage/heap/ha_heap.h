@@ -34,6 +34,7 @@ class ha_heap final : public handler
   ulong   records_changed;
   uint    key_stat_version;
   my_bool internal_table;
+  my_bool lock_rows;                    /* See lock_row() */
 public:
   ha_heap(handlerton *hton, TABLE_SHARE *table);
   ~ha_heap() {}
@@ -88,9 +89,11 @@ class ha_heap final : public handler
                          enum ha_rkey_function find_flag);
   int index_next(uchar * buf);
   int index_prev(uchar * buf);
+  int index_end();
   int index_first(uchar * buf);
   int index_last(uchar * buf);
   int rnd_init(bool scan);
+  int rnd_end();
   int rnd_next(uchar *buf);
   int rnd_pos(uchar * buf, uchar *pos);
   void position(const uchar *record);
@@ -99,7 +102,9 @@ class ha_heap final : public handler
   int extra(enum ha_extra_function operation);
   int reset();
   int external_lock(THD *thd, int lock_type);
+  void unlock_row();
   int delete_all_rows(void);
+  bool exchange_tmp_table_rows(handler *other);
   int reset_auto_increment(ulonglong value);
   int disable_indexes(uint mode);
   int enable_indexes(uint mode);
@@ -122,4 +127,5 @@ class ha_heap final : public handler
   int find_unique_row(uchar *record, uint unique_idx);
 private:
   void update_key_stats();
+  int lock_row(uchar *buf);
 };
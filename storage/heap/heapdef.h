@@ -19,6 +19,7 @@
 #include <my_base.h>
 C_MODE_START
 #include <my_pthread.h>
+#include <my_atomic.h>
 #include "heap.h"			/* Structs & some defines */
 #include "my_tree.h"
 
@@ -52,6 +53,105 @@ typedef struct st_hp_hash_info
   ulong hash_of_key;
 } HASH_INFO;
 
+#define HP_OA_GROUP 16			/* Slots probed at once */
+#define HP_OA_INLINE_KEY 8		/* Longest key image kept in a slot */
+
+typedef struct st_hp_oa_slot
+{
+  uchar *ptr_to_rec;
+  ulong hash_of_key;
+  uchar key[HP_OA_INLINE_KEY];
+} HP_OA_SLOT;
+
+/*
+  Slots of an open addressing hash index. tags[] follows slots[] in the
+  same allocation.
+*/
+
+typedef struct st_hp_oa_table
+{
+  struct st_hp_oa_table *next_retired;
+  ulong size;				/* Number of slots */
+  uchar *tags;				/* One per slot, 0 if empty */
+  HP_OA_SLOT *slots;
+} HP_OA_TABLE;
+
+/*
+  A CONCURRENT_ACCESS table has HP_ROW_LOCKS buckets of rows, picked by
+  the position of the row.
+
+  version is a sequence lock: writers make it odd while they change a
+  row of the bucket, under the latch and write_mutex, so readers that do
+  not exclude writers can copy a row and check that it did not change,
+  see hp_read_row().
+
+  owner is the connection that read a row of the bucket for UPDATE or
+  DELETE; other connections wait in heap_row_lock() until it is done
+  with the row.
+*/
+
+#define HP_ROW_LOCKS 1024
+
+typedef struct st_hp_row_lock
+{
+  uint32 version;
+  uint count;				/* heap_row_lock() calls by owner */
+  const void *owner;
+} HP_ROW_LOCK;
+
+static inline HP_ROW_LOCK *hp_row_lock_of(HP_SHARE *share, const uchar *pos)
+{
+  return share->row_locks +
+    ((size_t) pos / share->block.recbuffer) % HP_ROW_LOCKS;
+}
+
+/* Order the reads of a row before reading its version again */
+
+static inline void hp_read_barrier(void)
+{
+#ifdef _MSC_VER
+  MemoryBarrier();
+#else
+  __atomic_thread_fence(__ATOMIC_ACQUIRE);
+#endif
+}
+
+/* Order the version change before the writes of the row */
+
+static inline void hp_write_barrier(void)
+{
+#ifdef _MSC_VER
+  MemoryBarrier();
+#else
+  __atomic_thread_fence(__ATOMIC_RELEASE);
+#endif
+}
+
+/* Start and end the change of a row of a CONCURRENT_ACCESS table */
+
+static inline void hp_row_change_begin(HP_SHARE *share, const uchar *pos)
+{
+  if (share->concurrent)
+  {
+    HP_ROW_LOCK *lock= hp_row_lock_of(share, pos);
+    DBUG_ASSERT(!(lock->version & 1));
+    my_atomic_store32_explicit((int32*) &lock->version, lock->version + 1,
+                               MY_MEMORY_ORDER_RELAXED);
+    hp_write_barrier();
+  }
+}
+
+static inline void hp_row_change_end(HP_SHARE *share, const uchar *pos)
+{
+  if (share->concurrent)
+  {
+    HP_ROW_LOCK *lock= hp_row_lock_of(share, pos);
+    DBUG_ASSERT(lock->version & 1);
+    my_atomic_store32_explicit((int32*) &lock->version, lock->version + 1,
+                               MY_MEMORY_ORDER_RELEASE);
+  }
+}
+
 typedef struct {
   HA_KEYSEG *keyseg;
   uint key_length;
@@ -62,6 +162,7 @@ typedef struct {
 
 extern HP_SHARE *hp_find_named_heap(const char *name);
 extern int hp_rectest(HP_INFO *info,const uchar *old);
+extern my_bool hp_read_row(HP_INFO *info, uchar *record, const uchar *pos);
 extern uchar *hp_find_block(HP_BLOCK *info,ulong pos);
 extern int hp_get_new_block(HP_SHARE *info, HP_BLOCK *block,
                             size_t* alloc_length);
@@ -81,6 +182,10 @@ extern uchar *hp_search(HP_INFO *info,HP_KEYDEF *keyinfo,const uchar *key,
 		       uint nextflag);
 extern uchar *hp_search_next(HP_INFO *info, HP_KEYDEF *keyinfo,
 			    const uchar *key, HASH_INFO *pos);
+extern int hp_collect_key_matches(HP_INFO *info, HP_KEYDEF *keyinfo,
+				  const uchar *key);
+extern uchar *hp_next_key_match(HP_INFO *info, HP_KEYDEF *keyinfo, int step);
+extern ulong hp_hashnr(HP_KEYDEF *keydef, const uchar *key);
 extern ulong hp_rec_hashnr(HP_KEYDEF *keyinfo,const uchar *rec);
 extern void hp_movelink(HASH_INFO *pos,HASH_INFO *next_link,
 			 HASH_INFO *newlink);
@@ -95,6 +200,20 @@ extern uint hp_rb_key_length(HP_KEYDEF *keydef, const uchar *key);
 extern uint hp_rb_null_key_length(HP_KEYDEF *keydef, const uchar *key);
 extern uint hp_rb_var_key_length(HP_KEYDEF *keydef, const uchar *key);
 extern my_bool hp_if_null_in_key(HP_KEYDEF *keyinfo, const uchar *record);
+extern void hp_oa_init(HP_KEYDEF *keyinfo);
+extern int hp_oa_write_key(HP_INFO *info, HP_KEYDEF *keyinfo,
+			   const uchar *record, uchar *recpos);
+extern int hp_oa_delete_key(HP_INFO *info, HP_KEYDEF *keyinfo,
+			    const uchar *record, uchar *recpos, int flag);
+extern uchar *hp_oa_search(HP_INFO *info, HP_KEYDEF *keyinfo,
+			   const uchar *key, uint nextflag);
+extern uchar *hp_oa_find_record(HP_KEYDEF *keyinfo, const uchar *record);
+extern uchar *hp_oa_read(HP_INFO *info, HP_KEYDEF *keyinfo, const uchar *key,
+			 uchar *record);
+extern my_bool hp_oa_needs_resize(HP_KEYDEF *keyinfo, uint keys);
+extern void hp_oa_clear(HP_KEYDEF *keyinfo);
+extern int hp_oa_check(HP_KEYDEF *keydef, uint keynr, ulong records,
+		       my_bool print_status);
 extern int hp_close(HP_INFO *info);
 extern void hp_clear(HP_SHARE *info);
 extern void hp_clear_keys(HP_SHARE *info);
@@ -107,6 +226,11 @@ extern PSI_memory_key hp_key_memory_HP_SHARE;
 extern PSI_memory_key hp_key_memory_HP_INFO;
 extern PSI_memory_key hp_key_memory_HP_PTRS;
 extern PSI_memory_key hp_key_memory_HP_KEYDEF;
+extern PSI_memory_key hp_key_memory_HP_OA_HASH;
+extern PSI_rwlock_key hp_key_rwlock_HP_SHARE_latch;
+extern PSI_mutex_key hp_key_mutex_HP_SHARE_write_mutex;
+extern PSI_mutex_key hp_key_mutex_HP_SHARE_row_lock_mutex;
+extern PSI_cond_key hp_key_cond_HP_SHARE_row_lock_cond;
 
 #ifdef HAVE_PSI_INTERFACE
 void init_heap_psi_keys();
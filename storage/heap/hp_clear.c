@@ -93,6 +93,8 @@ void hp_clear_keys(HP_SHARE *info)
     {
       delete_tree(&keyinfo->rb_tree, 0);
     }
+    else if (keyinfo->open_addressing)
+      hp_oa_clear(keyinfo);
     else
     {
       HP_BLOCK *block= &keyinfo->block;
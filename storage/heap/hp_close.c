@@ -36,6 +36,11 @@ int hp_close(register HP_INFO *info)
   int error=0;
   DBUG_ENTER("hp_close");
   info->s->changed=0;
+  if (info->s->concurrent)
+  {
+    heap_row_unlock(info);
+    delete_dynamic(&info->key_matches);
+  }
   if (info->open_list.data)
     heap_open_list=list_delete(heap_open_list,&info->open_list);
   if (!--info->s->open_count && info->s->delete_on_close)
@@ -195,14 +195,24 @@ int heap_create(const char *name, HP_CREATE_INFO *create_info,
                       MY_TREE_WITH_DELETE));
 	keyinfo->delete_key= hp_rb_delete_key;
 	keyinfo->write_key= hp_rb_write_key;
+        keyinfo->open_addressing= 0;
       }
       else
       {
-	init_block(&keyinfo->block, sizeof(HASH_INFO), min_records,
-		   max_records);
-	keyinfo->delete_key= hp_delete_key;
-	keyinfo->write_key= hp_write_key;
-        keyinfo->hash_buckets= 0;
+        hp_oa_init(keyinfo);
+        if (keyinfo->open_addressing)
+        {
+          keyinfo->delete_key= hp_oa_delete_key;
+          keyinfo->write_key= hp_oa_write_key;
+        }
+        else
+        {
+          init_block(&keyinfo->block, sizeof(HASH_INFO), min_records,
+                     max_records);
+          keyinfo->delete_key= hp_delete_key;
+          keyinfo->write_key= hp_write_key;
+          keyinfo->hash_buckets= 0;
+        }
       }
       if ((keyinfo->flag & HA_AUTO_KEY) && create_info->with_auto_increment)
         share->auto_key= i + 1;
@@ -222,9 +232,25 @@ int heap_create(const char *name, HP_CREATE_INFO *create_info,
     share->auto_increment= create_info->auto_increment;
     share->create_time= (long) time((time_t*) 0);
     share->internal= create_info->internal_table;
+    share->concurrent= create_info->concurrent && !share->internal;
+    if (share->concurrent)
+    {
+      share->shared_writes= 1;
+      for (i= 0; i < keys; i++)
+        share->shared_writes&= share->keydef[i].open_addressing;
+      if (!(share->row_locks= (HP_ROW_LOCK*)
+            my_malloc(hp_key_memory_HP_SHARE,
+                      HP_ROW_LOCKS * sizeof(HP_ROW_LOCK),
+                      MYF(MY_ZEROFILL))))
+      {
+        my_free(share);
+        goto err;
+      }
+    }
     /* Must be allocated separately for rename to work */
     if (!(share->name= my_strdup(hp_key_memory_HP_SHARE, name, MYF(0))))
     {
+      my_free(share->row_locks);
       my_free(share);
       goto err;
     }
@@ -232,6 +258,16 @@ int heap_create(const char *name, HP_CREATE_INFO *create_info,
     if (!create_info->internal_table)
     {
       thr_lock_init(&share->lock);
+      if (share->concurrent)
+      {
+        mysql_rwlock_init(hp_key_rwlock_HP_SHARE_latch, &share->latch);
+        mysql_mutex_init(hp_key_mutex_HP_SHARE_write_mutex,
+                         &share->write_mutex, MY_MUTEX_INIT_FAST);
+        mysql_mutex_init(hp_key_mutex_HP_SHARE_row_lock_mutex,
+                         &share->row_lock_mutex, MY_MUTEX_INIT_FAST);
+        mysql_cond_init(hp_key_cond_HP_SHARE_row_lock_cond,
+                        &share->row_lock_cond, NULL);
+      }
       share->open_list.data= (void*) share;
       heap_share_list= list_add(heap_share_list,&share->open_list);
     }
@@ -360,8 +396,16 @@ void hp_free(HP_SHARE *share)
   {
     heap_share_list= list_delete(heap_share_list, &share->open_list);
     thr_lock_delete(&share->lock);
+    if (share->concurrent)
+    {
+      mysql_rwlock_destroy(&share->latch);
+      mysql_mutex_destroy(&share->write_mutex);
+      mysql_mutex_destroy(&share->row_lock_mutex);
+      mysql_cond_destroy(&share->row_lock_cond);
+    }
   }
   hp_clear(share);			/* Remove blocks from memory */
+  my_free(share->row_locks);
   my_free(share->name);
   my_free(share);
   return;
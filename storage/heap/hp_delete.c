@@ -33,6 +33,7 @@ int heap_delete(HP_INFO *info, const uchar *record)
 
   if ( --(share->records) < share->blength >> 1) share->blength>>=1;
   pos=info->current_ptr;
+  hp_row_change_begin(share, pos);
 
   p_lastinx = share->keydef + info->lastinx;
   for (keydef = share->keydef, end = keydef + share->keys; keydef < end; 
@@ -46,6 +47,7 @@ int heap_delete(HP_INFO *info, const uchar *record)
   *((uchar**) pos)=share->del_link;
   share->del_link=pos;
   pos[share->visible]=0;		/* Record deleted */
+  hp_row_change_end(share, pos);
   share->deleted++;
   share->key_version++;
 #if !defined(DBUG_OFF) && defined(EXTRA_HEAP_DEBUG)
@@ -54,6 +56,7 @@ int heap_delete(HP_INFO *info, const uchar *record)
 
   DBUG_RETURN(0);
 err:
+  hp_row_change_end(share, pos);
   if (++(share->records) == share->blength)
     share->blength+= share->blength;
   DBUG_RETURN(my_errno);
@@ -20,6 +20,7 @@
 /* - Reset recordpointers as after open database */
 
 #include "heapdef.h"
+#include <my_cpu.h>
 
 static void heap_extra_keyflag(register HP_INFO *info,
                                enum ha_extra_function function);
@@ -63,6 +64,221 @@ int heap_reset(HP_INFO *info)
 }
 
 
+/*
+  TRUE if a write may change what readers under the shared latch walk:
+  the block tree of the rows, when a row is added after the last one, or
+  the slots of an open addressing key, when they are resized
+*/
+
+static my_bool hp_write_needs_exclusive(HP_SHARE *share)
+{
+  HP_KEYDEF *keydef, *end;
+
+  if (!share->del_link && !(share->records % share->block.records_in_block))
+    return 1;
+  for (keydef= share->keydef, end= keydef + share->keys; keydef < end;
+       keydef++)
+  {
+    if (hp_oa_needs_resize(keydef, 1))
+      return 1;
+  }
+  return 0;
+}
+
+
+/*
+  Latch a CONCURRENT_ACCESS table for one row operation. Other tables are
+  protected by THR_LOCK alone and are not latched.
+
+  NOTES
+    Readers share the latch. Writers share it too if all keys use open
+    addressing, and take write_mutex instead, so that they exclude each
+    other but not the readers; see hp_read_row() for how readers copy
+    the rows. Writes that change the chained hash keys, or that allocate
+    memory the readers walk, take the latch exclusively.
+*/
+
+void heap_latch(HP_INFO *info, enum hp_latch_mode mode)
+{
+  HP_SHARE *share= info->s;
+
+  if (!share->concurrent)
+    return;
+  DBUG_ASSERT(info->latched == HP_LATCH_NONE && mode != HP_LATCH_NONE);
+  switch (mode) {
+  case HP_LATCH_READ:
+    mysql_rwlock_rdlock(&share->latch);
+    break;
+  case HP_LATCH_WRITE:
+    if (share->shared_writes)
+    {
+      mysql_rwlock_rdlock(&share->latch);
+      mysql_mutex_lock(&share->write_mutex);
+      if (!hp_write_needs_exclusive(share))
+        break;
+      mysql_mutex_unlock(&share->write_mutex);
+      mysql_rwlock_unlock(&share->latch);
+    }
+    mode= HP_LATCH_EXCLUSIVE;
+    /* fall through */
+  default:
+    mysql_rwlock_wrlock(&share->latch);
+  }
+  info->latched= mode;
+}
+
+
+void heap_unlatch(HP_INFO *info)
+{
+  switch (info->latched) {
+  case HP_LATCH_NONE:
+    return;
+  case HP_LATCH_WRITE:
+    mysql_mutex_unlock(&info->s->write_mutex);
+    /* fall through */
+  default:
+    mysql_rwlock_unlock(&info->s->latch);
+  }
+  info->latched= HP_LATCH_NONE;
+}
+
+
+/*
+  Copy a row unless it is deleted
+
+  NOTES
+    Unless the table is latched for writing, writers of a CONCURRENT_ACCESS
+    table may be changing the row. The row is then copied again until the
+    version of its bucket (see HP_ROW_LOCK) shows that no writer changed
+    it during the copy.
+
+  RETURN
+    0  ok
+    1  the row is deleted
+*/
+
+my_bool hp_read_row(HP_INFO *info, uchar *record, const uchar *pos)
+{
+  HP_SHARE *share= info->s;
+  HP_ROW_LOCK *lock;
+  uint32 version;
+  my_bool deleted;
+
+  if (!share->concurrent || info->latched >= HP_LATCH_WRITE)
+  {
+    if (!pos[share->visible])
+      return 1;
+    memcpy(record, pos, (size_t) share->reclength);
+    return 0;
+  }
+  lock= hp_row_lock_of(share, pos);
+  for (;;)
+  {
+    version= (uint32) my_atomic_load32_explicit((int32*) &lock->version,
+                                                MY_MEMORY_ORDER_ACQUIRE);
+    if (version & 1)
+    {
+      MY_RELAX_CPU();
+      continue;
+    }
+    if (!(deleted= !pos[share->visible]))
+      memcpy(record, pos, (size_t) share->reclength);
+    hp_read_barrier();
+    if (version == (uint32) my_atomic_load32_explicit((int32*) &lock->version,
+                                                      MY_MEMORY_ORDER_RELAXED))
+      return deleted;
+  }
+}
+
+
+/*
+  Lock the current row of a CONCURRENT_ACCESS table for UPDATE or DELETE
+
+  SYNOPSIS
+    heap_row_lock()
+    info	Table handler, not latched, positioned on a row
+    record	The row is read again into it
+    owner	Connection; its handlers share the locks it holds
+    timeout_ms	How long to wait for another owner
+
+  NOTES
+    The lock is on the bucket of the row, see HP_ROW_LOCK, and is held
+    until heap_row_unlock(). Rows are updated and deleted only by the
+    owner of their bucket, and inserts only reuse deleted rows, so the
+    row read again stays as it is until it is unlocked. heap_update()
+    and heap_delete() can then not find it changed.
+
+  RETURN
+    0				Ok, the row is in record
+    HA_ERR_RECORD_DELETED	The row was deleted while waiting, or
+				does no longer have the key of the
+				index read. The row is not locked.
+    HA_ERR_LOCK_WAIT_TIMEOUT	The row is not locked
+*/
+
+int heap_row_lock(HP_INFO *info, uchar *record, const void *owner,
+                  ulong timeout_ms)
+{
+  HP_SHARE *share= info->s;
+  HP_ROW_LOCK *lock= hp_row_lock_of(share, info->current_ptr);
+  DBUG_ENTER("heap_row_lock");
+  DBUG_ASSERT(share->concurrent && !info->row_lock);
+  DBUG_ASSERT(info->latched == HP_LATCH_NONE);
+
+  mysql_mutex_lock(&share->row_lock_mutex);
+  if (lock->owner && lock->owner != owner)
+  {
+    struct timespec abstime;
+    int error= 0;
+    set_timespec_nsec(abstime, timeout_ms * 1000000ULL);
+    share->row_lock_waiters++;
+    while (lock->owner && !error)
+      error= mysql_cond_timedwait(&share->row_lock_cond,
+                                  &share->row_lock_mutex, &abstime);
+    share->row_lock_waiters--;
+    if (lock->owner)
+    {
+      mysql_mutex_unlock(&share->row_lock_mutex);
+      DBUG_RETURN(my_errno= HA_ERR_LOCK_WAIT_TIMEOUT);
+    }
+  }
+  lock->owner= owner;
+  lock->count++;
+  mysql_mutex_unlock(&share->row_lock_mutex);
+  info->row_lock= lock;
+
+  /* Another connection may have changed the row before it was locked */
+  if (hp_read_row(info, record, info->current_ptr) ||
+      (info->lastinx >= 0 &&
+       hp_key_cmp(share->keydef + info->lastinx, record, info->lastkey)))
+  {
+    heap_row_unlock(info);
+    DBUG_RETURN(my_errno= HA_ERR_RECORD_DELETED);
+  }
+  DBUG_RETURN(0);
+}
+
+
+void heap_row_unlock(HP_INFO *info)
+{
+  HP_SHARE *share= info->s;
+  HP_ROW_LOCK *lock= info->row_lock;
+
+  if (!lock)
+    return;
+  info->row_lock= 0;
+  mysql_mutex_lock(&share->row_lock_mutex);
+  DBUG_ASSERT(lock->owner && lock->count);
+  if (!--lock->count)
+  {
+    lock->owner= 0;
+    if (share->row_lock_waiters)
+      mysql_cond_broadcast(&share->row_lock_cond);
+  }
+  mysql_mutex_unlock(&share->row_lock_mutex);
+}
+
+
 /*
     Start/Stop Inserting Duplicates Into a Table, WL#1648.
  */
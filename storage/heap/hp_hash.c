@@ -28,7 +28,6 @@ hp_charpos(CHARSET_INFO *cs, const uchar *b, const uchar *e, size_t num)
 }
 
 
-static ulong hp_hashnr(HP_KEYDEF *keydef, const uchar *key);
 /*
   Find out how many rows there is in the given range
 
@@ -114,6 +113,8 @@ uchar *hp_search(HP_INFO *info, HP_KEYDEF *keyinfo, const uchar *key,
   uint old_nextflag;
   HP_SHARE *share=info->s;
   DBUG_ENTER("hp_search");
+  if (keyinfo->open_addressing)
+    DBUG_RETURN(hp_oa_search(info, keyinfo, key, nextflag));
   old_nextflag=nextflag;
   prev_ptr=0;
 
@@ -201,6 +202,69 @@ uchar *hp_search_next(HP_INFO *info, HP_KEYDEF *keyinfo, const uchar *key,
 }
 
 
+/*
+  Remember the rows with the key for heap_rnext() and heap_rprev()
+
+  SYNOPSIS
+    hp_collect_key_matches()
+    info	Table handler, positioned by hp_search() on the first row
+    keyinfo	Non-unique hash key
+    key		Search key
+
+  NOTES
+    Used for CONCURRENT_ACCESS tables, where other threads can change the
+    hash chain between the calls. The rows themselves stay in place.
+
+  RETURN
+    0		ok
+    #		error
+*/
+
+int hp_collect_key_matches(HP_INFO *info, HP_KEYDEF *keyinfo,
+                           const uchar *key)
+{
+  HASH_INFO *pos;
+  DBUG_ENTER("hp_collect_key_matches");
+
+  reset_dynamic(&info->key_matches);
+  info->key_match= 0;
+  for (pos= info->current_hash_ptr; pos; pos= pos->next_key)
+  {
+    if (!hp_key_cmp(keyinfo, pos->ptr_to_rec, key) &&
+        insert_dynamic(&info->key_matches, (uchar*) &pos->ptr_to_rec))
+      DBUG_RETURN(my_errno= HA_ERR_OUT_OF_MEM);
+  }
+  info->current_hash_ptr= 0;
+  DBUG_RETURN(0);
+}
+
+
+/*
+  Next (step 1) or previous (step -1) row of hp_collect_key_matches()
+  that is not deleted and still has the key in info->lastkey
+*/
+
+uchar *hp_next_key_match(HP_INFO *info, HP_KEYDEF *keyinfo, int step)
+{
+  ulong i= info->key_match;
+  DBUG_ENTER("hp_next_key_match");
+
+  /* Before the first row i wraps around to ~0 */
+  while ((i+= step) < info->key_matches.elements)
+  {
+    uchar *pos= *dynamic_element(&info->key_matches, i, uchar**);
+    if (pos[info->s->visible] && !hp_key_cmp(keyinfo, pos, info->lastkey))
+    {
+      info->key_match= i;
+      DBUG_RETURN(info->current_ptr= pos);
+    }
+  }
+  info->key_match= step > 0 ? info->key_matches.elements : ~0UL;
+  my_errno= HA_ERR_KEY_NOT_FOUND;
+  DBUG_RETURN(info->current_ptr= 0);
+}
+
+
 /*
   Change
     next_link -> ... -> X -> pos
@@ -222,7 +286,7 @@ void hp_movelink(HASH_INFO *pos, HASH_INFO *next_link, HASH_INFO *newlink)
 
 	/* Calc hashvalue for a key */
 
-static ulong hp_hashnr(HP_KEYDEF *keydef, const uchar *key)
+ulong hp_hashnr(HP_KEYDEF *keydef, const uchar *key)
 {
   /*register*/ 
   ulong nr=1, nr2=4;
@@ -0,0 +1,627 @@
+/*
+   Copyright (c) 2021, MariaDB Corporation.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; version 2 of the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1335 USA */
+
+/*
+  Open addressing hash index for unique HASH keys
+
+  The linear hash in hp_hash.c / hp_write.c chains the keys of one bucket
+  through HASH_INFO entries that are spread over the HP_BLOCK tree, so every
+  probe follows several pointers and compares the key in the record. A
+  unique key has no chains to walk, and is kept instead in a flat table:
+
+  - slots[] holds the record pointer, the hash value and, for short keys
+    that are compared byte by byte, the key image itself
+  - tags[] holds one byte per slot: HP_OA_EMPTY, HP_OA_DELETED or
+    0x80 | 7 bits of the hash
+
+  Slots are probed in groups of HP_OA_GROUP; the tags of a group are
+  compared to the tag of the key at once (with SSE2 when available) and
+  only the slots with a matching tag are looked at. The groups are visited
+  in triangular order, which covers all of them as their number is a power
+  of two. A search stops at the first group that has an empty slot.
+
+  Keys with NULL parts that are not equal to each other (HA_NULL_PART_KEY)
+  can have duplicates, so they use the chained hash.
+
+  Lookups on a CONCURRENT_ACCESS table do not latch it, see hp_oa_read().
+  Writers change slots and tags in place, and a slot is written before
+  its tag. hp_oa_resize() builds a new table and keeps the old one
+  until the index is cleared, as readers may still be probing it.
+*/
+
+#include "heapdef.h"
+#include <my_bit.h>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#define HP_OA_EMPTY   0
+#define HP_OA_DELETED 1
+#define HP_OA_MIN_SIZE 64
+
+static inline ulonglong hp_oa_mix(ulong hash)
+{
+  return (ulonglong) hash * 0x9E3779B97F4A7C15ULL;
+}
+
+static inline uchar hp_oa_tag(ulong hash)
+{
+  return (uchar) (0x80 | ((hp_oa_mix(hash) >> 25) & 0x7f));
+}
+
+static inline ulong hp_oa_first_group(const HP_OA_TABLE *table, ulong hash)
+{
+  return (ulong) (hp_oa_mix(hash) >> 32) & (table->size / HP_OA_GROUP - 1);
+}
+
+
+/* Bit i is set if tags[i] == tag */
+
+static inline uint hp_oa_match(const uchar *tags, uchar tag)
+{
+#ifdef __SSE2__
+  __m128i group= _mm_loadu_si128((const __m128i*) tags);
+  return (uint) _mm_movemask_epi8(_mm_cmpeq_epi8(group,
+                                                 _mm_set1_epi8((char) tag)));
+#else
+  uint i, mask= 0;
+  for (i= 0; i < HP_OA_GROUP; i++)
+    mask|= (uint) (tags[i] == tag) << i;
+  return mask;
+#endif
+}
+
+
+/*
+  Set up the key at table creation. All keys that can not be compared by
+  their image go through hp_rec_key_cmp() / hp_key_cmp().
+*/
+
+void hp_oa_init(HP_KEYDEF *keyinfo)
+{
+  HA_KEYSEG *seg, *end;
+  uint length= 0;
+
+  bzero(&keyinfo->oa, sizeof(keyinfo->oa));
+  keyinfo->open_addressing=
+    (keyinfo->flag & (HA_NOSAME | HA_NULL_PART_KEY)) == HA_NOSAME;
+  if (!keyinfo->open_addressing)
+    return;
+
+  for (seg= keyinfo->seg, end= seg + keyinfo->keysegs; seg < end; seg++)
+  {
+    if (seg->type == HA_KEYTYPE_TEXT || seg->type == HA_KEYTYPE_VARTEXT1 ||
+        seg->type == HA_KEYTYPE_VARTEXT2 || seg->type == HA_KEYTYPE_BIT)
+      return;
+    length+= seg->length + MY_TEST(seg->null_bit);
+  }
+  if (length <= HP_OA_INLINE_KEY)
+    keyinfo->oa.inline_length= length;
+}
+
+
+/* Key image of a record, see hp_oa_key_image() */
+
+static void hp_oa_rec_image(HP_KEYDEF *keyinfo, const uchar *rec, uchar *to)
+{
+  HA_KEYSEG *seg, *end;
+
+  for (seg= keyinfo->seg, end= seg + keyinfo->keysegs; seg < end; seg++)
+  {
+    if (seg->null_bit &&
+        (*to++= MY_TEST(rec[seg->null_pos] & seg->null_bit)))
+      bzero(to, seg->length);
+    else
+      memcpy(to, rec + seg->start, seg->length);
+    to+= seg->length;
+  }
+}
+
+
+/*
+  Key image of a search key: the key with the value of NULL parts zeroed,
+  so that equal keys have equal images
+*/
+
+static void hp_oa_key_image(HP_KEYDEF *keyinfo, const uchar *key, uchar *to)
+{
+  HA_KEYSEG *seg, *end;
+
+  for (seg= keyinfo->seg, end= seg + keyinfo->keysegs; seg < end; seg++)
+  {
+    if (seg->null_bit && (*to++= *key++))
+      bzero(to, seg->length);
+    else
+      memcpy(to, key, seg->length);
+    to+= seg->length;
+    key+= seg->length;
+  }
+}
+
+
+/*
+  Find a key given by a record or a search key
+
+  SYNOPSIS
+    hp_oa_find()
+    keyinfo	Key definition
+    table	oa.table of the key, not NULL
+    hash	Hash value of the key
+    image	Key image if the key is inlined, otherwise NULL
+    record	Record with the key, or NULL
+    key		Search key if record is NULL
+
+  RETURN
+    Slot number of the key, or table->size if not found
+*/
+
+static ulong hp_oa_find(HP_KEYDEF *keyinfo, const HP_OA_TABLE *table,
+                        ulong hash, const uchar *image,
+                        const uchar *record, const uchar *key)
+{
+  ulong group, groups= table->size / HP_OA_GROUP, probe;
+  uint inline_length= keyinfo->oa.inline_length;
+  uchar tag= hp_oa_tag(hash);
+
+  group= hp_oa_first_group(table, hash);
+  for (probe= 1; probe <= groups; probe++)
+  {
+    const uchar *tags= table->tags + group * HP_OA_GROUP;
+    uint match= hp_oa_match(tags, tag);
+    /* Read the slots after their tags, see hp_oa_write_key() */
+    hp_read_barrier();
+    while (match)
+    {
+      ulong nr= group * HP_OA_GROUP + my_find_first_bit(match);
+      HP_OA_SLOT *slot= table->slots + nr;
+      if (slot->hash_of_key == hash &&
+          (image ? !memcmp(slot->key, image, inline_length) :
+           record ? !hp_rec_key_cmp(keyinfo, record, slot->ptr_to_rec) :
+           !hp_key_cmp(keyinfo, slot->ptr_to_rec, key)))
+        return nr;
+      match&= match - 1;
+    }
+    if (hp_oa_match(tags, HP_OA_EMPTY))
+      break;
+    group= (group + probe) & (groups - 1);
+  }
+  return table->size;
+}
+
+
+/* Slot for a new key: the first deleted or empty slot on its probe path */
+
+static ulong hp_oa_free_slot(const HP_OA_TABLE *table, ulong hash)
+{
+  ulong group= hp_oa_first_group(table, hash);
+  ulong groups= table->size / HP_OA_GROUP, probe;
+
+  for (probe= 1; ; probe++)
+  {
+    const uchar *tags= table->tags + group * HP_OA_GROUP;
+    uint free_slots= (hp_oa_match(tags, HP_OA_EMPTY) |
+                      hp_oa_match(tags, HP_OA_DELETED));
+    if (free_slots)
+      return group * HP_OA_GROUP + my_find_first_bit(free_slots);
+    DBUG_ASSERT(probe < groups);
+    group= (group + probe) & (groups - 1);
+  }
+}
+
+
+/*
+  Rebuild the table with room for at least one more key, dropping the
+  deleted slots
+
+  NOTES
+    Lookups of a CONCURRENT_ACCESS table may still be probing the old
+    table, which is kept in oa->retired until hp_oa_clear(). The sizes
+    double, so the retired tables take less memory than the current one.
+
+  RETURN
+    0  ok
+    1  out of memory
+*/
+
+static int hp_oa_resize(HP_SHARE *share, HP_KEYDEF *keyinfo)
+{
+  HP_OA_HASH *oa= &keyinfo->oa;
+  HP_OA_TABLE *old= oa->table, *table;
+  ulong size= old ? MY_MAX(old->size, HP_OA_MIN_SIZE) : HP_OA_MIN_SIZE, i;
+  size_t length;
+
+  /* Keep the table at most half full after the rebuild */
+  while ((oa->records + 1) * 2 > size)
+    size*= 2;
+  length= ALIGN_SIZE(sizeof(HP_OA_TABLE)) + size * (sizeof(HP_OA_SLOT) + 1);
+  if (!(table= (HP_OA_TABLE*) my_malloc(hp_key_memory_HP_OA_HASH, length,
+                                        MYF(MY_ZEROFILL |
+                                            (share->internal ?
+                                             MY_THREAD_SPECIFIC : 0)))))
+    return 1;
+  table->size= size;
+  table->slots= (HP_OA_SLOT*) ((uchar*) table +
+                               ALIGN_SIZE(sizeof(HP_OA_TABLE)));
+  table->tags= (uchar*) (table->slots + size);
+
+  for (i= 0; old && i < old->size; i++)
+  {
+    if (old->tags[i] & 0x80)
+    {
+      ulong nr= hp_oa_free_slot(table, old->slots[i].hash_of_key);
+      table->tags[nr]= old->tags[i];
+      table->slots[nr]= old->slots[i];
+    }
+  }
+  /* Publish the table with its slots for hp_oa_read() */
+  my_atomic_storeptr_explicit((void**) &oa->table, table,
+                              MY_MEMORY_ORDER_RELEASE);
+  oa->deleted= 0;
+  share->index_length+= length;
+  if (old && share->concurrent)
+  {
+    old->next_retired= oa->retired;
+    oa->retired= old;
+  }
+  else if (old)
+  {
+    share->index_length-= ALIGN_SIZE(sizeof(HP_OA_TABLE)) +
+                          old->size * (sizeof(HP_OA_SLOT) + 1);
+    my_free(old);
+  }
+  return 0;
+}
+
+
+/*
+  Write a key to the open addressing hash index
+
+  RETURN
+    0  - OK
+    -1 - Out of memory
+    HA_ERR_FOUND_DUPP_KEY - Duplicate key. Unlike with hp_write_key() the
+    key is not added.
+*/
+
+int hp_oa_write_key(HP_INFO *info, HP_KEYDEF *keyinfo,
+                    const uchar *record, uchar *recpos)
+{
+  HP_OA_HASH *oa= &keyinfo->oa;
+  HP_OA_TABLE *table= oa->table;
+  uchar image[HP_OA_INLINE_KEY];
+  ulong hash= hp_rec_hashnr(keyinfo, record), nr;
+  HP_OA_SLOT *slot;
+  DBUG_ENTER("hp_oa_write_key");
+
+  if (oa->inline_length)
+    hp_oa_rec_image(keyinfo, record, image);
+  if (table && hp_oa_find(keyinfo, table, hash,
+                          oa->inline_length ? image : NULL,
+                          record, NULL) != table->size)
+    DBUG_RETURN(my_errno= HA_ERR_FOUND_DUPP_KEY);
+
+  if (hp_oa_needs_resize(keyinfo, 1))
+  {
+    /* heap_latch() does not let writers share the latch then */
+    DBUG_ASSERT(!info->s->concurrent || info->latched == HP_LATCH_EXCLUSIVE);
+    if (hp_oa_resize(info->s, keyinfo))
+      DBUG_RETURN(-1);				/* No more memory */
+    table= oa->table;
+  }
+
+  nr= hp_oa_free_slot(table, hash);
+  if (table->tags[nr] == HP_OA_DELETED)
+    oa->deleted--;
+  slot= table->slots + nr;
+  slot->ptr_to_rec= recpos;
+  slot->hash_of_key= hash;
+  memcpy(slot->key, image, oa->inline_length);
+  /* A lookup that sees the tag must see the slot */
+  hp_write_barrier();
+  table->tags[nr]= hp_oa_tag(hash);
+  oa->records++;
+  DBUG_RETURN(0);
+}
+
+
+/*
+  Remove one key from the open addressing hash index
+
+  NOTES
+    The slot becomes empty if its group has an empty slot: no probe path
+    goes past such a group. Otherwise it is marked as deleted.
+*/
+
+int hp_oa_delete_key(HP_INFO *info, HP_KEYDEF *keyinfo,
+                     const uchar *record, uchar *recpos, int flag)
+{
+  HP_OA_HASH *oa= &keyinfo->oa;
+  HP_OA_TABLE *table= oa->table;
+  ulong hash= hp_rec_hashnr(keyinfo, record), nr;
+  ulong group, groups, probe;
+  uchar tag= hp_oa_tag(hash);
+  DBUG_ENTER("hp_oa_delete_key");
+
+  if (flag)
+  {
+    /* There is no other row with the key for heap_rnext/heap_rprev */
+    info->current_hash_ptr= 0;
+    info->current_ptr= 0;
+  }
+  if (!oa->records)
+    DBUG_RETURN(my_errno= HA_ERR_CRASHED);
+
+  groups= table->size / HP_OA_GROUP;
+  group= hp_oa_first_group(table, hash);
+  for (probe= 1; probe <= groups; probe++)
+  {
+    uchar *tags= table->tags + group * HP_OA_GROUP;
+    uint match= hp_oa_match(tags, tag);
+    while (match)
+    {
+      nr= group * HP_OA_GROUP + my_find_first_bit(match);
+      if (table->slots[nr].ptr_to_rec == recpos)
+      {
+        if (hp_oa_match(tags, HP_OA_EMPTY))
+          table->tags[nr]= HP_OA_EMPTY;
+        else
+        {
+          table->tags[nr]= HP_OA_DELETED;
+          oa->deleted++;
+        }
+        oa->records--;
+        DBUG_RETURN(0);
+      }
+      match&= match - 1;
+    }
+    if (hp_oa_match(tags, HP_OA_EMPTY))
+      break;
+    group= (group + probe) & (groups - 1);
+  }
+  DBUG_RETURN(my_errno= HA_ERR_CRASHED);	/* This shouldn't happend */
+}
+
+
+/*
+  Search after a record based on a key, see hp_search().
+  A unique key has at most one row, there is no next or previous one.
+*/
+
+uchar *hp_oa_search(HP_INFO *info, HP_KEYDEF *keyinfo, const uchar *key,
+                    uint nextflag)
+{
+  HP_OA_HASH *oa= &keyinfo->oa;
+  HP_OA_TABLE *table= oa->table;
+  uchar image[HP_OA_INLINE_KEY], *pos= 0, *prev_ptr= 0;
+  uint old_nextflag= nextflag;
+  ulong nr;
+  DBUG_ENTER("hp_oa_search");
+
+  info->current_hash_ptr= 0;
+  if (oa->inline_length)
+    hp_oa_key_image(keyinfo, key, image);
+  if (table &&
+      (nr= hp_oa_find(keyinfo, table, hp_hashnr(keyinfo, key),
+                      oa->inline_length ? image : NULL, NULL, key)) !=
+      table->size)
+  {
+    pos= table->slots[nr].ptr_to_rec;
+    switch (nextflag) {
+    case 0:					/* Search after key */
+      DBUG_RETURN(info->current_ptr= pos);
+    case 1:					/* Search next */
+      if (pos == info->current_ptr)
+        nextflag= 0;
+      break;
+    case 2:					/* Search previous */
+      if (pos == info->current_ptr)
+      {
+        my_errno= HA_ERR_KEY_NOT_FOUND;
+        DBUG_RETURN(info->current_ptr= 0);
+      }
+      prev_ptr= pos;
+      break;
+    case 3:					/* Search same */
+      if (pos == info->current_ptr)
+        DBUG_RETURN(info->current_ptr);
+    }
+  }
+
+  my_errno= HA_ERR_KEY_NOT_FOUND;
+  if (nextflag == 2 && !info->current_ptr)
+    DBUG_RETURN(info->current_ptr= prev_ptr);	/* Previous from end */
+  if (old_nextflag && nextflag)
+    my_errno= HA_ERR_RECORD_CHANGED;		/* Didn't find old record */
+  DBUG_RETURN(info->current_ptr= 0);
+}
+
+
+/* Find the row with the key of record, for ha_heap::find_unique_row() */
+
+uchar *hp_oa_find_record(HP_KEYDEF *keyinfo, const uchar *record)
+{
+  HP_OA_HASH *oa= &keyinfo->oa;
+  HP_OA_TABLE *table= oa->table;
+  uchar image[HP_OA_INLINE_KEY];
+  ulong nr;
+
+  if (!table)
+    return 0;
+  if (oa->inline_length)
+    hp_oa_rec_image(keyinfo, record, image);
+  nr= hp_oa_find(keyinfo, table, hp_rec_hashnr(keyinfo, record),
+                 oa->inline_length ? image : NULL, record, NULL);
+  return nr != table->size ? table->slots[nr].ptr_to_rec : 0;
+}
+
+
+/*
+  Read the row with a key of a CONCURRENT_ACCESS table without latching
+
+  SYNOPSIS
+    hp_oa_read()
+    info	Table handler, the table is not latched
+    keyinfo	Open addressing key
+    key		Search key
+    record	Row is copied here
+
+  NOTES
+    Writers may change the slots while they are probed. The row found is
+    copied by hp_read_row() and is returned only if it still has the
+    key; otherwise the slot was stale and the search starts over. After
+    HP_OA_READ_TRIES misses like that the writers are kept out with the
+    latch and write_mutex.
+
+    A search that does not find the key is not repeated: a writer can
+    only have removed it, or added it after the search started.
+
+  RETURN
+    Position of the row, or 0 with my_errno= HA_ERR_KEY_NOT_FOUND
+*/
+
+#define HP_OA_READ_TRIES 16
+
+uchar *hp_oa_read(HP_INFO *info, HP_KEYDEF *keyinfo, const uchar *key,
+                  uchar *record)
+{
+  HP_SHARE *share= info->s;
+  HP_OA_HASH *oa= &keyinfo->oa;
+  uchar image[HP_OA_INLINE_KEY], *pos= 0;
+  ulong hash= hp_hashnr(keyinfo, key);
+  uint tries;
+  DBUG_ENTER("hp_oa_read");
+  DBUG_ASSERT(share->concurrent && info->latched == HP_LATCH_NONE);
+
+  if (oa->inline_length)
+    hp_oa_key_image(keyinfo, key, image);
+  for (tries= 0; tries < HP_OA_READ_TRIES; tries++)
+  {
+    HP_OA_TABLE *table=
+      my_atomic_loadptr_explicit((void**) &oa->table,
+                                 MY_MEMORY_ORDER_ACQUIRE);
+    ulong nr;
+    if (!table ||
+        (nr= hp_oa_find(keyinfo, table, hash,
+                        oa->inline_length ? image : NULL, NULL, key)) ==
+        table->size)
+      break;
+    pos= table->slots[nr].ptr_to_rec;
+    if (!hp_read_row(info, record, pos) && !hp_key_cmp(keyinfo, record, key))
+      DBUG_RETURN(pos);
+    pos= 0;
+  }
+  if (tries == HP_OA_READ_TRIES)
+  {
+    heap_latch(info, HP_LATCH_WRITE);
+    if ((pos= hp_oa_search(info, keyinfo, key, 0)))
+      memcpy(record, pos, (size_t) share->reclength);
+    heap_unlatch(info);
+  }
+  if (!pos)
+    my_errno= HA_ERR_KEY_NOT_FOUND;
+  DBUG_RETURN(pos);
+}
+
+
+/*
+  TRUE if writing keys extra times would make hp_oa_write_key() resize
+  the table
+*/
+
+my_bool hp_oa_needs_resize(HP_KEYDEF *keyinfo, uint keys)
+{
+  HP_OA_HASH *oa= &keyinfo->oa;
+  return (!oa->table ||
+          (oa->records + oa->deleted + keys) * 8 > oa->table->size * 7);
+}
+
+
+/* Free the index, the caller resets share->index_length */
+
+void hp_oa_clear(HP_KEYDEF *keyinfo)
+{
+  HP_OA_HASH *oa= &keyinfo->oa;
+  my_free(oa->table);
+  while (oa->retired)
+  {
+    HP_OA_TABLE *table= oa->retired;
+    oa->retired= table->next_retired;
+    my_free(table);
+  }
+  oa->table= 0;
+  oa->records= oa->deleted= 0;
+}
+
+
+/* Check the index for heap_check_heap() */
+
+int hp_oa_check(HP_KEYDEF *keydef, uint keynr, ulong records,
+                my_bool print_status)
+{
+  HP_OA_HASH *oa= &keydef->oa;
+  HP_OA_TABLE *table= oa->table;
+  ulong i, size= table ? table->size : 0, found= 0, deleted= 0, seeks= 0;
+  uchar image[HP_OA_INLINE_KEY];
+  int error= 0;
+
+  for (i= 0; i < size; i++)
+  {
+    HP_OA_SLOT *slot= table->slots + i;
+    ulong group, probe;
+    if (table->tags[i] == HP_OA_DELETED)
+      deleted++;
+    if (!(table->tags[i] & 0x80))
+      continue;
+    found++;
+    if (slot->hash_of_key != hp_rec_hashnr(keydef, slot->ptr_to_rec) ||
+        table->tags[i] != hp_oa_tag(slot->hash_of_key))
+    {
+      DBUG_PRINT("error", ("Found row with wrong hash_of_key at slot %lu", i));
+      error= 1;
+    }
+    if (oa->inline_length)
+    {
+      hp_oa_rec_image(keydef, slot->ptr_to_rec, image);
+      if (memcmp(image, slot->key, oa->inline_length))
+      {
+        DBUG_PRINT("error", ("Found wrong key image at slot %lu", i));
+        error= 1;
+      }
+    }
+    /* Count the groups visited to find the key */
+    group= hp_oa_first_group(table, slot->hash_of_key);
+    for (probe= 1; group != i / HP_OA_GROUP; probe++)
+      group= (group + probe) & (size / HP_OA_GROUP - 1);
+    seeks+= probe;
+  }
+  if (found != records || oa->records != records || oa->deleted != deleted)
+  {
+    DBUG_PRINT("error", ("Found %lu of %lu records, %lu of %lu deleted",
+                         found, records, deleted, oa->deleted));
+    error= 1;
+  }
+  DBUG_PRINT("info",
+             ("key: %u  records: %lu  slots: %lu  deleted: %lu  "
+              "seeks: %lu  hitrate: %.2f",
+              keynr, records, size, deleted, seeks,
+              (float) seeks / (float) (records ? records : 1)));
+  if (print_status)
+    printf("Key: %u  records: %lu  slots: %lu  deleted: %lu  "
+           "seeks: %lu  hitrate: %.2f\n",
+           keynr, records, size, deleted, seeks,
+           (float) seeks / (float) (records ? records : 1));
+  return error;
+}
@@ -46,6 +46,9 @@ HP_INFO *heap_open_from_share(HP_SHARE *share, int mode)
   info->mode= mode;
   info->current_record= (ulong) ~0L;		/* No current record */
   info->lastinx= info->errkey= -1;
+  if (share->concurrent)
+    my_init_dynamic_array(hp_key_memory_HP_INFO, &info->key_matches,
+                          sizeof(uchar*), 16, 16, MYF(0));
 #ifndef DBUG_OFF
   info->opt_flag= READ_CHECK_USED;		/* Check when changing */
 #endif
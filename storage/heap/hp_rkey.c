@@ -58,14 +58,36 @@ int heap_rkey(HP_INFO *info, uchar *record, int inx, const uchar *key,
     memcpy(&pos, pos + (*keyinfo->get_key_length)(keyinfo, pos), sizeof(uchar*));
     info->current_ptr= pos;
   }
+  else if (share->concurrent && keyinfo->open_addressing)
+  {
+    /* The table is not latched, see hp_oa_read() */
+    if (!(pos= hp_oa_read(info, keyinfo, key, record)))
+    {
+      info->update= HA_STATE_NO_KEY;
+      DBUG_RETURN(my_errno);
+    }
+    info->current_hash_ptr= 0;
+    info->current_ptr= pos;
+    /* For heap_row_lock() */
+    memcpy(info->lastkey, key, (size_t) keyinfo->length);
+    info->update= HA_STATE_AKTIV;
+    DBUG_RETURN(0);
+  }
   else
   {
-    if (!(pos= hp_search(info, share->keydef + inx, key, 0)))
+    pos= hp_search(info, share->keydef + inx, key, 0);
+    /* Other threads can change the hash chain before heap_rnext() */
+    if (share->concurrent && !keyinfo->open_addressing &&
+        hp_collect_key_matches(info, keyinfo, key))
+      DBUG_RETURN(my_errno);
+    if (!pos)
     {
       info->update= HA_STATE_NO_KEY;
       DBUG_RETURN(my_errno);
     }
-    if ((keyinfo->flag & (HA_NOSAME | HA_NULL_PART_KEY)) != HA_NOSAME)
+    /* heap_row_lock() checks the key of concurrent tables */
+    if ((keyinfo->flag & (HA_NOSAME | HA_NULL_PART_KEY)) != HA_NOSAME ||
+        share->concurrent)
       memcpy(info->lastkey, key, (size_t) keyinfo->length);
   }
   memcpy(record, pos, (size_t) share->reclength);
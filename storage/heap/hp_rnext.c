@@ -99,6 +99,8 @@ int heap_rnext(HP_INFO *info, uchar *record)
       my_errno = HA_ERR_KEY_NOT_FOUND;
     }
   }
+  else if (share->concurrent && !keyinfo->open_addressing)
+    pos= hp_next_key_match(info, keyinfo, 1);
   else
   {
     if (info->current_hash_ptr)
@@ -117,6 +119,12 @@ int heap_rnext(HP_INFO *info, uchar *record)
 	pos= hp_search(info, keyinfo, info->lastkey, 1);
     }
   }
+  /* A writer that shares the latch may have deleted the row */
+  if (pos && hp_read_row(info, record, pos))
+  {
+    pos= 0;
+    my_errno= HA_ERR_KEY_NOT_FOUND;
+  }
   if (!pos)
   {
     info->update=HA_STATE_NEXT_FOUND;		/* For heap_rprev */
@@ -124,7 +132,6 @@ int heap_rnext(HP_INFO *info, uchar *record)
       my_errno=HA_ERR_END_OF_FILE;
     DBUG_RETURN(my_errno);
   }
-  memcpy(record,pos,(size_t) share->reclength);
   info->update=HA_STATE_AKTIV | HA_STATE_NEXT_FOUND;
   DBUG_RETURN(0);
 }
@@ -70,6 +70,8 @@ int heap_rprev(HP_INFO *info, uchar *record)
       my_errno = HA_ERR_KEY_NOT_FOUND;
     }
   }
+  else if (share->concurrent && !keyinfo->open_addressing)
+    pos= hp_next_key_match(info, keyinfo, -1);
   else
   {
     if (info->current_ptr || (info->update & HA_STATE_NEXT_FOUND))
@@ -85,6 +87,12 @@ int heap_rprev(HP_INFO *info, uchar *record)
       my_errno=HA_ERR_KEY_NOT_FOUND;
     }
   }
+  /* A writer that shares the latch may have deleted the row */
+  if (pos && hp_read_row(info, record, pos))
+  {
+    pos= 0;
+    my_errno= HA_ERR_KEY_NOT_FOUND;
+  }
   if (!pos)
   {
     info->update=HA_STATE_PREV_FOUND;		/* For heap_rprev */
@@ -92,7 +100,6 @@ int heap_rprev(HP_INFO *info, uchar *record)
       my_errno=HA_ERR_END_OF_FILE;
     DBUG_RETURN(my_errno);
   }
-  memcpy(record,pos,(size_t) share->reclength);
   info->update=HA_STATE_AKTIV | HA_STATE_PREV_FOUND;
   DBUG_RETURN(0);
 }
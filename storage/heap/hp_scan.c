@@ -40,7 +40,7 @@ int heap_scan_init(register HP_INFO *info)
 int heap_scan(register HP_INFO *info, uchar *record)
 {
   HP_SHARE *share=info->s;
-  ulong pos;
+  ulong pos, rows;
   DBUG_ENTER("heap_scan");
 
   pos= ++info->current_record;
@@ -53,9 +53,14 @@ int heap_scan(register HP_INFO *info, uchar *record)
     /* increase next_block to the next records_in_block boundary */
     ulong rem= info->next_block % share->block.records_in_block;
     info->next_block+=share->block.records_in_block - rem;
-    if (info->next_block >= share->records+share->deleted)
+    /*
+      Writers that share the latch of a CONCURRENT_ACCESS table change the
+      counts, but not the allocated rows
+    */
+    rows= MY_MIN(share->records+share->deleted, share->block.last_allocated);
+    if (info->next_block >= rows)
     {
-      info->next_block= share->records+share->deleted;
+      info->next_block= rows;
       if (pos >= info->next_block)
       {
 	info->update= 0;
@@ -64,14 +69,13 @@ int heap_scan(register HP_INFO *info, uchar *record)
     }
     hp_find_record(info, pos);
   }
-  if (!info->current_ptr[share->visible])
+  if (hp_read_row(info, record, info->current_ptr))
   {
     DBUG_PRINT("warning",("Found deleted record"));
     info->update= HA_STATE_PREV_FOUND | HA_STATE_NEXT_FOUND;
     DBUG_RETURN(my_errno=HA_ERR_RECORD_DELETED);
   }
   info->update= HA_STATE_PREV_FOUND | HA_STATE_NEXT_FOUND | HA_STATE_AKTIV;
-  memcpy(record,info->current_ptr,(size_t) share->reclength);
   info->current_hash_ptr=0;			/* Can't use read_next */
   DBUG_RETURN(0);
 } /* heap_scan */
@@ -28,6 +28,11 @@ PSI_memory_key hp_key_memory_HP_SHARE;
 PSI_memory_key hp_key_memory_HP_INFO;
 PSI_memory_key hp_key_memory_HP_PTRS;
 PSI_memory_key hp_key_memory_HP_KEYDEF;
+PSI_memory_key hp_key_memory_HP_OA_HASH;
+PSI_rwlock_key hp_key_rwlock_HP_SHARE_latch;
+PSI_mutex_key hp_key_mutex_HP_SHARE_write_mutex;
+PSI_mutex_key hp_key_mutex_HP_SHARE_row_lock_mutex;
+PSI_cond_key hp_key_cond_HP_SHARE_row_lock_cond;
 
 #ifdef HAVE_PSI_INTERFACE
 
@@ -36,7 +41,24 @@ static PSI_memory_info all_heap_memory[]=
   { & hp_key_memory_HP_SHARE, "HP_SHARE", 0},
   { & hp_key_memory_HP_INFO, "HP_INFO", 0},
   { & hp_key_memory_HP_PTRS, "HP_PTRS", 0},
-  { & hp_key_memory_HP_KEYDEF, "HP_KEYDEF", 0}
+  { & hp_key_memory_HP_KEYDEF, "HP_KEYDEF", 0},
+  { & hp_key_memory_HP_OA_HASH, "HP_OA_HASH", 0}
+};
+
+static PSI_rwlock_info all_heap_rwlocks[]=
+{
+  { & hp_key_rwlock_HP_SHARE_latch, "HP_SHARE::latch", 0}
+};
+
+static PSI_mutex_info all_heap_mutexes[]=
+{
+  { & hp_key_mutex_HP_SHARE_write_mutex, "HP_SHARE::write_mutex", 0},
+  { & hp_key_mutex_HP_SHARE_row_lock_mutex, "HP_SHARE::row_lock_mutex", 0}
+};
+
+static PSI_cond_info all_heap_conds[]=
+{
+  { & hp_key_cond_HP_SHARE_row_lock_cond, "HP_SHARE::row_lock_cond", 0}
 };
 
 void init_heap_psi_keys()
@@ -49,6 +71,15 @@ void init_heap_psi_keys()
 
   count= array_elements(all_heap_memory);
   mysql_memory_register(category, all_heap_memory, count);
+
+  count= array_elements(all_heap_rwlocks);
+  mysql_rwlock_register(category, all_heap_rwlocks, count);
+
+  count= array_elements(all_heap_mutexes);
+  mysql_mutex_register(category, all_heap_mutexes, count);
+
+  count= array_elements(all_heap_conds);
+  mysql_cond_register(category, all_heap_conds, count);
 }
 #endif /* HAVE_PSI_INTERFACE */
 
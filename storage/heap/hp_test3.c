@@ -0,0 +1,190 @@
+/* Copyright (c) 2021, MariaDB Corporation.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; version 2 of the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1335  USA */
+
+/*
+  Benchmark of the HASH indexes of heap tables.
+  The same keys are written to and looked up in a table with a unique key,
+  which uses the open addressing hash, and in a table with a non unique
+  key, which uses the linear hash.
+*/
+
+#include <my_global.h>
+#include <my_sys.h>
+#include <m_string.h>
+#include "heap.h"
+
+#define MAX_KEY_LENGTH 32
+
+static int get_options(int argc, char *argv[]);
+
+static ulong records= 1000000;
+static uint key_length= 8;
+static int verbose= 0, deletes= 0;
+
+static void make_key(uchar *key, ulong nr)
+{
+  ulonglong value= (ulonglong) nr * 0x9E3779B97F4A7C15ULL;
+  uint i;
+  for (i= 0; i < key_length; i++)
+    key[i]= (uchar) ((value >> ((i % 8) * 8)) ^ i);
+}
+
+
+static int run(const char *filename, uint key_flag)
+{
+  HP_INFO *file;
+  HP_KEYDEF keyinfo[1];
+  HA_KEYSEG keyseg[1];
+  HP_CREATE_INFO hp_create_info;
+  HP_SHARE *tmp_share;
+  my_bool unused;
+  uchar record[MAX_KEY_LENGTH + 1], key[MAX_KEY_LENGTH];
+  ulonglong start;
+  ulong i, found;
+
+  bzero(&hp_create_info, sizeof(hp_create_info));
+  bzero(keyinfo, sizeof(keyinfo));
+  bzero(keyseg, sizeof(keyseg));
+  hp_create_info.max_table_size= 1024L*1024L*1024L;
+  hp_create_info.keys= 1;
+  hp_create_info.keydef= keyinfo;
+  hp_create_info.reclength= key_length + 1;
+  hp_create_info.max_records= records;
+  hp_create_info.min_records= records;
+
+  keyinfo[0].keysegs= 1;
+  keyinfo[0].seg= keyseg;
+  keyinfo[0].algorithm= HA_KEY_ALG_HASH;
+  keyinfo[0].seg[0].type= HA_KEYTYPE_BINARY;
+  keyinfo[0].seg[0].start= 1;
+  keyinfo[0].seg[0].length= key_length;
+  keyinfo[0].seg[0].charset= &my_charset_bin;
+  keyinfo[0].flag= key_flag;
+
+  if (heap_create(filename, &hp_create_info, &tmp_share, &unused) ||
+      !(file= heap_open(filename, 2)))
+    return 1;
+  printf("- %s: %s hash\n", filename,
+         file->s->keydef[0].open_addressing ? "open addressing" : "linear");
+
+  record[0]= 0;
+  start= my_interval_timer();
+  for (i= 0; i < records; i++)
+  {
+    make_key(record + 1, i);
+    if (heap_write(file, record))
+    {
+      printf("heap_write of record %lu failed: %d\n", i, my_errno);
+      return 1;
+    }
+  }
+  printf("  heap_write:  %lu rows, %llu ns/row\n", records,
+         (my_interval_timer() - start) / records);
+
+  found= 0;
+  start= my_interval_timer();
+  for (i= 0; i < records * 2; i++)
+  {
+    make_key(key, i);
+    if (!heap_rkey(file, record, 0, key, HA_WHOLE_KEY, HA_READ_KEY_EXACT))
+      found++;
+  }
+  printf("  heap_rkey:   %lu lookups, %llu ns/lookup\n", records * 2,
+         (my_interval_timer() - start) / (records * 2));
+  if (found != records)
+  {
+    printf("found %lu of %lu rows\n", found, records);
+    return 1;
+  }
+
+  if (deletes)
+  {
+    start= my_interval_timer();
+    for (i= 0; i < records; i+= 2)
+    {
+      make_key(key, i);
+      if (heap_rkey(file, record, 0, key, HA_WHOLE_KEY, HA_READ_KEY_EXACT) ||
+          heap_delete(file, record))
+      {
+        printf("delete of record %lu failed: %d\n", i, my_errno);
+        return 1;
+      }
+    }
+    printf("  heap_delete: %lu rows, %llu ns/row\n", (records + 1) / 2,
+           (my_interval_timer() - start) / ((records + 1) / 2));
+  }
+
+  if (heap_check_heap(file, verbose))
+  {
+    puts("Heap keys crashed");
+    return 1;
+  }
+  if (heap_close(file) || heap_delete_table(filename))
+    return 1;
+  return 0;
+}
+
+
+int main(int argc, char **argv)
+{
+  MY_INIT(argv[0]);
+  get_options(argc, argv);
+
+  if (run("test3_unique", HA_NOSAME) || run("test3_multi", 0))
+  {
+    printf("got error: %d when using heap-database\n", my_errno);
+    return 1;
+  }
+  if (hp_panic(HA_PANIC_CLOSE))
+    return 1;
+  my_end(MY_GIVE_INFO);
+  return 0;
+} /* main */
+
+
+/* Read options */
+
+static int get_options(int argc, char **argv)
+{
+  char *pos;
+
+  while (--argc >0 && *(pos = *(++argv)) == '-' ) {
+    switch(*++pos) {
+    case 'd':				/* Delete every second row */
+      deletes= 1;
+      break;
+    case 'k':				/* Key length */
+      key_length= (uint) atoi(++pos);
+      if (key_length < 8 || key_length > MAX_KEY_LENGTH)
+        key_length= 8;
+      break;
+    case 'r':				/* Number of rows */
+      records= (ulong) atol(++pos);
+      if (!records)
+        records= 1;
+      break;
+    case 'v':				/* verbose */
+      verbose=1;
+      break;
+    case 'V':
+      printf("hp_test3    Ver 1.0 \n");
+      exit(0);
+    case '#':
+      DBUG_PUSH (++pos);
+      break;
+    }
+  }
+  return 0;
+} /* get options */
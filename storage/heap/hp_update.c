@@ -33,6 +33,7 @@ int heap_update(HP_INFO *info, const uchar *old, const uchar *heap_new)
     DBUG_RETURN(my_errno);				/* Record changed */
   if (--(share->records) < share->blength >> 1) share->blength>>= 1;
   share->changed=1;
+  hp_row_change_begin(share, pos);
 
   p_lastinx= share->keydef + info->lastinx;
   for (keydef= share->keydef, end= keydef + share->keys; keydef < end; keydef++)
@@ -48,6 +49,7 @@ int heap_update(HP_INFO *info, const uchar *old, const uchar *heap_new)
   }
 
   memcpy(pos,heap_new,(size_t) share->reclength);
+  hp_row_change_end(share, pos);
   if (++(share->records) == share->blength) share->blength+= share->blength;
 
 #if !defined(DBUG_OFF) && defined(EXTRA_HEAP_DEBUG)
@@ -63,11 +65,12 @@ int heap_update(HP_INFO *info, const uchar *old, const uchar *heap_new)
   if (my_errno == HA_ERR_FOUND_DUPP_KEY)
   {
     info->errkey = (int) (keydef - share->keydef);
-    if (keydef->algorithm == HA_KEY_ALG_BTREE)
+    if (keydef->algorithm == HA_KEY_ALG_BTREE || keydef->open_addressing)
     {
-      /* we don't need to delete non-inserted key from rb-tree */
+      /* we don't need to delete non-inserted key from rb-tree or hash */
       if ((*keydef->write_key)(info, keydef, old, pos))
       {
+        hp_row_change_end(share, pos);
         if (++(share->records) == share->blength)
 	  share->blength+= share->blength;
         DBUG_RETURN(my_errno);
@@ -85,6 +88,7 @@ int heap_update(HP_INFO *info, const uchar *old, const uchar *heap_new)
       keydef--;
     }
   }
+  hp_row_change_end(share, pos);
   if (++(share->records) == share->blength)
     share->blength+= share->blength;
   DBUG_RETURN(my_errno);
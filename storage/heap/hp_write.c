@@ -45,6 +45,7 @@ int heap_write(HP_INFO *info, const uchar *record)
   if (!(pos=next_free_record_pos(share)))
     DBUG_RETURN(my_errno);
   share->changed=1;
+  hp_row_change_begin(share, pos);
 
   for (keydef = share->keydef, end = keydef + share->keys; keydef < end;
        keydef++)
@@ -55,6 +56,7 @@ int heap_write(HP_INFO *info, const uchar *record)
 
   memcpy(pos,record,(size_t) share->reclength);
   pos[share->visible]= 1;                     /* Mark record as not deleted */
+  hp_row_change_end(share, pos);
   if (++share->records == share->blength)
     share->blength+= share->blength;
   info->s->key_version++;
@@ -71,12 +73,13 @@ int heap_write(HP_INFO *info, const uchar *record)
     DBUG_PRINT("info",("Duplicate key: %d", (int) (keydef - share->keydef)));
   info->errkey= (int) (keydef - share->keydef);
   /*
-    We don't need to delete non-inserted key from rb-tree.  Also, if
-    we got ENOMEM, the key wasn't inserted, so don't try to delete it
-    either.  Otherwise for HASH index on HA_ERR_FOUND_DUPP_KEY the key
-    was inserted and we have to delete it.
+    We don't need to delete non-inserted key from rb-tree or from an
+    open addressing hash.  Also, if we got ENOMEM, the key wasn't inserted,
+    so don't try to delete it either.  Otherwise for HASH index on
+    HA_ERR_FOUND_DUPP_KEY the key was inserted and we have to delete it.
   */
-  if (keydef->algorithm == HA_KEY_ALG_BTREE || my_errno == ENOMEM)
+  if (keydef->algorithm == HA_KEY_ALG_BTREE || keydef->open_addressing ||
+      my_errno == ENOMEM)
   {
     keydef--;
   }
@@ -91,6 +94,7 @@ int heap_write(HP_INFO *info, const uchar *record)
   *((uchar**) pos)=share->del_link;
   share->del_link=pos;
   pos[share->visible]= 0;                                 /* Record deleted */
+  hp_row_change_end(share, pos);
 
   DBUG_RETURN(my_errno);
 } /* heap_write */
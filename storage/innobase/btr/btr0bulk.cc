@@ -31,6 +31,10 @@ Created 03/11/2014 Shaohua Wang
 #include "ibuf0ibuf.h"
 #include "page0page.h"
 #include "trx0trx.h"
+#include "gis0rtree.h"
+#include "rem0cmp.h"
+
+#include <algorithm>
 
 /** Innodb B-tree index fill factor for bulk load. */
 uint	innobase_fill_factor;
@@ -91,9 +95,23 @@ PageBulk::init()
 			page_create_zip(new_block, m_index, m_level, 0,
 					&m_mtr);
 		} else {
-			ut_ad(!m_index->is_spatial());
 			page_create(new_block, &m_mtr,
 				    m_index->table->not_redundant());
+			if (m_index->is_spatial()) {
+				static_assert(((FIL_PAGE_INDEX & 0xff00)
+					       | byte(FIL_PAGE_RTREE))
+					      == FIL_PAGE_RTREE,
+					      "compatibility");
+				m_mtr.write<1>(*new_block,
+					       FIL_PAGE_TYPE + 1 + new_page,
+					       byte(FIL_PAGE_RTREE));
+				if (mach_read_from_8(new_page
+						     + FIL_RTREE_SPLIT_SEQ_NUM)) {
+					m_mtr.memset(new_block,
+						     FIL_RTREE_SPLIT_SEQ_NUM,
+						     8, 0);
+				}
+			}
 			m_mtr.memset(*new_block, FIL_PAGE_PREV, 8, 0xff);
 			m_mtr.write<2,mtr_t::MAYBE_NOP>(*new_block, PAGE_HEADER
 							+ PAGE_LEVEL
@@ -343,6 +361,89 @@ inline void PageBulk::insert(const rec_t *rec, rec_offs *offsets)
   }
 }
 
+/** Compare two records of a SPATIAL index in the order of cmp_rec_rec(),
+which cannot be used for records that are not in an index page.
+@param rec1      record
+@param rec2      record
+@param offsets1  rec_get_offsets(rec1)
+@param offsets2  rec_get_offsets(rec2)
+@param index     SPATIAL index
+@param leaf      whether the records are leaf page records
+@return the comparison result of rec1 and rec2 */
+static int rtr_bulk_rec_cmp(const rec_t *rec1, const rec_t *rec2,
+                            const rec_offs *offsets1, const rec_offs *offsets2,
+                            const dict_index_t *index, bool leaf)
+{
+  ut_ad(index->is_spatial());
+  const ulint comp= rec_offs_comp(offsets1);
+  const ulint min1= rec_get_info_bits(rec1, comp) & REC_INFO_MIN_REC_FLAG;
+  const ulint min2= rec_get_info_bits(rec2, comp) & REC_INFO_MIN_REC_FLAG;
+
+  if (min1 != min2)
+    return min1 ? -1 : 1;
+
+  const ulint n_fields= std::min<ulint>(rec_offs_n_fields(offsets1),
+                                        dict_index_get_n_unique_in_tree(index));
+
+  for (ulint i= 0; i < n_fields; i++)
+  {
+    const dict_col_t *col= dict_index_get_nth_col(index, i);
+    ulint mtype= col->mtype, prtype= col->prtype;
+    if (!i)
+      prtype|= DATA_GIS_MBR;
+    else if (!leaf)
+    {
+      /* Node pointers consist of the MBR and the child page number. */
+      mtype= DATA_SYS_CHILD;
+      prtype= 0;
+    }
+
+    ulint len1, len2;
+    const byte *data1= rec_get_nth_field(rec1, offsets1, i, &len1);
+    const byte *data2= rec_get_nth_field(rec2, offsets2, i, &len2);
+    if (int cmp= cmp_data_data(mtype, prtype, data1, len1, data2, len2))
+      return cmp;
+  }
+
+  return 0;
+}
+
+/** Add a record of a SPATIAL index to the page.
+@param[in]	rec		record
+@param[in]	offsets		record offsets */
+inline void PageBulk::add(const rec_t *rec, rec_offs *offsets)
+{
+  ut_ad(m_index->is_spatial());
+  const ulint n_recs= m_rec_no + m_pending.size();
+  m_pending_space+= rec_offs_size(offsets) +
+    page_dir_calc_reserved_space(n_recs + 1) -
+    page_dir_calc_reserved_space(n_recs);
+  ut_ad(m_pending_space <= m_free_space);
+  m_pending.push_back(std::make_pair(rec, offsets));
+}
+
+/** Copy the records that were added by add() to the page. */
+void PageBulk::insert_pending()
+{
+  ut_ad(m_index->is_spatial());
+  const dict_index_t *index= m_index;
+  const bool leaf= !m_level;
+
+  std::sort(m_pending.begin(), m_pending.end(),
+            [index, leaf](const std::pair<const rec_t*, rec_offs*> &a,
+                          const std::pair<const rec_t*, rec_offs*> &b)
+            {
+              return rtr_bulk_rec_cmp(a.first, b.first, a.second, b.second,
+                                      index, leaf) < 0;
+            });
+
+  for (const auto &rec : m_pending)
+    insert(rec.first, rec.second);
+
+  m_pending.clear();
+  m_pending_space= 0;
+}
+
 /** Set the number of owned records in the uncompressed page of
 a ROW_FORMAT=COMPRESSED record without redo-logging. */
 static void rec_set_n_owned_zip(rec_t *rec, ulint n_owned)
@@ -522,8 +623,6 @@ and set page header members.
 @tparam compressed  whether the page is in ROW_FORMAT=COMPRESSED */
 inline void PageBulk::finish()
 {
-  ut_ad(!m_index->is_spatial());
-
   if (!needs_finish());
   else if (UNIV_LIKELY_NULL(m_page_zip))
     finishPage<COMPRESSED>();
@@ -584,8 +683,18 @@ PageBulk::getNodePtr()
 	/* Create node pointer */
 	first_rec = page_rec_get_next(page_get_infimum_rec(m_page));
 	ut_a(page_rec_is_user_rec(first_rec));
-	node_ptr = dict_index_build_node_ptr(m_index, first_rec, m_page_no,
-					     m_heap, m_level);
+
+	if (m_index->is_spatial()) {
+		rtr_mbr_t	mbr;
+
+		rtr_page_cal_mbr(m_index, m_block, &mbr, m_heap);
+		node_ptr = rtr_index_build_node_ptr(m_index, &mbr, first_rec,
+						    m_page_no, m_heap);
+	} else {
+		node_ptr = dict_index_build_node_ptr(m_index, first_rec,
+						     m_page_no, m_heap,
+						     m_level);
+	}
 
 	return(node_ptr);
 }
@@ -752,24 +861,27 @@ PageBulk::isSpaceAvailable(
 {
 	ulint	slot_size;
 	ulint	required_space;
+	/* Account for the records that add() has not copied yet */
+	const ulint	rec_no = m_rec_no + m_pending.size();
+	const ulint	free_space = m_free_space - m_pending_space;
 
-	slot_size = page_dir_calc_reserved_space(m_rec_no + 1)
-		- page_dir_calc_reserved_space(m_rec_no);
+	slot_size = page_dir_calc_reserved_space(rec_no + 1)
+		- page_dir_calc_reserved_space(rec_no);
 
 	required_space = rec_size + slot_size;
 
-	if (required_space > m_free_space) {
-		ut_ad(m_rec_no > 0);
+	if (required_space > free_space) {
+		ut_ad(rec_no > 0);
 		return false;
 	}
 
 	/* Fillfactor & Padding apply to both leaf and non-leaf pages.
 	Note: we keep at least 2 records in a page to avoid B-tree level
 	growing too high. */
-	if (m_rec_no >= 2
-	    && ((m_page_zip == NULL && m_free_space - required_space
+	if (rec_no >= 2
+	    && ((m_page_zip == NULL && free_space - required_space
 		 < m_reserved_space)
-		|| (m_page_zip != NULL && m_free_space - required_space
+		|| (m_page_zip != NULL && free_space - required_space
 		    < m_padding_space))) {
 		return(false);
 	}
@@ -934,6 +1046,10 @@ BtrBulk::pageCommit(
 	PageBulk*	next_page_bulk,
 	bool		insert_father)
 {
+	if (m_index->is_spatial()) {
+		page_bulk->insert_pending();
+	}
+
 	page_bulk->finish();
 
 	/* Set page links */
@@ -1119,7 +1235,12 @@ BtrBulk::insert(
         offsets = rec_get_offsets(rec, m_index, offsets, !level,
 				  ULINT_UNDEFINED, &page_bulk->m_heap);
 
-	page_bulk->insert(rec, offsets);
+	if (m_index->is_spatial()) {
+		ut_ad(!big_rec);
+		page_bulk->add(rec, offsets);
+	} else {
+		page_bulk->insert(rec, offsets);
+	}
 
 	if (big_rec != NULL) {
 		ut_ad(dict_index_is_clust(m_index));
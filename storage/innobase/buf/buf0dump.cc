@@ -41,6 +41,8 @@ Created April 08, 2011 Vasil Dimov
 #include "ut0byte.h"
 
 #include <algorithm>
+#include <mutex>
+#include <vector>
 
 #include "mysql/service_wsrep.h" /* wsrep_recovery */
 #include <my_service_manager.h>
@@ -48,6 +50,7 @@ Created April 08, 2011 Vasil Dimov
 static void buf_do_load_dump();
 
 enum status_severity {
+	STATUS_VERBOSE,
 	STATUS_INFO,
 	STATUS_ERR
 };
@@ -58,9 +61,32 @@ enum status_severity {
 take after being waked up. */
 static volatile bool	buf_dump_should_start;
 static volatile bool	buf_load_should_start;
+/** Whether a periodic dump was requested by buf_dump_periodic() */
+static volatile bool	buf_dump_periodic_should_start;
+
+/** When buf_dump_periodic() last requested a dump, or 0 until the buffer
+pool load at startup finished or was skipped */
+static Atomic_relaxed<time_t>	buf_dump_periodic_time;
 
 static bool	buf_load_abort_flag;
 
+/** Maximum number of tablespaces whose pages a load reads first */
+#define BUF_LOAD_MAX_REQUESTS	64
+
+/** Tablespaces that foreground reads missed during a buffer pool load.
+The load reads the dumped pages of these tablespaces before the rest. */
+static struct
+{
+  /** protects the other fields */
+  std::mutex mutex;
+  /** whether buf_load() is running */
+  Atomic_relaxed<bool> active;
+  /** number of requested tablespaces */
+  Atomic_relaxed<ulint> n;
+  /** the requested tablespaces */
+  uint32_t space_id[BUF_LOAD_MAX_REQUESTS];
+} buf_load_requests;
+
 /** Start the buffer pool dump/load task and instructs it to start a dump. */
 void buf_dump_start()
 {
@@ -75,6 +101,33 @@ void buf_load_start()
   buf_do_load_dump();
 }
 
+/** Start a dump if innodb_buffer_pool_dump_interval has passed since
+the previous periodic dump and pages were read into the buffer pool
+since then. Invoked by the master task once per second. */
+void buf_dump_periodic()
+{
+  static ulint last_n_pages;
+  const time_t last_time= buf_dump_periodic_time;
+
+  if (!srv_buf_dump_interval ||
+      /* Do not replace the dump before it was loaded, or with the
+      pages loaded so far. */
+      !last_time || export_vars.innodb_buffer_pool_load_incomplete)
+    return;
+
+  const time_t now= time(nullptr);
+  if (ulong(now - last_time) < srv_buf_dump_interval)
+    return;
+  const ulint n_pages= buf_pool.stat.n_pages_read +
+    buf_pool.stat.n_pages_created;
+  if (n_pages == last_n_pages)
+    return;
+  buf_dump_periodic_time= now;
+  last_n_pages= n_pages;
+  buf_dump_periodic_should_start= true;
+  buf_do_load_dump();
+}
+
 /*****************************************************************//**
 Sets the global variable that feeds MySQL's innodb_buffer_pool_dump_status
 to the specified string. The format and the following parameters are the
@@ -103,6 +156,9 @@ buf_dump_status(
 		fmt, ap);
 
 	switch (severity) {
+	case STATUS_VERBOSE:
+		break;
+
 	case STATUS_INFO:
 		ib::info() << export_vars.innodb_buffer_pool_dump_status;
 		break;
@@ -142,6 +198,9 @@ buf_load_status(
 		fmt, ap);
 
 	switch (severity) {
+	case STATUS_VERBOSE:
+		break;
+
 	case STATUS_INFO:
 		ib::info() << export_vars.innodb_buffer_pool_load_status;
 		break;
@@ -227,13 +286,16 @@ Perform a buffer pool dump into the file specified by
 innodb_buffer_pool_filename. If any errors occur then the value of
 innodb_buffer_pool_dump_status will be set accordingly, see buf_dump_status().
 The dump filename can be specified by (relative to srv_data_home):
-SET GLOBAL innodb_buffer_pool_filename='filename'; */
+SET GLOBAL innodb_buffer_pool_filename='filename';
+The pages are dumped hottest first, see buf_load(). */
 static
 void
 buf_dump(
 /*=====*/
-	ibool	obey_shutdown)	/*!< in: quit if we are in a shutting down
+	ibool	obey_shutdown,	/*!< in: quit if we are in a shutting down
 				state */
+	bool	periodic = false)/*!< in: whether this is a periodic dump
+				that is not to be reported in the error log */
 {
 #define SHOULD_QUIT()	(SHUTTING_DOWN() && obey_shutdown)
 
@@ -242,13 +304,14 @@ buf_dump(
 	char	now[32];
 	FILE*	f;
 	int	ret;
+	const status_severity info = periodic ? STATUS_VERBOSE : STATUS_INFO;
 
 	buf_dump_generate_path(full_filename, sizeof(full_filename));
 
 	snprintf(tmp_filename, sizeof(tmp_filename),
 		 "%s.incomplete", full_filename);
 
-	buf_dump_status(STATUS_INFO, "Dumping buffer pool(s) to %s",
+	buf_dump_status(info, "Dumping buffer pool(s) to %s",
 			full_filename);
 
 #ifdef _WIN32
@@ -296,7 +359,7 @@ buf_dump(
 		total number of pages */
 		t_pages = buf_pool.curr_size * srv_buf_pool_dump_pct / 100;
 		if (n_pages > t_pages) {
-			buf_dump_status(STATUS_INFO,
+			buf_dump_status(info,
 					"Restricted to " ULINTPF
 					" pages due to "
 					"innodb_buf_pool_dump_pct=%lu",
@@ -323,23 +386,35 @@ buf_dump(
 		return;
 	}
 
-	for (bpage = UT_LIST_GET_FIRST(buf_pool.LRU), j = 0;
-	     bpage != NULL && j < n_pages;
-	     bpage = UT_LIST_GET_NEXT(LRU, bpage)) {
+	/* Rank the pages by how often they were accessed. The LRU list
+	starts with the pages that were accessed again after
+	innodb_old_blocks_time and thus made young. Pages that were read
+	ahead but not accessed since then are the least likely to be
+	needed, and they are dumped last. */
+	j = 0;
+	for (ulint pass = 0; pass < 2; pass++) {
+		for (bpage = UT_LIST_GET_FIRST(buf_pool.LRU);
+		     bpage != NULL && j < n_pages;
+		     bpage = UT_LIST_GET_NEXT(LRU, bpage)) {
 
-		ut_a(bpage->in_file());
-		const page_id_t id(bpage->id());
+			ut_a(bpage->in_file());
+			const page_id_t id(bpage->id());
 
-		if (id.space() == SRV_TMP_SPACE_ID) {
-			/* Ignore the innodb_temporary tablespace. */
-			continue;
-		}
+			if (id.space() == SRV_TMP_SPACE_ID) {
+				/* Ignore the innodb_temporary tablespace. */
+				continue;
+			}
 
-		if (bpage->status == buf_page_t::FREED) {
-			continue;
-		}
+			if (bpage->status == buf_page_t::FREED) {
+				continue;
+			}
 
-		dump[j++] = id;
+			if (!bpage->is_accessed() == !pass) {
+				continue;
+			}
+
+			dump[j++] = id;
+		}
 	}
 
 	mysql_mutex_unlock(&buf_pool.mutex);
@@ -404,7 +479,7 @@ buf_dump(
 
 	ut_sprintf_timestamp(now);
 
-	buf_dump_status(STATUS_INFO,
+	buf_dump_status(info,
 			"Buffer pool(s) dump completed at %s", now);
 
 	/* Though dumping doesn't related to an incomplete load,
@@ -479,6 +554,95 @@ buf_load_throttle_if_needed(
 	*last_activity_count = srv_get_activity_count();
 }
 
+/** Number of dumped pages that buf_load() sorts at a time */
+#define BUF_LOAD_BATCH	1024
+
+/** Start accepting buf_load_request(). */
+static void buf_load_requests_start()
+{
+  std::lock_guard<std::mutex> lk(buf_load_requests.mutex);
+  buf_load_requests.n= 0;
+  buf_load_requests.active= true;
+}
+
+/** Fetch the next tablespace that buf_load_request() asked for.
+@param n         number of requests that were already fetched
+@param space_id  the requested tablespace
+@return whether a request was fetched */
+static bool buf_load_next_request(ulint &n, uint32_t *space_id)
+{
+  if (n >= buf_load_requests.n)
+    return false;
+  std::lock_guard<std::mutex> lk(buf_load_requests.mutex);
+  *space_id= buf_load_requests.space_id[n++];
+  return true;
+}
+
+/** Note that a foreground read missed a page in the buffer pool.
+If a buffer pool load is running, it will read the dumped pages of
+the tablespace before any other pages.
+@param id  page that is being read */
+void buf_load_request(const page_id_t id)
+{
+  if (!buf_load_requests.active ||
+      buf_load_requests.n >= BUF_LOAD_MAX_REQUESTS)
+    return;
+  std::lock_guard<std::mutex> lk(buf_load_requests.mutex);
+  const ulint n= buf_load_requests.n;
+  if (!buf_load_requests.active || n >= BUF_LOAD_MAX_REQUESTS)
+    return;
+  for (ulint i= 0; i < n; i++)
+    if (buf_load_requests.space_id[i] == id.space())
+      return;
+  buf_load_requests.space_id[n]= id.space();
+  buf_load_requests.n= n + 1;
+}
+
+/** Submit an asynchronous read of a dumped page, waiting while
+innodb_buffer_pool_load_io_depth reads are pending.
+@param id     page identifier
+@param space  tablespace of the previous read, or nullptr; updated
+@return whether the page was submitted for reading */
+static bool buf_load_read(const page_id_t id, fil_space_t *&space)
+{
+  if (id.space() == SRV_TMP_SPACE_ID)
+    /* Ignore the innodb_temporary tablespace. */
+    return false;
+
+  if (!space || space->id != id.space())
+  {
+    if (space)
+      space->release();
+    space= fil_space_t::get(id.space());
+    if (!space)
+      return false;
+  }
+
+  /* JAN: TODO: As we use background page read below,
+  if tablespace is encrypted we cant use it. */
+  if (id.page_no() >= space->get_size() ||
+      (space->crypt_data &&
+       space->crypt_data->encryption != FIL_ENCRYPTION_OFF &&
+       space->crypt_data->type != CRYPT_SCHEME_UNENCRYPTED))
+    return false;
+
+  if (space->is_stopping())
+  {
+    space->release();
+    space= nullptr;
+    return false;
+  }
+
+  /* Foreground reads are not limited, and they will get ahead
+  of the load while it is waiting here. */
+  while (buf_pool.n_pend_reads >= srv_buf_load_io_depth && !SHUTTING_DOWN())
+    os_thread_sleep(100);
+
+  space->reacquire();
+  buf_read_page_background(space, id, space->zip_size(), false);
+  return true;
+}
+
 /*****************************************************************//**
 Perform a buffer pool load from the file specified by
 innodb_buffer_pool_filename. If any errors occur then the value of
@@ -621,69 +785,65 @@ buf_load()
 		return;
 	}
 
+	/* dump[] is in the order of buf_dump(), hottest pages first.
+	Read it in batches that are sorted by (space, page), so that the
+	reads are more sequential and fil_space_t::get() is called less often.
+	The copy that is sorted as a whole is for finding the pages of the
+	tablespaces that foreground reads are waiting for. */
+	std::vector<page_id_t>	sorted;
+
 	if (!SHUTTING_DOWN()) {
-		std::sort(dump, dump + dump_n);
+		sorted.assign(dump, dump + dump_n);
+		std::sort(sorted.begin(), sorted.end());
 	}
 
 	ulint		last_check_time = 0;
 	ulint		last_activity_cnt = 0;
-
-	/* Avoid calling the expensive fil_space_t::get() for each
-	page within the same tablespace. dump[] is sorted by (space, page),
-	so all pages from a given tablespace are consecutive. */
-	ulint		cur_space_id = dump[0].space();
-	fil_space_t*	space = fil_space_t::get(cur_space_id);
-	ulint		zip_size = space ? space->zip_size() : 0;
+	ulint		n_io = 0;
+	ulint		n_requests = 0;
+	fil_space_t*	space = nullptr;
 
 	PSI_stage_progress*	pfs_stage_progress __attribute__((unused))
 		= mysql_set_stage(srv_stage_buffer_pool_load.m_key);
 	mysql_stage_set_work_estimated(pfs_stage_progress, dump_n);
 	mysql_stage_set_work_completed(pfs_stage_progress, 0);
 
-	for (i = 0; i < dump_n && !SHUTTING_DOWN(); i++) {
+	buf_load_requests_start();
 
-		/* space_id for this iteration of the loop */
-		const ulint	this_space_id = dump[i].space();
+	for (i = 0; i < dump_n && !SHUTTING_DOWN(); i++) {
 
-		if (this_space_id == SRV_TMP_SPACE_ID) {
-			/* Ignore the innodb_temporary tablespace. */
-			continue;
+		if (!(i % BUF_LOAD_BATCH)) {
+			std::sort(dump + i,
+				  dump + std::min(i + BUF_LOAD_BATCH, dump_n));
 		}
 
-		if (this_space_id != cur_space_id) {
-			if (space) {
-				space->release();
+		/* Let the pages of the tablespaces that foreground reads
+		missed jump the queue. */
+		uint32_t	request;
+
+		while (!buf_load_abort_flag && !SHUTTING_DOWN()
+		       && buf_load_next_request(n_requests, &request)) {
+			for (auto p = std::lower_bound(sorted.begin(),
+						       sorted.end(),
+						       page_id_t(request, 0));
+			     p != sorted.end() && p->space() == request
+			     && !buf_load_abort_flag && !SHUTTING_DOWN();
+			     p++) {
+				if (buf_load_read(*p, space)) {
+					buf_load_throttle_if_needed(
+						&last_check_time,
+						&last_activity_cnt, n_io++);
+				}
 			}
-
-			cur_space_id = this_space_id;
-			space = fil_space_t::get(cur_space_id);
-
-			if (!space) {
-				continue;
-			}
-
-			zip_size = space->zip_size();
 		}
 
-		/* JAN: TODO: As we use background page read below,
-		if tablespace is encrypted we cant use it. */
-		if (!space || dump[i].page_no() >= space->get_size() ||
-		    (space->crypt_data &&
-		     space->crypt_data->encryption != FIL_ENCRYPTION_OFF &&
-		     space->crypt_data->type != CRYPT_SCHEME_UNENCRYPTED)) {
-			continue;
+		if (buf_load_read(dump[i], space)) {
+			buf_load_throttle_if_needed(
+				&last_check_time, &last_activity_cnt, n_io++);
 		}
 
-		if (space->is_stopping()) {
-			space->release();
-			space = nullptr;
-			continue;
-		}
-
-		space->reacquire();
-		buf_read_page_background(space, dump[i], zip_size, true);
-
 		if (buf_load_abort_flag) {
+			buf_load_requests.active = false;
 			if (space) {
 				space->release();
 			}
@@ -702,9 +862,6 @@ buf_load()
 			return;
 		}
 
-		buf_load_throttle_if_needed(
-			&last_check_time, &last_activity_cnt, i);
-
 #ifdef UNIV_DEBUG
 		if ((i+1) >= srv_buf_pool_load_pages_abort) {
 			buf_load_abort_flag = true;
@@ -712,6 +869,8 @@ buf_load()
 #endif
 	}
 
+	buf_load_requests.active = false;
+
 	if (space) {
 		space->release();
 	}
@@ -767,19 +926,28 @@ static void buf_dump_load_func(void *)
 		}
 #endif /* WITH_WSREP */
 	}
-	first_time = false;
+	if (first_time) {
+		/* The load at startup finished: allow periodic dumps */
+		buf_dump_periodic_time = time(NULL);
+		first_time = false;
+	}
 
 	while (!SHUTTING_DOWN()) {
 		if (buf_dump_should_start) {
 			buf_dump_should_start = false;
+			buf_dump_periodic_should_start = false;
 			buf_dump(true);
+		} else if (buf_dump_periodic_should_start) {
+			buf_dump_periodic_should_start = false;
+			buf_dump(true, true);
 		}
 		if (buf_load_should_start) {
 			buf_load_should_start = false;
 			buf_load();
 		}
 
-		if (!buf_dump_should_start && !buf_load_should_start) {
+		if (!buf_dump_should_start && !buf_load_should_start
+		    && !buf_dump_periodic_should_start) {
 			return;
 		}
 	}
@@ -811,6 +979,8 @@ void buf_load_at_startup()
   load_dump_enabled= true;
   if (srv_buffer_pool_load_at_startup)
     buf_do_load_dump();
+  else
+    buf_dump_periodic_time= time(nullptr);
 }
 
 static void buf_do_load_dump()
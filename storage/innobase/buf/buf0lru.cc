@@ -1003,6 +1003,11 @@ buf_LRU_block_free_non_file_page(
 		page_zip_set_size(&block->page.zip, 0);
 	}
 
+	/* The page directory cache will be allocated on demand
+	when the block is used for an index page again. */
+	ut_free(block->dir_cache.exchange(nullptr,
+					  std::memory_order_relaxed));
+
 	if (buf_pool.curr_size < buf_pool.old_size
 	    && UT_LIST_GET_LEN(buf_pool.withdraw) < buf_pool.withdraw_target
 	    && buf_pool.will_be_withdrawn(block->page)) {
@@ -35,6 +35,7 @@ Created 11/5/1995 Heikki Tuuri
 #include "buf0lru.h"
 #include "buf0buddy.h"
 #include "buf0dblwr.h"
+#include "buf0dump.h"
 #include "ibuf0ibuf.h"
 #include "log0recv.h"
 #include "trx0sys.h"
@@ -482,7 +483,10 @@ dberr_t buf_read_page(const page_id_t page_id, ulint zip_size)
   dberr_t err;
   if (buf_read_page_low(&err, space, true, BUF_READ_ANY_PAGE,
 			page_id, zip_size, false))
+  {
     srv_stats.buf_pool_reads.add(1);
+    buf_load_request(page_id);
+  }
 
   buf_LRU_stat_inc_io();
   return err;
@@ -3479,6 +3479,32 @@ fts_query_index_fetch_nodes(
 	}
 }
 
+/** Calculate the inverse document frequency (IDF) of a term.
+@param[in]	total_docs	total number of documents
+@param[in]	doc_count	number of documents containing the term,
+				must not be 0
+@return inverse document frequency */
+static
+double
+fts_query_idf(
+	ib_uint64_t	total_docs,
+	ib_uint64_t	doc_count)
+{
+	ut_ad(doc_count > 0);
+
+	if (total_docs == doc_count) {
+		/* QP assume ranking > 0 if we find
+		a match. Since Log10(1) = 0, we cannot
+		make IDF a zero value if do find a
+		word in all documents. So let's make
+		it an arbitrary very small number */
+		return(log10(1.0001));
+	}
+
+	return(log10(static_cast<double>(total_docs)
+		     / static_cast<double>(doc_count)));
+}
+
 /*****************************************************************//**
 Calculate the inverse document frequency (IDF) for all the terms. */
 static
@@ -3501,19 +3527,8 @@ fts_query_calculate_idf(
 		word_freq = rbt_value(fts_word_freq_t, node);
 
 		if (word_freq->doc_count > 0) {
-			if (total_docs == word_freq->doc_count) {
-				/* QP assume ranking > 0 if we find
-				a match. Since Log10(1) = 0, we cannot
-				make IDF a zero value if do find a
-				word in all documents. So let's make
-				it an arbitrary very small number */
-				word_freq->idf = log10(1.0001);
-			} else {
-				word_freq->idf = log10(
-					static_cast<double>(total_docs)
-					/ static_cast<double>(
-						word_freq->doc_count));
-			}
+			word_freq->idf = fts_query_idf(
+				total_docs, word_freq->doc_count);
 		}
 	}
 }
@@ -3898,6 +3913,601 @@ fts_query_parse(
 	DBUG_RETURN(state.root);
 }
 
+/** Doc id of a posting list cursor that is past the end */
+#define FTS_TOPK_END		(~doc_id_t(0))
+
+/** Relative margin of the rank bounds of a top-k query over the ranks,
+which are accumulated in fts_rank_t and thus rounded */
+#define FTS_TOPK_BOUND_MARGIN	1.00001
+
+/** A block of the posting list of a term: the ilist of an FTS index
+row or of an FTS index cache node */
+struct fts_topk_block_t {
+	doc_id_t	first_doc_id;	/*!< First doc id in ilist */
+	doc_id_t	last_doc_id;	/*!< Last doc id in ilist */
+	ulint		doc_count;	/*!< Number of doc ids in ilist */
+	byte*		ilist;		/*!< Copy of the ilist */
+	ulint		ilist_size;	/*!< Size of ilist in bytes */
+
+	/** @return upper bound of the frequency of the term in a
+	document of the block. Every document of the ilist takes at least
+	one byte for the doc id delta, for a position and for the end
+	of positions marker. */
+	ulint max_freq() const
+	{
+		return(ilist_size >= 3 * doc_count
+		       ? ilist_size - 3 * doc_count + 1 : ilist_size);
+	}
+};
+
+typedef std::vector<fts_topk_block_t, ut_allocator<fts_topk_block_t> >
+	topk_block_vector_t;
+typedef std::vector<fts_doc_freq_t, ut_allocator<fts_doc_freq_t> >
+	topk_posting_vector_t;
+
+/** Cursor on the posting list of a term of a top-k query. A block of
+the posting list is decoded only when a document in it is looked at. */
+struct fts_topk_term_t {
+	fts_string_t	word;		/*!< The term */
+	ulint		doc_count;	/*!< Number of documents that
+					contain the term */
+	double		idf;		/*!< Inverse document frequency */
+	double		max_weight;	/*!< Upper bound of the contribution
+					of the term to the rank */
+	topk_block_vector_t blocks;	/*!< Blocks in doc id order */
+	ulint		block;		/*!< Current block */
+	bool		decoded;	/*!< Whether postings holds the
+					current block */
+	topk_posting_vector_t postings;	/*!< Postings of the current block */
+	ulint		pos;		/*!< Current posting */
+	ulint		block_max_freq;	/*!< Maximum frequency in postings */
+
+	/** @return the current doc id, or FTS_TOPK_END */
+	doc_id_t doc_id() const
+	{
+		if (block == blocks.size()) {
+			return(FTS_TOPK_END);
+		}
+
+		/* The first doc id of a block is that of its first
+		posting, so it need not be decoded for this. */
+		return(decoded
+		       ? postings[pos].doc_id : blocks[block].first_doc_id);
+	}
+
+	/** @return the frequency of the term in the current document */
+	ulint freq()
+	{
+		if (!decoded) {
+			decode();
+		}
+
+		return(postings[pos].freq);
+	}
+
+	/** @return upper bound of the contribution of the term to the
+	rank of a document of the current block */
+	double block_max_weight() const
+	{
+		ulint	max_freq = decoded
+			? block_max_freq : blocks[block].max_freq();
+
+		return(double(max_freq) * idf * idf * FTS_TOPK_BOUND_MARGIN);
+	}
+
+	/** Move to the start of the next block */
+	void next_block()
+	{
+		++block;
+		decoded = false;
+		pos = 0;
+	}
+
+	/** Decode the current block and move to its first posting */
+	void decode();
+
+	/** Move to the first posting whose doc id is not smaller
+	than doc_id */
+	void seek(doc_id_t doc_id);
+
+	/** Skip the blocks whose doc ids are all smaller than doc_id,
+	without decoding them */
+	void skip_blocks(doc_id_t doc_id)
+	{
+		while (block < blocks.size()
+		       && blocks[block].last_doc_id < doc_id) {
+			next_block();
+		}
+	}
+};
+
+void fts_topk_term_t::decode()
+{
+	const fts_topk_block_t&	b = blocks[block];
+	byte*			ptr = b.ilist;
+	doc_id_t		doc_id = 0;
+
+	postings.clear();
+	block_max_freq = 0;
+
+	while (ulint(ptr - b.ilist) < b.ilist_size) {
+		fts_doc_freq_t	posting;
+
+		doc_id += fts_decode_vlc(&ptr);
+
+		posting.doc_id = doc_id;
+		posting.freq = 0;
+
+		/* Count the positions up to the end marker */
+		while (*ptr) {
+			fts_decode_vlc(&ptr);
+			++posting.freq;
+		}
+
+		++ptr;
+
+		block_max_freq = std::max(block_max_freq, posting.freq);
+		postings.push_back(posting);
+	}
+
+	/* Some sanity checks. */
+	ut_a(doc_id == b.last_doc_id);
+	ut_ad(block_max_freq <= b.max_freq());
+
+	decoded = true;
+	pos = 0;
+}
+
+void fts_topk_term_t::seek(doc_id_t doc_id)
+{
+	if (this->doc_id() >= doc_id) {
+		return;
+	}
+
+	skip_blocks(doc_id);
+
+	if (this->doc_id() >= doc_id) {
+		return;
+	}
+
+	if (!decoded) {
+		decode();
+	}
+
+	/* The last doc id of the block is not smaller than doc_id */
+	while (postings[pos].doc_id < doc_id) {
+		++pos;
+	}
+}
+
+/** Argument of fts_query_top_k_fetch_nodes() */
+struct fts_topk_fetch_t {
+	fts_query_t*		query;	/*!< Query instance */
+	fts_topk_term_t*	term;	/*!< Term whose nodes are read */
+};
+
+/** Add a block to the posting list of a term of a top-k query.
+@param[in,out]	query		query instance
+@param[in,out]	term		term of the query
+@param[in]	first_doc_id	first doc id in ilist
+@param[in]	last_doc_id	last doc id in ilist
+@param[in]	doc_count	number of doc ids in ilist
+@param[in]	ilist		doc id ilist
+@param[in]	ilist_size	size of ilist in bytes */
+static
+void
+fts_query_top_k_add_block(
+	fts_query_t*		query,
+	fts_topk_term_t*	term,
+	doc_id_t		first_doc_id,
+	doc_id_t		last_doc_id,
+	ulint			doc_count,
+	const byte*		ilist,
+	ulint			ilist_size)
+{
+	fts_topk_block_t	block;
+
+	block.first_doc_id = first_doc_id;
+	block.last_doc_id = last_doc_id;
+	block.doc_count = doc_count;
+	block.ilist = static_cast<byte*>(
+		mem_heap_dup(query->heap, ilist, ilist_size));
+	block.ilist_size = ilist_size;
+
+	term->blocks.push_back(block);
+	term->doc_count += doc_count;
+}
+
+/*****************************************************************//**
+Callback function to fetch the rows in an FTS INDEX record for a
+top-k query.
+@return always returns TRUE */
+static
+ibool
+fts_query_top_k_fetch_nodes(
+/*========================*/
+	void*		row,		/*!< in: sel_node_t* */
+	void*		user_arg)	/*!< in: pointer to fts_fetch_t */
+{
+	sel_node_t*	sel_node = static_cast<sel_node_t*>(row);
+	fts_fetch_t*	fetch = static_cast<fts_fetch_t*>(user_arg);
+	fts_topk_fetch_t* arg = static_cast<fts_topk_fetch_t*>(
+		fetch->read_arg);
+	const byte*	data[4];
+	ulint		len = 0;
+	ulint		i = 0;
+
+	/* Skip the word, and read DOC_COUNT, FIRST_DOC_ID, LAST_DOC_ID
+	and ILIST. Note: The column numbers must match the SELECT. */
+	for (que_node_t* exp = que_node_get_next(sel_node->select_list);
+	     exp; exp = que_node_get_next(exp), ++i) {
+		dfield_t*	dfield = que_node_get_val(exp);
+
+		ut_a(i < 4);
+		ut_a(dfield_get_len(dfield) != UNIV_SQL_NULL);
+
+		data[i] = static_cast<const byte*>(dfield_get_data(dfield));
+		len = dfield_get_len(dfield);
+	}
+
+	ut_a(i == 4);
+
+	fts_query_top_k_add_block(
+		arg->query, arg->term, fts_read_doc_id(data[1]),
+		fts_read_doc_id(data[2]), mach_read_from_4(data[0]),
+		data[3], len);
+
+	return(TRUE);
+}
+
+/** Read the posting list of a term of a top-k query from the FTS index
+cache and from the FTS index.
+@param[in,out]	query	query instance
+@param[in,out]	term	term of the query
+@return DB_SUCCESS if all go well */
+static
+dberr_t
+fts_query_top_k_fetch(
+	fts_query_t*		query,
+	fts_topk_term_t*	term)
+{
+	fts_cache_t*		cache = query->index->table->fts->cache;
+	const ib_vector_t*	nodes;
+
+	mysql_mutex_lock(&cache->lock);
+
+	const fts_index_cache_t*	index_cache = fts_find_index_cache(
+		cache, query->index);
+
+	/* Must find the index cache. */
+	ut_a(index_cache != NULL);
+
+	nodes = fts_cache_find_word(index_cache, &term->word);
+
+	for (ulint i = 0; nodes && i < ib_vector_size(nodes); ++i) {
+		const fts_node_t*	node = static_cast<const fts_node_t*>(
+			ib_vector_get_const(nodes, i));
+
+		fts_query_top_k_add_block(
+			query, term, node->first_doc_id, node->last_doc_id,
+			node->doc_count, node->ilist, node->ilist_size);
+	}
+
+	mysql_mutex_unlock(&cache->lock);
+
+	fts_topk_fetch_t	arg;
+	fts_fetch_t		fetch;
+	que_t*			graph = NULL;
+
+	arg.query = query;
+	arg.term = term;
+	fetch.read_arg = &arg;
+	fetch.read_record = fts_query_top_k_fetch_nodes;
+
+	/* Read the nodes from disk. */
+	dberr_t	error = fts_index_fetch_nodes(
+		query->trx, &graph, &query->fts_index_table, &term->word,
+		&fetch);
+
+	fts_que_graph_free(graph);
+
+	return(error);
+}
+
+/** Compare the rank of two documents of a top-k query.
+@return whether r1 ranks better than r2; the smaller doc id wins
+a tie, as in the order of fts_query_sort_result_on_rank() */
+static
+bool
+fts_query_top_k_better(
+	const fts_ranking_t&	r1,
+	const fts_ranking_t&	r2)
+{
+	return(r1.rank > r2.rank
+	       || (r1.rank == r2.rank && r1.doc_id < r2.doc_id));
+}
+
+/** Evaluate a natural language query by finding only its best ranked
+documents (top-k). The query must consist of distinct terms without
+wildcards.
+
+The documents are visited in doc id order, and the rank of a document
+is calculated only if the upper bounds of the contributions of its
+terms can rank it above the worst of the best documents found so far
+(WAND). The bound of a term is derived from the size of the ilists of
+its FTS index rows and cache nodes, and the bound of the block at hand
+is checked before the block is decoded, so that blocks that cannot
+contribute are skipped.
+
+The ranks equal those that the complete evaluation calculates.
+@param[in,out]	query	query instance
+@param[in]	limit	number of best ranked documents to find
+@param[out]	result	the best ranked documents
+@return whether the query was evaluated; false if it must be evaluated
+completely */
+static
+bool
+fts_query_top_k(
+	fts_query_t*	query,
+	ulint		limit,
+	fts_result_t**	result)
+{
+	typedef std::vector<fts_topk_term_t, ut_allocator<fts_topk_term_t> >
+		term_vector_t;
+	typedef std::vector<fts_topk_term_t*, ut_allocator<fts_topk_term_t*> >
+		term_ptr_vector_t;
+	typedef std::vector<fts_ranking_t, ut_allocator<fts_ranking_t> >
+		ranking_vector_t;
+
+	term_vector_t	terms;
+	CHARSET_INFO*	charset = query->fts_index_table.charset;
+
+	ut_ad(limit > 0);
+	ut_ad(!query->boolean_mode);
+
+	for (const fts_ast_node_t* node = query->root->list.head;
+	     node != NULL; node = node->next) {
+		fts_string_t	word;
+
+		if (node->type != FTS_AST_TERM || node->term.wildcard) {
+			return(false);
+		}
+
+		word.f_str = node->term.ptr->str;
+		word.f_len = node->term.ptr->len;
+		word.f_n_char = 0;
+
+		/* The complete evaluation adds up the statistics of
+		a repeated term */
+		for (const fts_topk_term_t& term : terms) {
+			if (!innobase_fts_text_cmp(charset, &word,
+						   &term.word)) {
+				return(false);
+			}
+		}
+
+		terms.resize(terms.size() + 1);
+		terms.back().word = word;
+	}
+
+	if (terms.empty()) {
+		return(false);
+	}
+
+	for (fts_topk_term_t& term : terms) {
+		query->error = fts_query_top_k_fetch(query, &term);
+
+		if (query->error != DB_SUCCESS) {
+			return(true);
+		}
+
+		std::sort(term.blocks.begin(), term.blocks.end(),
+			  [](const fts_topk_block_t& b1,
+			     const fts_topk_block_t& b2)
+			  {
+				  return(b1.first_doc_id < b2.first_doc_id);
+			  });
+
+		/* A document can only be looked at once */
+		for (ulint i = 1; i < term.blocks.size(); ++i) {
+			if (term.blocks[i - 1].last_doc_id
+			    >= term.blocks[i].first_doc_id) {
+				return(false);
+			}
+		}
+	}
+
+	ulint		n_deleted = ib_vector_size(query->deleted->doc_ids);
+	doc_id_t*	deleted = static_cast<doc_id_t*>(
+		query->deleted->doc_ids->data);
+
+	if (terms.size() == 1) {
+		/* As with FTS_OPT_RANKING, the deleted documents are
+		not counted in the IDF of a single term */
+		fts_topk_term_t&	term = terms[0];
+
+		for (term.block = 0; term.block < term.blocks.size();
+		     ++term.block) {
+			const fts_topk_block_t&	b = term.blocks[term.block];
+
+			if (std::lower_bound(deleted, deleted + n_deleted,
+					     b.first_doc_id)
+			    == std::upper_bound(deleted, deleted + n_deleted,
+						b.last_doc_id)) {
+				continue;
+			}
+
+			term.decode();
+
+			for (const fts_doc_freq_t& posting : term.postings) {
+				if (fts_bsearch(deleted, 0, int(n_deleted),
+						posting.doc_id) >= 0) {
+					--term.doc_count;
+				}
+			}
+		}
+
+		term.block = 0;
+		term.decoded = false;
+	}
+
+	term_ptr_vector_t	order;
+
+	for (fts_topk_term_t& term : terms) {
+		ulint	max_freq = 0;
+
+		term.idf = term.doc_count
+			? fts_query_idf(query->total_docs, term.doc_count)
+			: 0;
+
+		for (const fts_topk_block_t& b : term.blocks) {
+			max_freq = std::max(max_freq, b.max_freq());
+		}
+
+		term.max_weight = double(max_freq) * term.idf * term.idf
+			* FTS_TOPK_BOUND_MARGIN;
+
+		order.push_back(&term);
+	}
+
+	/* The best documents found so far, the worst of them first */
+	ranking_vector_t	best;
+
+	for (;;) {
+		std::sort(order.begin(), order.end(),
+			  [](const fts_topk_term_t* t1,
+			     const fts_topk_term_t* t2)
+			  {
+				  return(t1->doc_id() < t2->doc_id());
+			  });
+
+		const double	threshold = best.size() < limit
+			? -1.0 : double(best.front().rank);
+		double		bound = 0;
+		ulint		pivot;
+
+		/* Find the first document that the terms up to and
+		including the pivot term can rank above the threshold.
+		The documents before it cannot rank above it. */
+		for (pivot = 0; pivot < order.size()
+		     && order[pivot]->doc_id() != FTS_TOPK_END; ++pivot) {
+			bound += order[pivot]->max_weight;
+
+			if (bound > threshold) {
+				break;
+			}
+		}
+
+		if (pivot == order.size()
+		    || order[pivot]->doc_id() == FTS_TOPK_END) {
+			break;
+		}
+
+		const doc_id_t	doc_id = order[pivot]->doc_id();
+		doc_id_t	next = FTS_TOPK_END;
+
+		for (ulint i = 0; i < pivot; ++i) {
+			order[i]->skip_blocks(doc_id);
+		}
+
+		/* Check the bounds of the blocks that may contain doc_id.
+		They hold for all the documents up to next. */
+		bound = 0;
+
+		for (const fts_topk_term_t* term : order) {
+			if (term->block == term->blocks.size()) {
+				continue;
+			}
+
+			const fts_topk_block_t&	b = term->blocks[term->block];
+
+			if (b.first_doc_id <= doc_id) {
+				bound += term->block_max_weight();
+				next = std::min(next, b.last_doc_id + 1);
+			} else {
+				next = std::min(next, term->doc_id());
+			}
+		}
+
+		if (bound <= threshold) {
+			for (fts_topk_term_t* term : order) {
+				term->seek(next);
+			}
+
+			continue;
+		}
+
+		for (ulint i = 0; i < pivot; ++i) {
+			order[i]->seek(doc_id);
+		}
+
+		if (fts_bsearch(deleted, 0, int(n_deleted), doc_id) < 0) {
+			fts_ranking_t	ranking;
+
+			ranking.doc_id = doc_id;
+			ranking.words = NULL;
+
+			if (terms.size() == 1) {
+				/* As in fts_query_prepare_result() */
+				ranking.rank = static_cast<fts_rank_t>(
+					terms[0].freq());
+				ranking.rank = static_cast<fts_rank_t>(
+					ranking.rank * terms[0].idf
+					* terms[0].idf);
+			} else {
+				/* As in fts_query_calculate_ranking(),
+				which adds up the terms in query order */
+				ranking.rank = 0;
+
+				for (fts_topk_term_t& term : terms) {
+					if (term.doc_id() != doc_id) {
+						continue;
+					}
+
+					double	weight = (double) term.freq()
+						* term.idf;
+
+					ranking.rank += (fts_rank_t) (
+						weight * term.idf);
+				}
+			}
+
+			if (best.size() < limit) {
+				best.push_back(ranking);
+				std::push_heap(best.begin(), best.end(),
+					       fts_query_top_k_better);
+			} else if (fts_query_top_k_better(
+					   ranking, best.front())) {
+				std::pop_heap(best.begin(), best.end(),
+					      fts_query_top_k_better);
+				best.back() = ranking;
+				std::push_heap(best.begin(), best.end(),
+					       fts_query_top_k_better);
+			}
+		}
+
+		for (fts_topk_term_t* term : order) {
+			if (term->doc_id() == doc_id) {
+				term->seek(doc_id + 1);
+			}
+		}
+	}
+
+	*result = static_cast<fts_result_t*>(ut_zalloc_nokey(sizeof(**result)));
+
+	(*result)->rankings_by_id = rbt_create(
+		sizeof(fts_ranking_t), fts_ranking_doc_id_cmp);
+
+	for (const fts_ranking_t& ranking : best) {
+		rbt_insert((*result)->rankings_by_id, &ranking, &ranking);
+	}
+
+	/* Documents that rank below the result may have been left out */
+	(*result)->limited = best.size() == limit;
+
+	return(true);
+}
+
 /*******************************************************************//**
 FTS Query optimization
 Set FTS_OPT_RANKING if it is a simple term query */
@@ -3929,6 +4539,8 @@ fts_query_can_optimize(
 @param[in]	query_str	FTS query
 @param[in]	query_len	FTS query string len in bytes
 @param[in,out]	result		result doc ids
+@param[in]	limit		number of best ranked documents that
+				will be read, or ULINT_UNDEFINED
 @return DB_SUCCESS if successful otherwise error code */
 dberr_t
 fts_query(
@@ -3937,7 +4549,8 @@ fts_query(
 	uint		flags,
 	const byte*	query_str,
 	ulint		query_len,
-	fts_result_t**	result)
+	fts_result_t**	result,
+	ulint		limit)
 {
 	fts_query_t	query;
 	dberr_t		error = DB_SUCCESS;
@@ -4067,11 +4680,20 @@ fts_query(
 			        fts_result_cache_limit = 2048;
 		);
 
+		/* If only the best ranked documents will be read,
+		try to find just them. */
+		const bool	top_k = limit != ULINT_UNDEFINED && limit
+			&& !(flags & (FTS_BOOL | FTS_EXPAND))
+			&& fts_query_top_k(&query, limit, result);
+
 		/* Traverse the Abstract Syntax Tree (AST) and execute
 		the query. */
-		query.error = fts_ast_visit(
-			FTS_NONE, ast, fts_query_visitor,
-			&query, &will_be_ignored);
+		if (!top_k) {
+			query.error = fts_ast_visit(
+				FTS_NONE, ast, fts_query_visitor,
+				&query, &will_be_ignored);
+		}
+
 		if (query.error == DB_INTERRUPTED) {
 			error = DB_INTERRUPTED;
 			ut_free(lc_query_str);
@@ -4085,14 +4707,14 @@ fts_query(
 		}
 
 		/* Calculate the inverse document frequency of the terms. */
-		if (query.error == DB_SUCCESS
+		if (query.error == DB_SUCCESS && !top_k
 		    && query.flags != FTS_OPT_RANKING) {
 			fts_query_calculate_idf(&query);
 		}
 
 		/* Copy the result from the query state, so that we can
 		return it to the caller. */
-		if (query.error == DB_SUCCESS) {
+		if (query.error == DB_SUCCESS && !top_k) {
 			*result = fts_query_get_result(&query, *result);
 		}
 
@@ -4163,6 +4785,37 @@ fts_query_free_result(
 	}
 }
 
+/** Remove the documents of a limited result of a query from the
+result on rank of the same query.
+@param[in,out]	result	result sorted by fts_query_sort_result_on_rank()
+@param[in]	limited	result limited to the best ranked documents */
+void
+fts_query_exclude_result(
+	fts_result_t*		result,
+	const fts_result_t*	limited)
+{
+	ut_ad(result->rankings_by_rank != NULL);
+	ut_ad(limited->limited);
+
+	for (const ib_rbt_node_t* node = rbt_first(limited->rankings_by_id);
+	     node != NULL;
+	     node = rbt_next(limited->rankings_by_id, node)) {
+
+		ib_rbt_bound_t		parent;
+		const fts_ranking_t*	ranking;
+
+		ranking = rbt_value(fts_ranking_t, node);
+
+		/* The rank tree is searched by the rank of the
+		document in this result */
+		if (rbt_search(result->rankings_by_id, &parent,
+			       ranking) == 0) {
+			rbt_delete(result->rankings_by_rank,
+				   rbt_value(fts_ranking_t, parent.last));
+		}
+	}
+}
+
 /*****************************************************************//**
 FTS Query sort result, returned by fts_query() on fts_ranking_t::rank. */
 void
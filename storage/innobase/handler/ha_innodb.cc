@@ -103,6 +103,7 @@ this program; if not, write to the Free Software Foundation, Inc.,
 #include "row0quiesce.h"
 #include "row0sel.h"
 #include "row0upd.h"
+#include "row0vers.h"
 #include "fil0crypt.h"
 #include "srv0mon.h"
 #include "srv0start.h"
@@ -970,6 +971,9 @@ static SHOW_VAR innodb_status_variables[]= {
   {"ibuf_merges", &ibuf.n_merges, SHOW_SIZE_T},
   {"ibuf_segment_size", &ibuf.seg_size, SHOW_SIZE_T},
   {"ibuf_size", &ibuf.size, SHOW_SIZE_T},
+  {"log_page_image_bytes",
+   &export_vars.innodb_log_page_image_bytes, SHOW_ULONGLONG},
+  {"log_page_images", &export_vars.innodb_log_page_images, SHOW_SIZE_T},
   {"log_waits", &export_vars.innodb_log_waits, SHOW_SIZE_T},
   {"log_write_requests", &export_vars.innodb_log_write_requests, SHOW_SIZE_T},
   {"log_writes", &export_vars.innodb_log_writes, SHOW_SIZE_T},
@@ -1066,6 +1070,12 @@ static SHOW_VAR innodb_status_variables[]= {
   {"secondary_index_triggered_cluster_reads_avoided",
    &export_vars.innodb_sec_rec_cluster_reads_avoided, SHOW_SIZE_T},
 
+  /* Old record versions found and not found in the version cache */
+  {"version_cache_hits",
+   &export_vars.innodb_version_cache_hits, SHOW_SIZE_T},
+  {"version_cache_misses",
+   &export_vars.innodb_version_cache_misses, SHOW_SIZE_T},
+
   /* Encryption */
   {"encryption_rotation_pages_read_from_cache",
    &export_vars.innodb_encryption_rotation_pages_read_from_cache, SHOW_SIZE_T},
@@ -2527,10 +2537,12 @@ ha_innobase::ha_innobase(
                           | HA_CAN_TABLES_WITHOUT_ROLLBACK
                           | HA_CAN_ONLINE_BACKUPS
 			  | HA_CONCURRENT_OPTIMIZE
+			  | HA_CAN_READ_BATCH
 			  |  (srv_force_primary_key ? HA_REQUIRE_PRIMARY_KEY : 0)
 		  ),
 	m_start_of_scan(),
-        m_mysql_has_locked()
+        m_mysql_has_locked(),
+	m_ignore_dup_key()
 {}
 
 /*********************************************************************//**
@@ -4006,6 +4018,14 @@ innobase_commit(
 	bool	read_only = trx->read_only || trx->id == 0;
 	DBUG_PRINT("info", ("readonly: %d", read_only));
 
+	if (UNIV_UNLIKELY(trx->bulk_insert_pending)
+	    && !trx->active_commit_ordered) {
+		/* handler::end_bulk_insert() was not invoked */
+		if (dberr_t err = trx->bulk_insert_apply()) {
+			DBUG_RETURN(convert_error_code_to_mysql(err, 0, thd));
+		}
+	}
+
 	if (commit_trx
 	    || (!thd_test_options(thd, OPTION_NOT_AUTOCOMMIT | OPTION_BEGIN))) {
 
@@ -7277,6 +7297,46 @@ bool ha_innobase::is_read_only() const
   return true;
 }
 
+/** Start a multi-row insert. If the table turns out to be empty, the
+index entries of the inserted rows may be buffered, sorted and loaded
+into the indexes in end_bulk_insert().
+@param rows   estimated number of rows, or 0 if unknown
+@param flags  HA_CREATE_UNIQUE_INDEX_BY_SORT or 0 */
+void ha_innobase::start_bulk_insert(ha_rows rows, uint flags)
+{
+	/* Duplicates can only be reported at the end of the statement,
+	so they cannot be ignored, replaced or updated row by row.
+	Triggers could observe the rows that were inserted so far. */
+	m_prebuilt->bulk_insert_buffer = !m_ignore_dup_key
+		&& !m_prebuilt->trx->duplicates
+		&& !table->triggers
+		&& row_merge_bulk_t::is_supported(*m_prebuilt->table);
+}
+
+/** Load any buffered rows of a multi-row insert into the indexes.
+@return error code */
+int ha_innobase::end_bulk_insert()
+{
+	trx_t*	trx = m_prebuilt->trx;
+
+	m_prebuilt->bulk_insert_buffer = false;
+
+	if (!trx->bulk_insert_pending) {
+		return(0);
+	}
+
+	dberr_t	err = trx->bulk_insert_apply(*m_prebuilt->table, table);
+
+	if (err == DB_SUCCESS) {
+		return(0);
+	}
+
+	int	error = convert_error_code_to_mysql(
+		err, m_prebuilt->table->flags, m_user_thd);
+	my_errno = error;
+	return(error);
+}
+
 /********************************************************************//**
 Stores a row in an InnoDB database, to the table specified in this
 handle.
@@ -8889,6 +8949,54 @@ ha_innobase::index_next(
 	return(general_fetch(buf, ROW_SEL_NEXT, 0));
 }
 
+/** Copy rows of a forward scan from the prefetch cache, which
+row_search_mvcc() filled while the page was latched.
+@param[out]	buf		buffer for max_rows rows
+@param[in]	stride		distance between the rows in buf
+@param[in]	max_rows	maximum number of rows to copy
+@return number of rows copied */
+uint
+ha_innobase::fetch_cached_rows(uchar* buf, size_t stride, uint max_rows)
+{
+	if (!max_rows || !m_prebuilt->n_fetch_cached) {
+		return(0);
+	}
+
+	ulint	n_rows = row_sel_dequeue_cached_rows(
+		buf, stride, max_rows, m_prebuilt);
+
+	if (m_prebuilt->table->is_system_db) {
+		srv_stats.n_system_rows_read.add(
+			thd_get_thread_id(m_prebuilt->trx->mysql_thd), n_rows);
+	} else {
+		srv_stats.n_rows_read.add(
+			thd_get_thread_id(m_prebuilt->trx->mysql_thd), n_rows);
+	}
+
+	return(uint(n_rows));
+}
+
+/** Read the next rows of an index scan. The first row is read with
+row_search_mvcc(), the others are taken from the prefetch cache.
+@param[out]	buf		buffer for max_rows rows in MySQL format
+@param[in]	stride		distance between the rows in buf
+@param[in]	max_rows	maximum number of rows to read
+@param[out]	rows		number of rows read
+@return 0, HA_ERR_END_OF_FILE, or error number */
+int
+ha_innobase::index_next_batch(
+	uchar*	buf,
+	size_t	stride,
+	uint	max_rows,
+	uint*	rows)
+{
+	int	error = general_fetch(buf, ROW_SEL_NEXT, 0);
+
+	*rows = error ? 0 : 1 + fetch_cached_rows(buf + stride, stride,
+						  max_rows - 1);
+	return(error);
+}
+
 /*******************************************************************//**
 Reads the next row matching to the key value given as the parameter.
 @return 0, HA_ERR_END_OF_FILE, or error number */
@@ -9034,6 +9142,23 @@ ha_innobase::rnd_next(
 	DBUG_RETURN(error);
 }
 
+/** Read the next rows of a table scan.
+@see ha_innobase::index_next_batch()
+@return 0, HA_ERR_END_OF_FILE, or error number */
+int
+ha_innobase::rnd_next_batch(
+	uchar*	buf,
+	size_t	stride,
+	uint	max_rows,
+	uint*	rows)
+{
+	int	error = rnd_next(buf);
+
+	*rows = error ? 0 : 1 + fetch_cached_rows(buf + stride, stride,
+						  max_rows - 1);
+	return(error);
+}
+
 /**********************************************************************//**
 Fetches a row from the table based on a row reference.
 @return 0, HA_ERR_KEY_NOT_FOUND, or error code */
@@ -9093,11 +9218,14 @@ Initialize FT index scan
 @return FT_INFO structure if successful or NULL */
 
 FT_INFO*
-ha_innobase::ft_init_ext(
-/*=====================*/
+ha_innobase::ft_init_ext_with_limit(
+/*================================*/
 	uint			flags,	/* in: */
 	uint			keynr,	/* in: */
-	String*			key)	/* in: */
+	String*			key,	/* in: */
+	ha_rows			limit)	/* in: number of best ranked
+					rows that will be read, or
+					HA_POS_ERROR */
 {
 	NEW_FT_INFO*		fts_hdl = NULL;
 	dict_index_t*		index;
@@ -9188,22 +9316,38 @@ ha_innobase::ft_init_ext(
 	const byte*	q = reinterpret_cast<const byte*>(
 		const_cast<char*>(query));
 
-	// FIXME: support ft_init_ext_with_hints(), pass LIMIT
-	dberr_t	error = fts_query(trx, index, flags, q, query_len, &result);
+	dberr_t	error = fts_query(trx, index, flags, q, query_len, &result,
+				  limit < ULINT_UNDEFINED
+				  ? ulint(limit) : ULINT_UNDEFINED);
 
 	if (error != DB_SUCCESS) {
 		my_error(convert_error_code_to_mysql(error, 0, NULL), MYF(0));
 		return(NULL);
 	}
 
-	/* Allocate FTS handler, and instantiate it before return */
+	/* Allocate FTS handler, and instantiate it before return. A
+	limited result keeps a copy of the query after the handler. */
+	const ulint	query_copy_len = result->limited ? query_len : 0;
+
 	fts_hdl = reinterpret_cast<NEW_FT_INFO*>(
-		my_malloc(PSI_INSTRUMENT_ME, sizeof(NEW_FT_INFO), MYF(0)));
+		my_malloc(PSI_INSTRUMENT_ME,
+			  sizeof(NEW_FT_INFO) + query_copy_len, MYF(0)));
 
 	fts_hdl->please = const_cast<_ft_vft*>(&ft_vft_result);
 	fts_hdl->could_you = const_cast<_ft_vft_ext*>(&ft_vft_ext_result);
 	fts_hdl->ft_prebuilt = m_prebuilt;
 	fts_hdl->ft_result = result;
+	fts_hdl->ft_query = NULL;
+	fts_hdl->ft_query_len = query_copy_len;
+	fts_hdl->ft_flags = flags;
+	fts_hdl->ft_index = index;
+	fts_hdl->ft_skipped = false;
+
+	if (result->limited) {
+		byte*	copy = reinterpret_cast<byte*>(fts_hdl + 1);
+		memcpy(copy, q, query_copy_len);
+		fts_hdl->ft_query = copy;
+	}
 
 	/* FIXME: Re-evaluate the condition when Bug 14469540 is resolved */
 	m_prebuilt->in_fts_query = true;
@@ -9255,6 +9399,50 @@ innobase_fts_create_doc_id_key(
 	}
 }
 
+/** Replace a result that fts_query() limited to the best ranked
+documents with the rest of the complete result. This is needed when
+ft_read() skipped documents of the limited result that are not visible
+to the transaction, and the limited result ran out of rows.
+@param[in,out]	fts_hdl	FTS handler
+@param[in,out]	trx	transaction
+@return error code */
+static
+dberr_t
+innobase_fts_read_complete(
+	NEW_FT_INFO*	fts_hdl,
+	trx_t*		trx)
+{
+	fts_result_t*	limited = fts_hdl->ft_result;
+	fts_result_t*	result;
+
+	ut_ad(limited->limited);
+
+	dberr_t	error = fts_query(trx, fts_hdl->ft_index, fts_hdl->ft_flags,
+				  fts_hdl->ft_query, fts_hdl->ft_query_len,
+				  &result, ULINT_UNDEFINED);
+
+	if (error != DB_SUCCESS) {
+		return(error);
+	}
+
+	if (result->rankings_by_id != NULL) {
+		fts_query_sort_result_on_rank(result);
+
+		/* The documents of the limited result were read already */
+		fts_query_exclude_result(result, limited);
+
+		result->current = const_cast<ib_rbt_node_t*>(
+			rbt_first(result->rankings_by_rank));
+	}
+
+	fts_query_free_result(limited);
+
+	fts_hdl->ft_result = result;
+	fts_hdl->ft_query = NULL;
+
+	return(DB_SUCCESS);
+}
+
 /**********************************************************************//**
 Fetch next result from the FT result set
 @return error code */
@@ -9264,15 +9452,16 @@ ha_innobase::ft_read(
 /*=================*/
 	uchar*		buf)		/*!< in/out: buf contain result row */
 {
+	NEW_FT_INFO*	fts_hdl = reinterpret_cast<NEW_FT_INFO*>(ft_handler);
 	row_prebuilt_t*	ft_prebuilt;
 
-	ft_prebuilt = reinterpret_cast<NEW_FT_INFO*>(ft_handler)->ft_prebuilt;
+	ft_prebuilt = fts_hdl->ft_prebuilt;
 
 	ut_a(ft_prebuilt == m_prebuilt);
 
 	fts_result_t*	result;
 
-	result = reinterpret_cast<NEW_FT_INFO*>(ft_handler)->ft_result;
+	result = fts_hdl->ft_result;
 
 	if (result->current == NULL) {
 		/* This is the case where the FTS query did not
@@ -9296,6 +9485,22 @@ ha_innobase::ft_read(
 
 next_record:
 
+	if (result->current == NULL && fts_hdl->ft_skipped
+	    && fts_hdl->ft_query != NULL) {
+		/* The limited result did not have enough visible
+		documents for the LIMIT of the query */
+		fts_hdl->ft_skipped = false;
+
+		if (dberr_t err = innobase_fts_read_complete(
+			    fts_hdl, m_prebuilt->trx)) {
+			table->status = STATUS_NOT_FOUND;
+			return(convert_error_code_to_mysql(
+				       err, 0, m_user_thd));
+		}
+
+		result = fts_hdl->ft_result;
+	}
+
 	if (result->current != NULL) {
 		doc_id_t	search_doc_id;
 		dtuple_t*	tuple = m_prebuilt->search_tuple;
@@ -9346,11 +9551,13 @@ ha_innobase::ft_read(
 			table->status = 0;
 			break;
 		case DB_RECORD_NOT_FOUND:
+			fts_hdl->ft_skipped = true;
+
 			result->current = const_cast<ib_rbt_node_t*>(
 				rbt_next(result->rankings_by_rank,
 					 result->current));
 
-			if (!result->current) {
+			if (!result->current && !fts_hdl->ft_query) {
 				/* exhaust the result set, should return
 				HA_ERR_END_OF_FILE just like
 				ha_innobase::general_fetch() and/or
@@ -15119,7 +15326,11 @@ ha_innobase::extra(
 	case HA_EXTRA_INSERT_WITH_UPDATE:
 		trx->duplicates |= TRX_DUP_IGNORE;
 		goto stmt_boundary;
+	case HA_EXTRA_IGNORE_DUP_KEY:
+		m_ignore_dup_key = true;
+		break;
 	case HA_EXTRA_NO_IGNORE_DUP_KEY:
+		m_ignore_dup_key = false;
 		trx->duplicates &= ~TRX_DUP_IGNORE;
 		goto stmt_boundary;
 	case HA_EXTRA_WRITE_CAN_REPLACE:
@@ -15173,6 +15384,9 @@ ha_innobase::reset()
 	/* This is a statement level counter. */
 	m_prebuilt->autoinc_last_value = 0;
 
+	m_prebuilt->bulk_insert_buffer = false;
+	m_ignore_dup_key = false;
+
 	return(0);
 }
 
@@ -16362,6 +16576,12 @@ innobase_xa_prepare(
 
 	thd_get_xid(thd, (MYSQL_XID*) trx->xid);
 
+	if (UNIV_UNLIKELY(trx->bulk_insert_pending)) {
+		if (dberr_t err = trx->bulk_insert_apply()) {
+			return(convert_error_code_to_mysql(err, 0, thd));
+		}
+	}
+
 	if (!trx_is_registered_for_2pc(trx) && trx_is_started(trx)) {
 
 		sql_print_error("Transaction not registered for MariaDB 2PC,"
@@ -16780,6 +17000,17 @@ innodb_buffer_pool_size_update(THD*,st_mysql_sys_var*,void*, const void* save)
 		<< " (new size: " << in_val << " bytes)";
 }
 
+/** Update innodb_version_cache_size.
+@param[in]	save	the new value */
+static void innodb_version_cache_size_update(THD*, st_mysql_sys_var*, void*,
+					     const void* save)
+{
+	srv_version_cache_size = *static_cast<const size_t*>(save);
+	mysql_mutex_unlock(&LOCK_global_system_variables);
+	row_vers_cache_resize();
+	mysql_mutex_lock(&LOCK_global_system_variables);
+}
+
 /** The latest assigned innodb_ft_aux_table name */
 static char* innodb_ft_aux_table;
 
@@ -18500,6 +18731,12 @@ static MYSQL_SYSVAR_ULONG(buffer_pool_dump_pct, srv_buf_pool_dump_pct,
   "Dump only the hottest N% of each buffer pool, defaults to 25",
   NULL, NULL, 25, 1, 100, 0);
 
+static MYSQL_SYSVAR_ULONG(buffer_pool_dump_interval, srv_buf_dump_interval,
+  PLUGIN_VAR_RQCMDARG,
+  "Dump the buffer pool every N seconds if pages were read into it"
+  " since the previous dump (0=only on demand and at shutdown)",
+  NULL, NULL, 0, 0, 86400, 0);
+
 #ifdef UNIV_DEBUG
 /* Added to test the innodb_buffer_pool_load_incomplete status variable. */
 static MYSQL_SYSVAR_ULONG(buffer_pool_load_pages_abort, srv_buf_pool_load_pages_abort,
@@ -18529,6 +18766,11 @@ static MYSQL_SYSVAR_BOOL(buffer_pool_load_at_startup, srv_buffer_pool_load_at_st
   "Load the buffer pool from a file named @@innodb_buffer_pool_filename",
   NULL, NULL, TRUE);
 
+static MYSQL_SYSVAR_ULONG(buffer_pool_load_io_depth, srv_buf_load_io_depth,
+  PLUGIN_VAR_RQCMDARG,
+  "Maximum number of pending page reads of a buffer pool load",
+  NULL, NULL, 64, 1, 4096, 0);
+
 static MYSQL_SYSVAR_BOOL(defragment, srv_defragment,
   PLUGIN_VAR_RQCMDARG,
   "Enable/disable InnoDB defragmentation (default FALSE). When set to FALSE, all existing "
@@ -18668,6 +18910,13 @@ static MYSQL_SYSVAR_ULONG(sort_buffer_size, srv_sort_buf_size,
   "Memory buffer size for index creation",
   NULL, NULL, 1048576, 65536, 64<<20, 0);
 
+static MYSQL_SYSVAR_ULONG(alter_parallel_threads, srv_alter_parallel_threads,
+  PLUGIN_VAR_RQCMDARG,
+  "Number of threads that read the clustered index and merge-sort the"
+  " index entries when creating secondary indexes (1 disables parallel"
+  " index creation). Each thread allocates its own sort buffers.",
+  NULL, NULL, 1, 1, 64, 0);
+
 static MYSQL_SYSVAR_ULONGLONG(online_alter_log_max_size, srv_online_max_size,
   PLUGIN_VAR_RQCMDARG,
   "Maximum modification log file size for online index creation",
@@ -18812,6 +19061,31 @@ static MYSQL_SYSVAR_BOOL(use_native_aio, srv_use_native_aio,
   "Use native AIO if supported on this platform.",
   NULL, NULL, TRUE);
 
+static MYSQL_SYSVAR_BOOL(csn_snapshots, srv_csn_snapshots,
+  PLUGIN_VAR_NOCMDARG | PLUGIN_VAR_READONLY,
+  "Create read views as snapshots of the commit sequence number,"
+  " without copying the ids of the active transactions.",
+  NULL, NULL, FALSE);
+
+static MYSQL_SYSVAR_SIZE_T(version_cache_size, srv_version_cache_size,
+  PLUGIN_VAR_RQCMDARG,
+  "Maximum memory in bytes for caching old versions of records"
+  " that consistent reads built from the undo log (0=disable)",
+  NULL, innodb_version_cache_size_update, 0, 0, SIZE_T_MAX, 0);
+
+static MYSQL_SYSVAR_BOOL(log_page_images, srv_log_page_images,
+  PLUGIN_VAR_NOCMDARG,
+  "Write an image of each page to the redo log on its first modification"
+  " after the page was written, so that crash recovery can restore torn"
+  " pages without the doublewrite buffer (innodb_doublewrite=OFF).",
+  NULL, NULL, FALSE);
+
+static MYSQL_SYSVAR_BOOL(page_search_cache, srv_page_search_cache,
+  PLUGIN_VAR_OPCMDARG,
+  "Cache prefixes of the first key field of page directory records"
+  " to narrow down searches within index pages.",
+  NULL, NULL, FALSE);
+
 #ifdef HAVE_LIBNUMA
 static MYSQL_SYSVAR_BOOL(numa_interleave, srv_numa_interleave,
   PLUGIN_VAR_NOCMDARG | PLUGIN_VAR_READONLY,
@@ -19144,6 +19418,7 @@ static struct st_mysql_sys_var* innobase_system_variables[]= {
   MYSQL_SYSVAR(buffer_pool_dump_now),
   MYSQL_SYSVAR(buffer_pool_dump_at_shutdown),
   MYSQL_SYSVAR(buffer_pool_dump_pct),
+  MYSQL_SYSVAR(buffer_pool_dump_interval),
 #ifdef UNIV_DEBUG
   MYSQL_SYSVAR(buffer_pool_evict),
 #endif /* UNIV_DEBUG */
@@ -19153,6 +19428,7 @@ static struct st_mysql_sys_var* innobase_system_variables[]= {
   MYSQL_SYSVAR(buffer_pool_load_pages_abort),
 #endif /* UNIV_DEBUG */
   MYSQL_SYSVAR(buffer_pool_load_at_startup),
+  MYSQL_SYSVAR(buffer_pool_load_io_depth),
   MYSQL_SYSVAR(defragment),
   MYSQL_SYSVAR(defragment_n_pages),
   MYSQL_SYSVAR(defragment_stats_accuracy),
@@ -19229,6 +19505,7 @@ static struct st_mysql_sys_var* innobase_system_variables[]= {
   MYSQL_SYSVAR(status_file),
   MYSQL_SYSVAR(strict_mode),
   MYSQL_SYSVAR(sort_buffer_size),
+  MYSQL_SYSVAR(alter_parallel_threads),
   MYSQL_SYSVAR(online_alter_log_max_size),
   MYSQL_SYSVAR(sync_spin_loops),
   MYSQL_SYSVAR(spin_wait_delay),
@@ -19238,6 +19515,10 @@ static struct st_mysql_sys_var* innobase_system_variables[]= {
   MYSQL_SYSVAR(autoinc_lock_mode),
   MYSQL_SYSVAR(version),
   MYSQL_SYSVAR(use_native_aio),
+  MYSQL_SYSVAR(csn_snapshots),
+  MYSQL_SYSVAR(version_cache_size),
+  MYSQL_SYSVAR(log_page_images),
+  MYSQL_SYSVAR(page_search_cache),
 #ifdef HAVE_LIBNUMA
   MYSQL_SYSVAR(numa_interleave),
 #endif /* HAVE_LIBNUMA */
@@ -109,6 +109,10 @@ class ha_innobase final : public handler
 
 	int write_row(const uchar * buf) override;
 
+	void start_bulk_insert(ha_rows rows, uint flags) override;
+
+	int end_bulk_insert() override;
+
 	int update_row(const uchar * old_data, const uchar * new_data) override;
 
 	int delete_row(const uchar * buf) override;
@@ -134,6 +138,9 @@ class ha_innobase final : public handler
 
         int index_next(uchar * buf) override;
 
+	int index_next_batch(uchar *buf, size_t stride, uint max_rows,
+			     uint *rows) override;
+
 	int index_next_same(uchar * buf, const uchar * key,
 			    uint keylen) override;
 
@@ -153,11 +160,19 @@ class ha_innobase final : public handler
 
 	int rnd_next(uchar *buf) override;
 
+	int rnd_next_batch(uchar *buf, size_t stride, uint max_rows,
+			   uint *rows) override;
+
 	int rnd_pos(uchar * buf, uchar *pos) override;
 
 	int ft_init() override;
 	void ft_end() override { rnd_end(); }
-	FT_INFO *ft_init_ext(uint flags, uint inx, String* key) override;
+	FT_INFO *ft_init_ext(uint flags, uint inx, String* key) override
+	{
+		return ft_init_ext_with_limit(flags, inx, key, HA_POS_ERROR);
+	}
+	FT_INFO *ft_init_ext_with_limit(uint flags, uint inx, String* key,
+					ha_rows limit) override;
 	int ft_read(uchar* buf) override;
 
 	void position(const uchar *record) override;
@@ -464,6 +479,7 @@ class ha_innobase final : public handler
 	void update_thd();
 
 	int general_fetch(uchar* buf, uint direction, uint match_mode);
+	uint fetch_cached_rows(uchar* buf, size_t stride, uint max_rows);
 	int change_active_index(uint keynr);
 	dict_index_t* innobase_get_index(uint keynr);
 
@@ -516,6 +532,9 @@ class ha_innobase final : public handler
 
         /** If mysql has locked with external_lock() */
         bool                    m_mysql_has_locked;
+
+	/** whether HA_EXTRA_IGNORE_DUP_KEY is in effect */
+	bool			m_ignore_dup_key;
 };
 
 
@@ -585,6 +604,15 @@ typedef struct new_ft_info
 	struct _ft_vft_ext	*could_you;
 	row_prebuilt_t*		ft_prebuilt;
 	fts_result_t*		ft_result;
+	/** The query string, or NULL if ft_result is not limited to
+	the best ranked documents. It is kept with the search mode and
+	the index for finding the rest of the documents. */
+	const byte*		ft_query;
+	ulint			ft_query_len;
+	uint			ft_flags;
+	dict_index_t*		ft_index;
+	/** Whether ft_read() skipped a document that is not visible */
+	bool			ft_skipped;
 } NEW_FT_INFO;
 
 /**
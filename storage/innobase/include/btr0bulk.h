@@ -39,7 +39,8 @@ extern	uint	innobase_fill_factor;
 /*
 The proper function call sequence of PageBulk is as below:
 -- PageBulk::init
--- PageBulk::insert
+-- PageBulk::insert (PageBulk::add for a SPATIAL index)
+-- PageBulk::insert_pending (SPATIAL index only)
 -- PageBulk::finish
 -- PageBulk::compress(COMPRESSED table only)
 -- PageBulk::pageSplit(COMPRESSED table only)
@@ -79,9 +80,10 @@ class PageBulk
 		m_total_data(0),
 #endif /* UNIV_DEBUG */
 		m_modify_clock(0),
-		m_err(DB_SUCCESS)
+		m_err(DB_SUCCESS),
+		m_pending(),
+		m_pending_space(0)
 	{
-		ut_ad(!dict_index_is_spatial(m_index));
 		ut_ad(!m_index->table->is_temporary());
 	}
 
@@ -100,6 +102,18 @@ class PageBulk
 	@param[in]	rec		record
 	@param[in]	offsets		record offsets */
 	inline void insert(const rec_t* rec, rec_offs* offsets);
+
+	/** Add a record of a SPATIAL index to the page. The records of
+	an R-tree page must be ordered by their MBR, while the pages are
+	filled in the order of the sort key of row_merge_buf_sort().
+	Therefore, the records are only copied to the page by
+	insert_pending(), in sorted order.
+	@param[in]	rec		record
+	@param[in]	offsets		record offsets */
+	inline void add(const rec_t* rec, rec_offs* offsets);
+
+	/** Copy the records that were added by add() to the page. */
+	void insert_pending();
 private:
 	/** Page format */
 	enum format { REDUNDANT, DYNAMIC, COMPRESSED };
@@ -272,6 +286,15 @@ class PageBulk
 
 	/** Operation result DB_SUCCESS or error code */
 	dberr_t		m_err;
+
+	/** Records of a SPATIAL index that were added by add(),
+	with their offsets */
+	std::vector<std::pair<const rec_t*, rec_offs*>,
+		    ut_allocator<std::pair<const rec_t*, rec_offs*> > >
+			m_pending;
+
+	/** The space that the records in m_pending will take */
+	ulint		m_pending_space;
 };
 
 typedef std::vector<PageBulk*, ut_allocator<PageBulk*> >
@@ -290,7 +313,6 @@ class BtrBulk
 		m_index(index),
 		m_trx(trx)
 	{
-		ut_ad(!dict_index_is_spatial(index));
 	}
 
 	/** Insert a tuple
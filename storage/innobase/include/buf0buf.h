@@ -1011,6 +1011,11 @@ struct buf_block_t{
 					bufferfixed, or (2) the thread has an
 					x-latch on the block */
 	/* @} */
+	/** normalized key prefixes of some page directory slots for
+	page_cur_search_with_match(), or nullptr if none were allocated;
+	the contents are validated against modify_clock, and the memory
+	is freed by buf_LRU_block_free_non_file_page() */
+	std::atomic<page_dir_cache_t*> dir_cache;
 #ifdef BTR_CUR_HASH_ADAPT
 	/** @name Hash search fields (unprotected)
 	NOTE that these fields are NOT protected by any semaphore! */
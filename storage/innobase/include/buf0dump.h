@@ -27,14 +27,27 @@ Created April 08, 2011 Vasil Dimov
 #ifndef buf0dump_h
 #define buf0dump_h
 
+#include "buf0types.h"
+
 /** Start the buffer pool dump/load task and instructs it to start a dump. */
 void buf_dump_start();
 /** Start the buffer pool dump/load task and instructs it to start a load. */
 void buf_load_start();
 
+/** Start a dump if innodb_buffer_pool_dump_interval has passed since
+the previous periodic dump and pages were read into the buffer pool
+since then. Invoked by the master task once per second. */
+void buf_dump_periodic();
+
 /** Abort a currently running buffer pool load. */
 void buf_load_abort();
 
+/** Note that a foreground read missed a page in the buffer pool.
+If a buffer pool load is running, it will read the dumped pages of
+the tablespace before any other pages.
+@param id  page that is being read */
+void buf_load_request(const page_id_t id);
+
 /** Start async buffer pool load, if srv_buffer_pool_load_at_startup was set.*/
 void buf_load_at_startup();
 
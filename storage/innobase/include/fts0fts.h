@@ -281,6 +281,10 @@ struct fts_result_t {
 					indexed by doc id */
 	ib_rbt_t*	rankings_by_rank;/*!< RB tree of type fts_ranking_t
 					indexed by rank */
+
+	bool		limited;	/*!< true if rankings_by_id only
+					contains the best ranked documents,
+					see fts_query() */
 };
 
 /** This is used to generate the FTS auxiliary table name, we need the
@@ -528,6 +532,8 @@ fts_commit(
 @param[in]	query_str	FTS query
 @param[in]	query_len	FTS query string len in bytes
 @param[in,out]	result		result doc ids
+@param[in]	limit		number of best ranked documents that
+				will be read, or ULINT_UNDEFINED
 @return DB_SUCCESS if successful otherwise error code */
 dberr_t
 fts_query(
@@ -536,7 +542,8 @@ fts_query(
 	uint		flags,
 	const byte*	query_str,
 	ulint		query_len,
-	fts_result_t**	result)
+	fts_result_t**	result,
+	ulint		limit)
 	MY_ATTRIBUTE((warn_unused_result));
 
 /******************************************************************//**
@@ -557,6 +564,15 @@ fts_query_sort_result_on_rank(
 	fts_result_t*	result);		/*!< out: result instance
 						to sort.*/
 
+/** Remove the documents of a limited result of a query from the
+result on rank of the same query.
+@param[in,out]	result	result sorted by fts_query_sort_result_on_rank()
+@param[in]	limited	result limited to the best ranked documents */
+void
+fts_query_exclude_result(
+	fts_result_t*		result,
+	const fts_result_t*	limited);
+
 /******************************************************************//**
 FTS Query free result, returned by fts_query(). */
 void
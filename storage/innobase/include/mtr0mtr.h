@@ -614,6 +614,10 @@ struct mtr_t {
   @param type   extended record subtype; @see mrec_ext_t */
   inline void log_write_extended(const buf_block_t &block, byte type);
 
+  /** Log an image of each page that this mini-transaction is the first
+  to modify since the page was last written to the data file. */
+  void log_page_images();
+
   /** Prepare to write the mini-transaction log to the redo log buffer.
   @return number of bytes to write in finish_write() */
   inline ulint prepare_write();
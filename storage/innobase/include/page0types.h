@@ -41,6 +41,8 @@ typedef	byte		page_t;
 #ifndef UNIV_INNOCHECKSUM
 /** Index page cursor */
 struct page_cur_t;
+/** Key prefixes of the page directory, see page_cur_search_with_match() */
+struct page_dir_cache_t;
 /** Buffer pool block */
 struct buf_block_t;
 
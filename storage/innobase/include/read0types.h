@@ -63,14 +63,22 @@ class ReadViewBase
   */
   trx_id_t m_low_limit_no;
 
+  /**
+    Whether this is a snapshot of the commit sequence number
+    m_low_limit_id (innodb_csn_snapshots). m_ids is then empty, and the
+    transactions between m_up_limit_id and m_low_limit_id are looked up
+    in trx_sys.csn.
+  */
+  bool m_csn;
+
+  /** @return whether a snapshot of commit sequence numbers sees id */
+  bool csn_visible(trx_id_t id) const;
+
 protected:
   bool empty() { return m_ids.empty(); }
 
-  /** @return the up limit id */
-  trx_id_t up_limit_id() const { return m_up_limit_id; }
-
 public:
-  ReadViewBase(): m_low_limit_id(0) {}
+  ReadViewBase(): m_low_limit_id(0), m_csn(false) {}
 
 
   /**
@@ -85,10 +93,15 @@ class ReadViewBase
   void append(const ReadViewBase &other)
   {
     ut_ad(&other != this);
+    ut_ad(!m_csn);
     if (m_low_limit_no > other.m_low_limit_no)
       m_low_limit_no= other.m_low_limit_no;
-    if (m_low_limit_id > other.m_low_limit_id)
-      m_low_limit_id= other.m_low_limit_id;
+    /* Without m_ids, a commit sequence number snapshot may not see any
+    transaction from its m_up_limit_id on */
+    const trx_id_t other_low_limit_id= other.m_csn
+      ? other.m_up_limit_id : other.m_low_limit_id;
+    if (m_low_limit_id > other_low_limit_id)
+      m_low_limit_id= other_low_limit_id;
 
     trx_ids_t::iterator dst= m_ids.begin();
     for (const trx_id_t id : other.m_ids)
@@ -150,8 +163,11 @@ class ReadViewBase
   {
     if (id >= m_low_limit_id)
       return false;
-    return id < m_up_limit_id ||
-           m_ids.empty() ||
+    if (id < m_up_limit_id)
+      return true;
+    if (m_csn)
+      return csn_visible(id);
+    return m_ids.empty() ||
            !std::binary_search(m_ids.begin(), m_ids.end(), id);
   }
 
@@ -169,8 +185,11 @@ class ReadViewBase
       check_trx_id_sanity(id, name);
       return false;
     }
-    return id < m_up_limit_id ||
-           m_ids.empty() ||
+    if (id < m_up_limit_id)
+      return true;
+    if (m_csn)
+      return csn_visible(id);
+    return m_ids.empty() ||
            !std::binary_search(m_ids.begin(), m_ids.end(), id);
   }
 
@@ -186,6 +205,9 @@ class ReadViewBase
 
   /** @return the low limit id */
   trx_id_t low_limit_id() const { return m_low_limit_id; }
+
+  /** @return the up limit id */
+  trx_id_t up_limit_id() const { return m_up_limit_id; }
 };
 
 
@@ -210,6 +210,9 @@ struct ins_node_t
 
 	/** Bulk insert enabled for this table */
 	bool		bulk_insert= false;
+	/** MySQL table of a statement whose inserts into an empty table
+	may be buffered in row_merge_bulk_t, or NULL */
+	struct TABLE*	bulk_insert_table= NULL;
 };
 
 /** Create an insert object.
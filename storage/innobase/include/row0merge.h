@@ -459,4 +459,76 @@ row_merge_read_rec(
 	row_merge_block_t*	crypt_block, /*!< in: crypt buf or NULL */
 	ulint			space)	   /*!< in: space id */
 	MY_ATTRIBUTE((warn_unused_result));
+
+/** Buffered index entries of an insert into an empty table.
+
+Instead of inserting the rows one by one, the entries of every index
+are collected in a sort buffer. A full buffer is sorted and written to
+a temporary file as a sorted run. When the statement ends, the runs
+are merged, and each index is built bottom-up with BtrBulk, like
+ALTER TABLE does. The insert is covered by a TRX_UNDO_EMPTY record. */
+class row_merge_bulk_t
+{
+  /** sort buffer for every index of the table */
+  row_merge_buf_t **m_merge_buf;
+  /** sorted runs of every index, written when m_merge_buf[] was full */
+  merge_file_t *m_merge_files;
+  /** number of indexes */
+  ulint m_n_index;
+  /** temporary file for row_merge_sort() */
+  pfs_os_file_t m_tmpfd;
+  /** MySQL table for reporting duplicates, or nullptr */
+  struct TABLE *m_table;
+  /** maximum AUTO_INCREMENT value to persist, or 0 */
+  ib_uint64_t m_autoinc;
+  /** allocator for m_block and m_crypt_block */
+  ut_allocator<row_merge_block_t> m_alloc;
+  /** I/O buffers for writing and merging the sorted runs, or nullptr */
+  row_merge_block_t *m_block;
+  ut_new_pfx_t m_block_pfx;
+  /** buffer for encrypting the sorted runs, or nullptr */
+  row_merge_block_t *m_crypt_block;
+  ut_new_pfx_t m_crypt_pfx;
+public:
+  /** Create a sort buffer for every index of a table
+  @param table        table that is being inserted into
+  @param mysql_table  MySQL table for reporting duplicates, or nullptr */
+  row_merge_bulk_t(dict_table_t *table, struct TABLE *mysql_table);
+  ~row_merge_bulk_t();
+
+  /** @return whether inserts into a table can be buffered */
+  static bool is_supported(const dict_table_t &table);
+
+  /** Buffer an index entry.
+  @param entry  index entry
+  @param index  index of the table
+  @param trx    transaction
+  @retval DB_SUCCESS      if the entry was buffered
+  @retval DB_TOO_BIG_RECORD if the entry cannot be buffered
+  @return error code of writing a sorted run */
+  dberr_t bulk_insert_buffered(const dtuple_t &entry,
+                               const dict_index_t &index, trx_t *trx);
+
+  /** Build all indexes of the table from the buffered entries.
+  @param trx          transaction
+  @param mysql_table  MySQL table for reporting duplicates, or nullptr
+  @return error code */
+  dberr_t write_to_table(trx_t *trx, struct TABLE *mysql_table);
+
+private:
+  /** Allocate m_block and m_crypt_block if needed
+  @return whether the allocation succeeded */
+  bool alloc_block();
+  /** Sort the buffer of an index and write it to a sorted run
+  @param i      index number
+  @param trx    transaction
+  @return error code */
+  dberr_t write_to_tmp_file(ulint i, trx_t *trx);
+  /** Build an index from its sorted runs and sort buffer
+  @param i            index number
+  @param trx          transaction
+  @param mysql_table  MySQL table for reporting duplicates, or nullptr
+  @return error code */
+  dberr_t write_to_index(ulint i, trx_t *trx, struct TABLE *mysql_table);
+};
 #endif /* row0merge.h */
@@ -563,7 +563,12 @@ struct mysql_row_templ_t {
 	ulint	is_virtual;		/*!< if a column is a virtual column */
 };
 
+/* Minimum number of rows in fetch_cache */
 #define MYSQL_FETCH_CACHE_SIZE		8
+/* Maximum number of rows in fetch_cache */
+#define MYSQL_FETCH_CACHE_MAX		64
+/* Narrow rows are cached until fetch_cache holds about this many bytes */
+#define MYSQL_FETCH_CACHE_BYTES		16384
 /* After fetching this many rows, we start caching them in fetch_cache */
 #define MYSQL_FETCH_CACHE_THRESHOLD	4
 
@@ -633,6 +638,11 @@ struct row_prebuilt_t {
 					(VARCHAR can be off-page too) */
 	unsigned	versioned_write:1;/*!< whether this is
 					a versioned write */
+	unsigned	bulk_insert_buffer:1;/*!< whether inserts into an
+					empty table may be buffered and
+					sorted, between
+					handler::start_bulk_insert() and
+					handler::end_bulk_insert() */
 	mysql_row_templ_t* mysql_template;/*!< template used to transform
 					rows fast between MySQL and Innobase
 					formats; memory for this template
@@ -738,7 +748,7 @@ struct row_prebuilt_t {
 	ulint		n_rows_fetched;	/*!< number of rows fetched after
 					positioning the current cursor */
 	ulint		fetch_direction;/*!< ROW_SEL_NEXT or ROW_SEL_PREV */
-	byte*		fetch_cache[MYSQL_FETCH_CACHE_SIZE];
+	byte*		fetch_cache[MYSQL_FETCH_CACHE_MAX];
 					/*!< a cache for fetched rows if we
 					fetch many rows from the same cursor:
 					it saves CPU time to fetch them in a
@@ -752,6 +762,10 @@ struct row_prebuilt_t {
 					cache with HA_EXTRA_KEYREAD, don't
 					overwrite other fields in mysql row
 					row buffer.*/
+	ulint		fetch_cache_size;/*!< number of rows in fetch_cache,
+					between MYSQL_FETCH_CACHE_SIZE and
+					MYSQL_FETCH_CACHE_MAX depending on
+					mysql_row_len */
 	ulint		fetch_cache_first;/*!< position of the first not yet
 					fetched row in fetch_cache */
 	ulint		n_fetch_cached;	/*!< number of not yet fetched rows
@@ -35,6 +35,7 @@ Created 3/14/1997 Heikki Tuuri
 #include "row0mysql.h"
 #include "mysqld.h"
 #include <queue>
+#include <vector>
 
 class MDL_ticket;
 /** Determines if it is possible to remove a secondary index entry.
@@ -152,6 +153,33 @@ struct purge_node_t{
 	/** Undo recs to purge */
 	std::queue<trx_purge_rec_t>	undo_recs;
 
+	/** A delete-marked record whose purge was deferred */
+	struct del_mark_t
+	{
+		/** row reference to the clustered index record */
+		const dtuple_t*	ref;
+		/** roll pointer to the undo log record */
+		roll_ptr_t	roll_ptr;
+		/** DB_TRX_ID of the delete-marked record */
+		trx_id_t	trx_id;
+	};
+
+	/** A secondary index entry of a deferred delete-marked record */
+	struct sec_entry_t
+	{
+		/** secondary index */
+		dict_index_t*	index;
+		/** index entry, allocated from heap */
+		const dtuple_t*	entry;
+		/** position of the record in del_marks */
+		ulint		rec;
+	};
+
+	/** delete-marked records of table, purged by apply_del_marks() */
+	std::vector<del_mark_t>		del_marks;
+	/** secondary index entries of del_marks */
+	std::vector<sec_entry_t>	sec_entries;
+
 	/** Constructor */
 	explicit purge_node_t(que_thr_t* parent) :
 		common(QUE_NODE_PURGE, parent),
@@ -215,6 +243,23 @@ struct purge_node_t{
   }
 
 
+  /** Set the state for purging a deferred delete-marked record.
+  @param rec  the record */
+  void set_del_mark(const del_mark_t &rec)
+  {
+    ref= rec.ref;
+    roll_ptr= rec.roll_ptr;
+    trx_id= rec.trx_id;
+    if (found_clust)
+    {
+      btr_pcur_close(&pcur);
+      found_clust= FALSE;
+    }
+  }
+
+  /** Purge the deferred delete-marked records of the table. */
+  void apply_del_marks();
+
   /** Close the existing table and release the MDL for it. */
   void close_table()
   {
@@ -222,9 +267,11 @@ struct purge_node_t{
     if (!table)
     {
       ut_ad(!mdl_ticket);
+      ut_ad(del_marks.empty());
       return;
     }
 
+    apply_del_marks();
     innobase_reset_background_thd(purge_thd);
     dict_table_close(table, false, false, purge_thd, mdl_ticket);
     table= nullptr;
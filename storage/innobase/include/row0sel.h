@@ -194,6 +194,21 @@ row_search_mvcc(
 	ulint		direction)
 	MY_ATTRIBUTE((warn_unused_result));
 
+/** Pop rows of a forward scan from the prefetch cache, without
+restoring the cursor.
+@param[out]	buf		buffer for max_rows rows in MySQL format
+@param[in]	stride		distance between the rows in buf
+@param[in]	max_rows	maximum number of rows to copy
+@param[in,out]	prebuilt	prebuilt struct for the table handler
+@return number of rows copied to buf */
+ulint
+row_sel_dequeue_cached_rows(
+	byte*		buf,
+	ulint		stride,
+	ulint		max_rows,
+	row_prebuilt_t*	prebuilt)
+	MY_ATTRIBUTE((nonnull));
+
 /********************************************************************//**
 Count rows in a R-Tree leaf level.
 @return DB_SUCCESS if successful */
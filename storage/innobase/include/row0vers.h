@@ -111,6 +111,14 @@ row_vers_build_for_consistent_read(
 				it was freshly inserted afterwards */
 	dtuple_t**	vrow);	/*!< out: reports virtual column info if any */
 
+/** Create the cache of old record versions (innodb_version_cache_size). */
+void row_vers_cache_create();
+/** Free the cache of old record versions. */
+void row_vers_cache_close();
+/** Discard the cached record versions if they exceed
+innodb_version_cache_size. */
+void row_vers_cache_resize();
+
 /*****************************************************************//**
 Constructs the last committed version of a clustered index record,
 which should be seen by a semi-consistent read. */
@@ -304,6 +304,10 @@ enum monitor_id_t {
 	MONITOR_DML_PURGE_DELAY,
 	MONITOR_PURGE_STOP_COUNT,
 	MONITOR_PURGE_RESUME_COUNT,
+	MONITOR_PURGE_N_UNDO_REC,
+	MONITOR_PURGE_HISTORY_CHANGE,
+	MONITOR_PURGE_SEC_SORTED,
+	MONITOR_PURGE_SEC_SAME_PAGE,
 
 	/* Recovery related counters */
 	MONITOR_MODULE_RECOVERY,
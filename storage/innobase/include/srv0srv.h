@@ -89,6 +89,12 @@ struct srv_stats_t
 	/** Number of the log write requests done */
 	ulint_ctr_1_t		log_write_requests;
 
+	/** Number of page images written to the log */
+	ulint_ctr_1_t		log_page_images;
+
+	/** Amount of page image data written to the log, in bytes */
+	lsn_ctr_1_t		log_page_image_bytes;
+
 	/** Number of physical writes to the log performed */
 	ulint_ctr_1_t		log_writes;
 
@@ -176,6 +182,12 @@ struct srv_stats_t
 	/** Number of times prefix optimization avoided triggering cluster lookup */
 	ulint_ctr_64_t		n_sec_rec_cluster_reads_avoided;
 
+	/** Number of old record versions found in the version cache */
+	ulint_ctr_64_t		n_version_cache_hits;
+
+	/** Number of old record versions not found in the version cache */
+	ulint_ctr_64_t		n_version_cache_misses;
+
 	/** Number of encryption_get_latest_key_version calls */
 	ulint_ctr_64_t		n_key_requests;
 
@@ -242,6 +254,9 @@ extern my_bool	srv_file_per_table;
 
 /** Sort buffer size in index creation */
 extern ulong	srv_sort_buf_size;
+/** Number of threads that scan the clustered index and merge-sort the
+index entries in index creation */
+extern ulong	srv_alter_parallel_threads;
 /** Maximum modification log file size for online index creation */
 extern unsigned long long	srv_online_max_size;
 
@@ -251,6 +266,19 @@ use simulated aio.
 Currently we support native aio on windows and linux */
 extern my_bool	srv_use_native_aio;
 extern my_bool	srv_numa_interleave;
+/** innodb_csn_snapshots: whether read views are snapshots of commit
+sequence numbers, see trx_csn_t */
+extern my_bool	srv_csn_snapshots;
+/** innodb_version_cache_size: maximum memory for reconstructed old
+record versions, see row_vers_build_for_consistent_read() */
+extern size_t	srv_version_cache_size;
+/** innodb_log_page_images: whether the first modification of a page
+since it was last written logs an image of the page, see
+mtr_t::log_page_images() */
+extern my_bool	srv_log_page_images;
+/** innodb_page_search_cache: whether page_cur_search_with_match()
+narrows down its search with key prefixes cached in buf_block_t::dir_cache */
+extern my_bool	srv_page_search_cache;
 
 /* Use atomic writes i.e disable doublewrite buffer */
 extern my_bool srv_use_atomic_writes;
@@ -336,6 +364,10 @@ extern ulint	srv_buf_pool_base_size;
 extern ulint	srv_buf_pool_curr_size;
 /** Dump this % of each buffer pool during BP dump */
 extern ulong	srv_buf_pool_dump_pct;
+/** innodb_buffer_pool_dump_interval: seconds between periodic dumps */
+extern ulong	srv_buf_dump_interval;
+/** innodb_buffer_pool_load_io_depth: maximum pending reads of a load */
+extern ulong	srv_buf_load_io_depth;
 #ifdef UNIV_DEBUG
 /** Abort load after this amount of pages */
 extern ulong srv_buf_pool_load_pages_abort;
@@ -741,6 +773,8 @@ struct export_var_t{
 	ulint innodb_history_list_length;
 	ulint innodb_log_waits;			/*!< srv_log_waits */
 	ulint innodb_log_write_requests;	/*!< srv_log_write_requests */
+	ulint innodb_log_page_images;		/*!< srv_stats.log_page_images */
+	lsn_t innodb_log_page_image_bytes;	/*!< srv_stats.log_page_image_bytes */
 	ulint innodb_log_writes;		/*!< srv_log_writes */
 	lsn_t innodb_lsn_current;
 	lsn_t innodb_lsn_flushed;
@@ -832,6 +866,8 @@ struct export_var_t{
 
 	ulint innodb_sec_rec_cluster_reads;	/*!< srv_sec_rec_cluster_reads */
 	ulint innodb_sec_rec_cluster_reads_avoided;/*!< srv_sec_rec_cluster_reads_avoided */
+	ulint innodb_version_cache_hits;	/*!< srv_stats.n_version_cache_hits */
+	ulint innodb_version_cache_misses;	/*!< srv_stats.n_version_cache_misses */
 
 	ulint innodb_encryption_rotation_pages_read_from_cache;
 	ulint innodb_encryption_rotation_pages_read_from_disk;
@@ -840,6 +840,137 @@ class thread_safe_trx_ilist_t
   alignas(CACHE_LINE_SIZE) ilist<trx_t> trx_list;
 };
 
+/**
+  Commit sequence numbers of read-write transactions (innodb_csn_snapshots).
+
+  The serialisation number trx_t::no of a transaction serves as its commit
+  sequence number: a read view that is a snapshot of m_max_trx_id sees
+  exactly the transactions with no below it, and taking the snapshot does
+  not need to iterate rw_trx_hash.
+
+  The numbers are kept in a ring of slots indexed by transaction id. A slot
+  is protected by a sequence lock that is held while a number is assigned,
+  so that a reader that knows about the number also finds it in the slot.
+  When a slot is reused, its previous transaction is moved to m_overflow,
+  unless it has committed before every open snapshot.
+
+  The ring covers the ids of the last N_SLOTS read-write transactions. A
+  transaction stays in it if it commits before N_SLOTS later transactions
+  start and no read view is open for longer than that. Other transactions
+  are moved to m_overflow, a lock-free hash like rw_trx_hash, so that long
+  transactions and old read views do not serialise the others.
+*/
+class trx_csn_t
+{
+public:
+  /** trx_t::no of an active transaction */
+  static constexpr trx_id_t ACTIVE= TRX_ID_MAX;
+  /** trx_t::no of a transaction that was rolled back or that did not
+  write any undo log */
+  static constexpr trx_id_t ABORTED= TRX_ID_MAX - 1;
+  /** trx_t::no of a transaction in m_overflow that is being assigned
+  its serialisation number */
+  static constexpr trx_id_t COMMITTING= TRX_ID_MAX - 2;
+
+  /** Create the ring after the recovery of transactions.
+  @param max_trx_id  smallest transaction id that was not assigned yet */
+  void create(trx_id_t max_trx_id);
+  /** Free the ring on shutdown */
+  void close();
+  /** @return whether read views are snapshots of commit sequence numbers */
+  bool is_enabled() const { return m_slots != nullptr; }
+
+  /** Register a new read-write transaction.
+  @param id transaction id */
+  void register_trx(trx_id_t id);
+  /** Assign the serialisation number to a committing transaction.
+  @param id       transaction id
+  @param counter  trx_sys_t::m_max_trx_id
+  @return the serialisation number */
+  trx_id_t commit(trx_id_t id, Atomic_counter<trx_id_t> &counter);
+  /** Mark a transaction without serialisation number as finished.
+  @param id transaction id */
+  void abort(trx_id_t id);
+
+  /** Check whether a snapshot sees a transaction.
+  @param id        transaction id, at least min_active()
+  @param snapshot  m_max_trx_id at the time of the snapshot
+  @return whether the transaction committed before the snapshot */
+  bool visible(trx_id_t id, trx_id_t snapshot);
+
+  /** @return a transaction id that is smaller than the ids of all
+  transactions that can still be active. A snapshot must read this
+  before trx_sys_t::get_max_trx_id(). */
+  trx_id_t min_active() const
+  { return m_min_active.load(std::memory_order_acquire); }
+
+  /** Publish the state of the purge view and remove entries that all
+  snapshots see from m_overflow.
+  @param min_active  smallest id of the active transactions
+  @param horizon     no snapshot is older than this */
+  void purge(trx_id_t min_active, trx_id_t horizon);
+
+private:
+  /** Number of slots, a power of 2 */
+  static constexpr size_t N_SLOTS= 1 << 16;
+
+  struct slot_t
+  {
+    /** sequence lock, odd while the slot is being modified */
+    std::atomic<uint32_t> seq;
+    /** transaction id */
+    std::atomic<trx_id_t> id;
+    /** serialisation number, ACTIVE or ABORTED */
+    std::atomic<trx_id_t> no;
+  };
+
+  /** An element of m_overflow */
+  struct overflow_t
+  {
+    /** transaction id; lf_hash_init() relies on this to be first */
+    trx_id_t id;
+    /** serialisation number, ACTIVE, ABORTED or COMMITTING */
+    std::atomic<trx_id_t> no;
+  };
+
+  slot_t &slot(trx_id_t id) const { return m_slots[id & (m_n_slots - 1)]; }
+  static void lock(slot_t &s);
+  static void unlock(slot_t &s)
+  { s.seq.fetch_add(1, std::memory_order_release); }
+
+  /** Add a transaction to m_overflow.
+  @param id  transaction id
+  @param no  serialisation number, ACTIVE or ABORTED */
+  void overflow_insert(trx_id_t id, trx_id_t no);
+  static void overflow_initializer(LF_HASH *, overflow_t *element,
+                                   const trx_id_t *id_no);
+
+  /** Argument of overflow_collect() */
+  struct collect_arg_t
+  {
+    /** collect the elements whose serialisation number is below this */
+    trx_id_t horizon;
+    /** the ids of the collected elements */
+    std::vector<trx_id_t> ids;
+  };
+  static my_bool overflow_collect(overflow_t *element, collect_arg_t *arg);
+
+  /** the ring of slots, or nullptr if the feature is disabled */
+  slot_t *m_slots= nullptr;
+  /** number of slots in m_slots; N_SLOTS unless a debug build injects
+  a smaller ring */
+  size_t m_n_slots;
+  /** the smallest id that can be found in m_slots */
+  trx_id_t m_start;
+  /** snapshots see the transactions that are below this id */
+  std::atomic<trx_id_t> m_min_active;
+  /** no snapshot is older than this */
+  Atomic_relaxed<trx_id_t> m_horizon;
+  /** transactions that are no longer in m_slots */
+  LF_HASH m_overflow;
+};
+
+
 /** The transaction system central memory data structure. */
 class trx_sys_t
 {
@@ -872,6 +1003,9 @@ class trx_sys_t
   /** List of all transactions. */
   thread_safe_trx_ilist_t trx_list;
 
+  /** Commit sequence numbers for read views */
+  trx_csn_t csn;
+
 	MY_ALIGNED(CACHE_LINE_SIZE)
 	/** Temporary rollback segments */
 	trx_rseg_t*	temp_rsegs[TRX_SYS_N_RSEGS];
@@ -983,7 +1117,9 @@ class trx_sys_t
   */
   void assign_new_trx_no(trx_t *trx)
   {
-    trx->rw_trx_hash_element->no= get_new_trx_id_no_refresh();
+    trx->rw_trx_hash_element->no= csn.is_enabled()
+      ? csn.commit(trx->id, m_max_trx_id)
+      : get_new_trx_id_no_refresh();
     refresh_rw_trx_hash_version();
   }
 
@@ -1072,6 +1208,8 @@ class trx_sys_t
   void register_rw(trx_t *trx)
   {
     trx->id= get_new_trx_id_no_refresh();
+    if (csn.is_enabled())
+      csn.register_trx(trx->id);
     rw_trx_hash.insert(trx);
     refresh_rw_trx_hash_version();
   }
@@ -1086,6 +1224,8 @@ class trx_sys_t
 
   void deregister_rw(trx_t *trx)
   {
+    if (csn.is_enabled() && trx->rw_trx_hash_element->no == TRX_ID_MAX)
+      csn.abort(trx->id);
     rw_trx_hash.erase(trx);
   }
 
@@ -1131,7 +1271,7 @@ class trx_sys_t
     in. This function is called by purge thread to determine whether it should
     purge the delete marked record or not.
   */
-  void clone_oldest_view(ReadViewBase *view) const;
+  void clone_oldest_view(ReadViewBase *view);
 
 
   /** @return the number of active views */
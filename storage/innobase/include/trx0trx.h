@@ -43,6 +43,7 @@ Created 3/26/1996 Heikki Tuuri
 // Forward declaration
 struct mtr_t;
 struct rw_trx_hash_element_t;
+class row_merge_bulk_t;
 
 /******************************************************************//**
 Set detailed error message for the transaction. */
@@ -512,10 +513,16 @@ class trx_mod_table_time_t
   undo_no_t first;
   /** First modification of a system versioned column (or NONE) */
   undo_no_t first_versioned= NONE;
+  /** Buffered entries of a bulk insert, or nullptr */
+  row_merge_bulk_t *bulk_store= nullptr;
 public:
   /** Constructor
   @param rows   number of modified rows so far */
   trx_mod_table_time_t(undo_no_t rows) : first(rows) { ut_ad(rows < LIMIT); }
+  /** Destructor; discards any buffered bulk insert */
+  ~trx_mod_table_time_t();
+  trx_mod_table_time_t(const trx_mod_table_time_t&)= delete;
+  trx_mod_table_time_t &operator=(const trx_mod_table_time_t&)= delete;
 
 #ifdef UNIV_DEBUG
   /** Validation
@@ -547,6 +554,20 @@ class trx_mod_table_time_t
   /** @return whether an insert was covered by TRX_UNDO_EMPTY record */
   bool was_bulk_insert() const { return first & WAS_BULK; }
 
+  /** Start buffering the bulk insert, after is_bulk_insert() was set
+  @param table        table that is being inserted into
+  @param mysql_table  MySQL table for reporting duplicates, or nullptr
+  @return the buffer */
+  row_merge_bulk_t *start_bulk_buffer(dict_table_t *table,
+                                      struct TABLE *mysql_table);
+  /** @return the buffered bulk insert, or nullptr */
+  row_merge_bulk_t *bulk_buffer() const { return bulk_store; }
+  /** Write the buffered bulk insert to the indexes, and free the buffer
+  @param trx          transaction
+  @param mysql_table  MySQL table for reporting duplicates, or nullptr
+  @return error code */
+  dberr_t write_bulk(trx_t *trx, struct TABLE *mysql_table);
+
   /** Invoked after partial rollback
   @param limit	number of surviving modified rows (trx_t::undo_no)
   @return	whether this should be erased from trx_t::mod_tables */
@@ -960,6 +981,9 @@ struct trx_t : ilist_node<> {
 					transaction branch */
 	trx_mod_tables_t mod_tables;	/*!< List of tables that were modified
 					by this transaction */
+	bool		bulk_insert_pending;
+					/*!< whether some mod_tables entry
+					may have a bulk_buffer() */
 	/*------------------------------*/
 	char*		detailed_error;	/*!< detailed error message for last
 					error, or empty. */
@@ -1098,6 +1122,26 @@ struct trx_t : ilist_node<> {
       t.second.end_bulk_insert();
   }
 
+  /** @return the buffered bulk insert into a table, or nullptr */
+  row_merge_bulk_t *bulk_buffer(const dict_table_t &table) const
+  {
+    if (UNIV_LIKELY(!bulk_insert_pending))
+      return nullptr;
+    auto it= mod_tables.find(const_cast<dict_table_t*>(&table));
+    return it == mod_tables.end() ? nullptr : it->second.bulk_buffer();
+  }
+
+  /** Write the buffered bulk insert into a table to its indexes.
+  @param table        table that was inserted into
+  @param mysql_table  MySQL table for reporting duplicates, or nullptr
+  @return error code */
+  dberr_t bulk_insert_apply(const dict_table_t &table,
+                            struct TABLE *mysql_table);
+
+  /** Write all buffered bulk inserts of the transaction.
+  @return error code */
+  dberr_t bulk_insert_apply();
+
 private:
   /** Assign a rollback segment for modifying temporary tables.
   @return the assigned rollback segment */
@@ -869,6 +869,7 @@ constexpr const char* const auto_event_names[] =
   "lock0lock",
   "mem0mem",
   "os0file",
+  "page0cur",
   "pars0lex",
   "rem0rec",
   "row0ftsort",
@@ -877,12 +878,14 @@ constexpr const char* const auto_event_names[] =
   "row0merge",
   "row0mysql",
   "row0sel",
+  "row0vers",
   "srv0start",
   "trx0i_s",
   "trx0i_s",
   "trx0roll",
   "trx0rseg",
   "trx0seg",
+  "trx0sys",
   "trx0trx",
   "trx0undo",
   "ut0list",
@@ -351,6 +351,64 @@ struct ReleaseBlocks
   }
 };
 
+/** Log images of the pages that become dirty in the mini-transaction. */
+struct LogPageImages
+{
+  mtr_t &mtr;
+
+  LogPageImages(mtr_t &mtr) : mtr(mtr) {}
+
+  /** @return true always */
+  bool operator()(mtr_memo_slot_t *slot) const
+  {
+    if (!slot->object)
+      return true;
+    switch (slot->type) {
+    case MTR_MEMO_PAGE_X_MODIFY:
+    case MTR_MEMO_PAGE_SX_MODIFY:
+      break;
+    default:
+      return true;
+    }
+
+    buf_block_t *block= static_cast<buf_block_t*>(slot->object);
+    /* The page latch prevents the page from being written or made
+    dirty by others. Pages that were (re)initialized in this
+    mini-transaction will not be read by recovery anyway.
+    ROW_FORMAT=COMPRESSED pages keep using the doublewrite buffer. */
+    if (block->page.oldest_modification() > 1 ||
+        block->page.status != buf_page_t::NORMAL ||
+        block->page.zip.data)
+      return true;
+
+    /* Recovery discards any earlier records of the page at INIT_PAGE
+    and will not read the possibly torn page from the data file.
+    mtr_t::init() also lets buf_flush_page() skip the doublewrite buffer.
+    The records are split so that each fits in recv_sys_t::alloc(). */
+    mtr.init(block);
+    const ulint end= srv_page_size - FIL_PAGE_DATA_END;
+    for (ulint ofs= FIL_PAGE_PREV; ofs < end; )
+    {
+      const ulint len= std::min<ulint>(end - ofs, srv_page_size / 2);
+      mtr.memcpy(*block, ofs, len);
+      ofs+= len;
+    }
+
+    srv_stats.log_page_images.inc();
+    srv_stats.log_page_image_bytes.add(end - FIL_PAGE_PREV);
+    return true;
+  }
+};
+
+/** Log an image of each page that this mini-transaction is the first
+to modify since the page was last written to the data file. */
+void mtr_t::log_page_images()
+{
+  ut_ad(m_log_mode == MTR_LOG_ALL);
+  ut_ad(m_made_dirty);
+  m_memo.for_each_block(CIterate<const LogPageImages>(LogPageImages(*this)));
+}
+
 /** Start a mini-transaction. */
 void mtr_t::start()
 {
@@ -405,6 +463,9 @@ void mtr_t::commit()
 
     std::pair<lsn_t,bool> lsns;
 
+    if (m_made_dirty && srv_log_page_images && m_log_mode == MTR_LOG_ALL)
+      log_page_images();
+
     if (const ulint len= prepare_write())
       lsns= finish_write(len);
     else
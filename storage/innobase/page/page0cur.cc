@@ -263,6 +263,212 @@ page_cur_rec_field_extends(
 }
 #endif /* PAGE_CUR_LE_OR_EXTENDS */
 
+/** Maximum number of directory slots in page_dir_cache_t */
+static constexpr ulint PAGE_DIR_CACHE_N = 64;
+
+/** Normalized prefixes of the first field of the records that own some
+page directory slots of an index page, in ascending order. The search key
+is compared to all prefixes at once, so that page_cur_search_with_match()
+only needs to access the records between the two closest slots.
+
+The cache remains valid as long as buf_block_t::modify_clock and the
+number of directory slots are unchanged. Deleting records or
+reorganizing the page will increment the modify clock, and an insert
+can change the owners of the directory slots only by splitting a slot. */
+struct page_dir_cache_t
+{
+  /** even while the cache is stable; odd while it is being rebuilt */
+  std::atomic<uint32_t> version;
+  /** number of entries in key[] and slot[] */
+  uint32_t n;
+  /** buf_block_t::modify_clock when the cache was built */
+  uint64_t modify_clock;
+  /** page identifier when the cache was built */
+  page_id_t id;
+  /** page_dir_get_n_slots() when the cache was built */
+  ulint n_slots;
+  /** normalized prefixes of page_dir_slot_get_rec() of slot[] */
+  uint64_t key[PAGE_DIR_CACHE_N];
+  /** directory slot numbers, in ascending order */
+  uint16_t slot[PAGE_DIR_CACHE_N];
+};
+
+/** Determine whether a field can be normalized by page_dir_cache_key().
+@param mtype   main data type
+@param prtype  precise data type
+@return whether cmp_data() compares the field with memcmp() */
+static bool page_dir_cache_type(ulint mtype, ulint prtype)
+{
+  switch (mtype) {
+  case DATA_INT:
+  case DATA_SYS:
+    return true;
+  case DATA_FIXBINARY:
+  case DATA_BINARY:
+    return dtype_get_charset_coll(prtype) == DATA_MYSQL_BINARY_CHARSET_COLL;
+  }
+  return false;
+}
+
+/** Normalize a field that cmp_data() compares with memcmp(), so that
+page_dir_cache_key(a) < page_dir_cache_key(b) implies a < b.
+@param data  field data
+@param len   length of the field, or UNIV_SQL_NULL
+@return the first 8 bytes of the field as a big-endian number */
+static uint64_t page_dir_cache_key(const byte *data, ulint len)
+{
+  if (len == UNIV_SQL_NULL)
+    return 0;
+  byte buf[8]= {0};
+  memcpy(buf, data, std::min<ulint>(len, sizeof buf));
+  return mach_read_from_8(buf);
+}
+
+/** Rebuild the cache of normalized key prefixes of an index page.
+@param cache    cache that is being rebuilt by the caller
+@param block    index page
+@param index    index tree
+@param n_slots  page_dir_get_n_slots() */
+static void page_dir_cache_build(page_dir_cache_t *cache,
+                                 const buf_block_t *block,
+                                 const dict_index_t *index, ulint n_slots)
+{
+  const page_t *page= block->frame;
+  const bool comp= page_is_comp(page);
+  const bool is_leaf= page_is_leaf(page);
+  /* The search never compares the infimum and supremum slots. */
+  const ulint n= n_slots - 2;
+  const ulint m= std::min(n, PAGE_DIR_CACHE_N);
+  mem_heap_t *heap= nullptr;
+  rec_offs offsets_[REC_OFFS_NORMAL_SIZE];
+  rec_offs *offsets= offsets_;
+  rec_offs_init(offsets_);
+
+  for (ulint i= 0; i < m; i++)
+  {
+    const ulint s= 1 + i * n / m;
+    const rec_t *rec= page_dir_slot_get_rec(page_dir_get_nth_slot(page, s));
+    cache->slot[i]= static_cast<uint16_t>(s);
+
+    if (rec_get_info_bits(rec, comp) & REC_INFO_MIN_REC_FLAG)
+      cache->key[i]= 0;
+    else
+    {
+      offsets= rec_get_offsets(rec, index, offsets, is_leaf, 1, &heap);
+      ulint len;
+      const byte *data= rec_get_nth_field(rec, offsets, 0, &len);
+      cache->key[i]= page_dir_cache_key(data, len);
+    }
+
+    ut_ad(!i || cache->key[i - 1] <= cache->key[i]);
+  }
+
+  cache->n= static_cast<uint32_t>(m);
+  cache->modify_clock= block->modify_clock;
+  cache->id= block->page.id();
+  cache->n_slots= n_slots;
+
+  if (UNIV_LIKELY_NULL(heap))
+    mem_heap_free(heap);
+}
+
+/** Narrow down the binary search of page_cur_search_with_match()
+by comparing the search key to the prefixes in buf_block_t::dir_cache.
+@param block               index page
+@param index               index tree
+@param tuple               search key
+@param n_slots             page_dir_get_n_slots()
+@param low                 lower limit directory slot
+@param up                  upper limit directory slot
+@param low_matched_fields  matched fields in the lower limit record
+@param up_matched_fields   matched fields in the upper limit record */
+static void page_dir_cache_search(const buf_block_t *block,
+                                  const dict_index_t *index,
+                                  const dtuple_t *tuple, ulint n_slots,
+                                  ulint &low, ulint &up,
+                                  ulint &low_matched_fields,
+                                  ulint &up_matched_fields)
+{
+  const dfield_t *field= dtuple_get_nth_field(tuple, 0);
+  const dict_col_t *col= dict_index_get_nth_col(index, 0);
+
+  if (!page_dir_cache_type(field->type.mtype, field->type.prtype) ||
+      !page_dir_cache_type(col->mtype, col->prtype) ||
+      (tuple->info_bits & REC_INFO_MIN_REC_FLAG) || index->is_ibuf() ||
+      block->page.state() != BUF_BLOCK_FILE_PAGE)
+    return;
+
+  page_dir_cache_t *cache= block->dir_cache.load(std::memory_order_acquire);
+
+  if (UNIV_UNLIKELY(!cache))
+  {
+    page_dir_cache_t *c= static_cast<page_dir_cache_t*>
+      (ut_zalloc_nokey(sizeof *c));
+    if (!c)
+      return;
+    if (const_cast<buf_block_t*>(block)->dir_cache.
+        compare_exchange_strong(cache, c, std::memory_order_acq_rel))
+      cache= c;
+    else
+      ut_free(c);
+  }
+
+  /* The page cannot be modified while we are holding a latch on it,
+  but other threads that hold a shared latch may rebuild the cache.
+  Like with a seqlock, the result is discarded if the version changed. */
+  uint32_t version= cache->version.load(std::memory_order_acquire);
+
+  if (version & 1)
+    return;
+
+  if (cache->n_slots != n_slots ||
+      cache->modify_clock != block->modify_clock ||
+      cache->id != block->page.id())
+  {
+    if (!cache->version.compare_exchange_strong(version, version + 1,
+                                                std::memory_order_acq_rel))
+      return;
+    std::atomic_thread_fence(std::memory_order_release);
+    page_dir_cache_build(cache, block, index, n_slots);
+    version+= 2;
+    cache->version.store(version, std::memory_order_release);
+  }
+
+  const uint64_t key= page_dir_cache_key(
+    static_cast<const byte*>(dfield_get_data(field)), dfield_get_len(field));
+  const ulint n= cache->n;
+  ulint n_less= 0, n_less_or_equal= 0;
+
+  /* This loop is branch-free, so that it can be vectorized. */
+  for (ulint i= 0; i < n; i++)
+  {
+    n_less+= cache->key[i] < key;
+    n_less_or_equal+= cache->key[i] <= key;
+  }
+
+  const ulint new_low= n_less ? cache->slot[n_less - 1] : low;
+  const ulint new_up= n_less_or_equal < n
+    ? cache->slot[n_less_or_equal] : up;
+
+  std::atomic_thread_fence(std::memory_order_acquire);
+  if (cache->version.load(std::memory_order_relaxed) != version)
+    return;
+
+  /* Where the prefixes differ, also the first fields differ, and
+  no fields of the records match the search key. */
+  if (n_less)
+  {
+    low= new_low;
+    low_matched_fields= 0;
+  }
+  if (n_less_or_equal < n)
+  {
+    up= new_up;
+    up_matched_fields= 0;
+  }
+  ut_ad(low < up);
+}
+
 /****************************************************************//**
 Searches the right position for a page cursor. */
 void
@@ -379,6 +585,13 @@ page_cur_search_with_match(
 	low = 0;
 	up = ulint(page_dir_get_n_slots(page)) - 1;
 
+	/* On pages with a few directory slots the binary search
+	is short enough. */
+	if (srv_page_search_cache && up > 8) {
+		page_dir_cache_search(block, index, tuple, up + 1, low, up,
+				      low_matched_fields, up_matched_fields);
+	}
+
 	/* Perform binary search until the lower and upper limit directory
 	slots come to the distance 1 of each other */
 
@@ -172,6 +172,23 @@ For details see: row_vers_old_has_index_entry() and row_purge_poss_sec()
 */
 inline void ReadViewBase::snapshot(trx_t *trx)
 {
+  if (trx && trx_sys.csn.is_enabled())
+  {
+    /* Read the bound first: the transactions below it committed before
+    the purge view that published it, and thus before this snapshot. */
+    const trx_id_t min_active= trx_sys.csn.min_active();
+    /* The transactions that got their serialisation number before this
+    are seen. Their numbers can be found in trx_sys.csn. */
+    m_low_limit_id= m_low_limit_no= trx_sys.get_max_trx_id();
+    /* Pairs with the release fences in trx_csn_t::commit() */
+    std::atomic_thread_fence(std::memory_order_acquire);
+    m_up_limit_id= std::min(min_active, m_low_limit_id);
+    m_ids.clear();
+    m_csn= true;
+    return;
+  }
+
+  m_csn= false;
   trx_sys.snapshot_ids(trx, &m_ids, &m_low_limit_id, &m_low_limit_no);
   std::sort(m_ids.begin(), m_ids.end());
   m_up_limit_id= m_ids.empty() ? m_low_limit_id : m_ids.front();
@@ -221,7 +238,11 @@ void ReadView::open(trx_t *trx)
   else if (likely(!srv_read_only_mode))
   {
     m_creator_trx_id= trx->id;
+    /* A reused commit sequence number snapshot could be missed by
+    clone_oldest_view(), which would let trx_sys.csn forget transactions
+    that it does not see */
     if (trx_is_autocommit_non_locking(trx) && empty() &&
+        !trx_sys.csn.is_enabled() &&
         low_limit_id() == trx_sys.get_max_trx_id())
       m_open.store(true, std::memory_order_relaxed);
     else
@@ -242,11 +263,21 @@ void ReadView::open(trx_t *trx)
   in. This function is called by purge thread to determine whether it should
   purge the delete marked record or not.
 */
-void trx_sys_t::clone_oldest_view(ReadViewBase *view) const
+void trx_sys_t::clone_oldest_view(ReadViewBase *view)
 {
   view->snapshot(nullptr);
+  const trx_id_t min_active= view->up_limit_id();
   /* Find oldest view. */
   trx_list.for_each([view](const trx_t &trx) {
                       trx.read_view.append_to(view);
 		    });
+  if (csn.is_enabled())
+    csn.purge(min_active, view->low_limit_no());
+}
+
+
+bool ReadViewBase::csn_visible(trx_id_t id) const
+{
+  ut_ad(m_csn);
+  return trx_sys.csn.visible(id, m_low_limit_id);
 }
@@ -36,6 +36,7 @@ Created 4/20/1996 Heikki Tuuri
 #include "row0upd.h"
 #include "row0sel.h"
 #include "row0log.h"
+#include "row0merge.h"
 #include "rem0cmp.h"
 #include "lock0lock.h"
 #include "log0log.h"
@@ -2687,7 +2688,47 @@ row_ins_clust_index_entry_low(
 #endif /* BTR_CUR_HASH_ADAPT */
 		}
 
-		static_cast<ins_node_t*>(thr->run_node)->bulk_insert = true;
+		ins_node_t* node = static_cast<ins_node_t*>(thr->run_node);
+		node->bulk_insert = true;
+
+		if (node->bulk_insert_table && mode == BTR_MODIFY_LEAF
+		    && trx->mod_tables.find(index->table)
+		    == trx->mod_tables.end()
+		    && row_merge_bulk_t::is_supported(*index->table)) {
+			/* Buffer the index entries of this and the
+			subsequent rows, to be sorted and inserted by
+			trx_t::bulk_insert_apply(). */
+			mtr.commit();
+			roll_ptr_t roll_ptr = roll_ptr_t{1}
+				<< ROLL_PTR_INSERT_FLAG_POS;
+			/* Write the TRX_UNDO_EMPTY record. */
+			err = trx_undo_report_row_operation(
+				thr, index, entry, NULL, 0, NULL, NULL,
+				&roll_ptr);
+			if (err != DB_SUCCESS) {
+				goto func_exit;
+			}
+
+			trx_mod_table_time_t& time
+				= trx->mod_tables.find(index->table)->second;
+			ut_ad(time.is_bulk_insert());
+			trx_write_roll_ptr(static_cast<byte*>(
+				dtuple_get_nth_field(
+					entry, index->db_roll_ptr())->data),
+					   roll_ptr);
+			trx->bulk_insert_pending = true;
+			err = time.start_bulk_buffer(
+				index->table, node->bulk_insert_table)
+				->bulk_insert_buffered(*entry, *index, trx);
+			if (err == DB_TOO_BIG_RECORD) {
+				/* Retry without buffering. */
+				err = time.write_bulk(trx, NULL);
+				if (err == DB_SUCCESS) {
+					err = DB_FAIL;
+				}
+			}
+			goto func_exit;
+		}
 	}
 
 #ifndef DBUG_OFF
@@ -3376,6 +3417,21 @@ row_ins_index_entry(
 			DBUG_SET("-d,row_ins_index_entry_timeout");
 			return(DB_LOCK_WAIT);});
 
+	trx_t* trx = thr_get_trx(thr);
+
+	if (row_merge_bulk_t* bulk = trx->bulk_buffer(*index->table)) {
+		dberr_t err = bulk->bulk_insert_buffered(*entry, *index, trx);
+		if (err != DB_TOO_BIG_RECORD) {
+			return err;
+		}
+		/* Write the buffered entries of all indexes, and
+		continue row by row. */
+		err = trx->bulk_insert_apply(*index->table, NULL);
+		if (err != DB_SUCCESS) {
+			return err;
+		}
+	}
+
 	if (index->is_primary()) {
 		return row_ins_clust_index_entry(index, entry, thr, 0);
 	} else {
@@ -61,195 +61,6 @@ Completed by Sunny Bains and Marko Makela
 /* Whether to disable file system cache */
 char	srv_disable_sort_file_cache;
 
-/** Class that caches index row tuples made from a single cluster
-index page scan, and then insert into corresponding index tree */
-class index_tuple_info_t {
-public:
-	/** constructor
-	@param[in]	heap	memory heap
-	@param[in]	index	index to be created */
-	index_tuple_info_t(mem_heap_t* heap, dict_index_t* index) :
-		m_dtuple_vec(UT_NEW_NOKEY(idx_tuple_vec())),
-		m_index(index), m_heap(heap)
-	{ ut_ad(index->is_spatial()); }
-
-	/** destructor */
-	~index_tuple_info_t()
-	{
-		UT_DELETE(m_dtuple_vec);
-	}
-
-	/** Get the index object
-	@return the index object */
-	dict_index_t*   get_index() UNIV_NOTHROW
-	{
-		return(m_index);
-	}
-
-	/** Caches an index row into index tuple vector
-	@param[in]	row	table row
-	@param[in]	ext	externally stored column
-	prefixes, or NULL */
-	void add(
-		const dtuple_t*		row,
-		const row_ext_t*	ext) UNIV_NOTHROW
-	{
-		dtuple_t*	dtuple;
-
-		dtuple = row_build_index_entry(row, ext, m_index, m_heap);
-
-		ut_ad(dtuple);
-
-		m_dtuple_vec->push_back(dtuple);
-	}
-
-	/** Insert spatial index rows cached in vector into spatial index
-	@param[in]	trx_id		transaction id
-	@param[in,out]	row_heap	memory heap
-	@param[in]	pcur		cluster index scanning cursor
-	@param[in,out]	mtr_started	whether scan_mtr is active
-	@param[in,out]	scan_mtr	mini-transaction for pcur
-	@return DB_SUCCESS if successful, else error number */
-	dberr_t insert(trx_id_t trx_id, mem_heap_t* row_heap, btr_pcur_t* pcur,
-		       bool& mtr_started, mtr_t* scan_mtr) const
-	{
-		big_rec_t*      big_rec;
-		rec_t*          rec;
-		btr_cur_t       ins_cur;
-		mtr_t           mtr;
-		rtr_info_t      rtr_info;
-		rec_offs*	ins_offsets = NULL;
-		dberr_t		error = DB_SUCCESS;
-		dtuple_t*	dtuple;
-		ulint		count = 0;
-		const ulint	flag = BTR_NO_UNDO_LOG_FLAG
-				       | BTR_NO_LOCKING_FLAG
-				       | BTR_KEEP_SYS_FLAG | BTR_CREATE_FLAG;
-
-		ut_ad(mtr_started == scan_mtr->is_active());
-
-		DBUG_EXECUTE_IF("row_merge_instrument_log_check_flush",
-				log_sys.set_check_flush_or_checkpoint(););
-
-		for (idx_tuple_vec::iterator it = m_dtuple_vec->begin();
-		     it != m_dtuple_vec->end();
-		     ++it) {
-			dtuple = *it;
-			ut_ad(dtuple);
-
-			if (log_sys.check_flush_or_checkpoint()) {
-				if (mtr_started) {
-					btr_pcur_move_to_prev_on_page(pcur);
-					btr_pcur_store_position(pcur, scan_mtr);
-					scan_mtr->commit();
-					mtr_started = false;
-				}
-
-				log_free_check();
-			}
-
-			mtr.start();
-			m_index->set_modified(mtr);
-
-			ins_cur.index = m_index;
-			rtr_init_rtr_info(&rtr_info, false, &ins_cur, m_index,
-					  false);
-			rtr_info_update_btr(&ins_cur, &rtr_info);
-
-			btr_cur_search_to_nth_level(m_index, 0, dtuple,
-						    PAGE_CUR_RTREE_INSERT,
-						    BTR_MODIFY_LEAF, &ins_cur,
-						    0, &mtr);
-
-			/* It need to update MBR in parent entry,
-			so change search mode to BTR_MODIFY_TREE */
-			if (rtr_info.mbr_adj) {
-				mtr_commit(&mtr);
-				rtr_clean_rtr_info(&rtr_info, true);
-				rtr_init_rtr_info(&rtr_info, false, &ins_cur,
-						  m_index, false);
-				rtr_info_update_btr(&ins_cur, &rtr_info);
-				mtr_start(&mtr);
-				m_index->set_modified(mtr);
-				btr_cur_search_to_nth_level(
-					m_index, 0, dtuple,
-					PAGE_CUR_RTREE_INSERT,
-					BTR_MODIFY_TREE, &ins_cur, 0, &mtr);
-			}
-
-			error = btr_cur_optimistic_insert(
-				flag, &ins_cur, &ins_offsets, &row_heap,
-				dtuple, &rec, &big_rec, 0, NULL, &mtr);
-
-			if (error == DB_FAIL) {
-				ut_ad(!big_rec);
-				mtr.commit();
-				mtr.start();
-				m_index->set_modified(mtr);
-
-				rtr_clean_rtr_info(&rtr_info, true);
-				rtr_init_rtr_info(&rtr_info, false,
-						  &ins_cur, m_index, false);
-
-				rtr_info_update_btr(&ins_cur, &rtr_info);
-				btr_cur_search_to_nth_level(
-					m_index, 0, dtuple,
-					PAGE_CUR_RTREE_INSERT,
-					BTR_MODIFY_TREE,
-					&ins_cur, 0, &mtr);
-
-				error = btr_cur_pessimistic_insert(
-						flag, &ins_cur, &ins_offsets,
-						&row_heap, dtuple, &rec,
-						&big_rec, 0, NULL, &mtr);
-			}
-
-			DBUG_EXECUTE_IF(
-				"row_merge_ins_spatial_fail",
-				error = DB_FAIL;
-			);
-
-			if (error == DB_SUCCESS) {
-				if (rtr_info.mbr_adj) {
-					error = rtr_ins_enlarge_mbr(
-							&ins_cur, &mtr);
-				}
-
-				if (error == DB_SUCCESS) {
-					page_update_max_trx_id(
-						btr_cur_get_block(&ins_cur),
-						btr_cur_get_page_zip(&ins_cur),
-						trx_id, &mtr);
-				}
-			}
-
-			mtr_commit(&mtr);
-
-			rtr_clean_rtr_info(&rtr_info, true);
-			count++;
-		}
-
-		m_dtuple_vec->clear();
-
-		return(error);
-	}
-
-private:
-	/** Cache index rows made from a cluster index scan. Usually
-	for rows on single cluster index page */
-	typedef std::vector<dtuple_t*, ut_allocator<dtuple_t*> >
-		idx_tuple_vec;
-
-	/** vector used to cache index rows made from cluster index scan */
-	idx_tuple_vec* const	m_dtuple_vec;
-
-	/** the index being built */
-	dict_index_t* const	m_index;
-
-	/** memory heap for creating index tuples */
-	mem_heap_t* const	m_heap;
-};
-
 /* Maximum pending doc memory limit in bytes for a fts tokenization thread */
 #define FTS_PENDING_DOC_MEMORY_LIMIT	1000000
 
@@ -463,6 +274,195 @@ row_merge_buf_redundant_convert(
 	dfield_set_data(field, buf, len);
 }
 
+/** Map a coordinate to an unsigned integer of the same order. Only the
+most significant half of the IEEE 754 representation is used, which
+keeps a relative precision of about 6 decimal digits.
+@param[in]	d	coordinate
+@return order preserving image of d */
+static
+uint32_t
+row_merge_spatial_coord(double d)
+{
+	uint64_t	u;
+
+	memcpy(&u, &d, sizeof u);
+	u = (u >> 63) ? ~u : u | 1ULL << 63;
+
+	return(static_cast<uint32_t>(u >> 32));
+}
+
+/** Compute the sort key of a SPATIAL index entry: the distance of the
+centre of its minimum bounding rectangle along a Hilbert curve. Sorting
+by it places nearby geometries next to each other, so that the pages that
+row_merge_insert_index_tuples() packs bottom-up cover small and seldom
+overlapping MBRs.
+@param[in]	mbr	minimum bounding rectangle of DATA_MBR_LEN bytes
+@return Hilbert curve key */
+static
+uint64_t
+row_merge_spatial_key(const byte* mbr)
+{
+	uint32_t	x = row_merge_spatial_coord(
+		(mach_double_read(mbr) + mach_double_read(mbr + 8)) / 2);
+	uint32_t	y = row_merge_spatial_coord(
+		(mach_double_read(mbr + 16) + mach_double_read(mbr + 24)) / 2);
+	uint64_t	key = 0;
+
+	for (uint32_t s = 1U << 31; s; s >>= 1) {
+		const uint32_t	rx = (x & s) != 0;
+		const uint32_t	ry = (y & s) != 0;
+
+		key += uint64_t{s} * s * ((3 * rx) ^ ry);
+
+		/* Rotate the quadrant. */
+		if (!ry) {
+			if (rx) {
+				x = ~x;
+				y = ~y;
+			}
+
+			std::swap(x, y);
+		}
+	}
+
+	return(key);
+}
+
+/** Compare two SPATIAL index entries by row_merge_spatial_key(),
+and then by all fields.
+@param[in]	n_field	number of fields
+@param[in]	a	first entry
+@param[in]	b	second entry
+@return positive, 0, negative if a is greater, equal, less, than b,
+respectively */
+static
+int
+row_merge_spatial_cmp(
+	ulint			n_field,
+	const dfield_t*		a,
+	const dfield_t*		b)
+{
+	ut_ad(dfield_get_len(a) == DATA_MBR_LEN);
+	ut_ad(dfield_get_len(b) == DATA_MBR_LEN);
+
+	const uint64_t	a_key = row_merge_spatial_key(
+		static_cast<const byte*>(dfield_get_data(a)));
+	const uint64_t	b_key = row_merge_spatial_key(
+		static_cast<const byte*>(dfield_get_data(b)));
+
+	if (a_key != b_key) {
+		return(a_key < b_key ? -1 : 1);
+	}
+
+	for (ulint i = 0; i < n_field; i++) {
+		if (int cmp = cmp_dfield_dfield(a + i, b + i)) {
+			return(cmp);
+		}
+	}
+
+	return(0);
+}
+
+/** Compare two SPATIAL index records in the order of
+row_merge_spatial_cmp().
+@param[in]	a		first record
+@param[in]	b		second record
+@param[in]	a_offsets	offsets of a
+@param[in]	b_offsets	offsets of b
+@param[in]	index		SPATIAL index
+@return positive, 0, negative if a is greater, equal, less, than b,
+respectively */
+static
+int
+row_merge_spatial_rec_cmp(
+	const mrec_t*		a,
+	const mrec_t*		b,
+	const rec_offs*		a_offsets,
+	const rec_offs*		b_offsets,
+	const dict_index_t*	index)
+{
+	ulint		a_len;
+	ulint		b_len;
+	const byte*	a_data = rec_get_nth_field(a, a_offsets, 0, &a_len);
+	const byte*	b_data = rec_get_nth_field(b, b_offsets, 0, &b_len);
+
+	ut_ad(a_len == DATA_MBR_LEN);
+	ut_ad(b_len == DATA_MBR_LEN);
+
+	const uint64_t	a_key = row_merge_spatial_key(a_data);
+	const uint64_t	b_key = row_merge_spatial_key(b_data);
+
+	if (a_key != b_key) {
+		return(a_key < b_key ? -1 : 1);
+	}
+
+	for (ulint i = 0; i < dict_index_get_n_fields(index); i++) {
+		const dict_col_t*	col = dict_index_get_nth_col(index, i);
+
+		a_data = rec_get_nth_field(a, a_offsets, i, &a_len);
+		b_data = rec_get_nth_field(b, b_offsets, i, &b_len);
+
+		if (int cmp = cmp_data_data(
+			    col->mtype,
+			    i ? col->prtype : col->prtype | DATA_GIS_MBR,
+			    a_data, a_len, b_data, b_len)) {
+			return(cmp);
+		}
+	}
+
+	return(0);
+}
+
+/** Insert the entry of a SPATIAL index for a table row into a sort
+buffer. The entry consists of the minimum bounding rectangle of the
+geometry and the PRIMARY KEY.
+@param[in,out]	buf	sort buffer
+@param[in]	row	table row
+@param[in]	ext	cache of externally stored column prefixes, or NULL
+@return number of rows added, 0 if out of space */
+static
+ulint
+row_merge_buf_add_spatial(
+	row_merge_buf_t*	buf,
+	const dtuple_t*		row,
+	const row_ext_t*	ext)
+{
+	const dict_index_t*	index = buf->index;
+	const ulint		n_fields = dict_index_get_n_fields(index);
+
+	ut_ad(dict_index_is_spatial(index));
+
+	/* The MBR is allocated from buf->heap. */
+	dtuple_t*	entry = row_build_index_entry(row, ext, index,
+						      buf->heap);
+	ut_ad(entry);
+	ut_ad(dtuple_get_n_fields(entry) == n_fields);
+
+	ulint	extra_size;
+	ulint	data_size = rec_get_converted_size_temp(
+		index, entry->fields, n_fields, &extra_size);
+
+	/* See row_merge_buf_encode() for the encoding of extra_size. */
+	data_size += 1 + ((extra_size + 1) >= 0x80);
+
+	ut_ad(data_size < srv_sort_buf_size);
+
+	/* Reserve bytes for the end marker of row_merge_block_t. */
+	if (buf->total_size + data_size >= srv_sort_buf_size) {
+		return(0);
+	}
+
+	buf->total_size += data_size;
+	buf->tuples[buf->n_tuples++].fields = entry->fields;
+
+	/* Copy the PRIMARY KEY fields. */
+	for (ulint i = 1; i < n_fields; i++) {
+		dfield_dup(&entry->fields[i], buf->heap);
+	}
+
+	return(1);
+}
+
 /** Insert a data tuple into a sort buffer.
 @param[in,out]	buf		sort buffer
 @param[in]	fts_index	fts index to be created
@@ -529,8 +529,9 @@ row_merge_buf_add(
 	fts_index */
 	index = (buf->index->type & DICT_FTS) ? fts_index : buf->index;
 
-	/* create spatial index should not come here */
-	ut_ad(!dict_index_is_spatial(index));
+	if (dict_index_is_spatial(index)) {
+		DBUG_RETURN(row_merge_buf_add_spatial(buf, row, ext));
+	}
 
 	n_fields = dict_index_get_n_fields(index);
 
@@ -852,7 +853,7 @@ row_merge_dup_report(
 	row_merge_dup_t*	dup,	/*!< in/out: for reporting duplicates */
 	const dfield_t*		entry)	/*!< in: duplicate index entry */
 {
-	if (!dup->n_dup++) {
+	if (!dup->n_dup++ && dup->table) {
 		/* Only report the first duplicate record,
 		but count all duplicate records. */
 		innobase_fields_to_mysql(dup->table, dup->index, entry);
@@ -974,7 +975,19 @@ row_merge_buf_sort(
 	row_merge_dup_t*	dup)	/*!< in/out: reporter of duplicates
 					(NULL if non-unique index) */
 {
-	ut_ad(!dict_index_is_spatial(buf->index));
+	if (dict_index_is_spatial(buf->index)) {
+		const ulint	n_field = dict_index_get_n_fields(buf->index);
+
+		ut_ad(!dup);
+
+		std::sort(buf->tuples, buf->tuples + buf->n_tuples,
+			  [n_field](const mtuple_t& a, const mtuple_t& b) {
+				  return(row_merge_spatial_cmp(
+						 n_field, a.fields,
+						 b.fields) < 0);
+			  });
+		return;
+	}
 
 	row_merge_tuple_sort(dict_index_get_n_unique(buf->index),
 			     dict_index_get_n_fields(buf->index),
@@ -1555,39 +1568,6 @@ row_mtuple_cmp(
 		       n_unique, n_unique, *current_mtuple, *prev_mtuple, dup));
 }
 
-/** Insert cached spatial index rows.
-@param[in]	trx_id		transaction id
-@param[in]	sp_tuples	cached spatial rows
-@param[in]	num_spatial	number of spatial indexes
-@param[in,out]	heap		heap for insert
-@param[in,out]	sp_heap		heap for tuples
-@param[in,out]	pcur		cluster index cursor
-@param[in,out]	started		whether mtr is active
-@param[in,out]	mtr		mini-transaction
-@return DB_SUCCESS or error number */
-static
-dberr_t
-row_merge_spatial_rows(
-	trx_id_t		trx_id,
-	index_tuple_info_t**	sp_tuples,
-	ulint			num_spatial,
-	mem_heap_t*		heap,
-	mem_heap_t*		sp_heap,
-	btr_pcur_t*		pcur,
-	bool&			started,
-	mtr_t*			mtr)
-{
-  if (!sp_tuples)
-    return DB_SUCCESS;
-
-  for (ulint j= 0; j < num_spatial; j++)
-    if (dberr_t err= sp_tuples[j]->insert(trx_id, heap, pcur, started, mtr))
-      return err;
-
-  mem_heap_empty(sp_heap);
-  return DB_SUCCESS;
-}
-
 /** Check if the geometry field is valid.
 @param[in]	row		the row
 @param[in]	index		spatial index
@@ -1698,9 +1678,6 @@ row_merge_read_clustered_index(
 	doc_id_t		max_doc_id = 0;
 	ibool			add_doc_id = FALSE;
 	pthread_cond_t*		fts_parallel_sort_cond = nullptr;
-	index_tuple_info_t**	sp_tuples = NULL;
-	mem_heap_t*		sp_heap = NULL;
-	ulint			num_spatial = 0;
 	BtrBulk*		clust_btr_bulk = NULL;
 	bool			clust_temp_file = false;
 	mem_heap_t*		mtuple_heap = NULL;
@@ -1777,37 +1754,10 @@ row_merge_read_clustered_index(
 			fts_parallel_sort_cond =
 				 &psort_info[0].psort_common->sort_cond;
 		} else {
-			if (dict_index_is_spatial(index[i])) {
-				num_spatial++;
-			}
-
 			merge_buf[i] = row_merge_buf_create(index[i]);
 		}
 	}
 
-	if (num_spatial > 0) {
-		ulint	count = 0;
-
-		sp_heap = mem_heap_create(512);
-
-		sp_tuples = static_cast<index_tuple_info_t**>(
-			ut_malloc_nokey(num_spatial
-					* sizeof(*sp_tuples)));
-
-		for (ulint i = 0; i < n_index; i++) {
-			if (dict_index_is_spatial(index[i])) {
-				sp_tuples[count]
-					= UT_NEW_NOKEY(
-						index_tuple_info_t(
-							sp_heap,
-							index[i]));
-				count++;
-			}
-		}
-
-		ut_ad(count == num_spatial);
-	}
-
 	mtr.start();
 	mtr_started = true;
 
@@ -1957,19 +1907,6 @@ row_merge_read_clustered_index(
 				}
 			}
 
-			/* Insert the cached spatial index rows. */
-			err = row_merge_spatial_rows(
-				trx->id, sp_tuples, num_spatial,
-				row_heap, sp_heap, &pcur, mtr_started, &mtr);
-
-			if (err != DB_SUCCESS) {
-				goto func_exit;
-			}
-
-			if (!mtr_started) {
-				goto scan_next;
-			}
-
 			if (clust_index->lock.is_waiting()) {
 				/* There are waiters on the clustered
 				index tree lock, likely the purge
@@ -1994,7 +1931,6 @@ row_merge_read_clustered_index(
 
 				/* Give the waiters a chance to proceed. */
 				os_thread_yield();
-scan_next:
 				ut_ad(!mtr_started);
 				ut_ad(!mtr.is_active());
 				mtr.start();
@@ -2319,33 +2255,19 @@ row_merge_read_clustered_index(
 		in a single scan of the clustered index. */
 
 		n_rows++;
-		ulint	s_idx_cnt = 0;
 		bool	skip_sort = skip_pk_sort
 			&& dict_index_is_clust(merge_buf[0]->index);
 
-		for (ulint k = 0, i = 0; i < n_index; i++, skip_sort = false) {
+		for (ulint i = 0; i < n_index; i++, skip_sort = false) {
 			row_merge_buf_t*	buf	= merge_buf[i];
 			ulint			rows_added = 0;
 
-			if (dict_index_is_spatial(buf->index)) {
-				if (!row) {
-					continue;
-				}
-
-				ut_ad(sp_tuples[s_idx_cnt]->get_index()
-				      == buf->index);
-
-				/* If the geometry field is invalid, report
-				error. */
-				if (!row_geo_field_is_valid(row, buf->index)) {
-					err = DB_CANT_CREATE_GEOMETRY_OBJECT;
-					break;
-				}
-
-				sp_tuples[s_idx_cnt]->add(row, ext);
-				s_idx_cnt++;
-
-				continue;
+			/* If the geometry field is invalid, report
+			error. */
+			if (row && dict_index_is_spatial(buf->index)
+			    && !row_geo_field_is_valid(row, buf->index)) {
+				err = DB_CANT_CREATE_GEOMETRY_OBJECT;
+				break;
 			}
 
 			ut_ad(!row
@@ -2353,7 +2275,7 @@ row_merge_read_clustered_index(
 			      || trx_id_check(row->fields[new_trx_id_col].data,
 					      trx->id));
 
-			merge_file_t*	file = &files[k++];
+			merge_file_t*	file = &files[i];
 
 			if (UNIV_LIKELY
 			    (row && (rows_added = row_merge_buf_add(
@@ -2454,23 +2376,6 @@ row_merge_read_clustered_index(
 					/* Temporary File is not used.
 					so insert sorted block to the index */
 					if (row != NULL) {
-						/* We have to do insert the
-						cached spatial index rows, since
-						after the mtr_commit, the cluster
-						index page could be updated, then
-						the data in cached rows become
-						invalid. */
-						err = row_merge_spatial_rows(
-							trx->id, sp_tuples,
-							num_spatial,
-							row_heap, sp_heap,
-							&pcur, mtr_started,
-							&mtr);
-
-						if (err != DB_SUCCESS) {
-							goto func_exit;
-						}
-
 						/* We are not at the end of
 						the scan yet. We must
 						mtr.commit() in order to be
@@ -2523,9 +2428,8 @@ row_merge_read_clustered_index(
 						UT_DELETE(clust_btr_bulk);
 						clust_btr_bulk = NULL;
 					} else {
-						/* Release latches for possible
-						log_free_chck in spatial index
-						build. */
+						/* Release latches before
+						resuming the scan. */
 						clust_btr_bulk->release();
 					}
 
@@ -2814,17 +2718,6 @@ row_merge_read_clustered_index(
 
 	btr_pcur_close(&pcur);
 
-	if (sp_tuples != NULL) {
-		for (ulint i = 0; i < num_spatial; i++) {
-			UT_DELETE(sp_tuples[i]);
-		}
-		ut_free(sp_tuples);
-
-		if (sp_heap) {
-			mem_heap_free(sp_heap);
-		}
-	}
-
 	/* Update the next Doc ID we used. Table should be locked, so
 	no concurrent DML */
 	if (max_doc_id && err == DB_SUCCESS) {
@@ -2840,8 +2733,7 @@ row_merge_read_clustered_index(
 	if (vers_update_trt) {
 		trx_mod_table_time_t& time =
 			trx->mod_tables
-				.insert(trx_mod_tables_t::value_type(
-					const_cast<dict_table_t*>(new_table), 0))
+				.emplace(const_cast<dict_table_t*>(new_table), 0)
 				.first->second;
 		time.set_versioned(0);
 	}
@@ -2851,83 +2743,803 @@ row_merge_read_clustered_index(
 	DBUG_RETURN(err);
 }
 
-/** Write a record via buffer 2 and read the next record to buffer N.
-@param N number of the buffer (0 or 1)
-@param INDEX record descriptor
-@param AT_END statement to execute at end of input */
-#define ROW_MERGE_WRITE_GET_NEXT_LOW(N, INDEX, AT_END)			\
-	do {								\
-		b2 = row_merge_write_rec(&block[2 * srv_sort_buf_size], \
-					 &buf[2], b2,			\
-					 of->fd, &of->offset,		\
-					 mrec##N, offsets##N,		\
-			crypt_block ? &crypt_block[2 * srv_sort_buf_size] : NULL , \
-					space);				\
-		if (UNIV_UNLIKELY(!b2 || ++of->n_rec > file->n_rec)) {	\
-			goto corrupt;					\
-		}							\
-		b##N = row_merge_read_rec(&block[N * srv_sort_buf_size],\
-					  &buf[N], b##N, INDEX,		\
-					  file->fd, foffs##N,		\
-					  &mrec##N, offsets##N,		\
-			crypt_block ? &crypt_block[N * srv_sort_buf_size] : NULL, \
-					  space);			\
-									\
-		if (UNIV_UNLIKELY(!b##N)) {				\
-			if (mrec##N) {					\
-				goto corrupt;				\
-			}						\
-			AT_END;						\
-		}							\
-	} while (0)
-
-#ifdef HAVE_PSI_STAGE_INTERFACE
-#define ROW_MERGE_WRITE_GET_NEXT(N, INDEX, AT_END)			\
-	do {								\
-		if (stage != NULL) {					\
-			stage->inc();					\
-		}							\
-		ROW_MERGE_WRITE_GET_NEXT_LOW(N, INDEX, AT_END);		\
-	} while (0)
-#else /* HAVE_PSI_STAGE_INTERFACE */
-#define ROW_MERGE_WRITE_GET_NEXT(N, INDEX, AT_END)			\
-	ROW_MERGE_WRITE_GET_NEXT_LOW(N, INDEX, AT_END)
-#endif /* HAVE_PSI_STAGE_INTERFACE */
+/** State of a clustered index scan by several threads,
+see row_merge_read_clustered_index_parallel() */
+struct row_merge_scan_t
+{
+	/** transaction that is creating the indexes */
+	trx_t*			trx;
+	/** MySQL table, for reporting duplicate keys */
+	struct TABLE*		table;
+	/** table whose clustered index is being read */
+	const dict_table_t*	old_table;
+	/** whether the indexes are being created online */
+	bool			online;
+	/** indexes to be created */
+	dict_index_t**		index;
+	/** MySQL key numbers of index[] */
+	const ulint*		key_numbers;
+	/** number of indexes */
+	ulint			n_index;
+	/** location of the temporary files */
+	const char*		path;
+	/** lower bounds of the key ranges, except the first one */
+	const dtuple_t**	bounds;
+	/** number of key ranges */
+	ulint			n_ranges;
+	/** next key range to be read */
+	std::atomic<ulint>	next_range;
+	/** number of records read */
+	std::atomic<ulint>	n_recs;
+	/** number of leaf pages read */
+	std::atomic<ulint>	n_pages;
+	/** whether the scan is to be aborted because of an error */
+	std::atomic<bool>	failed;
+	/** protects files, tmpfd, err, error_key_num and table */
+	srw_mutex		mutex;
+	/** sorted runs of index[] */
+	merge_file_t*		files;
+	/** temporary file for row_merge_sort() */
+	pfs_os_file_t*		tmpfd;
+	/** the first error */
+	dberr_t			err;
+	/** trx->error_key_num of the first error */
+	ulint			error_key_num;
+	/** performance schema accounting object; only accessed by the
+	thread that started the scan */
+	ut_stage_alter_t*	stage;
+	/** percent of task weight of the scan out of total alter job */
+	double			pct_cost;
+	/** estimated number of rows in the table */
+	ib_uint64_t		table_total_rows;
+	/** number of records reported to stage */
+	ib_uint64_t		read_rows;
+
+	/** Note an error, unless an earlier one was noted.
+	@param error	error code
+	@param key_num	trx->error_key_num to report */
+	void set_error(dberr_t error, ulint key_num)
+	{
+		mutex.wr_lock();
+		if (err == DB_SUCCESS) {
+			err = error;
+			error_key_num = key_num;
+		}
+		mutex.wr_unlock();
+		failed = true;
+	}
+};
 
-/** Merge two blocks of records on disk and write a bigger block.
-@param[in]	dup	descriptor of index being created
-@param[in]	file	file containing index entries
-@param[in,out]	block	3 buffers
-@param[in,out]	foffs0	offset of first source list in the file
-@param[in,out]	foffs1	offset of second source list in the file
-@param[in,out]	of	output file
-@param[in,out]	stage	performance schema accounting object, used by
-ALTER TABLE. If not NULL stage->inc() will be called for each record
-processed.
-@param[in,out]	crypt_block	encryption buffer
-@param[in]	space	tablespace ID for encryption
-@return DB_SUCCESS or error code */
-static MY_ATTRIBUTE((warn_unused_result))
-dberr_t
-row_merge_blocks(
-	const row_merge_dup_t*	dup,
-	const merge_file_t*	file,
-	row_merge_block_t*	block,
-	ulint*			foffs0,
-	ulint*			foffs1,
-	merge_file_t*		of,
-	ut_stage_alter_t*	stage MY_ATTRIBUTE((unused)),
-	row_merge_block_t*	crypt_block,
-	ulint			space)
+/** Pick the key ranges of a parallel clustered index scan from the
+node pointer records on the root page.
+@param[in]	index		clustered index
+@param[in]	n_ranges	wanted number of key ranges
+@param[in,out]	heap		memory heap for the range boundaries
+@param[out]	bounds		lower bounds of the ranges but the first one
+@return number of key ranges; 1 if the root page is a leaf page */
+static
+ulint
+row_merge_scan_split(
+	dict_index_t*		index,
+	ulint			n_ranges,
+	mem_heap_t*		heap,
+	const dtuple_t***	bounds)
 {
-	mem_heap_t*	heap;	/*!< memory heap for offsets0, offsets1 */
+	mtr_t	mtr;
+	ulint	n = 1;
 
-	mrec_buf_t*	buf;	/*!< buffer for handling
-				split mrec in block[] */
-	const byte*	b0;	/*!< pointer to block[0] */
-	const byte*	b1;	/*!< pointer to block[srv_sort_buf_size] */
-	byte*		b2;	/*!< pointer to block[2 * srv_sort_buf_size] */
-	const mrec_t*	mrec0;	/*!< merge rec, points to block[0] or buf[0] */
+	mtr.start();
+
+	if (const buf_block_t* root = btr_root_block_get(
+		    index, RW_S_LATCH, &mtr)) {
+		const page_t*	page = buf_block_get_frame(root);
+		const ulint	n_recs = page_get_n_recs(page);
+
+		if (btr_page_get_level(page) && n_recs > 1) {
+			n = std::min(n_ranges, n_recs);
+			*bounds = static_cast<const dtuple_t**>(
+				mem_heap_alloc(heap, (n - 1) * sizeof **bounds));
+
+			const ulint	n_fields
+				= dict_index_get_n_unique_in_tree_nonleaf(
+					index);
+			const rec_t*	rec = page_rec_get_next_const(
+				page_get_infimum_rec(page));
+
+			/* Split the node pointers evenly. The first
+			one carries REC_INFO_MIN_REC_FLAG and is never
+			picked as a boundary. */
+			for (ulint r = 0, b = 1; b < n;
+			     r++, rec = page_rec_get_next_const(rec)) {
+				if (r == b * n_recs / n) {
+					(*bounds)[b++ - 1]
+						= dict_index_build_data_tuple(
+							rec, index, false,
+							n_fields, heap);
+				}
+			}
+		}
+	}
+
+	mtr.commit();
+	return(n);
+}
+
+/** Report the progress of a parallel clustered index scan. This is
+only called by the thread that started the scan.
+@param[in,out]	scan	parallel scan */
+static
+void
+row_merge_scan_report(
+	row_merge_scan_t*	scan)
+{
+	for (ulint n = scan->n_recs.exchange(0); n--; ) {
+		scan->stage->n_pk_recs_inc();
+		scan->read_rows++;
+	}
+
+	for (ulint n = scan->n_pages.exchange(0); n--; ) {
+		scan->stage->inc();
+	}
+
+	double curr_progress = (scan->read_rows >= scan->table_total_rows)
+		? scan->pct_cost
+		: scan->pct_cost * static_cast<double>(scan->read_rows)
+		/ static_cast<double>(scan->table_total_rows);
+	/* presenting 10.12% as 1012 integer */
+	onlineddl_pct_progress = (ulint) (curr_progress * 100);
+}
+
+/** Sort a full buffer of a parallel clustered index scan and write it
+to the merge file of its index as a new run.
+@param[in,out]	scan		parallel scan
+@param[in]	i		position of the index in scan->index[]
+@param[in,out]	buf		sort buffer
+@param[in,out]	block		file buffer
+@param[in,out]	crypt_block	encrypted file buffer, or NULL
+@return whether the buffer was written */
+static
+bool
+row_merge_scan_write(
+	row_merge_scan_t*	scan,
+	ulint			i,
+	row_merge_buf_t*	buf,
+	row_merge_block_t*	block,
+	row_merge_block_t*	crypt_block)
+{
+	merge_file_t*	file = &scan->files[i];
+	ulint		offset = 0;
+
+	if (dict_index_is_unique(buf->index)) {
+		row_merge_dup_t	dup = {buf->index, NULL, NULL, 0};
+
+		row_merge_buf_sort(buf, &dup);
+
+		if (dup.n_dup) {
+			scan->mutex.wr_lock();
+			if (scan->err == DB_SUCCESS) {
+				/* Sort again to copy the duplicate
+				key value to the MySQL table. */
+				dup.table = scan->table;
+				dup.n_dup = 0;
+				row_merge_buf_sort(buf, &dup);
+				scan->err = DB_DUPLICATE_KEY;
+				scan->error_key_num = scan->key_numbers[i];
+			}
+			scan->mutex.wr_unlock();
+			scan->failed = true;
+			return(false);
+		}
+	} else {
+		row_merge_buf_sort(buf, NULL);
+	}
+
+	/* Reserve the space of the run in the file. */
+	scan->mutex.wr_lock();
+	const bool created = row_merge_file_create_if_needed(
+		file, scan->tmpfd, 0, scan->path);
+	if (created) {
+		offset = file->offset++;
+		file->n_rec += buf->n_tuples;
+	}
+	scan->mutex.wr_unlock();
+
+	if (!created) {
+		scan->set_error(DB_OUT_OF_MEMORY, i);
+		return(false);
+	}
+
+	row_merge_buf_write(buf, file, block);
+
+	if (!row_merge_write(file->fd, offset, block, crypt_block,
+			     scan->old_table->space_id)) {
+		scan->set_error(DB_TEMP_FILE_WRITE_FAIL, i);
+		return(false);
+	}
+
+	MEM_UNDEFINED(&block[0], srv_sort_buf_size);
+	return(true);
+}
+
+/** Read a key range of the clustered index into the sort buffers.
+@param[in,out]	scan		parallel scan
+@param[in]	low		lower bound of the range, or NULL
+@param[in]	high		upper bound (excluded) of the range, or NULL
+@param[in,out]	merge_buf	sort buffers of scan->index[]
+@param[in,out]	block		file buffer
+@param[in,out]	crypt_block	encrypted file buffer, or NULL
+@param[in]	report		whether to report the progress
+@return whether the scan is to be continued */
+static
+bool
+row_merge_scan_range(
+	row_merge_scan_t*	scan,
+	const dtuple_t*		low,
+	const dtuple_t*		high,
+	row_merge_buf_t**	merge_buf,
+	row_merge_block_t*	block,
+	row_merge_block_t*	crypt_block,
+	bool			report)
+{
+	trx_t*			trx = scan->trx;
+	const dict_table_t*	old_table = scan->old_table;
+	dict_index_t*		clust_index = dict_table_get_first_index(
+		old_table);
+	mem_heap_t*		row_heap = mem_heap_create(
+		sizeof(mrec_buf_t));
+	mem_heap_t*		v_heap = NULL;
+	doc_id_t		doc_id = 0;
+	btr_pcur_t		pcur;
+	mtr_t			mtr;
+	bool			ok = true;
+
+	mtr.start();
+
+	if (low) {
+		btr_pcur_open(clust_index, low, PAGE_CUR_GE, BTR_SEARCH_LEAF,
+			      &pcur, &mtr);
+		btr_pcur_move_to_prev_on_page(&pcur);
+	} else {
+		btr_pcur_open_at_index_side(
+			true, clust_index, BTR_SEARCH_LEAF, &pcur, true, 0,
+			&mtr);
+		btr_pcur_move_to_next_user_rec(&pcur, &mtr);
+		if (!rec_is_metadata(btr_pcur_get_rec(&pcur),
+				     *clust_index)) {
+			btr_pcur_move_to_prev_on_page(&pcur);
+		}
+	}
+
+	for (;;) {
+		const rec_t*	rec;
+		rec_offs*	offsets;
+		dtuple_t*	row;
+		row_ext_t*	ext;
+		page_cur_t*	cur = btr_pcur_get_page_cur(&pcur);
+
+		mem_heap_empty(row_heap);
+
+		page_cur_move_to_next(cur);
+
+		if (page_cur_is_after_last(cur)) {
+			scan->n_pages++;
+
+			if (report) {
+				row_merge_scan_report(scan);
+			}
+
+			if (scan->failed) {
+				ok = false;
+				break;
+			}
+
+			if (UNIV_UNLIKELY(trx_is_interrupted(trx))) {
+				scan->set_error(DB_INTERRUPTED, 0);
+				ok = false;
+				break;
+			}
+
+			if (!old_table->is_readable()) {
+				scan->set_error(DB_DECRYPTION_FAILED, 0);
+				ok = false;
+				break;
+			}
+
+			if (clust_index->lock.is_waiting()) {
+				/* Yield to the waiters on the index
+				tree lock, like
+				row_merge_read_clustered_index() does. */
+				btr_pcur_move_to_prev_on_page(&pcur);
+				btr_pcur_store_position(&pcur, &mtr);
+				mtr.commit();
+
+				os_thread_yield();
+
+				mtr.start();
+				btr_pcur_restore_position(
+					BTR_SEARCH_LEAF, &pcur, &mtr);
+				if (!btr_pcur_move_to_next_user_rec(
+					    &pcur, &mtr)) {
+					break;
+				}
+			} else {
+				uint32_t next_page_no = btr_page_get_next(
+					page_cur_get_page(cur));
+
+				if (next_page_no == FIL_NULL) {
+					break;
+				}
+
+				buf_block_t* next_block = btr_block_get(
+					*clust_index, next_page_no,
+					RW_S_LATCH, false, &mtr);
+
+				btr_leaf_page_release(page_cur_get_block(cur),
+						      BTR_SEARCH_LEAF, &mtr);
+				page_cur_set_before_first(next_block, cur);
+				page_cur_move_to_next(cur);
+
+				ut_ad(!page_cur_is_after_last(cur));
+			}
+		}
+
+		rec = page_cur_get_rec(cur);
+		offsets = rec_get_offsets(rec, clust_index, NULL, true,
+					  ULINT_UNDEFINED, &row_heap);
+
+		if (high && cmp_dtuple_rec(high, rec, offsets) <= 0) {
+			break;
+		}
+
+		scan->n_recs++;
+
+		if (scan->online) {
+			/* Perform a REPEATABLE READ, as in
+			row_merge_read_clustered_index(). */
+			trx_id_t rec_trx_id = row_get_rec_trx_id(
+				rec, clust_index, offsets);
+
+			if (!trx->read_view.changes_visible(
+				    rec_trx_id, old_table->name)) {
+				rec_t*	old_vers;
+
+				row_vers_build_for_consistent_read(
+					rec, &mtr, clust_index, &offsets,
+					&trx->read_view, &row_heap,
+					row_heap, &old_vers, NULL);
+
+				if (!old_vers) {
+					continue;
+				}
+
+				rec = old_vers;
+			}
+		}
+
+		if (rec_get_deleted_flag(rec, dict_table_is_comp(old_table))) {
+			continue;
+		}
+
+		ut_ad(!rec_offs_any_null_extern(rec, offsets));
+
+		row = row_build(ROW_COPY_POINTERS, clust_index, rec, offsets,
+				old_table, NULL, NULL, &ext, row_heap);
+
+		for (ulint i = 0; i < scan->n_index; i++) {
+			row_merge_buf_t*	buf = merge_buf[i];
+			dberr_t			err = DB_SUCCESS;
+
+			if (!row_merge_buf_add(buf, NULL, old_table,
+					       old_table, NULL, row, ext,
+					       &doc_id, NULL, &err, &v_heap,
+					       NULL, trx)) {
+				/* The buffer is full. */
+				if (!row_merge_scan_write(scan, i, buf, block,
+							  crypt_block)) {
+					ok = false;
+					break;
+				}
+
+				merge_buf[i] = buf = row_merge_buf_empty(buf);
+
+				if (!row_merge_buf_add(
+					    buf, NULL, old_table, old_table,
+					    NULL, row, ext, &doc_id, NULL,
+					    &err, &v_heap, NULL, trx)) {
+					/* An empty buffer should have
+					enough room for at least one
+					record. */
+					ut_error;
+				}
+			}
+
+			if (err != DB_SUCCESS) {
+				ut_ad(err == DB_TOO_BIG_RECORD);
+				scan->set_error(err, i);
+				ok = false;
+				break;
+			}
+		}
+
+		if (!ok) {
+			break;
+		}
+
+		if (v_heap) {
+			mem_heap_empty(v_heap);
+		}
+	}
+
+	mtr.commit();
+	btr_pcur_close(&pcur);
+
+	mem_heap_free(row_heap);
+
+	if (v_heap) {
+		mem_heap_free(v_heap);
+	}
+
+	return(ok);
+}
+
+/** Read key ranges of the clustered index until all of them have been
+read, and write the index entries to sorted runs.
+@param[in,out]	scan	parallel scan
+@param[in]	report	whether to report the progress */
+static
+void
+row_merge_scan_ranges(
+	row_merge_scan_t*	scan,
+	bool			report)
+{
+	ut_allocator<row_merge_block_t>	alloc(mem_key_row_merge_sort);
+	ut_new_pfx_t		block_pfx;
+	ut_new_pfx_t		crypt_pfx;
+	row_merge_block_t*	block;
+	row_merge_block_t*	crypt_block = NULL;
+	row_merge_buf_t**	merge_buf;
+
+	block = alloc.allocate_large(srv_sort_buf_size, &block_pfx);
+
+	if (block == NULL) {
+		scan->set_error(DB_OUT_OF_MEMORY, 0);
+		return;
+	}
+
+	if (log_tmp_is_encrypted()) {
+		crypt_block = alloc.allocate_large(srv_sort_buf_size,
+						   &crypt_pfx);
+
+		if (crypt_block == NULL) {
+			alloc.deallocate_large(block, &block_pfx);
+			scan->set_error(DB_OUT_OF_MEMORY, 0);
+			return;
+		}
+	}
+
+	merge_buf = static_cast<row_merge_buf_t**>(
+		ut_malloc_nokey(scan->n_index * sizeof *merge_buf));
+
+	for (ulint i = 0; i < scan->n_index; i++) {
+		merge_buf[i] = row_merge_buf_create(scan->index[i]);
+	}
+
+	/* The sort buffers are kept across ranges, so that each
+	thread writes runs of full buffers. */
+	for (ulint r; !scan->failed
+	     && (r = scan->next_range++) < scan->n_ranges; ) {
+		if (!row_merge_scan_range(
+			    scan, r ? scan->bounds[r - 1] : NULL,
+			    r + 1 < scan->n_ranges ? scan->bounds[r] : NULL,
+			    merge_buf, block, crypt_block, report)) {
+			break;
+		}
+
+		if (report) {
+			/* The other threads keep reading their ranges. */
+			DEBUG_SYNC_C("row_merge_scan_range_done");
+		}
+	}
+
+	for (ulint i = 0; i < scan->n_index; i++) {
+		if (!scan->failed && merge_buf[i]->n_tuples) {
+			row_merge_scan_write(scan, i, merge_buf[i], block,
+					     crypt_block);
+		}
+
+		row_merge_buf_free(merge_buf[i]);
+	}
+
+	ut_free(merge_buf);
+
+	alloc.deallocate_large(block, &block_pfx);
+
+	if (crypt_block) {
+		alloc.deallocate_large(crypt_block, &crypt_pfx);
+	}
+}
+
+/** Entry point of the threads of a parallel clustered index scan.
+@param[in,out]	arg	parallel scan */
+static
+void
+row_merge_scan_task(
+	void*	arg)
+{
+	row_merge_scan_ranges(static_cast<row_merge_scan_t*>(arg), false);
+}
+
+/** Whether row_merge_read_clustered_index_parallel() can be used.
+@param[in]	old_table	table where rows are read from
+@param[in]	new_table	table where indexes are created
+@param[in]	index		indexes to be created
+@param[in]	n_index		size of index[]
+@param[in]	add_v		new virtual columns, or NULL
+@return whether the clustered index can be scanned by several threads */
+static
+bool
+row_merge_scan_is_parallel(
+	const dict_table_t*	old_table,
+	const dict_table_t*	new_table,
+	dict_index_t* const*	index,
+	ulint			n_index,
+	const dict_add_v_col_t*	add_v)
+{
+	if (srv_alter_parallel_threads <= 1 || old_table != new_table
+	    || add_v) {
+		return(false);
+	}
+
+	for (ulint i = 0; i < n_index; i++) {
+		if ((index[i]->type & (DICT_FTS | DICT_SPATIAL))
+		    || index[i]->has_virtual()) {
+			return(false);
+		}
+	}
+
+	return(true);
+}
+
+/** Read the clustered index of a table by several threads, each of
+which reads key ranges of the index and writes sorted runs of the index
+entries of all indexes, like row_merge_read_clustered_index() does for
+the whole table. Only secondary indexes without virtual columns can be
+created this way, see row_merge_scan_is_parallel().
+@param[in]	trx		transaction
+@param[in,out]	table		MySQL table object, for reporting erroneous
+				records
+@param[in]	old_table	table where rows are read from
+@param[in]	online		true if creating indexes online
+@param[in]	index		indexes to be created
+@param[in]	files		temporary files
+@param[in]	key_numbers	MySQL key numbers to create
+@param[in]	n_index		number of indexes to create
+@param[in,out]	tmpfd		temporary file handle
+@param[in,out]	stage		performance schema accounting object, used by
+ALTER TABLE. stage->n_pk_recs_inc() will be called for each record read and
+stage->inc() will be called for each page read.
+@param[in]	pct_cost	percent of task weight out of total alter job
+@param[out]	done		whether the index was read; false if it
+				consists of a single page and
+				row_merge_read_clustered_index() should be
+				used instead
+@return DB_SUCCESS or error */
+static MY_ATTRIBUTE((warn_unused_result))
+dberr_t
+row_merge_read_clustered_index_parallel(
+	trx_t*			trx,
+	struct TABLE*		table,
+	const dict_table_t*	old_table,
+	bool			online,
+	dict_index_t**		index,
+	merge_file_t*		files,
+	const ulint*		key_numbers,
+	ulint			n_index,
+	pfs_os_file_t*		tmpfd,
+	ut_stage_alter_t*	stage,
+	double			pct_cost,
+	bool*			done)
+{
+	dict_index_t*		clust_index = dict_table_get_first_index(
+		old_table);
+	mem_heap_t*		heap = mem_heap_create(1024);
+	tpool::waitable_task**	tasks;
+	row_merge_scan_t	scan;
+	ulint			n_threads = srv_alter_parallel_threads;
+
+	DBUG_ENTER("row_merge_read_clustered_index_parallel");
+
+	ut_ad(trx_state_eq(trx, TRX_STATE_ACTIVE));
+
+	/* Let each thread read several ranges, so that the threads
+	finish at about the same time even if the ranges differ in
+	size. */
+	scan.n_ranges = row_merge_scan_split(
+		clust_index, n_threads * 4, heap, &scan.bounds);
+
+	if (scan.n_ranges == 1) {
+		mem_heap_free(heap);
+		*done = false;
+		DBUG_RETURN(DB_SUCCESS);
+	}
+
+	*done = true;
+
+	/* Check if the table is supposed to be empty for our read view,
+	see row_merge_read_clustered_index(). */
+	if (!online) {
+	} else if (trx_id_t bulk_trx_id = old_table->bulk_trx_id) {
+		ut_ad(trx->read_view.is_open());
+		if (!trx->read_view.changes_visible(bulk_trx_id)) {
+			mem_heap_free(heap);
+			DBUG_RETURN(DB_SUCCESS);
+		}
+	}
+
+	n_threads = std::min(n_threads, scan.n_ranges);
+
+	scan.table_total_rows = dict_table_get_n_rows(old_table);
+	if (scan.table_total_rows == 0) {
+		/* We don't know total row count */
+		scan.table_total_rows = 1;
+	}
+
+	trx->op_info = "reading clustered index";
+
+	scan.trx = trx;
+	scan.table = table;
+	scan.old_table = old_table;
+	scan.online = online;
+	scan.index = index;
+	scan.key_numbers = key_numbers;
+	scan.n_index = n_index;
+	scan.path = thd_innodb_tmpdir(trx->mysql_thd);
+	scan.next_range = 0;
+	scan.n_recs = 0;
+	scan.n_pages = 0;
+	scan.failed = false;
+	scan.mutex.init();
+	scan.files = files;
+	scan.tmpfd = tmpfd;
+	scan.err = DB_SUCCESS;
+	scan.error_key_num = 0;
+	scan.stage = stage;
+	scan.pct_cost = pct_cost;
+	scan.read_rows = 0;
+
+	tasks = static_cast<tpool::waitable_task**>(
+		ut_malloc_nokey((n_threads - 1) * sizeof *tasks));
+
+	for (ulint i = 0; i < n_threads - 1; i++) {
+		tasks[i] = new tpool::waitable_task(row_merge_scan_task,
+						    &scan);
+		srv_thread_pool->submit_task(tasks[i]);
+	}
+
+	/* This thread reads ranges as well. The performance schema
+	stage is only updated by this thread. */
+	row_merge_scan_ranges(&scan, true);
+
+	for (ulint i = 0; i < n_threads - 1; i++) {
+		while (tasks[i]->is_running()) {
+			row_merge_scan_report(&scan);
+			os_thread_sleep(100000);
+		}
+
+		tasks[i]->wait();
+		delete tasks[i];
+	}
+
+	ut_free(tasks);
+
+	row_merge_scan_report(&scan);
+
+	if (scan.err != DB_SUCCESS) {
+		trx->error_key_num = scan.error_key_num;
+	} else if (online) {
+		for (ulint i = 0; i < n_index; i++) {
+			/* Note the newest transaction that modified
+			this index when the scan was completed, as in
+			row_merge_read_clustered_index(). */
+			index[i]->lock.x_lock(SRW_LOCK_CALL);
+			ut_a(dict_index_get_online_status(index[i])
+			     == ONLINE_INDEX_CREATION);
+
+			trx_id_t max_trx_id = row_log_get_max_trx(index[i]);
+
+			if (max_trx_id > index[i]->trx_id) {
+				index[i]->trx_id = max_trx_id;
+			}
+
+			index[i]->lock.x_unlock();
+		}
+	}
+
+	scan.mutex.destroy();
+	mem_heap_free(heap);
+
+	trx->op_info = "";
+
+	DBUG_RETURN(scan.err);
+}
+
+/** Write a record via buffer 2 and read the next record to buffer N.
+@param N number of the buffer (0 or 1)
+@param INDEX record descriptor
+@param AT_END statement to execute at end of input */
+#define ROW_MERGE_WRITE_GET_NEXT_LOW(N, INDEX, AT_END)			\
+	do {								\
+		b2 = row_merge_write_rec(&block[2 * srv_sort_buf_size], \
+					 &buf[2], b2,			\
+					 of->fd, &of->offset,		\
+					 mrec##N, offsets##N,		\
+			crypt_block ? &crypt_block[2 * srv_sort_buf_size] : NULL , \
+					space);				\
+		if (UNIV_UNLIKELY(!b2 || ++of->n_rec > file->n_rec)) {	\
+			goto corrupt;					\
+		}							\
+		b##N = row_merge_read_rec(&block[N * srv_sort_buf_size],\
+					  &buf[N], b##N, INDEX,		\
+					  file->fd, foffs##N,		\
+					  &mrec##N, offsets##N,		\
+			crypt_block ? &crypt_block[N * srv_sort_buf_size] : NULL, \
+					  space);			\
+									\
+		if (UNIV_UNLIKELY(!b##N)) {				\
+			if (mrec##N) {					\
+				goto corrupt;				\
+			}						\
+			AT_END;						\
+		}							\
+	} while (0)
+
+#ifdef HAVE_PSI_STAGE_INTERFACE
+#define ROW_MERGE_WRITE_GET_NEXT(N, INDEX, AT_END)			\
+	do {								\
+		if (stage != NULL) {					\
+			stage->inc();					\
+		}							\
+		ROW_MERGE_WRITE_GET_NEXT_LOW(N, INDEX, AT_END);		\
+	} while (0)
+#else /* HAVE_PSI_STAGE_INTERFACE */
+#define ROW_MERGE_WRITE_GET_NEXT(N, INDEX, AT_END)			\
+	ROW_MERGE_WRITE_GET_NEXT_LOW(N, INDEX, AT_END)
+#endif /* HAVE_PSI_STAGE_INTERFACE */
+
+/** Merge two blocks of records on disk and write a bigger block.
+@param[in]	dup	descriptor of index being created
+@param[in]	file	file containing index entries
+@param[in,out]	block	3 buffers
+@param[in,out]	foffs0	offset of first source list in the file
+@param[in,out]	foffs1	offset of second source list in the file
+@param[in,out]	of	output file
+@param[in,out]	stage	performance schema accounting object, used by
+ALTER TABLE. If not NULL stage->inc() will be called for each record
+processed.
+@param[in,out]	crypt_block	encryption buffer
+@param[in]	space	tablespace ID for encryption
+@return DB_SUCCESS or error code */
+static MY_ATTRIBUTE((warn_unused_result))
+dberr_t
+row_merge_blocks(
+	const row_merge_dup_t*	dup,
+	const merge_file_t*	file,
+	row_merge_block_t*	block,
+	ulint*			foffs0,
+	ulint*			foffs1,
+	merge_file_t*		of,
+	ut_stage_alter_t*	stage MY_ATTRIBUTE((unused)),
+	row_merge_block_t*	crypt_block,
+	ulint			space)
+{
+	mem_heap_t*	heap;	/*!< memory heap for offsets0, offsets1 */
+
+	mrec_buf_t*	buf;	/*!< buffer for handling
+				split mrec in block[] */
+	const byte*	b0;	/*!< pointer to block[0] */
+	const byte*	b1;	/*!< pointer to block[srv_sort_buf_size] */
+	byte*		b2;	/*!< pointer to block[2 * srv_sort_buf_size] */
+	const mrec_t*	mrec0;	/*!< merge rec, points to block[0] or buf[0] */
 	const mrec_t*	mrec1;	/*!< merge rec, points to
 				block[srv_sort_buf_size] or buf[1] */
 	rec_offs*	offsets0;/* offsets of mrec0 */
@@ -2978,9 +3590,12 @@ row_merge_blocks(
 	}
 
 	while (mrec0 && mrec1) {
-		int cmp = cmp_rec_rec_simple(
-			mrec0, mrec1, offsets0, offsets1,
-			dup->index, dup->table);
+		int cmp = dict_index_is_spatial(dup->index)
+			? row_merge_spatial_rec_cmp(
+				mrec0, mrec1, offsets0, offsets1, dup->index)
+			: cmp_rec_rec_simple(
+				mrec0, mrec1, offsets0, offsets1,
+				dup->index, dup->table);
 		if (cmp < 0) {
 			ROW_MERGE_WRITE_GET_NEXT(0, dup->index, goto merged);
 		} else if (cmp) {
@@ -3322,8 +3937,12 @@ row_merge_sort(
 	sol10-64 in buildbot.
 	*/
 #ifndef UNIV_SOLARIS
-	/* Progress report only for "normal" indexes. */
-	if (!(dup->index->type & DICT_FTS)) {
+	/* Progress report only for "normal" indexes, and not from the
+	tasks of row_merge_index_tasks_t. */
+	const bool	thd_progress = !(dup->index->type & DICT_FTS)
+		&& current_thd == trx->mysql_thd;
+
+	if (thd_progress) {
 		thd_progress_init(trx->mysql_thd, 1);
 	}
 #endif /* UNIV_SOLARIS */
@@ -3340,7 +3959,7 @@ row_merge_sort(
 		show processlist progress field */
 		/* Progress report only for "normal" indexes. */
 #ifndef UNIV_SOLARIS
-		if (!(dup->index->type & DICT_FTS)) {
+		if (thd_progress) {
 			thd_progress_report(trx->mysql_thd, file->offset - num_runs, file->offset);
 		}
 #endif /* UNIV_SOLARIS */
@@ -3370,7 +3989,7 @@ row_merge_sort(
 
 	/* Progress report only for "normal" indexes. */
 #ifndef UNIV_SOLARIS
-	if (!(dup->index->type & DICT_FTS)) {
+	if (thd_progress) {
 		thd_progress_end(trx->mysql_thd);
 	}
 #endif /* UNIV_SOLARIS */
@@ -3513,12 +4132,16 @@ row_merge_insert_index_tuples(
 
 	ut_ad(!srv_read_only_mode);
 	ut_ad(!(index->type & DICT_FTS));
-	ut_ad(!dict_index_is_spatial(index));
 
 	if (stage != NULL) {
 		stage->begin_phase_insert();
 	}
 
+	DBUG_EXECUTE_IF("row_merge_instrument_log_check_flush",
+			if (dict_index_is_spatial(index)) {
+				log_sys.set_check_flush_or_checkpoint();
+			});
+
 	tuple_heap = mem_heap_create(1000);
 
 	{
@@ -3630,6 +4253,11 @@ row_merge_insert_index_tuples(
 		ut_ad(dtuple_validate(dtuple));
 		error = btr_bulk->insert(dtuple);
 
+		DBUG_EXECUTE_IF("row_merge_ins_spatial_fail",
+				if (dict_index_is_spatial(index)) {
+					error = DB_FAIL;
+				});
+
 		if (error != DB_SUCCESS) {
 			goto err_exit;
 		}
@@ -4335,6 +4963,236 @@ row_merge_drop_table(
 			trx, SQLCOM_DROP_TABLE, false, false));
 }
 
+/** Merge sort and bulk load of non-unique secondary indexes in tpool
+tasks, while row_merge_build_indexes() builds the other indexes. Unique
+indexes are not built by the tasks, because duplicates are reported to
+the MySQL table object. */
+class row_merge_index_tasks_t
+{
+public:
+	/** Constructor.
+	@param[in]	trx		transaction
+	@param[in]	old_table	table where rows are read from
+	@param[in]	space_id	tablespace of the indexes
+	@param[in]	n_indexes	maximum number of indexes to build */
+	row_merge_index_tasks_t(trx_t* trx, const dict_table_t* old_table,
+				ulint space_id, ulint n_indexes)
+		: m_trx(trx), m_old_table(old_table), m_space_id(space_id),
+		  m_path(thd_innodb_tmpdir(trx->mysql_thd)),
+		  m_items(static_cast<item_t*>(
+				  ut_malloc_nokey(n_indexes * sizeof *m_items))),
+		  m_n_items(0), m_next(0), m_tasks(NULL), m_n_tasks(0) {}
+
+	/** Wait for the tasks without building the remaining indexes. */
+	~row_merge_index_tasks_t()
+	{
+		m_next = m_n_items;
+		join();
+		ut_free(m_items);
+	}
+
+	/** Add an index to be built by the tasks.
+	@param[in]	index		index
+	@param[in]	file		sorted runs of the index entries
+	@param[in]	pct_progress	total progress percent until the index
+	@param[in]	pct_sort	progress percent of the merge sort
+	@param[in]	pct_insert	progress percent of the bulk load */
+	void add(dict_index_t* index, merge_file_t* file,
+		 double pct_progress, double pct_sort, double pct_insert)
+	{
+		item_t&	item = m_items[m_n_items++];
+
+		item.index = index;
+		item.file = file;
+		item.pct_progress = pct_progress;
+		item.pct_sort = pct_sort;
+		item.pct_insert = pct_insert;
+		/* Until the index has been built */
+		item.err = DB_OUT_OF_MEMORY;
+	}
+
+	/** Start the tasks.
+	@param[in]	n_threads	maximum number of tasks */
+	void start(ulint n_threads)
+	{
+		m_n_tasks = std::min(n_threads, m_n_items);
+
+		if (!m_n_tasks) {
+			return;
+		}
+
+		m_tasks = static_cast<tpool::waitable_task**>(
+			ut_malloc_nokey(m_n_tasks * sizeof *m_tasks));
+
+		for (ulint i = 0; i < m_n_tasks; i++) {
+			m_tasks[i] = new tpool::waitable_task(task, this);
+			srv_thread_pool->submit_task(m_tasks[i]);
+		}
+	}
+
+	/** @return whether an index is built by the tasks
+	@param[in]	file	sorted runs of the index entries */
+	bool owns(const merge_file_t* file) const
+	{
+		return(find(file) != NULL);
+	}
+
+	/** Wait until an index has been built. The calling thread helps
+	building the remaining indexes.
+	@param[in]	file		sorted runs of the index entries
+	@param[out]	pct_progress	total progress percent after the index
+	@return DB_SUCCESS or error code */
+	dberr_t wait(const merge_file_t* file, double* pct_progress)
+	{
+		const item_t*	item = find(file);
+
+		build();
+		join();
+
+		*pct_progress = item->pct_progress + item->pct_sort
+			+ item->pct_insert;
+		return(item->err);
+	}
+
+private:
+	/** An index to be built */
+	struct item_t
+	{
+		/** the index */
+		dict_index_t*	index;
+		/** sorted runs of the index entries */
+		merge_file_t*	file;
+		/** total progress percent until the index */
+		double		pct_progress;
+		/** progress percent of the merge sort */
+		double		pct_sort;
+		/** progress percent of the bulk load */
+		double		pct_insert;
+		/** result of building the index */
+		dberr_t		err;
+	};
+
+	/** @return the item of an index, or NULL
+	@param[in]	file	sorted runs of the index entries */
+	const item_t* find(const merge_file_t* file) const
+	{
+		for (ulint i = 0; i < m_n_items; i++) {
+			if (m_items[i].file == file) {
+				return(&m_items[i]);
+			}
+		}
+
+		return(NULL);
+	}
+
+	/** Entry point of the tasks.
+	@param[in,out]	arg	row_merge_index_tasks_t */
+	static void task(void* arg)
+	{
+		static_cast<row_merge_index_tasks_t*>(arg)->build();
+	}
+
+	/** Wait for the tasks to finish. */
+	void join()
+	{
+		for (ulint i = 0; i < m_n_tasks; i++) {
+			m_tasks[i]->wait();
+			delete m_tasks[i];
+		}
+
+		ut_free(m_tasks);
+		m_tasks = NULL;
+		m_n_tasks = 0;
+	}
+
+	/** Build indexes until none are left. */
+	void build()
+	{
+		ut_allocator<row_merge_block_t>	alloc(
+			mem_key_row_merge_sort);
+		ut_new_pfx_t		block_pfx;
+		ut_new_pfx_t		crypt_pfx;
+		row_merge_block_t*	block;
+		row_merge_block_t*	crypt_block = NULL;
+		pfs_os_file_t		tmpfd = OS_FILE_CLOSED;
+		const size_t		block_size = 3 * srv_sort_buf_size;
+
+		block = alloc.allocate_large(block_size, &block_pfx);
+
+		if (block == NULL) {
+			return;
+		}
+
+		if (log_tmp_is_encrypted()) {
+			crypt_block = alloc.allocate_large(block_size,
+							   &crypt_pfx);
+
+			if (crypt_block == NULL) {
+				alloc.deallocate_large(block, &block_pfx);
+				return;
+			}
+		}
+
+		for (ulint i; (i = m_next++) < m_n_items; ) {
+			item_t&	item = m_items[i];
+
+			if (!row_merge_tmpfile_if_needed(&tmpfd, m_path)) {
+				continue;
+			}
+
+			row_merge_dup_t	dup = {item.index, NULL, NULL, 0};
+
+			dberr_t	err = row_merge_sort(
+				m_trx, &dup, item.file, block, &tmpfd, true,
+				item.pct_progress, item.pct_sort,
+				crypt_block, m_space_id);
+
+			if (err == DB_SUCCESS) {
+				BtrBulk	btr_bulk(item.index, m_trx);
+
+				err = row_merge_insert_index_tuples(
+					item.index, m_old_table,
+					item.file->fd, block, NULL,
+					&btr_bulk, item.file->n_rec,
+					item.pct_progress + item.pct_sort,
+					item.pct_insert, crypt_block,
+					m_space_id);
+
+				err = btr_bulk.finish(err);
+			}
+
+			item.err = err;
+		}
+
+		row_merge_file_destroy_low(tmpfd);
+
+		alloc.deallocate_large(block, &block_pfx);
+
+		if (crypt_block) {
+			alloc.deallocate_large(crypt_block, &crypt_pfx);
+		}
+	}
+
+	/** transaction */
+	trx_t* const			m_trx;
+	/** table where rows are read from */
+	const dict_table_t* const	m_old_table;
+	/** tablespace of the indexes */
+	const ulint			m_space_id;
+	/** location of the temporary files */
+	const char* const		m_path;
+	/** indexes to be built */
+	item_t* const			m_items;
+	/** number of m_items[] */
+	ulint				m_n_items;
+	/** next m_items[] to be built */
+	std::atomic<ulint>		m_next;
+	/** tasks that build m_items[] */
+	tpool::waitable_task**		m_tasks;
+	/** number of m_tasks[] */
+	ulint				m_n_tasks;
+};
+
 /** Build indexes on a table by reading a clustered index, creating a temporary
 file containing index entries, merge sorting these index entries and inserting
 sorted index entries to indexes.
@@ -4398,6 +5256,8 @@ row_merge_build_indexes(
 	fts_psort_t*		psort_info = NULL;
 	fts_psort_t*		merge_info = NULL;
 	bool			fts_psort_initiated = false;
+	row_merge_index_tasks_t*	index_tasks = NULL;
+	bool			scanned = false;
 
 	double total_static_cost = 0;
 	double total_dynamic_cost = 0;
@@ -4443,23 +5303,15 @@ row_merge_build_indexes(
 	}
 
 	trx_start_if_not_started_xa(trx, true);
-	ulint	n_merge_files = 0;
-
-	for (ulint i = 0; i < n_indexes; i++)
-	{
-		if (!dict_index_is_spatial(indexes[i])) {
-			n_merge_files++;
-		}
-	}
 
 	merge_files = static_cast<merge_file_t*>(
-		ut_malloc_nokey(n_merge_files * sizeof *merge_files));
+		ut_malloc_nokey(n_indexes * sizeof *merge_files));
 
 	/* Initialize all the merge file descriptors, so that we
 	don't call row_merge_file_destroy() on uninitialized
 	merge file descriptor */
 
-	for (i = 0; i < n_merge_files; i++) {
+	for (i = 0; i < n_indexes; i++) {
 		merge_files[i].fd = OS_FILE_CLOSED;
 		merge_files[i].offset = 0;
 		merge_files[i].n_rec = 0;
@@ -4527,12 +5379,22 @@ row_merge_build_indexes(
 
 	/* Read clustered index of the table and create files for
 	secondary index entries for merge sort */
-	error = row_merge_read_clustered_index(
-		trx, table, old_table, new_table, online, indexes,
-		fts_sort_idx, psort_info, merge_files, key_numbers,
-		n_indexes, defaults, add_v, col_map, add_autoinc,
-		sequence, block, skip_pk_sort, &tmpfd, stage,
-		pct_cost, crypt_block, eval_table, allow_not_null);
+	if (row_merge_scan_is_parallel(old_table, new_table, indexes,
+				       n_indexes, add_v)) {
+		error = row_merge_read_clustered_index_parallel(
+			trx, table, old_table, online, indexes, merge_files,
+			key_numbers, n_indexes, &tmpfd, stage, pct_cost,
+			&scanned);
+	}
+
+	if (!scanned) {
+		error = row_merge_read_clustered_index(
+			trx, table, old_table, new_table, online, indexes,
+			fts_sort_idx, psort_info, merge_files, key_numbers,
+			n_indexes, defaults, add_v, col_map, add_autoinc,
+			sequence, block, skip_pk_sort, &tmpfd, stage,
+			pct_cost, crypt_block, eval_table, allow_not_null);
+	}
 
 	stage->end_phase_read_pk();
 
@@ -4544,7 +5406,7 @@ row_merge_build_indexes(
 				      " and create temporary files");
 	}
 
-	for (i = 0; i < n_merge_files; i++) {
+	for (i = 0; i < n_indexes; i++) {
 		total_index_blocks += merge_files[i].offset;
 	}
 
@@ -4557,13 +5419,50 @@ row_merge_build_indexes(
 	/* Now we have files containing index entries ready for
 	sorting and inserting. */
 
-	for (ulint k = 0, i = 0; i < n_indexes; i++) {
-		dict_index_t*	sort_idx = indexes[i];
+	if (srv_alter_parallel_threads > 1) {
+		/* Let tasks merge-sort and load the non-unique
+		secondary indexes, while this thread builds the
+		others in the loop below. */
+		double	progress = pct_progress;
 
-		if (dict_index_is_spatial(sort_idx)) {
-			continue;
+		index_tasks = UT_NEW_NOKEY(
+			row_merge_index_tasks_t(trx, old_table,
+						new_table->space_id,
+						n_indexes));
+
+		for (ulint i = 0; i < n_indexes; i++) {
+			merge_file_t*	file = &merge_files[i];
+
+			if ((indexes[i]->type & DICT_FTS)
+			    || file->fd == OS_FILE_CLOSED) {
+				continue;
+			}
+
+			const double	cost = (COST_BUILD_INDEX_STATIC
+				+ (total_dynamic_cost
+				   * static_cast<double>(file->offset)
+				   / static_cast<double>(total_index_blocks)))
+				/ (total_static_cost + total_dynamic_cost)
+				* 100;
+			const double	pct_sort
+				= cost * PCT_COST_MERGESORT_INDEX;
+			const double	pct_insert
+				= cost * PCT_COST_INSERT_INDEX;
+
+			if (!dict_index_is_unique(indexes[i])) {
+				index_tasks->add(indexes[i], file, progress,
+						 pct_sort, pct_insert);
+			}
+
+			progress += pct_sort + pct_insert;
 		}
 
+		index_tasks->start(srv_alter_parallel_threads - 1);
+	}
+
+	for (ulint i = 0; i < n_indexes; i++) {
+		dict_index_t*	sort_idx = indexes[i];
+
 		if (indexes[i]->type & DICT_FTS) {
 
 			sort_idx = fts_sort_idx;
@@ -4585,14 +5484,18 @@ row_merge_build_indexes(
 #ifdef FTS_INTERNAL_DIAG_PRINT
 			DEBUG_FTS_SORT_PRINT("FTS_SORT: Complete Insert\n");
 #endif
-		} else if (merge_files[k].fd != OS_FILE_CLOSED) {
+		} else if (index_tasks
+			   && index_tasks->owns(&merge_files[i])) {
+			error = index_tasks->wait(&merge_files[i],
+						  &pct_progress);
+		} else if (merge_files[i].fd != OS_FILE_CLOSED) {
 			char	buf[NAME_LEN + 1];
 			row_merge_dup_t	dup = {
 				sort_idx, table, col_map, 0};
 
 			pct_cost = (COST_BUILD_INDEX_STATIC +
 				    (total_dynamic_cost
-				     * static_cast<double>(merge_files[k].offset)
+				     * static_cast<double>(merge_files[i].offset)
 				     / static_cast<double>(total_index_blocks)))
 				/ (total_static_cost + total_dynamic_cost)
 				* PCT_COST_MERGESORT_INDEX * 100;
@@ -4616,7 +5519,7 @@ row_merge_build_indexes(
 			}
 
 			error = row_merge_sort(
-					trx, &dup, &merge_files[k],
+					trx, &dup, &merge_files[i],
 					block, &tmpfd, true,
 					pct_progress, pct_cost,
 					crypt_block, new_table->space_id,
@@ -4643,7 +5546,7 @@ row_merge_build_indexes(
 				pct_cost = (COST_BUILD_INDEX_STATIC +
 					    (total_dynamic_cost
 					     * static_cast<double>(
-						     merge_files[k].offset)
+						     merge_files[i].offset)
 					     / static_cast<double>(
 						     total_index_blocks)))
 					/ (total_static_cost
@@ -4662,9 +5565,9 @@ row_merge_build_indexes(
 
 				error = row_merge_insert_index_tuples(
 					sort_idx, old_table,
-					merge_files[k].fd, block, NULL,
+					merge_files[i].fd, block, NULL,
 					&btr_bulk,
-					merge_files[k].n_rec, pct_progress, pct_cost,
+					merge_files[i].n_rec, pct_progress, pct_cost,
 					crypt_block, new_table->space_id,
 					stage);
 
@@ -4683,7 +5586,7 @@ row_merge_build_indexes(
 		}
 
 		/* Close the temporary file to free up space. */
-		row_merge_file_destroy(&merge_files[k++]);
+		row_merge_file_destroy(&merge_files[i]);
 
 		if (indexes[i]->type & DICT_FTS) {
 			row_fts_psort_info_destroy(psort_info, merge_info);
@@ -4735,9 +5638,12 @@ row_merge_build_indexes(
 		fts_psort_initiated = false;
 	}
 
+	/* Wait for the tasks before the merge files are freed. */
+	UT_DELETE(index_tasks);
+
 	row_merge_file_destroy_low(tmpfd);
 
-	for (i = 0; i < n_merge_files; i++) {
+	for (i = 0; i < n_indexes; i++) {
 		row_merge_file_destroy(&merge_files[i]);
 	}
 
@@ -4793,3 +5699,248 @@ row_merge_build_indexes(
 	DBUG_EXECUTE_IF("ib_index_crash_after_bulk_load", DBUG_SUICIDE(););
 	DBUG_RETURN(error);
 }
+
+row_merge_bulk_t::row_merge_bulk_t(dict_table_t *table,
+                                   struct TABLE *mysql_table)
+  : m_n_index(UT_LIST_GET_LEN(table->indexes)), m_tmpfd(OS_FILE_CLOSED),
+    m_table(mysql_table), m_autoinc(0), m_alloc(mem_key_row_merge_sort),
+    m_block(nullptr), m_crypt_block(nullptr)
+{
+  ut_ad(is_supported(*table));
+  m_merge_buf= static_cast<row_merge_buf_t**>(
+    ut_malloc_nokey(m_n_index * sizeof *m_merge_buf));
+  m_merge_files= static_cast<merge_file_t*>(
+    ut_malloc_nokey(m_n_index * sizeof *m_merge_files));
+  ulint i= 0;
+  for (dict_index_t *index= UT_LIST_GET_FIRST(table->indexes); index;
+       index= UT_LIST_GET_NEXT(indexes, index), i++)
+  {
+    m_merge_buf[i]= row_merge_buf_create(index);
+    m_merge_files[i].fd= OS_FILE_CLOSED;
+    m_merge_files[i].offset= 0;
+    m_merge_files[i].n_rec= 0;
+  }
+}
+
+row_merge_bulk_t::~row_merge_bulk_t()
+{
+  for (ulint i= 0; i < m_n_index; i++)
+  {
+    row_merge_buf_free(m_merge_buf[i]);
+    row_merge_file_destroy(&m_merge_files[i]);
+  }
+  row_merge_file_destroy_low(m_tmpfd);
+  ut_free(m_merge_buf);
+  ut_free(m_merge_files);
+  if (m_block)
+    m_alloc.deallocate_large(m_block, &m_block_pfx);
+  if (m_crypt_block)
+    m_alloc.deallocate_large(m_crypt_block, &m_crypt_pfx);
+}
+
+bool row_merge_bulk_t::is_supported(const dict_table_t &table)
+{
+  /* Foreign key checks, full-text and spatial indexes, virtual
+  columns and system versioning are only handled row by row. */
+  if (table.is_temporary() || table.versioned() || table.fts ||
+      !table.foreign_set.empty() || !table.referenced_set.empty() ||
+      dict_table_get_n_v_cols(&table))
+    return false;
+
+  for (const dict_index_t *index= UT_LIST_GET_FIRST(table.indexes); index;
+       index= UT_LIST_GET_NEXT(indexes, index))
+    if ((index->type & (DICT_FTS | DICT_SPATIAL)) || !index->is_committed() ||
+        index->online_status != ONLINE_INDEX_COMPLETE ||
+        index->is_corrupted())
+      return false;
+
+  return true;
+}
+
+bool row_merge_bulk_t::alloc_block()
+{
+  if (m_block)
+    return true;
+  m_block= m_alloc.allocate_large(3 * srv_sort_buf_size, &m_block_pfx);
+  if (!m_block)
+    return false;
+  if (log_tmp_is_encrypted())
+  {
+    m_crypt_block= m_alloc.allocate_large(3 * srv_sort_buf_size,
+                                          &m_crypt_pfx);
+    if (!m_crypt_block)
+      return false;
+  }
+  return true;
+}
+
+dberr_t row_merge_bulk_t::write_to_tmp_file(ulint i, trx_t *trx)
+{
+  row_merge_buf_t *buf= m_merge_buf[i];
+  merge_file_t *file= &m_merge_files[i];
+  dict_index_t *index= buf->index;
+
+  if (!alloc_block() ||
+      !row_merge_file_create_if_needed(file, &m_tmpfd, 0,
+                                       thd_innodb_tmpdir(trx->mysql_thd)))
+    return DB_OUT_OF_MEMORY;
+
+  if (dict_index_is_unique(index))
+  {
+    row_merge_dup_t dup= {index, m_table, nullptr, 0};
+    row_merge_buf_sort(buf, &dup);
+    if (dup.n_dup)
+    {
+      trx->error_info= index;
+      return DB_DUPLICATE_KEY;
+    }
+  }
+  else
+    row_merge_buf_sort(buf, nullptr);
+
+  row_merge_buf_write(buf, file, m_block);
+  if (!row_merge_write(file->fd, file->offset++, m_block, m_crypt_block,
+                       index->table->space_id))
+    return DB_TEMP_FILE_WRITE_FAIL;
+  MEM_UNDEFINED(&m_block[0], srv_sort_buf_size);
+
+  file->n_rec+= buf->n_tuples;
+  m_merge_buf[i]= row_merge_buf_empty(buf);
+  return DB_SUCCESS;
+}
+
+dberr_t row_merge_bulk_t::bulk_insert_buffered(const dtuple_t &entry,
+                                               const dict_index_t &index,
+                                               trx_t *trx)
+{
+  ulint i= 0;
+  for (; m_merge_buf[i]->index != &index; i++)
+    ut_ad(i + 1 < m_n_index);
+
+  ut_ad(dtuple_get_n_fields(&entry) == dict_index_get_n_fields(&index));
+  ut_ad(!dtuple_get_n_ext(&entry));
+
+  /* The size of the record in row_merge_block_t, including the
+  encoded length of extra_size; see row_merge_buf_encode(). */
+  ulint extra_size;
+  ulint size= rec_get_converted_size_temp(&index, entry.fields,
+                                          entry.n_fields, &extra_size);
+  size+= 1 + (extra_size + 1 >= 0x80);
+
+  /* A record must fit in an empty sort buffer and in the buffer of
+  row_merge_read_rec() for records that span two blocks. Rows with
+  long columns are inserted without buffering. */
+  if (size >= srv_sort_buf_size || size >= sizeof(mrec_buf_t))
+    return DB_TOO_BIG_RECORD;
+
+  row_merge_buf_t *buf= m_merge_buf[i];
+  if (buf->n_tuples >= buf->max_tuples ||
+      buf->total_size + size >= srv_sort_buf_size)
+  {
+    if (dberr_t err= write_to_tmp_file(i, trx))
+      return err;
+    buf= m_merge_buf[i];
+  }
+
+  if (index.is_primary())
+    if (unsigned ai= index.table->persistent_autoinc)
+    {
+      const dfield_t *dfield= dtuple_get_nth_field(&entry, ai - 1);
+      if (!dfield_is_null(dfield))
+      {
+        ib_uint64_t autoinc=
+          row_parse_int(static_cast<const byte*>(dfield->data), dfield->len,
+                        dfield->type.mtype,
+                        dfield->type.prtype & DATA_UNSIGNED);
+        if (autoinc > m_autoinc)
+          m_autoinc= autoinc;
+      }
+    }
+
+  mtuple_t *t= &buf->tuples[buf->n_tuples++];
+  t->fields= static_cast<dfield_t*>(
+    mem_heap_dup(buf->heap, entry.fields,
+                 entry.n_fields * sizeof *entry.fields));
+  for (ulint f= 0; f < entry.n_fields; f++)
+    dfield_dup(&t->fields[f], buf->heap);
+  buf->total_size+= size;
+  return DB_SUCCESS;
+}
+
+dberr_t row_merge_bulk_t::write_to_index(ulint i, trx_t *trx,
+                                         struct TABLE *mysql_table)
+{
+  row_merge_buf_t *buf= m_merge_buf[i];
+  merge_file_t *file= &m_merge_files[i];
+  dict_index_t *index= buf->index;
+  dict_table_t *table= index->table;
+  row_merge_dup_t dup= {index, mysql_table, nullptr, 0};
+  dberr_t err= DB_SUCCESS;
+  BtrBulk btr_bulk(index, trx);
+
+  if (file->fd == OS_FILE_CLOSED)
+  {
+    /* All entries fit in the sort buffer. */
+    row_merge_buf_sort(buf, dict_index_is_unique(index) ? &dup : nullptr);
+    if (dup.n_dup)
+      err= DB_DUPLICATE_KEY;
+    else
+      err= row_merge_insert_index_tuples(index, table, OS_FILE_CLOSED,
+                                         nullptr, buf, &btr_bulk, 0, 0, 0,
+                                         nullptr, table->space_id);
+  }
+  else
+  {
+    m_table= mysql_table;
+    if (buf->n_tuples)
+      err= write_to_tmp_file(i, trx);
+    if (err == DB_SUCCESS)
+      err= row_merge_sort(trx, &dup, file, m_block, &m_tmpfd, false, 0, 0,
+                          m_crypt_block, table->space_id);
+    if (err == DB_SUCCESS)
+      err= row_merge_insert_index_tuples(index, table, file->fd, m_block,
+                                         nullptr, &btr_bulk, 0, 0, 0,
+                                         m_crypt_block, table->space_id);
+  }
+
+  err= btr_bulk.finish(err);
+  if (err == DB_DUPLICATE_KEY)
+    trx->error_info= index;
+  return err;
+}
+
+dberr_t row_merge_bulk_t::write_to_table(trx_t *trx,
+                                         struct TABLE *mysql_table)
+{
+  dberr_t err= DB_SUCCESS;
+  for (ulint i= 0; i < m_n_index && err == DB_SUCCESS; i++)
+    err= write_to_index(i, trx, mysql_table);
+
+  if (err == DB_SUCCESS && m_autoinc)
+    btr_write_autoinc(m_merge_buf[0]->index, m_autoinc);
+  return err;
+}
+
+trx_mod_table_time_t::~trx_mod_table_time_t()
+{
+  UT_DELETE(bulk_store);
+}
+
+row_merge_bulk_t *trx_mod_table_time_t::start_bulk_buffer(
+  dict_table_t *table, struct TABLE *mysql_table)
+{
+  ut_ad(is_bulk_insert());
+  ut_ad(!bulk_store);
+  bulk_store= UT_NEW_NOKEY(row_merge_bulk_t(table, mysql_table));
+  return bulk_store;
+}
+
+dberr_t trx_mod_table_time_t::write_bulk(trx_t *trx,
+                                         struct TABLE *mysql_table)
+{
+  ut_ad(bulk_store);
+  dberr_t err= bulk_store->write_to_table(trx, mysql_table);
+  UT_DELETE(bulk_store);
+  bulk_store= nullptr;
+  return err;
+}
@@ -954,6 +954,10 @@ row_create_prebuilt(
 	prebuilt->fts_doc_id = 0;
 
 	prebuilt->mysql_row_len = mysql_row_len;
+	prebuilt->fetch_cache_size = ut_min(
+		ulint(MYSQL_FETCH_CACHE_MAX),
+		ut_max(ulint(MYSQL_FETCH_CACHE_SIZE),
+		       MYSQL_FETCH_CACHE_BYTES / (mysql_row_len + 1)));
 
 	prebuilt->fts_doc_id_in_read_set = 0;
 	prebuilt->blob_heap = NULL;
@@ -1009,7 +1013,7 @@ row_prebuilt_free(
 		byte*	base = prebuilt->fetch_cache[0] - 4;
 		byte*	ptr = base;
 
-		for (ulint i = 0; i < MYSQL_FETCH_CACHE_SIZE; i++) {
+		for (ulint i = 0; i < prebuilt->fetch_cache_size; i++) {
 			ulint	magic1 = mach_read_from_4(ptr);
 			ut_a(magic1 == ROW_PREBUILT_FETCH_MAGIC_N);
 			ptr += 4;
@@ -1357,6 +1361,8 @@ row_insert_for_mysql(
 
 	row_get_prebuilt_insert_row(prebuilt);
 	node = prebuilt->ins_node;
+	node->bulk_insert_table = prebuilt->bulk_insert_buffer
+		? prebuilt->m_mysql_table : NULL;
 
 	row_mysql_convert_row_to_innobase(node->row, prebuilt, mysql_rec,
 					  &blob_heap);
@@ -604,19 +604,21 @@ row_purge_skip_uncommitted_virtual_index(
 }
 
 /***********************************************************//**
-Purges a delete marking of a record.
-@retval true if the row was not found, or it was successfully removed
-@retval false the purge needs to be suspended because of
-running out of file space */
-static MY_ATTRIBUTE((nonnull, warn_unused_result))
-bool
+Purges a delete marking of a record. The purge is deferred until
+purge_node_t::apply_del_marks(), which processes the secondary index
+entries of all delete-marked records of the table in index order. */
+static MY_ATTRIBUTE((nonnull))
+void
 row_purge_del_mark(
 /*===============*/
 	purge_node_t*	node)	/*!< in/out: row purge node */
 {
-	mem_heap_t*	heap;
+	const ulint	rec = node->del_marks.size();
+	const purge_node_t::del_mark_t	del_mark = {
+		node->ref, node->roll_ptr, node->trx_id
+	};
 
-	heap = mem_heap_create(1024);
+	node->del_marks.push_back(del_mark);
 
 	while (node->index != NULL) {
 		/* skip corrupted secondary index */
@@ -629,19 +631,271 @@ row_purge_del_mark(
 		}
 
 		if (node->index->type != DICT_FTS) {
-			dtuple_t*	entry = row_build_index_entry_low(
-				node->row, NULL, node->index,
-				heap, ROW_BUILD_FOR_PURGE);
-			row_purge_remove_sec_if_poss(node, node->index, entry);
-			mem_heap_empty(heap);
+			/* The entry is allocated from node->heap, which
+			is only emptied by purge_node_t::end(). */
+			if (const dtuple_t* entry = row_build_index_entry_low(
+				    node->row, NULL, node->index,
+				    node->heap, ROW_BUILD_FOR_PURGE)) {
+				const purge_node_t::sec_entry_t	sec = {
+					node->index, entry, rec
+				};
+				node->sec_entries.push_back(sec);
+			}
 		}
 
 		node->index = dict_table_get_next_index(node->index);
 	}
+}
 
-	mem_heap_free(heap);
+/** Order the secondary index entries of deferred delete-marked records
+by index and key. */
+struct row_purge_sec_entry_less
+{
+	bool operator()(const purge_node_t::sec_entry_t& a,
+			const purge_node_t::sec_entry_t& b) const
+	{
+		if (a.index != b.index) {
+			return a.index->id < b.index->id;
+		}
+
+		if (!a.index->is_committed() || a.index->is_spatial()) {
+			/* These are purged one by one in undo log order */
+			return false;
+		}
+
+		const ulint n = std::min(dtuple_get_n_fields(a.entry),
+					 dtuple_get_n_fields(b.entry));
+
+		for (ulint i = 0; i < n; i++) {
+			if (int cmp = cmp_dfield_dfield(
+				    dtuple_get_nth_field(a.entry, i),
+				    dtuple_get_nth_field(b.entry, i))) {
+				return cmp < 0;
+			}
+		}
+
+		return false;
+	}
+};
+
+/** Determine if a secondary index entry belongs between the first and the
+last user record of a leaf page.
+@param[in]	block	leaf page
+@param[in]	index	secondary index
+@param[in]	entry	secondary index entry
+@param[in,out]	offsets	offsets of the records
+@param[in,out]	heap	memory heap for offsets
+@return whether the entry would be located on the page */
+static
+bool
+row_purge_sec_on_page(
+	const buf_block_t*	block,
+	const dict_index_t*	index,
+	const dtuple_t*		entry,
+	rec_offs*&		offsets,
+	mem_heap_t*&		heap)
+{
+	const page_t*	page = block->frame;
+
+	if (!page_get_n_recs(page)) {
+		return false;
+	}
+
+	const rec_t*	rec = page_rec_get_next_const(
+		page_get_infimum_rec(page));
+	offsets = rec_get_offsets(rec, index, offsets, true,
+				  ULINT_UNDEFINED, &heap);
+
+	if (cmp_dtuple_rec(entry, rec, offsets) < 0) {
+		return false;
+	}
 
-	return(row_purge_remove_clust_if_poss(node));
+	rec = page_rec_get_prev_const(page_get_supremum_rec(page));
+	offsets = rec_get_offsets(rec, index, offsets, true,
+				  ULINT_UNDEFINED, &heap);
+
+	return cmp_dtuple_rec(entry, rec, offsets) <= 0;
+}
+
+typedef std::vector<purge_node_t::sec_entry_t>::const_iterator
+	row_purge_sec_iter;
+
+/** Remove secondary index entries of deferred delete-marked records,
+starting from the given entry, for as long as the next entry is located on
+the same leaf page. All those entries are removed under one page latch.
+@param[in,out]	node	purge node
+@param[in]	it	first entry to remove
+@param[in]	end	end of the sorted entries
+@return the first entry that was not processed */
+static
+row_purge_sec_iter
+row_purge_remove_sec_batch(
+	purge_node_t*		node,
+	row_purge_sec_iter	it,
+	row_purge_sec_iter	end)
+{
+	dict_index_t*	index = it->index;
+
+	node->set_del_mark(node->del_marks[it->rec]);
+
+	if (!index->is_committed() || index->is_spatial()) {
+		row_purge_remove_sec_if_poss(node, index, it->entry);
+		return ++it;
+	}
+
+	mtr_t		mtr;
+	btr_pcur_t	pcur;
+	bool		found;
+
+	log_free_check();
+	mtr.start();
+	index->set_modified(mtr);
+
+	/* Set the purge node for the call to row_purge_poss_sec(),
+	and the query thread for ibuf_insert_low(). */
+	pcur.btr_cur.purge_node = node;
+	pcur.btr_cur.thr = static_cast<que_thr_t*>(que_node_get_parent(node));
+
+	switch (row_search_index_entry(index, it->entry,
+				       dict_index_has_virtual(index)
+				       ? BTR_MODIFY_LEAF : BTR_PURGE_LEAF,
+				       &pcur, &mtr)) {
+	case ROW_FOUND:
+		found = true;
+		break;
+	case ROW_NOT_FOUND:
+		found = false;
+		break;
+	default:
+		/* The deletion was buffered, or the entry is still
+		needed. No page was latched. */
+		btr_pcur_close(&pcur);
+		mtr.commit();
+		return ++it;
+	}
+
+	const buf_block_t*	block = btr_pcur_get_block(&pcur);
+	mem_heap_t*		heap = NULL;
+	rec_offs		offsets_[REC_OFFS_NORMAL_SIZE];
+	rec_offs*		offsets = offsets_;
+	bool			tree = false;
+	ulint			n_same_page = 0;
+
+	rec_offs_init(offsets_);
+
+	for (;;) {
+		if (found && row_purge_poss_sec(node, index, it->entry,
+						&pcur, &mtr, false)) {
+			btr_cur_t*	btr_cur = btr_pcur_get_btr_cur(&pcur);
+
+			if (!rec_get_deleted_flag(
+				    btr_cur_get_rec(btr_cur),
+				    dict_table_is_comp(index->table))) {
+				ib::error()
+					<< "tried to purge non-delete-marked"
+					" record in index " << index->name
+					<< " of table " << index->table->name
+					<< ": tuple: " << *it->entry
+					<< ", record: "
+					<< rec_index_print(
+						btr_cur_get_rec(btr_cur),
+						index);
+				ut_ad(0);
+			} else if (!btr_cur_optimistic_delete(
+					   btr_cur, 0, &mtr)) {
+				tree = true;
+				break;
+			}
+		}
+
+		if (++it == end || it->index != index) {
+			break;
+		}
+
+		node->set_del_mark(node->del_marks[it->rec]);
+
+		if (!row_purge_sec_on_page(block, index, it->entry,
+					   offsets, heap)) {
+			break;
+		}
+
+		ulint	up_match = 0, low_match = 0;
+
+		page_cur_search_with_match(block, index, it->entry,
+					   PAGE_CUR_LE, &up_match, &low_match,
+					   btr_pcur_get_page_cur(&pcur), NULL);
+		found = low_match == dtuple_get_n_fields(it->entry);
+		n_same_page++;
+	}
+
+	btr_pcur_close(&pcur);
+	mtr.commit();
+
+	if (heap) {
+		mem_heap_free(heap);
+	}
+
+	MONITOR_INC_VALUE(MONITOR_PURGE_SEC_SAME_PAGE, n_same_page);
+
+	if (tree) {
+		/* The page would underflow; modify the index tree. */
+		row_purge_remove_sec_if_poss(node, index, it->entry);
+		++it;
+	}
+
+	return it;
+}
+
+/** Purge the deferred delete-marked records of the table. The secondary
+index entries are removed in index order, so that the entries that are on
+the same leaf page are removed under a single page latch. After that, the
+clustered index records are removed. */
+void purge_node_t::apply_del_marks()
+{
+	if (del_marks.empty()) {
+		ut_ad(sec_entries.empty());
+		return;
+	}
+
+	ut_ad(table);
+
+	/* set_del_mark() overwrites the state of the undo log record
+	that is being parsed when the table is closed. */
+	const dtuple_t*	const	cur_ref = ref;
+	const roll_ptr_t	cur_roll_ptr = roll_ptr;
+	const trx_id_t		cur_trx_id = trx_id;
+
+	std::stable_sort(sec_entries.begin(), sec_entries.end(),
+			 row_purge_sec_entry_less());
+	MONITOR_INC_VALUE(MONITOR_PURGE_SEC_SORTED, sec_entries.size());
+
+	for (row_purge_sec_iter it = sec_entries.begin();
+	     it != sec_entries.end(); ) {
+		it = row_purge_remove_sec_batch(this, it, sec_entries.end());
+	}
+
+	for (const del_mark_t& rec : del_marks) {
+		set_del_mark(rec);
+
+		/* Retry the purge in a second if we are running out of
+		file space. */
+		while (!row_purge_remove_clust_if_poss(this)
+		       && srv_shutdown_state <= SRV_SHUTDOWN_INITIATED) {
+			os_thread_sleep(1000000);
+		}
+	}
+
+	if (found_clust) {
+		btr_pcur_close(&pcur);
+		found_clust = FALSE;
+	}
+
+	del_marks.clear();
+	sec_entries.clear();
+
+	ref = cur_ref;
+	roll_ptr = cur_roll_ptr;
+	trx_id = cur_trx_id;
 }
 
 /** Reset DB_TRX_ID, DB_ROLL_PTR of a clustered index record
@@ -1046,15 +1300,13 @@ row_purge_record_func(
 	case TRX_UNDO_EMPTY:
 		break;
 	case TRX_UNDO_DEL_MARK_REC:
-		purged = row_purge_del_mark(node);
-		if (purged) {
-			if (node->table->stat_initialized
-			    && srv_stats_include_delete_marked) {
-				dict_stats_update_if_needed(
-					node->table, *thr->graph->trx);
-			}
-			MONITOR_INC(MONITOR_N_DEL_ROW_PURGE);
+		row_purge_del_mark(node);
+		if (node->table->stat_initialized
+		    && srv_stats_include_delete_marked) {
+			dict_stats_update_if_needed(
+				node->table, *thr->graph->trx);
 		}
+		MONITOR_INC(MONITOR_N_DEL_ROW_PURGE);
 		break;
 	case TRX_UNDO_INSERT_METADATA:
 	case TRX_UNDO_INSERT_REC:
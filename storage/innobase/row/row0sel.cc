@@ -3765,6 +3765,36 @@ row_sel_dequeue_cached_row_for_mysql(
 	}
 }
 
+/** Pop rows of a forward scan from the prefetch cache, without
+restoring the cursor.
+@param[out]	buf		buffer for max_rows rows in MySQL format
+@param[in]	stride		distance between the rows in buf
+@param[in]	max_rows	maximum number of rows to copy
+@param[in,out]	prebuilt	prebuilt struct for the table handler
+@return number of rows copied to buf */
+ulint
+row_sel_dequeue_cached_rows(
+	byte*		buf,
+	ulint		stride,
+	ulint		max_rows,
+	row_prebuilt_t*	prebuilt)
+{
+	ulint	n_rows = 0;
+
+	if (prebuilt->fetch_direction != ROW_SEL_NEXT) {
+		return(0);
+	}
+
+	while (n_rows < max_rows && prebuilt->n_fetch_cached > 0) {
+		row_sel_dequeue_cached_row_for_mysql(buf, prebuilt);
+		prebuilt->n_rows_fetched++;
+		buf += stride;
+		n_rows++;
+	}
+
+	return(n_rows);
+}
+
 /********************************************************************//**
 Initialise the prefetch cache. */
 UNIV_INLINE
@@ -3778,10 +3808,10 @@ row_sel_prefetch_cache_init(
 	byte*	ptr;
 
 	/* Reserve space for the magic number. */
-	sz = UT_ARR_SIZE(prebuilt->fetch_cache) * (prebuilt->mysql_row_len + 8);
+	sz = prebuilt->fetch_cache_size * (prebuilt->mysql_row_len + 8);
 	ptr = static_cast<byte*>(ut_malloc_nokey(sz));
 
-	for (i = 0; i < UT_ARR_SIZE(prebuilt->fetch_cache); i++) {
+	for (i = 0; i < prebuilt->fetch_cache_size; i++) {
 
 		/* A user has reported memory corruption in these
 		buffers in Linux. Put magic numbers there to help
@@ -3808,7 +3838,7 @@ row_sel_fetch_last_buf(
 	row_prebuilt_t*	prebuilt)	/*!< in/out: prebuilt struct */
 {
 	ut_ad(!prebuilt->templ_contains_blob);
-	ut_ad(prebuilt->n_fetch_cached < MYSQL_FETCH_CACHE_SIZE);
+	ut_ad(prebuilt->n_fetch_cached < prebuilt->fetch_cache_size);
 
 	if (prebuilt->fetch_cache[0] == NULL) {
 		/* Allocate memory for the fetch cache */
@@ -4300,6 +4330,14 @@ row_search_mvcc(
 		DBUG_RETURN(DB_CORRUPTION);
 	}
 
+	if (UNIV_UNLIKELY(direction == 0 && trx->bulk_insert_pending)) {
+		/* Make the rows of a buffered bulk insert visible. */
+		dberr_t err = trx->bulk_insert_apply(*prebuilt->table, NULL);
+		if (err != DB_SUCCESS) {
+			DBUG_RETURN(err);
+		}
+	}
+
 	/* We need to get the virtual column values stored in secondary
 	index key, if this is covered index scan or virtual key read is
 	requested. */
@@ -4356,7 +4394,8 @@ row_search_mvcc(
 		}
 
 		if (prebuilt->fetch_cache_first > 0
-		    && prebuilt->fetch_cache_first < MYSQL_FETCH_CACHE_SIZE) {
+		    && prebuilt->fetch_cache_first
+		    < prebuilt->fetch_cache_size) {
 early_not_found:
 			/* The previous returned row was popped from the fetch
 			cache, but the cache was not full at the time of the
@@ -5480,7 +5519,7 @@ row_search_mvcc(
 		not cache rows because there the cursor is a scrollable
 		cursor. */
 
-		ut_a(prebuilt->n_fetch_cached < MYSQL_FETCH_CACHE_SIZE);
+		ut_a(prebuilt->n_fetch_cached < prebuilt->fetch_cache_size);
 
 		/* We only convert from InnoDB row format to MySQL row
 		format when ICP is disabled. */
@@ -5532,7 +5571,7 @@ row_search_mvcc(
 			row_sel_enqueue_cache_row_for_mysql(buf, prebuilt);
 		}
 
-		if (prebuilt->n_fetch_cached < MYSQL_FETCH_CACHE_SIZE) {
+		if (prebuilt->n_fetch_cached < prebuilt->fetch_cache_size) {
 			goto next_rec;
 		}
 
@@ -41,6 +41,8 @@ Created 2/6/1997 Heikki Tuuri
 #include "rem0cmp.h"
 #include "lock0lock.h"
 #include "row0mysql.h"
+#include "srw_lock.h"
+#include "srv0srv.h"
 
 /** Check whether all non-virtual index fields are equal.
 @param[in]	index	the secondary index
@@ -1085,6 +1087,309 @@ row_vers_old_has_index_entry(
 	}
 }
 
+/** An old version of a clustered index record that was reconstructed
+from the undo log, together with the versions that precede it */
+struct row_vers_cache_entry_t
+{
+  /** dict_index_t::id */
+  index_id_t index_id;
+  /** DB_TRX_ID of the newest version of the record */
+  trx_id_t head_trx_id;
+  /** DB_ROLL_PTR of the newest version of the record */
+  roll_ptr_t head_roll_ptr;
+  /** dict_index_t::n_fields when the version was built */
+  unsigned n_fields;
+  /** dict_index_t::n_core_fields when the version was built */
+  unsigned n_core_fields;
+  /** number of elements in newer() */
+  uint32_t n_newer;
+  /** DB_TRX_ID of the version */
+  trx_id_t trx_id;
+  /** rec_offs_extra_size() of the version */
+  uint32_t extra_size;
+  /** rec_offs_size() of the version, or 0 if the record did not exist */
+  uint32_t size;
+
+  /** @return DB_TRX_ID of the versions that are newer than this one */
+  trx_id_t *newer() { return reinterpret_cast<trx_id_t*>(this + 1); }
+  /** @return copy of the version, starting with the extra bytes */
+  byte *rec() { return reinterpret_cast<byte*>(newer() + n_newer); }
+  /** @return number of bytes allocated for an entry */
+  static size_t alloc_size(ulint n_newer, ulint size)
+  { return sizeof(row_vers_cache_entry_t) + n_newer * sizeof(trx_id_t) + size; }
+  /** @return number of bytes allocated for this entry */
+  size_t alloc_size() const { return alloc_size(n_newer, size); }
+
+  /** @return whether this was built from the given newest version */
+  bool is_for(const dict_index_t &index, trx_id_t trx, roll_ptr_t roll) const
+  {
+    return head_roll_ptr == roll && head_trx_id == trx &&
+      index_id == index.id && n_fields == index.n_fields &&
+      n_core_fields == index.n_core_fields;
+  }
+
+  /** Determine whether a consistent read would construct this version.
+  That is the case when the read view sees the changes of trx_id but
+  none of the newer changes. Purge cannot have discarded any of the undo
+  log records that were used, because the view does not see them.
+  @param view  consistent read view
+  @param name  table name, for changes_visible()
+  @return whether the view sees this version */
+  bool visible_in(const ReadView &view, const table_name_t &name)
+  {
+    if (size && !view.changes_visible(trx_id, name))
+      return false;
+    const trx_id_t *ids= newer();
+    for (uint32_t i= 0; i < n_newer; i++)
+      if (view.changes_visible(ids[i], name))
+        return false;
+    return true;
+  }
+};
+
+/** A bounded cache of old versions of clustered index records
+(innodb_version_cache_size). The versions are shared by all read views
+for which row_vers_build_for_consistent_read() would build the same
+version. Entries are direct-mapped on the newest version of the record,
+so that a hot record only occupies one slot. */
+class row_vers_cache_t
+{
+  /** number of independently latched parts of the cache */
+  static constexpr ulint N_SHARDS= 64;
+  /** number of entries in each shard */
+  static constexpr ulint N_SLOTS= 1024;
+
+  /** A part of the cache */
+  struct shard_t
+  {
+    /** protects slots[] */
+    srw_lock_low latch;
+    /** the cached versions */
+    row_vers_cache_entry_t *slots[N_SLOTS];
+  };
+
+  /** the shards; NULL if the cache was not created */
+  shard_t *m_shards;
+  /** number of bytes allocated for entries */
+  Atomic_counter<size_t> m_used;
+
+  /** Look up the slot of a record version.
+  @param index  clustered index
+  @param roll   DB_ROLL_PTR of the newest version
+  @param shard  the shard of the slot
+  @return the slot */
+  row_vers_cache_entry_t **slot(const dict_index_t &index, roll_ptr_t roll,
+                                shard_t *&shard) const
+  {
+    const ulint fold= ut_fold_ulint_pair(ulint(index.id), ut_fold_ull(roll));
+    shard= &m_shards[fold % N_SHARDS];
+    return &shard->slots[(fold / N_SHARDS) % N_SLOTS];
+  }
+
+public:
+  /** Create the cache */
+  void create()
+  {
+    m_shards= static_cast<shard_t*>(
+      ut_zalloc_nokey(N_SHARDS * sizeof *m_shards));
+    for (ulint i= 0; i < N_SHARDS; i++)
+      m_shards[i].latch.init();
+  }
+
+  /** Free the cache */
+  void close()
+  {
+    if (!m_shards)
+      return;
+    clear();
+    for (ulint i= 0; i < N_SHARDS; i++)
+      m_shards[i].latch.destroy();
+    ut_free(m_shards);
+    m_shards= nullptr;
+  }
+
+  /** Discard all entries */
+  void clear()
+  {
+    if (!m_shards)
+      return;
+    for (ulint i= 0; i < N_SHARDS; i++)
+    {
+      shard_t &shard= m_shards[i];
+      shard.latch.wr_lock();
+      for (ulint j= 0; j < N_SLOTS; j++)
+      {
+        if (row_vers_cache_entry_t *e= shard.slots[j])
+        {
+          m_used-= e->alloc_size();
+          ut_free(e);
+          shard.slots[j]= nullptr;
+        }
+      }
+      shard.latch.wr_unlock();
+    }
+  }
+
+  /** @return whether the cache is to be used */
+  bool enabled() const { return m_shards && srv_version_cache_size; }
+
+  /** @return number of bytes allocated for entries */
+  size_t used() const { return m_used; }
+
+  /** Look up the version of a record that a read view should see.
+  @param index     clustered index
+  @param trx_id    DB_TRX_ID of the newest version
+  @param roll_ptr  DB_ROLL_PTR of the newest version
+  @param view      consistent read view
+  @param heap      memory heap for *old_vers
+  @param old_vers  copy of the version, or NULL if the record did not exist
+  @return whether the version was found */
+  bool lookup(const dict_index_t &index, trx_id_t trx_id,
+              roll_ptr_t roll_ptr, const ReadView &view, mem_heap_t *heap,
+              rec_t **old_vers) const
+  {
+    shard_t *shard;
+    row_vers_cache_entry_t **s= slot(index, roll_ptr, shard);
+    shard->latch.rd_lock();
+    row_vers_cache_entry_t *e= *s;
+    const bool found= e && e->is_for(index, trx_id, roll_ptr) &&
+      e->visible_in(view, index.table->name);
+    if (found)
+    {
+      *old_vers= nullptr;
+      if (e->size)
+      {
+        byte *buf= static_cast<byte*>(mem_heap_alloc(heap, e->size));
+        memcpy(buf, e->rec(), e->size);
+        *old_vers= buf + e->extra_size;
+      }
+    }
+    shard->latch.rd_unlock();
+    return found;
+  }
+
+  /** Add a version of a record, replacing any version in the same slot.
+The replaced version is evicted before the new one is accounted for,
+so that used() never exceeds innodb_version_cache_size.
+  @param index     clustered index
+  @param trx_id    DB_TRX_ID of the newest version
+  @param roll_ptr  DB_ROLL_PTR of the newest version
+  @param newer     DB_TRX_ID of the versions that are newer than rec
+  @param n_newer   number of elements in newer
+  @param rec       the version, or NULL if the record did not exist
+  @param offsets   rec_get_offsets(rec, index) */
+  void insert(const dict_index_t &index, trx_id_t trx_id,
+              roll_ptr_t roll_ptr, const trx_id_t *newer, ulint n_newer,
+              const rec_t *rec, const rec_offs *offsets)
+  {
+    const ulint size= rec ? rec_offs_size(offsets) : 0;
+    const size_t alloc_size= row_vers_cache_entry_t::alloc_size(n_newer,
+                                                                size);
+    const size_t limit= srv_version_cache_size;
+    if (alloc_size > limit / 16)
+      return;
+
+    row_vers_cache_entry_t *e= static_cast<row_vers_cache_entry_t*>(
+      ut_malloc_nokey(alloc_size));
+    if (!e)
+      return;
+    e->index_id= index.id;
+    e->head_trx_id= trx_id;
+    e->head_roll_ptr= roll_ptr;
+    e->n_fields= index.n_fields;
+    e->n_core_fields= index.n_core_fields;
+    e->n_newer= uint32_t(n_newer);
+    e->size= uint32_t(size);
+    memcpy(e->newer(), newer, n_newer * sizeof *newer);
+    if (rec)
+    {
+      e->extra_size= uint32_t(rec_offs_extra_size(offsets));
+      e->trx_id= row_get_rec_trx_id(rec, &index, offsets);
+      memcpy(e->rec(), rec - e->extra_size, size);
+    }
+    else
+    {
+      e->extra_size= 0;
+      e->trx_id= 0;
+    }
+
+    shard_t *shard;
+    row_vers_cache_entry_t **s= slot(index, roll_ptr, shard);
+    shard->latch.wr_lock();
+    row_vers_cache_entry_t *old= *s;
+    if (old)
+      m_used-= old->alloc_size();
+    /* Concurrent inserts into other shards may have filled the cache. */
+    if ((m_used+= alloc_size) > limit)
+    {
+      m_used-= alloc_size;
+      *s= nullptr;
+      shard->latch.wr_unlock();
+      ut_free(old);
+      ut_free(e);
+      return;
+    }
+    *s= e;
+    shard->latch.wr_unlock();
+    ut_free(old);
+  }
+};
+
+/** The cache of old record versions */
+static row_vers_cache_t row_vers_cache;
+
+/** Create the cache of reconstructed old record versions. */
+void row_vers_cache_create() { row_vers_cache.create(); }
+
+/** Free the cache of reconstructed old record versions. */
+void row_vers_cache_close() { row_vers_cache.close(); }
+
+/** Discard the cached record versions if they exceed
+innodb_version_cache_size. */
+void row_vers_cache_resize()
+{
+  if (row_vers_cache.used() > srv_version_cache_size)
+    row_vers_cache.clear();
+}
+
+/** DB_TRX_ID of the versions of a record that are newer than the version
+that a consistent read sees, for row_vers_cache_t::insert(). Long histories
+are kept in the heap of the caller, which is emptied for each record. */
+class row_vers_newer_t
+{
+  /** the identifiers of a short history */
+  trx_id_t m_buf[16];
+  /** the identifiers: m_buf, or memory allocated from m_heap */
+  trx_id_t *m_ids= m_buf;
+  /** number of elements in m_ids */
+  ulint m_n= 0;
+  /** capacity of m_ids */
+  ulint m_size= array_elements(m_buf);
+  /** heap for growing m_ids */
+  mem_heap_t *const m_heap;
+public:
+  explicit row_vers_newer_t(mem_heap_t *heap) : m_heap(heap) {}
+
+  /** Append an identifier */
+  void push_back(trx_id_t id)
+  {
+    if (m_n == m_size)
+    {
+      trx_id_t *ids= static_cast<trx_id_t*>(
+        mem_heap_alloc(m_heap, 2 * m_size * sizeof *ids));
+      memcpy(ids, m_ids, m_n * sizeof *ids);
+      m_ids= ids;
+      m_size*= 2;
+    }
+    m_ids[m_n++]= id;
+  }
+
+  trx_id_t front() const { ut_ad(m_n); return m_ids[0]; }
+  trx_id_t back() const { ut_ad(m_n); return m_ids[m_n - 1]; }
+  const trx_id_t *data() const { return m_ids; }
+  ulint size() const { return m_n; }
+};
+
 /*****************************************************************//**
 Constructs the version of a clustered index record which a consistent
 read should see. We assume that the trx id stored in rec is such that
@@ -1135,6 +1440,33 @@ row_vers_build_for_consistent_read(
 
 	version = rec;
 
+	/* A version that was built for another read view can be reused
+	if this view sees the same changes. Virtual columns are not cached. */
+	const bool	use_cache = !vrow && row_vers_cache.enabled();
+	roll_ptr_t	roll_ptr = 0;
+	row_vers_newer_t newer(in_heap);
+	ulint		n_steps = 0;
+
+	if (use_cache) {
+		roll_ptr = row_get_rec_roll_ptr(rec, index, *offsets);
+
+		if (row_vers_cache.lookup(*index, trx_id, roll_ptr, *view,
+					  in_heap, old_vers)) {
+			srv_stats.n_version_cache_hits.inc();
+
+			if (*old_vers) {
+				*offsets = rec_get_offsets(
+					*old_vers, index, *offsets,
+					true, ULINT_UNDEFINED, offset_heap);
+			}
+
+			return(DB_SUCCESS);
+		}
+
+		srv_stats.n_version_cache_misses.inc();
+		newer.push_back(trx_id);
+	}
+
 	for (;;) {
 		mem_heap_t*	prev_heap = heap;
 
@@ -1152,6 +1484,7 @@ row_vers_build_for_consistent_read(
 			&prev_version, NULL, vrow, 0);
 
 		err  = (purge_sees) ? DB_SUCCESS : DB_MISSING_HISTORY;
+		n_steps++;
 
 		if (prev_heap != NULL) {
 			mem_heap_free(prev_heap);
@@ -1193,9 +1526,21 @@ row_vers_build_for_consistent_read(
 			break;
 		}
 
+		if (use_cache && newer.back() != trx_id) {
+			newer.push_back(trx_id);
+		}
+
 		version = prev_version;
 	}
 
+	/* Only cache versions that took more than one undo log record
+	to build. */
+	if (use_cache && err == DB_SUCCESS && n_steps > 1) {
+		row_vers_cache.insert(*index, newer.front(), roll_ptr,
+				      newer.data(), newer.size(),
+				      *old_vers, *offsets);
+	}
+
 	mem_heap_free(heap);
 
 	return(err);
@@ -807,6 +807,28 @@ static monitor_info_t	innodb_counter_info[] =
 	 MONITOR_DISPLAY_CURRENT,
 	 MONITOR_DEFAULT_START, MONITOR_PURGE_RESUME_COUNT},
 
+	{"purge_undo_records", "purge",
+	 "Number of undo log records handled by the purge",
+	 MONITOR_NONE,
+	 MONITOR_DEFAULT_START, MONITOR_PURGE_N_UNDO_REC},
+
+	{"purge_history_len_change", "purge",
+	 "Change of the history list length during the last purge batch",
+	 MONITOR_DISPLAY_CURRENT,
+	 MONITOR_DEFAULT_START, MONITOR_PURGE_HISTORY_CHANGE},
+
+	{"purge_sec_rec_sorted", "purge",
+	 "Number of secondary index records of delete-marked rows"
+	 " that the purge sorted in index order",
+	 MONITOR_NONE,
+	 MONITOR_DEFAULT_START, MONITOR_PURGE_SEC_SORTED},
+
+	{"purge_sec_rec_same_page", "purge",
+	 "Number of secondary index records that the purge processed"
+	 " without a new index lookup, under the latch of the same leaf page",
+	 MONITOR_NONE,
+	 MONITOR_DEFAULT_START, MONITOR_PURGE_SEC_SAME_PAGE},
+
 	/* ========== Counters for Recovery Module ========== */
 	{"module_log", "recovery", "Recovery Module",
 	 MONITOR_MODULE,
@@ -47,6 +47,7 @@ Created 10/8/1995 Heikki Tuuri
 #include "mysql/psi/psi.h"
 
 #include "btr0sea.h"
+#include "buf0dump.h"
 #include "buf0flu.h"
 #include "buf0lru.h"
 #include "dict0boot.h"
@@ -133,6 +134,9 @@ my_bool	high_level_read_only;
 
 /** Sort buffer size in index creation */
 ulong	srv_sort_buf_size;
+/** Number of threads that scan the clustered index and merge-sort the
+index entries in index creation */
+ulong	srv_alter_parallel_threads;
 /** Maximum modification log file size for online index creation */
 unsigned long long	srv_online_max_size;
 
@@ -142,6 +146,14 @@ use simulated aio we build below with threads.
 Currently we support native aio on windows and linux */
 my_bool	srv_use_native_aio;
 my_bool	srv_numa_interleave;
+/** innodb_csn_snapshots */
+my_bool	srv_csn_snapshots;
+/** innodb_version_cache_size */
+size_t	srv_version_cache_size;
+/** innodb_log_page_images */
+my_bool	srv_log_page_images;
+/** innodb_page_search_cache */
+my_bool	srv_page_search_cache;
 /** copy of innodb_use_atomic_writes; @see innodb_init_params() */
 my_bool	srv_use_atomic_writes;
 /** innodb_compression_algorithm; used with page compression */
@@ -212,6 +224,10 @@ ulint	srv_buf_pool_base_size;
 ulint	srv_buf_pool_curr_size;
 /** Dump this % of each buffer pool during BP dump */
 ulong	srv_buf_pool_dump_pct;
+/** innodb_buffer_pool_dump_interval */
+ulong	srv_buf_dump_interval;
+/** innodb_buffer_pool_load_io_depth */
+ulong	srv_buf_load_io_depth;
 /** Abort load after this amount of pages */
 #ifdef UNIV_DEBUG
 ulong srv_buf_pool_load_pages_abort = LONG_MAX;
@@ -1097,6 +1113,9 @@ srv_export_innodb_status(void)
 		srv_stats.os_log_pending_writes;
 
 	export_vars.innodb_log_write_requests = srv_stats.log_write_requests;
+	export_vars.innodb_log_page_images = srv_stats.log_page_images;
+	export_vars.innodb_log_page_image_bytes =
+		srv_stats.log_page_image_bytes;
 
 	export_vars.innodb_log_writes = srv_stats.log_writes;
 
@@ -1177,6 +1196,10 @@ srv_export_innodb_status(void)
 		srv_stats.n_sec_rec_cluster_reads;
 	export_vars.innodb_sec_rec_cluster_reads_avoided =
 		srv_stats.n_sec_rec_cluster_reads_avoided;
+	export_vars.innodb_version_cache_hits =
+		srv_stats.n_version_cache_hits;
+	export_vars.innodb_version_cache_misses =
+		srv_stats.n_version_cache_misses;
 
 	if (!srv_read_only_mode) {
 		export_vars.innodb_encryption_rotation_pages_read_from_cache =
@@ -1752,6 +1775,7 @@ void srv_master_callback(void*)
 	} else {
 		srv_master_do_idle_tasks();
 	}
+	buf_dump_periodic();
 	srv_main_thread_op_info = "sleeping";
 }
 
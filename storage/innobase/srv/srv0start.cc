@@ -95,6 +95,7 @@ Created 2/16/1996 Heikki Tuuri
 #include "row0upd.h"
 #include "row0row.h"
 #include "row0mysql.h"
+#include "row0vers.h"
 #include "btr0pcur.h"
 #include "zlib.h"
 #include "ut0crc32.h"
@@ -1224,6 +1225,7 @@ dberr_t srv_start(bool create_new_db)
 	log_sys.create();
 	recv_sys.create();
 	lock_sys.create(srv_lock_table_size);
+	row_vers_cache_create();
 
 
 	if (!srv_read_only_mode) {
@@ -2040,6 +2042,7 @@ void innodb_shutdown()
 	trx_sys.close();
 	buf_dblwr.close();
 	lock_sys.close();
+	row_vers_cache_close();
 	trx_pool_close();
 
 	if (!srv_read_only_mode) {
@@ -1194,6 +1194,7 @@ trx_purge_attach_undo_recs(ulint n_purge_threads)
 		}
 
 		node->undo_recs.push(purge_rec);
+		MONITOR_INC(MONITOR_PURGE_N_UNDO_REC);
 
 		if (n_pages_handled >= batch_size) {
 			break;
@@ -1276,6 +1277,8 @@ ulint trx_purge(ulint n_tasks, bool truncate)
 
 	srv_dml_needed_delay = trx_purge_dml_delay();
 
+	const ulint	history_len = trx_sys.rseg_history_len;
+
 	purge_sys.clone_oldest_view();
 
 #ifdef UNIV_DEBUG
@@ -1307,6 +1310,9 @@ ulint trx_purge(ulint n_tasks, bool truncate)
 
 	MONITOR_INC_VALUE(MONITOR_PURGE_INVOKED, 1);
 	MONITOR_INC_VALUE(MONITOR_PURGE_N_PAGE_HANDLED, n_pages_handled);
+	MONITOR_SET(MONITOR_PURGE_HISTORY_CHANGE,
+		    mon_type_t(trx_sys.rseg_history_len)
+		    - mon_type_t(history_len));
 
 	return(n_pages_handled);
 }
@@ -320,9 +320,224 @@ trx_sys_t::close()
 
 	ut_a(trx_list.empty());
 	trx_list.close();
+	csn.close();
 	m_initialised = false;
 }
 
+/** Collect the ids of recovered transactions */
+static my_bool trx_csn_add_recovered(rw_trx_hash_element_t *element,
+                                     std::vector<trx_id_t> *ids)
+{
+  if (element->trx)
+    ids->push_back(element->id);
+  return 0;
+}
+
+void trx_csn_t::overflow_initializer(LF_HASH *, overflow_t *element,
+                                     const trx_id_t *id_no)
+{
+  element->id= id_no[0];
+  element->no.store(id_no[1], std::memory_order_relaxed);
+}
+
+my_bool trx_csn_t::overflow_collect(overflow_t *element, collect_arg_t *arg)
+{
+  if (element->no.load(std::memory_order_relaxed) < arg->horizon)
+    arg->ids.push_back(element->id);
+  return 0;
+}
+
+void trx_csn_t::overflow_insert(trx_id_t id, trx_id_t no)
+{
+  const trx_id_t id_no[2]= {id, no};
+  LF_PINS *pins= lf_hash_get_pins(&m_overflow);
+  ut_a(pins);
+  int res= lf_hash_insert(&m_overflow, pins, id_no);
+  lf_hash_put_pins(pins);
+  ut_a(res == 0);
+}
+
+void trx_csn_t::create(trx_id_t max_trx_id)
+{
+  ut_ad(srv_is_being_started);
+  ut_ad(!is_enabled());
+  lf_hash_init(&m_overflow, sizeof(overflow_t), LF_HASH_UNIQUE, 0,
+               sizeof(trx_id_t), 0, &my_charset_bin);
+  m_overflow.initializer=
+    reinterpret_cast<lf_hash_initializer>(overflow_initializer);
+  m_start= max_trx_id;
+  m_horizon= max_trx_id;
+  std::vector<trx_id_t> recovered;
+  trx_sys.rw_trx_hash.iterate_no_dups(trx_csn_add_recovered, &recovered);
+  m_min_active.store(recovered.empty()
+                     ? max_trx_id
+                     : *std::min_element(recovered.begin(), recovered.end()),
+                     std::memory_order_relaxed);
+  for (const trx_id_t id : recovered)
+    overflow_insert(id, ACTIVE);
+  m_n_slots= N_SLOTS;
+  DBUG_EXECUTE_IF("innodb_csn_small_ring", m_n_slots= 4;);
+  m_slots= static_cast<slot_t*>(ut_zalloc_nokey(m_n_slots * sizeof *m_slots));
+}
+
+void trx_csn_t::close()
+{
+  if (!is_enabled())
+    return;
+  ut_free(m_slots);
+  m_slots= nullptr;
+  lf_hash_destroy(&m_overflow);
+}
+
+void trx_csn_t::lock(slot_t &s)
+{
+  for (;;)
+  {
+    uint32_t seq= s.seq.load(std::memory_order_relaxed);
+    if (!(seq & 1) &&
+        s.seq.compare_exchange_weak(seq, seq + 1, std::memory_order_acquire))
+      break;
+    ut_delay(1);
+  }
+}
+
+void trx_csn_t::register_trx(trx_id_t id)
+{
+  slot_t &s= slot(id);
+  lock(s);
+  const trx_id_t old_id= s.id.load(std::memory_order_relaxed);
+  const trx_id_t old_no= s.no.load(std::memory_order_relaxed);
+  if (old_id > id)
+  {
+    /* A transaction with a later id got the slot first */
+    overflow_insert(id, ACTIVE);
+    unlock(s);
+    return;
+  }
+  /* Keep the previous transaction of the slot unless every snapshot
+  sees it, or nothing of it remains visible. It is in m_overflow before
+  a reader can find the slot reused. */
+  if (old_id && old_no != ABORTED && (old_no == ACTIVE || old_no >= m_horizon))
+    overflow_insert(old_id, old_no);
+  s.id.store(id, std::memory_order_relaxed);
+  s.no.store(ACTIVE, std::memory_order_relaxed);
+  unlock(s);
+}
+
+trx_id_t trx_csn_t::commit(trx_id_t id, Atomic_counter<trx_id_t> &counter)
+{
+  trx_id_t no;
+  slot_t &s= slot(id);
+  lock(s);
+  if (s.id.load(std::memory_order_relaxed) == id)
+  {
+    /* A snapshot that includes no must find it in the slot: make the
+    lock visible before the counter, see ReadViewBase::snapshot() */
+    std::atomic_thread_fence(std::memory_order_release);
+    no= counter++;
+    s.no.store(no, std::memory_order_relaxed);
+    unlock(s);
+    return no;
+  }
+  unlock(s);
+
+  LF_PINS *pins= lf_hash_get_pins(&m_overflow);
+  ut_a(pins);
+  overflow_t *element= static_cast<overflow_t*>
+    (lf_hash_search(&m_overflow, pins, &id, sizeof id));
+  ut_a(element && element != MY_ERRPTR);
+  /* Likewise, a snapshot that includes no must not find the transaction
+  active. visible() waits while it is COMMITTING. */
+  element->no.store(COMMITTING, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  no= counter++;
+  element->no.store(no, std::memory_order_release);
+  lf_hash_search_unpin(pins);
+  lf_hash_put_pins(pins);
+  return no;
+}
+
+void trx_csn_t::abort(trx_id_t id)
+{
+  slot_t &s= slot(id);
+  lock(s);
+  if (s.id.load(std::memory_order_relaxed) == id)
+  {
+    s.no.store(ABORTED, std::memory_order_relaxed);
+    unlock(s);
+    return;
+  }
+  unlock(s);
+
+  LF_PINS *pins= lf_hash_get_pins(&m_overflow);
+  ut_a(pins);
+  lf_hash_delete(&m_overflow, pins, &id, sizeof id);
+  lf_hash_put_pins(pins);
+}
+
+bool trx_csn_t::visible(trx_id_t id, trx_id_t snapshot)
+{
+  const slot_t &s= slot(id);
+  bool sees;
+  for (;;)
+  {
+    const uint32_t seq= s.seq.load(std::memory_order_acquire);
+    if (seq & 1)
+    {
+      ut_delay(1);
+      continue;
+    }
+    const trx_id_t slot_id= s.id.load(std::memory_order_relaxed);
+    const trx_id_t no= s.no.load(std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (s.seq.load(std::memory_order_relaxed) != seq)
+      continue;
+    if (slot_id == id)
+      return no < snapshot;
+    /* Transactions that were dropped from a slot or from m_overflow had
+    committed before every open snapshot. A transaction that is in neither
+    has not been registered yet, and it has not modified anything. */
+    sees= slot_id > id || id < m_start;
+    break;
+  }
+
+  LF_PINS *pins= lf_hash_get_pins(&m_overflow);
+  ut_a(pins);
+  const overflow_t *element= static_cast<const overflow_t*>
+    (lf_hash_search(&m_overflow, pins, &id, sizeof id));
+  if (element && element != MY_ERRPTR)
+  {
+    trx_id_t no;
+    while ((no= element->no.load(std::memory_order_acquire)) == COMMITTING)
+      ut_delay(1);
+    lf_hash_search_unpin(pins);
+    sees= no < snapshot;
+  }
+  lf_hash_put_pins(pins);
+  return sees;
+}
+
+void trx_csn_t::purge(trx_id_t min_active, trx_id_t horizon)
+{
+  /* Pairs with min_active() in ReadViewBase::snapshot() */
+  if (m_min_active.load(std::memory_order_relaxed) < min_active)
+    m_min_active.store(min_active, std::memory_order_release);
+  if (m_horizon >= horizon)
+    return;
+  m_horizon= horizon;
+
+  collect_arg_t arg;
+  arg.horizon= horizon;
+  LF_PINS *pins= lf_hash_get_pins(&m_overflow);
+  ut_a(pins);
+  lf_hash_iterate(&m_overflow, pins,
+                  reinterpret_cast<my_hash_walk_action>(overflow_collect),
+                  &arg);
+  for (const trx_id_t id : arg.ids)
+    lf_hash_delete(&m_overflow, pins, &id, sizeof id);
+  lf_hash_put_pins(pins);
+}
+
 /** @return total number of active (non-prepared) transactions */
 ulint trx_sys_t::any_active_transactions()
 {
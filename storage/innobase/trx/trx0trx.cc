@@ -137,6 +137,8 @@ trx_init(
 
 	trx->internal = false;
 
+	trx->bulk_insert_pending = false;
+
 	ut_d(trx->start_file = 0);
 
 	ut_d(trx->start_line = 0);
@@ -796,6 +798,11 @@ trx_lists_init_at_db_start()
 
 		ib::info() << "Trx id counter is " << trx_sys.get_max_trx_id();
 	}
+
+	if (srv_csn_snapshots && !srv_read_only_mode) {
+		trx_sys.csn.create(trx_sys.get_max_trx_id());
+	}
+
 	purge_sys.clone_oldest_view();
 }
 
@@ -1727,6 +1734,31 @@ trx_mark_sql_stat_end(
 	ut_error;
 }
 
+dberr_t trx_t::bulk_insert_apply(const dict_table_t &table,
+                                 struct TABLE *mysql_table)
+{
+  auto it= mod_tables.find(const_cast<dict_table_t*>(&table));
+  if (it == mod_tables.end() || !it->second.bulk_buffer())
+    return DB_SUCCESS;
+  return it->second.write_bulk(this, mysql_table);
+}
+
+dberr_t trx_t::bulk_insert_apply()
+{
+  dberr_t err= DB_SUCCESS;
+  if (!bulk_insert_pending)
+    return err;
+  bulk_insert_pending= false;
+  for (auto &t : mod_tables)
+    if (t.second.bulk_buffer())
+    {
+      dberr_t e= t.second.write_bulk(this, nullptr);
+      if (err == DB_SUCCESS)
+        err= e;
+    }
+  return err;
+}
+
 /**********************************************************************//**
 Prints info about a transaction. */
 void
@@ -45,6 +45,8 @@ C_MODE_END
 #include "key.h"
 #include "log.h"
 #include "sql_parse.h"
+#include "sql_i_s.h"
+#include "sql_show.h"
 
 /*
   Note that in future versions, only *transactional* Maria tables can
@@ -59,6 +61,7 @@ C_MODE_END
 #define THD_TRN (TRN*) thd_get_ha_data(thd, maria_hton)
 
 ulong pagecache_division_limit, pagecache_age_threshold, pagecache_file_hash_size;
+uint pagecache_segments;
 ulonglong pagecache_buffer_size;
 const char *zerofill_error_msg=
   "Table is from another system and must be zerofilled or repaired to be "
@@ -257,6 +260,14 @@ static MYSQL_SYSVAR_ULONG(pagecache_file_hash_size, pagecache_file_hash_size,
        "value is probably 1/10 of number of possible open Aria files.", 0,0,
        512, 128, 16384, 1);
 
+static MYSQL_SYSVAR_UINT(pagecache_segments, pagecache_segments,
+       PLUGIN_VAR_RQCMDARG | PLUGIN_VAR_READONLY,
+       "Number of segments of the Aria page cache. Every segment has its own "
+       "lock and LRU list, which lets concurrent queries on Aria tables, "
+       "including internal temporary tables, use the cache in parallel. "
+       "The page cache memory is split evenly between the segments.", 0, 0,
+       1, 1, 64, 1);
+
 static MYSQL_SYSVAR_SET(recover_options, maria_recover_options, PLUGIN_VAR_OPCMDARG,
        "Specifies how corrupted tables should be automatically repaired",
        NULL, NULL, HA_RECOVER_BACKUP|HA_RECOVER_QUICK, &maria_recover_typelib);
@@ -3763,6 +3774,7 @@ static int ha_maria_init(void *p)
   bzero(maria_log_pagecache, sizeof(*maria_log_pagecache));
   maria_tmpdir= &mysql_tmpdir_list;             /* For REDO */
 
+  maria_pagecache->param_segments= pagecache_segments;
   if (!aria_readonly)
     res= maria_upgrade();
   res= res || maria_init();
@@ -3899,6 +3911,7 @@ static struct st_mysql_sys_var *system_variables[]= {
   MYSQL_SYSVAR(pagecache_buffer_size),
   MYSQL_SYSVAR(pagecache_division_limit),
   MYSQL_SYSVAR(pagecache_file_hash_size),
+  MYSQL_SYSVAR(pagecache_segments),
   MYSQL_SYSVAR(recover_options),
   MYSQL_SYSVAR(repair_threads),
   MYSQL_SYSVAR(sort_buffer_size),
@@ -4023,14 +4036,28 @@ static void update_log_file_size(MYSQL_THD thd,
 }
 
 
+static SHOW_VAR pagecache_status_variables[]= {
+  {"blocks_not_flushed", (char*) &maria_pagecache_var.global_blocks_changed, SHOW_LONG},
+  {"blocks_unused",      (char*) &maria_pagecache_var.blocks_unused, SHOW_LONG},
+  {"blocks_used",        (char*) &maria_pagecache_var.blocks_used, SHOW_LONG},
+  {"read_requests",      (char*) &maria_pagecache_var.global_cache_r_requests, SHOW_LONGLONG},
+  {"reads",              (char*) &maria_pagecache_var.global_cache_read, SHOW_LONGLONG},
+  {"write_requests",     (char*) &maria_pagecache_var.global_cache_w_requests, SHOW_LONGLONG},
+  {"writes",             (char*) &maria_pagecache_var.global_cache_write, SHOW_LONGLONG},
+  {NullS, NullS, SHOW_LONG}
+};
+
+/* The counters of a partitioned page cache live in its segments */
+static int show_pagecache_vars(THD *, SHOW_VAR *var, char *)
+{
+  pagecache_collect_statistics(maria_pagecache);
+  var->type= SHOW_ARRAY;
+  var->value= (char*) pagecache_status_variables;
+  return 0;
+}
+
 static SHOW_VAR status_variables[]= {
-  {"pagecache_blocks_not_flushed", (char*) &maria_pagecache_var.global_blocks_changed, SHOW_LONG},
-  {"pagecache_blocks_unused",      (char*) &maria_pagecache_var.blocks_unused, SHOW_LONG},
-  {"pagecache_blocks_used",        (char*) &maria_pagecache_var.blocks_used, SHOW_LONG},
-  {"pagecache_read_requests",      (char*) &maria_pagecache_var.global_cache_r_requests, SHOW_LONGLONG},
-  {"pagecache_reads",              (char*) &maria_pagecache_var.global_cache_read, SHOW_LONGLONG},
-  {"pagecache_write_requests",     (char*) &maria_pagecache_var.global_cache_w_requests, SHOW_LONGLONG},
-  {"pagecache_writes",             (char*) &maria_pagecache_var.global_cache_write, SHOW_LONGLONG},
+  {"pagecache",                    (char*) &show_pagecache_vars, SHOW_FUNC},
   {"transaction_log_syncs",        (char*) &translog_syncs, SHOW_LONGLONG},
   {NullS, NullS, SHOW_LONG}
 };
@@ -4169,6 +4196,83 @@ int ha_maria::find_unique_row(uchar *record, uint constrain_no)
 struct st_mysql_storage_engine maria_storage_engine=
 { MYSQL_HANDLERTON_INTERFACE_VERSION };
 
+/****************************************************************************
+ * INFORMATION_SCHEMA.ARIA_PAGECACHE_SEGMENTS
+ ***************************************************************************/
+
+namespace Show {
+
+static ST_FIELD_INFO pagecache_segments_fields_info[]=
+{
+  Column("SEGMENT_NUMBER",  ULong(3),       NOT_NULL),
+  Column("FULL_SIZE",       ULonglong(),    NOT_NULL),
+  Column("BLOCK_SIZE",      ULonglong(),    NOT_NULL),
+  Column("USED_BLOCKS",     ULonglong(),    NOT_NULL),
+  Column("UNUSED_BLOCKS",   ULonglong(),    NOT_NULL),
+  Column("DIRTY_BLOCKS",    ULonglong(),    NOT_NULL),
+  Column("READ_REQUESTS",   ULonglong(),    NOT_NULL),
+  Column("READS",           ULonglong(),    NOT_NULL),
+  Column("WRITE_REQUESTS",  ULonglong(),    NOT_NULL),
+  Column("WRITES",          ULonglong(),    NOT_NULL),
+  CEnd()
+};
+
+} // namespace Show
+
+
+static int store_pagecache_segment(THD *thd, TABLE *table, uint number,
+                                   PAGECACHE *segment)
+{
+  restore_record(table, s->default_values);
+  table->field[0]->store(number, TRUE);
+  table->field[1]->store((ulonglong) segment->mem_size, TRUE);
+  table->field[2]->store((ulonglong) segment->block_size, TRUE);
+  table->field[3]->store((ulonglong) segment->blocks_used, TRUE);
+  table->field[4]->store((ulonglong) segment->blocks_unused, TRUE);
+  table->field[5]->store((ulonglong) segment->global_blocks_changed, TRUE);
+  table->field[6]->store(segment->global_cache_r_requests, TRUE);
+  table->field[7]->store(segment->global_cache_read, TRUE);
+  table->field[8]->store(segment->global_cache_w_requests, TRUE);
+  table->field[9]->store(segment->global_cache_write, TRUE);
+  return schema_table_store_record(thd, table);
+}
+
+
+/*
+  One row per segment of the Aria page cache. A cache that is not
+  partitioned is shown as its only segment, number 0.
+*/
+
+static int pagecache_segments_fill(THD *thd, TABLE_LIST *tables, COND *)
+{
+  TABLE *table= tables->table;
+  uint i;
+
+  if (!maria_pagecache->inited)
+    return 0;
+  if (!maria_pagecache->segments)
+    return store_pagecache_segment(thd, table, 0, maria_pagecache);
+  for (i= 0; i < maria_pagecache->segments; i++)
+  {
+    if (store_pagecache_segment(thd, table, i,
+                                maria_pagecache->segment_array + i))
+      return 1;
+  }
+  return 0;
+}
+
+
+static int pagecache_segments_init(void *p)
+{
+  ST_SCHEMA_TABLE *schema= (ST_SCHEMA_TABLE *) p;
+  schema->fields_info= Show::pagecache_segments_fields_info;
+  schema->fill_table= pagecache_segments_fill;
+  return 0;
+}
+
+static struct st_mysql_information_schema pagecache_segments_descriptor=
+{ MYSQL_INFORMATION_SCHEMA_INTERFACE_VERSION };
+
 maria_declare_plugin(aria)
 {
   MYSQL_STORAGE_ENGINE_PLUGIN,
@@ -4184,5 +4288,20 @@ maria_declare_plugin(aria)
   system_variables,             /* system variables */
   "1.5",                        /* string version   */
   MariaDB_PLUGIN_MATURITY_STABLE /* maturity         */
+},
+{
+  MYSQL_INFORMATION_SCHEMA_PLUGIN,
+  &pagecache_segments_descriptor,
+  "ARIA_PAGECACHE_SEGMENTS",
+  "MariaDB Corporation Ab",
+  "Usage and statistics of the segments of the Aria page cache",
+  PLUGIN_LICENSE_GPL,
+  pagecache_segments_init,      /* Plugin Init      */
+  NULL,                         /* Plugin Deinit    */
+  0x0100,                       /* 1.0              */
+  NULL,                         /* status variables */
+  NULL,                         /* system variables */
+  "1.0",                        /* string version   */
+  MariaDB_PLUGIN_MATURITY_STABLE /* maturity         */
 }
 maria_declare_plugin_end;
@@ -589,6 +589,8 @@ pthread_handler_t ma_checkpoint_background(void *arg)
       {
         TRANSLOG_ADDRESS horizon= translog_get_horizon();
 
+        /* Sum up global_cache_write of a partitioned cache */
+        pagecache_collect_statistics(maria_pagecache);
         /*
           With background flushing evenly distributed over the time
           between two checkpoints, we should have only little flushing to do
@@ -624,6 +626,7 @@ pthread_handler_t ma_checkpoint_background(void *arg)
           below is possibly greater than last_checkpoint_lsn.
         */
         log_horizon_at_last_checkpoint= translog_get_horizon();
+        pagecache_collect_statistics(maria_pagecache);
         pagecache_flushes_at_last_checkpoint=
           maria_pagecache->global_cache_write;
         /*
@@ -737,6 +737,108 @@ static inline uint next_power(uint value)
 }
 
 
+/*
+  Find the segment of a partitioned page cache that serves a page
+
+  NOTES
+    Consecutive pages of a file go to different segments, so that
+    threads scanning the same table do not all queue up on one lock.
+*/
+
+static inline PAGECACHE *pagecache_segment(PAGECACHE *pagecache, File file,
+                                           pgcache_page_no_t pageno)
+{
+  return (pagecache->segment_array +
+          (uint) (((ulonglong) file + pageno) % pagecache->segments));
+}
+
+
+/*
+  Find the segment that owns a block. The block must be pinned or locked
+  by the caller, so that its hash link cannot change.
+*/
+
+static inline PAGECACHE *pagecache_block_segment(PAGECACHE *pagecache,
+                                                 PAGECACHE_BLOCK_LINK *block)
+{
+  return pagecache_segment(pagecache, block->hash_link->file.file,
+                           block->hash_link->pageno);
+}
+
+
+/*
+  Initialize a page cache split into pagecache->param_segments segments
+
+  NOTES
+    Every segment is an independent page cache that gets an equal share
+    of the memory and of the changed blocks hash. The top level structure
+    only keeps the parameters and the summary of the segments.
+
+  RETURN VALUE
+    number of blocks in all segments, if successful,
+    0 - otherwise.
+*/
+
+static size_t init_pagecache_segments(PAGECACHE *pagecache, size_t use_mem,
+                                      uint division_limit, uint age_threshold,
+                                      uint block_size,
+                                      uint changed_blocks_hash_size,
+                                      myf my_readwrite_flags)
+{
+  uint segments= pagecache->param_segments;
+  uint i;
+  size_t blocks= 0, mem_size= 0;
+  DBUG_ENTER("init_pagecache_segments");
+
+  if (!(pagecache->segment_array= (PAGECACHE*)
+        my_malloc(PSI_INSTRUMENT_ME, sizeof(PAGECACHE) * segments,
+                  MYF(MY_WME | MY_ZEROFILL))))
+    DBUG_RETURN(0);
+
+  for (i= 0; i < segments; i++)
+  {
+    PAGECACHE *segment= pagecache->segment_array + i;
+    size_t segment_blocks;
+    segment->extra_debug= pagecache->extra_debug;
+    if (!(segment_blocks=
+          init_pagecache(segment, use_mem / segments, division_limit,
+                         age_threshold, block_size,
+                         MY_MAX(changed_blocks_hash_size / segments, 1),
+                         my_readwrite_flags)))
+    {
+      int error= my_errno;
+      do
+        end_pagecache(pagecache->segment_array + i, 1);
+      while (i-- > 0);
+      my_free(pagecache->segment_array);
+      pagecache->segment_array= NULL;
+      my_errno= error;
+      DBUG_RETURN(0);
+    }
+    blocks+= segment_blocks;
+    mem_size+= segment->mem_size;
+  }
+
+  pagecache->segments= segments;
+  pagecache->mem_size= mem_size;
+  pagecache->block_size= block_size;
+  pagecache->shift= my_bit_log2_uint64(block_size);
+  pagecache->readwrite_flags= pagecache->segment_array->readwrite_flags;
+  pagecache->org_readwrite_flags= pagecache->readwrite_flags;
+  pagecache->blocks_unused= blocks;
+  pagecache->disk_blocks= blocks;
+  pagecache->blocks= blocks;
+  pagecache->blocks_used= pagecache->blocks_changed= 0;
+  pagecache->global_blocks_changed= 0;
+  pagecache->global_cache_w_requests= pagecache->global_cache_r_requests= 0;
+  pagecache->global_cache_read= pagecache->global_cache_write= 0;
+  pagecache->inited= 1;
+  pagecache->can_be_used= 1;
+  DBUG_PRINT("exit", ("segments: %u  disk_blocks: %zu", segments, blocks));
+  DBUG_RETURN(blocks);
+}
+
+
 /*
   Initialize a page cache
 
@@ -787,6 +889,12 @@ size_t init_pagecache(PAGECACHE *pagecache, size_t use_mem,
     DBUG_RETURN(0);
   }
 
+  if (pagecache->param_segments > 1)
+    DBUG_RETURN(init_pagecache_segments(pagecache, use_mem, division_limit,
+                                        age_threshold, block_size,
+                                        changed_blocks_hash_size,
+                                        my_readwrite_flags));
+
   pagecache->global_cache_w_requests= pagecache->global_cache_r_requests= 0;
   pagecache->global_cache_read= pagecache->global_cache_write= 0;
   pagecache->disk_blocks= -1;
@@ -1022,6 +1130,10 @@ size_t resize_pagecache(PAGECACHE *pagecache,
   if (!pagecache->inited)
     DBUG_RETURN(pagecache->disk_blocks);
 
+  /* The memory of a partitioned cache is owned by its segments */
+  if (pagecache->segments)
+    DBUG_RETURN(0);
+
   if(use_mem == pagecache->mem_size)
   {
     change_pagecache_param(pagecache, division_limit, age_threshold);
@@ -1107,6 +1219,24 @@ static inline void dec_counter_for_resize_op(PAGECACHE *pagecache)
   }
 }
 
+/*
+  Set the flags of pread()/pwrite() calls of a page cache
+
+  NOTES
+    Recovery clears MY_WME while it reads pages that may be beyond the
+    end of the file. The segments of a partitioned cache get their flags
+    when they are initialized, and later only through this function.
+*/
+
+void pagecache_set_readwrite_flags(PAGECACHE *pagecache, myf flags)
+{
+  uint i;
+  pagecache->readwrite_flags= flags;
+  for (i= 0; i < pagecache->segments; i++)
+    pagecache->segment_array[i].readwrite_flags= flags;
+}
+
+
 /*
   Change the page cache parameters
 
@@ -1130,6 +1260,15 @@ void change_pagecache_param(PAGECACHE *pagecache, uint division_limit,
 {
   DBUG_ENTER("change_pagecache_param");
 
+  if (pagecache->segments)
+  {
+    uint i;
+    for (i= 0; i < pagecache->segments; i++)
+      change_pagecache_param(pagecache->segment_array + i, division_limit,
+                             age_threshold);
+    DBUG_VOID_RETURN;
+  }
+
   pagecache_pthread_mutex_lock(&pagecache->cache_lock);
   if (division_limit)
     pagecache->min_warm_blocks= (pagecache->disk_blocks *
@@ -1193,6 +1332,21 @@ void end_pagecache(PAGECACHE *pagecache, my_bool cleanup)
   if (!pagecache->inited)
     DBUG_VOID_RETURN;
 
+  if (pagecache->segments)
+  {
+    /* The top level structure owns nothing but the segments */
+    uint i;
+    for (i= 0; i < pagecache->segments; i++)
+      end_pagecache(pagecache->segment_array + i, 1);
+    my_free(pagecache->segment_array);
+    pagecache->segment_array= NULL;
+    pagecache->segments= 0;
+    pagecache->disk_blocks= -1;
+    pagecache->blocks_changed= 0;
+    pagecache->inited= pagecache->can_be_used= 0;
+    DBUG_VOID_RETURN;
+  }
+
   if (pagecache->disk_blocks > 0)
   {
 #ifndef DBUG_OFF
@@ -3202,6 +3356,8 @@ void pagecache_unlock(PAGECACHE *pagecache,
   PAGECACHE_BLOCK_LINK *block;
   int page_st;
   DBUG_ENTER("pagecache_unlock");
+  if (pagecache->segments)
+    pagecache= pagecache_segment(pagecache, file->file, pageno);
   DBUG_PRINT("enter", ("fd: %u  page: %lu  %s  %s",
                        (uint) file->file, (ulong) pageno,
                        page_cache_page_lock_str[lock],
@@ -3296,6 +3452,8 @@ void pagecache_unpin(PAGECACHE *pagecache,
   PAGECACHE_BLOCK_LINK *block;
   int page_st;
   DBUG_ENTER("pagecache_unpin");
+  if (pagecache->segments)
+    pagecache= pagecache_segment(pagecache, file->file, pageno);
   DBUG_PRINT("enter", ("fd: %u  page: %lu",
                        (uint) file->file, (ulong) pageno));
   pagecache_pthread_mutex_lock(&pagecache->cache_lock);
@@ -3373,6 +3531,8 @@ void pagecache_unlock_by_link(PAGECACHE *pagecache,
                               my_bool any)
 {
   DBUG_ENTER("pagecache_unlock_by_link");
+  if (pagecache->segments)
+    pagecache= pagecache_block_segment(pagecache, block);
   DBUG_PRINT("enter", ("block: %p  fd: %u  page: %lu  changed: %d  %s  %s",
                        block, (uint) block->hash_link->file.file,
                        (ulong) block->hash_link->pageno, was_changed,
@@ -3484,6 +3644,8 @@ void pagecache_unpin_by_link(PAGECACHE *pagecache,
                              LSN lsn)
 {
   DBUG_ENTER("pagecache_unpin_by_link");
+  if (pagecache->segments)
+    pagecache= pagecache_block_segment(pagecache, block);
   DBUG_PRINT("enter", ("block: %p  fd: %u page: %lu",
                        block, (uint) block->hash_link->file.file,
                        (ulong) block->hash_link->pageno));
@@ -3723,6 +3885,8 @@ uchar *pagecache_read(PAGECACHE *pagecache,
   DBUG_ASSERT(pageno < ((1ULL) << 40));
 #endif
 
+  if (pagecache->segments)
+    pagecache= pagecache_segment(pagecache, file->file, pageno);
   if (!page_link)
     page_link= &fake_link;
   *page_link= 0;                                 /* Catch errors */
@@ -4075,6 +4239,8 @@ my_bool pagecache_delete_by_link(PAGECACHE *pagecache,
   my_bool error= 0;
   enum pagecache_page_pin pin= PAGECACHE_PIN_LEFT_PINNED;
   DBUG_ENTER("pagecache_delete_by_link");
+  if (pagecache->segments)
+    pagecache= pagecache_block_segment(pagecache, block);
   DBUG_PRINT("enter", ("fd: %d block %p  %s  %s",
                        block->hash_link->file.file,
                        block,
@@ -4197,6 +4363,9 @@ my_bool pagecache_delete(PAGECACHE *pagecache,
               lock == PAGECACHE_LOCK_LEFT_WRITELOCKED);
   DBUG_ASSERT(pin == PAGECACHE_PIN ||
               pin == PAGECACHE_PIN_LEFT_PINNED);
+  if (pagecache->segments)
+    pagecache= pagecache_segment(pagecache, file->file, pageno);
+
 restart:
 
   DBUG_ASSERT(pageno < ((1ULL) << 40));
@@ -4385,6 +4554,8 @@ my_bool pagecache_write_part(PAGECACHE *pagecache,
   DBUG_ASSERT(pagecache->big_block_read == 0);
 #endif
 
+  if (pagecache->segments)
+    pagecache= pagecache_segment(pagecache, file->file, pageno);
   if (!page_link)
     page_link= &fake_link;
   *page_link= 0;
@@ -5221,6 +5392,17 @@ int flush_pagecache_blocks_with_filter(PAGECACHE *pagecache,
 
   if (pagecache->disk_blocks <= 0)
     DBUG_RETURN(0);
+  if (pagecache->segments)
+  {
+    /* The pages of a file are spread over all segments */
+    uint i;
+    res= 0;
+    for (i= 0; i < pagecache->segments; i++)
+      res|= flush_pagecache_blocks_with_filter(pagecache->segment_array + i,
+                                               file, type, filter,
+                                               filter_arg);
+    DBUG_RETURN(res);
+  }
   pagecache_pthread_mutex_lock(&pagecache->cache_lock);
   inc_counter_for_resize_op(pagecache);
   res= flush_pagecache_blocks_int(pagecache, file, type, filter, filter_arg);
@@ -5257,6 +5439,12 @@ int reset_pagecache_counters(const char *name __attribute__((unused)),
   }
   DBUG_PRINT("info", ("Resetting counters for key cache %s.", name));
 
+  if (pagecache->segments)
+  {
+    uint i;
+    for (i= 0; i < pagecache->segments; i++)
+      reset_pagecache_counters(name, pagecache->segment_array + i);
+  }
   pagecache->global_blocks_changed= 0;   /* Key_blocks_not_flushed */
   pagecache->global_cache_r_requests= 0; /* Key_read_requests */
   pagecache->global_cache_read= 0;       /* Key_reads */
@@ -5266,6 +5454,104 @@ int reset_pagecache_counters(const char *name __attribute__((unused)),
 }
 
 
+/**
+  @brief Sum up the statistics of the segments of a partitioned cache
+
+  The usage and statistics variables of the top level structure of a
+  partitioned cache are only updated by this function. It does nothing
+  for a cache that is not partitioned.
+*/
+
+void pagecache_collect_statistics(PAGECACHE *pagecache)
+{
+  size_t blocks_used= 0, blocks_unused= 0, blocks_changed= 0;
+  size_t global_blocks_changed= 0;
+  ulonglong w_requests= 0, writes= 0, r_requests= 0, reads= 0;
+  uint i;
+
+  if (!pagecache->segments)
+    return;
+  for (i= 0; i < pagecache->segments; i++)
+  {
+    PAGECACHE *segment= pagecache->segment_array + i;
+    blocks_used+=           segment->blocks_used;
+    blocks_unused+=         segment->blocks_unused;
+    blocks_changed+=        segment->blocks_changed;
+    global_blocks_changed+= segment->global_blocks_changed;
+    w_requests+=            segment->global_cache_w_requests;
+    writes+=                segment->global_cache_write;
+    r_requests+=            segment->global_cache_r_requests;
+    reads+=                 segment->global_cache_read;
+  }
+  pagecache->blocks_used=             blocks_used;
+  pagecache->blocks_unused=           blocks_unused;
+  pagecache->blocks_changed=          blocks_changed;
+  pagecache->global_blocks_changed=   global_blocks_changed;
+  pagecache->global_cache_w_requests= w_requests;
+  pagecache->global_cache_write=      writes;
+  pagecache->global_cache_r_requests= r_requests;
+  pagecache->global_cache_read=       reads;
+}
+
+
+/**
+  @brief Merge the dirty page lists of all segments of a partitioned cache
+
+  Every segment is collected in turn; the result has the format of
+  pagecache_collect_changed_blocks_with_lsn().
+*/
+
+static my_bool collect_changed_blocks_of_segments(PAGECACHE *pagecache,
+                                                  LEX_STRING *str,
+                                                  LSN *min_rec_lsn)
+{
+  LEX_STRING *lists;
+  LSN minimum_rec_lsn= LSN_MAX;
+  ulonglong stored_list_size= 0;
+  char *ptr;
+  uint i;
+  my_bool error= 1;
+  DBUG_ENTER("collect_changed_blocks_of_segments");
+
+  if (!(lists= (LEX_STRING*) my_malloc(PSI_INSTRUMENT_ME,
+                                       sizeof(LEX_STRING) *
+                                       pagecache->segments,
+                                       MYF(MY_WME | MY_ZEROFILL))))
+    DBUG_RETURN(1);
+  str->length= 8;
+  for (i= 0; i < pagecache->segments; i++)
+  {
+    LSN segment_min_lsn;
+    if (pagecache_collect_changed_blocks_with_lsn(pagecache->segment_array + i,
+                                                  lists + i,
+                                                  &segment_min_lsn))
+      goto end;
+    if (cmp_translog_addr(segment_min_lsn, minimum_rec_lsn) < 0)
+      minimum_rec_lsn= segment_min_lsn;
+    stored_list_size+= uint8korr(lists[i].str);
+    str->length+= lists[i].length - 8;
+  }
+  if (NULL == (str->str= my_malloc(PSI_INSTRUMENT_ME, str->length, MYF(MY_WME))))
+    goto end;
+  ptr= str->str;
+  int8store(ptr, stored_list_size);
+  ptr+= 8;
+  for (i= 0; i < pagecache->segments; i++)
+  {
+    memcpy(ptr, lists[i].str + 8, lists[i].length - 8);
+    ptr+= lists[i].length - 8;
+  }
+  *min_rec_lsn= minimum_rec_lsn;
+  error= 0;
+
+end:
+  for (i= 0; i < pagecache->segments; i++)
+    my_free(lists[i].str);
+  my_free(lists);
+  DBUG_RETURN(error);
+}
+
+
 /**
    @brief Allocates a buffer and stores in it some info about all dirty pages
 
@@ -5298,6 +5584,9 @@ my_bool pagecache_collect_changed_blocks_with_lsn(PAGECACHE *pagecache,
   DBUG_ENTER("pagecache_collect_changed_blocks_with_LSN");
 
   DBUG_ASSERT(NULL == str->str);
+  if (pagecache->segments)
+    DBUG_RETURN(collect_changed_blocks_of_segments(pagecache, str,
+                                                   min_rec_lsn));
   /*
     We lock the entire cache but will be quick, just reading/writing a few MBs
     of memory at most.
@@ -5430,6 +5719,13 @@ void pagecache_file_no_dirty_page(PAGECACHE *pagecache, PAGECACHE_FILE *file)
 {
   File fd= file->file;
   PAGECACHE_BLOCK_LINK *block;
+  if (pagecache->segments)
+  {
+    uint i;
+    for (i= 0; i < pagecache->segments; i++)
+      pagecache_file_no_dirty_page(pagecache->segment_array + i, file);
+    return;
+  }
   for (block= pagecache->changed_blocks[FILE_HASH(*file, pagecache)];
        block != NULL;
        block= block->next_changed)
@@ -180,6 +180,13 @@ typedef struct st_pagecache
   PAGECACHE_BLOCK_LINK **changed_blocks;
   /* hash for other file bl.*/
   PAGECACHE_BLOCK_LINK **file_blocks;
+  /*
+    Segments of a partitioned cache. Each segment is a complete page cache
+    with its own lock and LRU; a page is served by segment
+    (file + pageno) % segments. 0 if the cache is not partitioned.
+  */
+  struct st_pagecache *segment_array;
+  uint segments;
 
   /**
     Function for reading file in big hunks from S3
@@ -201,6 +208,7 @@ typedef struct st_pagecache
   size_t param_block_size;       /* size of the blocks in the key cache      */
   size_t param_division_limit;   /* min. percentage of warm blocks           */
   size_t param_age_threshold;    /* determines when hot block is downgraded  */
+  uint param_segments;           /* number of segments to split the cache in */
 
   /* Statistics variables. These are reset in reset_pagecache_counters().    */
   size_t global_blocks_changed;	/* number of currently dirty blocks          */
@@ -245,6 +253,7 @@ extern size_t resize_pagecache(PAGECACHE *pagecache,
                               uint age_threshold, uint changed_blocks_hash_size);
 extern void change_pagecache_param(PAGECACHE *pagecache, uint division_limit,
                                    uint age_threshold);
+extern void pagecache_set_readwrite_flags(PAGECACHE *pagecache, myf flags);
 
 extern uchar *pagecache_read(PAGECACHE *pagecache,
                              PAGECACHE_FILE *file,
@@ -340,6 +349,7 @@ extern my_bool pagecache_collect_changed_blocks_with_lsn(PAGECACHE *pagecache,
                                                          LEX_STRING *str,
                                                          LSN *min_lsn);
 extern int reset_pagecache_counters(const char *name, PAGECACHE *pagecache);
+extern void pagecache_collect_statistics(PAGECACHE *pagecache);
 extern uchar *pagecache_block_link_to_buffer(PAGECACHE_BLOCK_LINK *block);
 
 extern uint pagecache_pagelevel(PAGECACHE_BLOCK_LINK *block);
@@ -725,7 +725,7 @@ ha_myisam::ha_myisam(handlerton *hton, TABLE_SHARE *table_arg)
                   HA_FILE_BASED | HA_CAN_GEOMETRY | HA_NO_TRANSACTIONS |
                   HA_CAN_INSERT_DELAYED | HA_CAN_BIT_FIELD | HA_CAN_RTREEKEYS |
                   HA_HAS_RECORDS | HA_STATS_RECORDS_IS_EXACT | HA_CAN_REPAIR |
-                  HA_CAN_TABLES_WITHOUT_ROLLBACK),
+                  HA_CAN_TABLES_WITHOUT_ROLLBACK | HA_CAN_SCAN_IN_THREADS),
    can_enable_indexes(0)
 {}
 
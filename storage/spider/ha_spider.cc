@@ -114,6 +114,7 @@ ha_spider::ha_spider(
   dml_inited = FALSE;
   use_pre_call = FALSE;
   use_pre_action = FALSE;
+  async_link_idx = -1;
 #ifdef HANDLER_HAS_DIRECT_UPDATE_ROWS
   do_direct_update = FALSE;
 #if defined(HS_HAS_SQLCOM) && defined(HAVE_HANDLERSOCKET)
@@ -218,6 +219,7 @@ ha_spider::ha_spider(
   dml_inited = FALSE;
   use_pre_call = FALSE;
   use_pre_action = FALSE;
+  async_link_idx = -1;
 #ifdef HANDLER_HAS_DIRECT_UPDATE_ROWS
   do_direct_update = FALSE;
 #if defined(HS_HAS_SQLCOM) && defined(HAVE_HANDLERSOCKET)
@@ -683,6 +685,8 @@ int ha_spider::close()
   backup_error_status();
   DBUG_ENTER("ha_spider::close");
   DBUG_PRINT("info",("spider this=%p", this));
+  if (async_link_idx >= 0)
+    read_async_result();
 
 #ifdef HA_MRR_USE_DEFAULT_IMPL
   if (multi_range_keys)
@@ -1426,6 +1430,8 @@ int ha_spider::reset()
   backup_error_status();
   DBUG_ENTER("ha_spider::reset");
   DBUG_PRINT("info",("spider this=%p", this));
+  if (async_link_idx >= 0)
+    read_async_result();
 #ifdef HA_CAN_BULK_ACCESS
   SPIDER_BULK_ACCESS_LINK *tmp_bulk_access_link = bulk_access_link_first;
   while (tmp_bulk_access_link)
@@ -2178,6 +2184,7 @@ int ha_spider::index_read_map_internal(
         }
         spider_conn_set_timeout_from_share(conn, roop_count,
           wide_handler->trx->thd, share);
+        conn->async_send = use_async_search(buf, roop_count);
         if (dbton_hdl->execute_sql(
           sql_type,
           conn,
@@ -2217,7 +2224,10 @@ int ha_spider::index_read_map_internal(
         DBUG_ASSERT(conn->mta_conn_mutex_unlock_later);
         conn->mta_conn_mutex_lock_already = FALSE;
         conn->mta_conn_mutex_unlock_later = FALSE;
-        if (roop_count == link_ok)
+        if (conn->async_sent)
+        {
+          set_async_result(conn, roop_count);
+        } else if (roop_count == link_ok)
         {
           if ((error_num = spider_db_store_result(this, roop_count, table)))
           {
@@ -2386,6 +2396,8 @@ int ha_spider::index_read_map(
 #endif
   if (use_pre_call)
   {
+    if (async_link_idx >= 0)
+      read_async_result();
     if (store_error_num)
     {
       if (store_error_num == HA_ERR_END_OF_FILE)
@@ -2686,6 +2698,7 @@ int ha_spider::index_read_last_map_internal(
         }
         spider_conn_set_timeout_from_share(conn, roop_count,
           wide_handler->trx->thd, share);
+        conn->async_send = use_async_search(buf, roop_count);
         if (dbton_hdl->execute_sql(
           sql_type,
           conn,
@@ -2725,7 +2738,10 @@ int ha_spider::index_read_last_map_internal(
         DBUG_ASSERT(conn->mta_conn_mutex_unlock_later);
         conn->mta_conn_mutex_lock_already = FALSE;
         conn->mta_conn_mutex_unlock_later = FALSE;
-        if (roop_count == link_ok)
+        if (conn->async_sent)
+        {
+          set_async_result(conn, roop_count);
+        } else if (roop_count == link_ok)
         {
           if ((error_num = spider_db_store_result(this, roop_count, table)))
           {
@@ -2798,6 +2814,8 @@ int ha_spider::index_read_last_map(
   DBUG_PRINT("info",("spider this=%p", this));
   if (use_pre_call)
   {
+    if (async_link_idx >= 0)
+      read_async_result();
     if (store_error_num)
     {
       if (store_error_num == HA_ERR_END_OF_FILE)
@@ -3172,6 +3190,7 @@ int ha_spider::index_first_internal(
           }
           spider_conn_set_timeout_from_share(conn, roop_count,
             wide_handler->trx->thd, share);
+          conn->async_send = use_async_search(buf, roop_count);
           if (dbton_hdl->execute_sql(
             sql_type,
             conn,
@@ -3211,7 +3230,10 @@ int ha_spider::index_first_internal(
           DBUG_ASSERT(conn->mta_conn_mutex_unlock_later);
           conn->mta_conn_mutex_lock_already = FALSE;
           conn->mta_conn_mutex_unlock_later = FALSE;
-          if (roop_count == link_ok)
+          if (conn->async_sent)
+          {
+            set_async_result(conn, roop_count);
+          } else if (roop_count == link_ok)
           {
             if ((error_num = spider_db_store_result(this, roop_count, table)))
             {
@@ -3293,6 +3315,8 @@ int ha_spider::index_first(
   DBUG_PRINT("info",("spider this=%p", this));
   if (use_pre_call)
   {
+    if (async_link_idx >= 0)
+      read_async_result();
     if (store_error_num)
     {
       if (store_error_num == HA_ERR_END_OF_FILE)
@@ -3575,6 +3599,7 @@ int ha_spider::index_last_internal(
           }
           spider_conn_set_timeout_from_share(conn, roop_count,
             wide_handler->trx->thd, share);
+          conn->async_send = use_async_search(buf, roop_count);
           if (dbton_hdl->execute_sql(
             sql_type,
             conn,
@@ -3614,7 +3639,10 @@ int ha_spider::index_last_internal(
           DBUG_ASSERT(conn->mta_conn_mutex_unlock_later);
           conn->mta_conn_mutex_lock_already = FALSE;
           conn->mta_conn_mutex_unlock_later = FALSE;
-          if (roop_count == link_ok)
+          if (conn->async_sent)
+          {
+            set_async_result(conn, roop_count);
+          } else if (roop_count == link_ok)
           {
             if ((error_num = spider_db_store_result(this, roop_count, table)))
             {
@@ -3696,6 +3724,8 @@ int ha_spider::index_last(
   DBUG_PRINT("info",("spider this=%p", this));
   if (use_pre_call)
   {
+    if (async_link_idx >= 0)
+      read_async_result();
     if (store_error_num)
     {
       if (store_error_num == HA_ERR_END_OF_FILE)
@@ -4037,6 +4067,7 @@ int ha_spider::read_range_first_internal(
         }
         spider_conn_set_timeout_from_share(conn, roop_count,
           wide_handler->trx->thd, share);
+        conn->async_send = use_async_search(buf, roop_count);
         if (dbton_hdl->execute_sql(
           sql_type,
           conn,
@@ -4076,7 +4107,10 @@ int ha_spider::read_range_first_internal(
         DBUG_ASSERT(conn->mta_conn_mutex_unlock_later);
         conn->mta_conn_mutex_lock_already = FALSE;
         conn->mta_conn_mutex_unlock_later = FALSE;
-        if (roop_count == link_ok)
+        if (conn->async_sent)
+        {
+          set_async_result(conn, roop_count);
+        } else if (roop_count == link_ok)
         {
           if ((error_num = spider_db_store_result(this, roop_count, table)))
           {
@@ -4152,6 +4186,8 @@ int ha_spider::read_range_first(
   DBUG_PRINT("info",("spider this=%p", this));
   if (use_pre_call)
   {
+    if (async_link_idx >= 0)
+      read_async_result();
     if (store_error_num)
     {
       if (store_error_num == HA_ERR_END_OF_FILE)
@@ -7748,6 +7784,7 @@ int ha_spider::rnd_next_internal(
         }
         spider_conn_set_timeout_from_share(conn, roop_count,
           wide_handler->trx->thd, share);
+        conn->async_send = use_async_search(buf, roop_count);
         if (dbton_hdl->execute_sql(
           sql_type,
           conn,
@@ -7787,7 +7824,10 @@ int ha_spider::rnd_next_internal(
         DBUG_ASSERT(conn->mta_conn_mutex_unlock_later);
         conn->mta_conn_mutex_lock_already = FALSE;
         conn->mta_conn_mutex_unlock_later = FALSE;
-        if (roop_count == link_ok)
+        if (conn->async_sent)
+        {
+          set_async_result(conn, roop_count);
+        } else if (roop_count == link_ok)
         {
           if ((error_num = spider_db_store_result(this, roop_count, table)))
           {
@@ -7874,6 +7914,8 @@ int ha_spider::rnd_next(
   DBUG_PRINT("info",("spider this=%p", this));
   if (use_pre_call)
   {
+    if (async_link_idx >= 0)
+      read_async_result();
     if (store_error_num)
     {
       if (store_error_num == HA_ERR_END_OF_FILE)
@@ -8380,6 +8422,7 @@ int ha_spider::ft_read_internal(
         }
         spider_conn_set_timeout_from_share(conn, roop_count,
           wide_handler->trx->thd, share);
+        conn->async_send = use_async_search(buf, roop_count);
         if (dbton_hdl->execute_sql(
           SPIDER_SQL_TYPE_SELECT_SQL,
           conn,
@@ -8419,7 +8462,10 @@ int ha_spider::ft_read_internal(
         DBUG_ASSERT(conn->mta_conn_mutex_unlock_later);
         conn->mta_conn_mutex_lock_already = FALSE;
         conn->mta_conn_mutex_unlock_later = FALSE;
-        if (roop_count == link_ok)
+        if (conn->async_sent)
+        {
+          set_async_result(conn, roop_count);
+        } else if (roop_count == link_ok)
         {
           if ((error_num = spider_db_store_result(this, roop_count, table)))
           {
@@ -8494,6 +8540,8 @@ int ha_spider::ft_read(
   DBUG_PRINT("info",("spider this=%p", this));
   if (use_pre_call)
   {
+    if (async_link_idx >= 0)
+      read_async_result();
     if (store_error_num)
     {
       if (store_error_num == HA_ERR_END_OF_FILE)
@@ -13945,6 +13993,67 @@ void ha_spider::check_pre_call(
   DBUG_VOID_RETURN;
 }
 
+/*
+  Whether the search of a pre-call is only sent to the remote server.
+  ha_partition makes the pre-calls of all partitions before it reads the
+  first row of any, so with spider_async_search the searches of all
+  partitions are executed by the remote servers at the same time, without
+  a background thread per connection. Searches that lock rows use all
+  links and are executed synchronously.
+*/
+bool ha_spider::use_async_search(
+  const uchar *buf,
+  int link_idx
+) {
+  DBUG_ENTER("ha_spider::use_async_search");
+  DBUG_RETURN(
+    !buf &&
+    use_pre_call &&
+#if defined(HS_HAS_SQLCOM) && defined(HAVE_HANDLERSOCKET)
+    conn_kind[link_idx] == SPIDER_CONN_KIND_MYSQL &&
+#endif
+    !spider_conn_lock_mode(this) &&
+    spider_param_async_search(wide_handler->trx->thd)
+  );
+}
+
+/*
+  Called after the search of link_idx was sent without reading its result.
+  The result is read by read_async_result(), or by spider_db_before_query()
+  if another query needs the connection first.
+*/
+void ha_spider::set_async_result(
+  SPIDER_CONN *conn,
+  int link_idx
+) {
+  DBUG_ENTER("ha_spider::set_async_result");
+  DBUG_PRINT("info",("spider this=%p", this));
+  conn->async_sent = FALSE;
+  conn->async_target = this;
+  conn->async_link_idx = link_idx;
+  async_link_idx = link_idx;
+  result_link_idx = link_idx;
+  SPIDER_CLEAR_FILE_POS(&conn->mta_conn_mutex_file_pos);
+  pthread_mutex_unlock(&conn->mta_conn_mutex);
+  DBUG_VOID_RETURN;
+}
+
+int ha_spider::read_async_result()
+{
+  SPIDER_CONN *conn = conns[async_link_idx];
+  DBUG_ENTER("ha_spider::read_async_result");
+  DBUG_PRINT("info",("spider this=%p", this));
+  pthread_mutex_assert_not_owner(&conn->mta_conn_mutex);
+  pthread_mutex_lock(&conn->mta_conn_mutex);
+  SPIDER_SET_FILE_POS(&conn->mta_conn_mutex_file_pos);
+  if (conn->async_target == this)
+    spider_db_async_store_result(conn);
+  SPIDER_CLEAR_FILE_POS(&conn->mta_conn_mutex_file_pos);
+  pthread_mutex_unlock(&conn->mta_conn_mutex);
+  async_link_idx = -1;
+  DBUG_RETURN(store_error_num);
+}
+
 #ifdef HANDLER_HAS_DIRECT_UPDATE_ROWS
 void ha_spider::check_insert_dup_update_pushdown()
 {
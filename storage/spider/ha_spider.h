@@ -170,6 +170,7 @@ class ha_spider final : public handler
   int                bulk_size;
   int                direct_dup_insert;
   int                store_error_num;
+  int                async_link_idx;    /* link with unread async result */
   uint               dup_key_idx;
   int                select_column_mode;
   bool               pk_update;
@@ -955,6 +956,15 @@ class ha_spider final : public handler
   void check_pre_call(
     bool use_parallel
   );
+  bool use_async_search(
+    const uchar *buf,
+    int link_idx
+  );
+  void set_async_result(
+    SPIDER_CONN *conn,
+    int link_idx
+  );
+  int read_async_result();
 #ifdef HANDLER_HAS_DIRECT_UPDATE_ROWS
   void check_insert_dup_update_pushdown();
 #endif
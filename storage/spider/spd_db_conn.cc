@@ -626,6 +626,11 @@ int spider_db_before_query(
   conn->in_before_query = TRUE;
   pthread_mutex_assert_owner(&conn->mta_conn_mutex);
   DBUG_ASSERT(conn->mta_conn_mutex_file_pos.file_name);
+  if (conn->async_target)
+  {
+    /* The error is returned by the searching handler */
+    spider_db_async_store_result(conn);
+  }
   if ((error_num = spider_db_conn_queue_action(conn)))
   {
     conn->in_before_query = FALSE;
@@ -690,8 +695,11 @@ int spider_db_query(
   int *need_mon
 ) {
   int error_num;
+  bool async_send = conn->async_send;
   DBUG_ENTER("spider_db_query");
   pthread_mutex_assert_owner(&conn->mta_conn_mutex);
+  /* Queries of spider_db_before_query() read their results */
+  conn->async_send = FALSE;
 #if defined(HS_HAS_SQLCOM) && defined(HAVE_HANDLERSOCKET)
   if (conn->conn_kind == SPIDER_CONN_KIND_MYSQL)
   {
@@ -712,6 +720,13 @@ int spider_db_query(
     DBUG_PRINT("info", ("spider query=%s", query));
     DBUG_PRINT("info", ("spider length=%u", length));
 #endif
+    if (async_send)
+    {
+      if ((error_num = conn->db_conn->send_query(query, length, quick_mode)))
+        DBUG_RETURN(error_num);
+      conn->async_sent = TRUE;
+      DBUG_RETURN(0);
+    }
     if ((error_num = conn->db_conn->exec_query(query, length, quick_mode)))
       DBUG_RETURN(error_num);
     DBUG_RETURN(0);
@@ -728,6 +743,44 @@ int spider_db_query(
 #endif
 }
 
+/*
+  Read the result of the query that conn->async_target sent without
+  waiting for it, and store the first rows into its result list. An error
+  is kept in the store_error_num of the handler, which returns it when the
+  search is continued. The caller owns conn->mta_conn_mutex.
+*/
+int spider_db_async_store_result(
+  SPIDER_CONN *conn
+) {
+  int error_num;
+  ha_spider *spider = (ha_spider *) conn->async_target;
+  int link_idx = conn->async_link_idx;
+  bool tmp_mta_conn_mutex_unlock_later;
+#ifndef WITHOUT_SPIDER_BG_SEARCH
+  volatile
+#endif
+    int *tmp_need_mon = conn->need_mon;
+  DBUG_ENTER("spider_db_async_store_result");
+  DBUG_PRINT("info",("spider spider=%p", spider));
+  pthread_mutex_assert_owner(&conn->mta_conn_mutex);
+  conn->async_target = NULL;
+  spider->async_link_idx = -1;
+  tmp_mta_conn_mutex_unlock_later = conn->mta_conn_mutex_unlock_later;
+  conn->mta_conn_mutex_unlock_later = TRUE;
+  conn->need_mon = &spider->need_mons[link_idx];
+  if (conn->db_conn->read_query_result())
+    error_num = spider_db_errorno(conn);
+  else
+    error_num = spider_db_store_result(spider, link_idx,
+      spider->result_list.table);
+  conn->mta_conn_mutex_unlock_later = tmp_mta_conn_mutex_unlock_later;
+  /* The caller may be monitoring another link of the connection */
+  conn->need_mon = tmp_need_mon;
+  if (error_num)
+    spider->store_error_num = spider->check_error_mode_eof(error_num);
+  DBUG_RETURN(error_num);
+}
+
 int spider_db_errorno(
   SPIDER_CONN *conn
 ) {
@@ -199,6 +199,10 @@
 #define SPIDER_SQL_GROUP_LEN (sizeof(SPIDER_SQL_GROUP_STR) - 1)
 #define SPIDER_SQL_HAVING_STR " having "
 #define SPIDER_SQL_HAVING_LEN (sizeof(SPIDER_SQL_HAVING_STR) - 1)
+#define SPIDER_SQL_SUM_STR "sum("
+#define SPIDER_SQL_SUM_LEN (sizeof(SPIDER_SQL_SUM_STR) - 1)
+#define SPIDER_SQL_COUNT_STR "count("
+#define SPIDER_SQL_COUNT_LEN (sizeof(SPIDER_SQL_COUNT_STR) - 1)
 #define SPIDER_SQL_PLUS_STR " + "
 #define SPIDER_SQL_PLUS_LEN (sizeof(SPIDER_SQL_PLUS_STR) - 1)
 #define SPIDER_SQL_MINUS_STR " - "
@@ -311,6 +315,10 @@ int spider_db_query(
   int *need_mon
 );
 
+int spider_db_async_store_result(
+  SPIDER_CONN *conn
+);
+
 int spider_db_errorno(
   SPIDER_CONN *conn
 );
@@ -1111,6 +1111,18 @@ class spider_db_conn
     uint length,
     int quick_mode
   ) = 0;
+  /* Send a query whose result is read later by read_query_result() */
+  virtual int send_query(
+    const char *query,
+    uint length,
+    int quick_mode
+  ) {
+    return exec_query(query, length, quick_mode);
+  }
+  virtual int read_query_result()
+  {
+    return 0;
+  }
   virtual int get_errno() = 0;
   virtual const char *get_error() = 0;
   virtual bool is_server_gone_error(
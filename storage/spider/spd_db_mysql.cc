@@ -2121,9 +2121,53 @@ int spider_db_mbase::exec_query(
   int quick_mode
 ) {
   int error_num = 0;
-  uint log_result_errors = spider_param_log_result_errors();
   DBUG_ENTER("spider_db_mbase::exec_query");
   DBUG_PRINT("info",("spider this=%p", this));
+  if ((error_num = general_log_query(query, length)))
+    DBUG_RETURN(error_num);
+  if (!spider_param_dry_access())
+  {
+    error_num = mysql_real_query(db_conn, query, length);
+  }
+  DBUG_RETURN(log_query_result(query, length, error_num));
+}
+
+int spider_db_mbase::send_query(
+  const char *query,
+  uint length,
+  int quick_mode
+) {
+  int error_num = 0;
+  DBUG_ENTER("spider_db_mbase::send_query");
+  DBUG_PRINT("info",("spider this=%p", this));
+  if ((error_num = general_log_query(query, length)))
+    DBUG_RETURN(error_num);
+  if (!spider_param_dry_access())
+  {
+    error_num = mysql_send_query(db_conn, query, length);
+  }
+  if (error_num)
+    DBUG_RETURN(log_query_result(query, length, error_num));
+  DBUG_RETURN(0);
+}
+
+int spider_db_mbase::read_query_result()
+{
+  int error_num = 0;
+  DBUG_ENTER("spider_db_mbase::read_query_result");
+  DBUG_PRINT("info",("spider this=%p", this));
+  if (!spider_param_dry_access())
+  {
+    error_num = mysql_read_query_result(db_conn);
+  }
+  DBUG_RETURN(log_query_result(NULL, 0, error_num));
+}
+
+int spider_db_mbase::general_log_query(
+  const char *query,
+  uint length
+) {
+  DBUG_ENTER("spider_db_mbase::general_log_query");
   if (spider_param_general_log())
   {
     const char *tgt_str = conn->tgt_host;
@@ -2142,10 +2186,20 @@ int spider_db_mbase::exec_query(
     general_log_write(current_thd, COM_QUERY, tmp_query_str.ptr(),
       tmp_query_str.length());
   }
-  if (!spider_param_dry_access())
-  {
-    error_num = mysql_real_query(db_conn, query, length);
-  }
+  DBUG_RETURN(0);
+}
+
+/*
+  Log the result of a query according to spider_log_result_errors.
+  query is NULL when the result of a query sent by send_query() is read.
+*/
+int spider_db_mbase::log_query_result(
+  const char *query,
+  uint length,
+  int error_num
+) {
+  uint log_result_errors = spider_param_log_result_errors();
+  DBUG_ENTER("spider_db_mbase::log_query_result");
   if (
     (error_num && log_result_errors >= 1) ||
     (log_result_errors >= 2 && db_conn->warning_count > 0) ||
@@ -2178,7 +2232,7 @@ int spider_db_mbase::exec_query(
           (ulong) thd->thread_id,
           tmp_query_str.c_ptr_safe());
       }
-      if (log_result_error_with_sql & 1)
+      if ((log_result_error_with_sql & 1) && query)
       {
         tmp_query_str.length(0);
         if (tmp_query_str.reserve(length + 1))
@@ -439,6 +439,12 @@ class spider_db_mbase: public spider_db_conn
     uint length,
     int quick_mode
   );
+  int send_query(
+    const char *query,
+    uint length,
+    int quick_mode
+  );
+  int read_query_result();
   int get_errno();
   const char *get_error();
   bool is_server_gone_error(
@@ -453,6 +459,15 @@ class spider_db_mbase: public spider_db_conn
   int print_warnings(
     struct tm *l_time
   );
+  int general_log_query(
+    const char *query,
+    uint length
+  );
+  int log_query_result(
+    const char *query,
+    uint length,
+    int error_num
+  );
   spider_db_result *store_result(
     spider_db_result_buffer **spider_res_buf,
     st_spider_db_request_key *request_key,
@@ -1612,6 +1612,832 @@ int spider_group_by_handler::end_scan()
   DBUG_RETURN(0);
 }
 
+#if defined(WITH_PARTITION_STORAGE_ENGINE) && \
+  defined(PARTITION_HAS_GET_CHILD_HANDLERS)
+#define SPIDER_PARTIAL_COPY 0
+#define SPIDER_PARTIAL_COUNT 1
+#define SPIDER_PARTIAL_SUM 2
+#define SPIDER_PARTIAL_MIN 3
+#define SPIDER_PARTIAL_MAX 4
+#define SPIDER_PARTIAL_AVG_KIND 5
+#define SPIDER_PARTIAL_SPILL_PREFIX "SPD"
+
+static uchar *spider_partial_group_get_key(
+  SPIDER_PARTIAL_GROUP *group,
+  size_t *length,
+  my_bool not_used __attribute__ ((unused))
+) {
+  DBUG_ENTER("spider_partial_group_get_key");
+  *length = group->key_length;
+  DBUG_RETURN(group->key);
+}
+
+spider_partial_group_by_handler::spider_partial_group_by_handler(
+  THD *thd_arg,
+  Query *query_arg
+) : group_by_handler(thd_arg, spider_hton_ptr),
+  query(*query_arg), trx(NULL), spiders(NULL), spider_count(0), items(NULL),
+  item_count(0), avg_count(0), key_length(0), key_buff(NULL),
+  row_avgs(NULL), groups_inited(FALSE), groups_size(0), max_groups_size(0),
+  current_group(0), spills(NULL), spill_level(0), spill_overflow(FALSE)
+{
+  DBUG_ENTER("spider_partial_group_by_handler::spider_partial_group_by_handler");
+  SPD_INIT_ALLOC_ROOT(&mem_root, 4096, 0, MYF(MY_WME));
+  SPD_INIT_ALLOC_ROOT(&groups_root, 4096, 0, MYF(MY_WME));
+  memset(spill_parts, 0, sizeof(spill_parts));
+  sql.init_calc_mem(273);
+  DBUG_VOID_RETURN;
+}
+
+spider_partial_group_by_handler::~spider_partial_group_by_handler()
+{
+  DBUG_ENTER("spider_partial_group_by_handler::~spider_partial_group_by_handler");
+  if (groups_inited)
+    my_hash_free(&groups);
+  if (spills)
+  {
+    for (uint level = 0; level < SPIDER_PARTIAL_SPILL_LEVELS; level++)
+    {
+      for (uint part = 0; part < SPIDER_PARTIAL_SPILL_PARTS; part++)
+        close_cached_file(&spills[level][part].file);
+    }
+  }
+  free_root(&groups_root, MYF(0));
+  free_root(&mem_root, MYF(0));
+  DBUG_VOID_RETURN;
+}
+
+/*
+  Check that the query can be aggregated in two phases and that every
+  partition can send its part of it to its remote server.
+*/
+bool spider_partial_group_by_handler::init()
+{
+  TABLE *from_table = query.from->table;
+  partition_info *part_info = from_table->part_info;
+  ha_partition *partition = (ha_partition *) from_table->file;
+  handler **handlers = partition->get_child_handlers();
+  List_iterator_fast<Item> it(*query.select);
+  SPIDER_PARTIAL_ITEM *partial_item;
+  Item *item;
+  ORDER *order;
+  ha_spider *spider;
+  SPIDER_CONN *conn;
+  uint part, roop_count;
+  bool with_sum = FALSE;
+  DBUG_ENTER("spider_partial_group_by_handler::init");
+  if (
+    !bitmap_bits_set(&part_info->read_partitions) ||
+    !(spiders = (ha_spider **) alloc_root(&mem_root, sizeof(ha_spider *) *
+      bitmap_bits_set(&part_info->read_partitions))) ||
+    !(items = (SPIDER_PARTIAL_ITEM *) alloc_root(&mem_root,
+      sizeof(SPIDER_PARTIAL_ITEM) * query.select->elements))
+  )
+    DBUG_RETURN(TRUE);
+
+  while ((item = it++))
+  {
+    if (item->const_item())
+      continue;
+    partial_item = &items[item_count++];
+    partial_item->item = item;
+    partial_item->field = NULL;
+    partial_item->group = FALSE;
+    partial_item->avg_idx = 0;
+    switch (item->type())
+    {
+      case Item::FIELD_ITEM:
+        partial_item->kind = SPIDER_PARTIAL_COPY;
+        break;
+      case Item::SUM_FUNC_ITEM:
+        switch (((Item_sum *) item)->sum_func())
+        {
+          case Item_sum::COUNT_FUNC:
+            partial_item->kind = SPIDER_PARTIAL_COUNT;
+            break;
+          case Item_sum::SUM_FUNC:
+            partial_item->kind = SPIDER_PARTIAL_SUM;
+            break;
+          case Item_sum::MIN_FUNC:
+            partial_item->kind = SPIDER_PARTIAL_MIN;
+            break;
+          case Item_sum::MAX_FUNC:
+            partial_item->kind = SPIDER_PARTIAL_MAX;
+            break;
+          case Item_sum::AVG_FUNC:
+            partial_item->kind = SPIDER_PARTIAL_AVG_KIND;
+            partial_item->avg_idx = avg_count++;
+            break;
+          default:
+            DBUG_PRINT("info",("spider aggregate can not be merged"));
+            DBUG_RETURN(TRUE);
+        }
+        if (((Item_sum *) item)->get_arg_count() != 1)
+          DBUG_RETURN(TRUE);
+        with_sum = TRUE;
+        break;
+      default:
+        DBUG_PRINT("info",("spider item can not be merged"));
+        DBUG_RETURN(TRUE);
+    }
+    if (
+      item->field_type() == MYSQL_TYPE_BLOB ||
+      (item->cmp_type() == STRING_RESULT && item->too_big_for_varchar())
+    ) {
+      DBUG_PRINT("info",("spider blob can not be merged"));
+      DBUG_RETURN(TRUE);
+    }
+  }
+
+  for (order = query.group_by; order; order = order->next)
+  {
+    if ((*order->item)->const_item())
+      continue;
+    for (roop_count = 0; roop_count < item_count; roop_count++)
+    {
+      if (items[roop_count].item == *order->item)
+        break;
+    }
+    if (
+      roop_count == item_count ||
+      items[roop_count].kind != SPIDER_PARTIAL_COPY
+    ) {
+      DBUG_PRINT("info",("spider group item is not selected"));
+      DBUG_RETURN(TRUE);
+    }
+    items[roop_count].group = TRUE;
+  }
+  if (!query.group_by && !with_sum)
+  {
+    if (!query.distinct)
+      DBUG_RETURN(TRUE);
+    /* the distinct rows of the partitions are merged */
+    for (roop_count = 0; roop_count < item_count; roop_count++)
+      items[roop_count].group = TRUE;
+  }
+
+  /*
+    The groups are kept in memory until the end of the scan and the groups
+    that do not fit are spilled to disk. Leave the grouping to the server
+    when they are not expected to fit in an in-memory temporary table.
+  */
+  max_groups_size = MY_MIN(thd->variables.tmp_memory_table_size,
+    thd->variables.max_heap_table_size);
+  if (query.group_by || !with_sum)
+  {
+    ha_rows records = from_table->file->stats.records;
+    double groups = 1;
+    ulonglong group_size = sizeof(SPIDER_PARTIAL_GROUP) +
+      sizeof(SPIDER_PARTIAL_AVG) * avg_count;
+    for (roop_count = 0; roop_count < item_count; roop_count++)
+    {
+      item = items[roop_count].item;
+      group_size += item->max_length;
+      if (!items[roop_count].group)
+        continue;
+      group_size += item->max_length + 1;
+      /* the distinct values of a column that starts an index */
+      Field *field = ((Item_field *) item)->field;
+      double values = (double) records;
+      for (uint key = 0; key < from_table->s->keys; key++)
+      {
+        if (field->key_start.is_set(key))
+        {
+          double rec_per_key =
+            from_table->key_info[key].actual_rec_per_key(0);
+          if (rec_per_key >= 1)
+            values /= rec_per_key;
+          break;
+        }
+      }
+      groups *= values;
+      if (groups > (double) records)
+        groups = (double) records;
+    }
+    if (groups * group_size > (double) max_groups_size)
+    {
+      DBUG_PRINT("info",("spider groups may not fit in memory"));
+      DBUG_RETURN(TRUE);
+    }
+  }
+
+  for (
+    part = bitmap_get_first_set(&part_info->read_partitions);
+    part != MY_BIT_NONE;
+    part = bitmap_get_next_set(&part_info->read_partitions, part)
+  ) {
+    spider = (ha_spider *) handlers[part];
+    if (spider_conn_lock_mode(spider) || spider->dml_init())
+      DBUG_RETURN(TRUE);
+    conn = spider->conns[spider->search_link_idx];
+    if (
+      !conn || conn->table_lock ||
+      spider_param_use_handler(thd,
+        spider->share->use_handlers[spider->search_link_idx])
+    ) {
+      DBUG_PRINT("info",("spider partition can not be aggregated"));
+      DBUG_RETURN(TRUE);
+    }
+    for (roop_count = 0; roop_count < item_count; roop_count++)
+    {
+      item = items[roop_count].item;
+      if (items[roop_count].kind == SPIDER_PARTIAL_AVG_KIND)
+        item = ((Item_sum *) item)->get_arg(0);
+      if (spider_db_print_item_type(item, NULL, spider, NULL, NULL, 0,
+        conn->dbton_id, FALSE, NULL))
+        DBUG_RETURN(TRUE);
+    }
+    if (
+      query.where &&
+      spider_db_print_item_type(query.where, NULL, spider, NULL, NULL, 0,
+        conn->dbton_id, FALSE, NULL)
+    )
+      DBUG_RETURN(TRUE);
+    spiders[spider_count++] = spider;
+  }
+  trx = spiders[0]->wide_handler->trx;
+  DBUG_RETURN(FALSE);
+}
+
+int spider_partial_group_by_handler::make_sql(
+  ha_spider *spider,
+  uint dbton_id
+) {
+  int error_num;
+  SPIDER_SHARE *share = spider->share;
+  int all_link_idx = spider->conn_link_idx[spider->search_link_idx];
+  spider_db_util *db_util = spider_dbton[dbton_id].db_util;
+  SPIDER_PARTIAL_ITEM *partial_item, *end = items + item_count;
+  bool first = TRUE;
+  DBUG_ENTER("spider_partial_group_by_handler::make_sql");
+  sql.length(0);
+  sql.set_charset(share->access_charset);
+  if (sql.reserve(SPIDER_SQL_SELECT_LEN + SPIDER_SQL_DISTINCT_LEN))
+    DBUG_RETURN(HA_ERR_OUT_OF_MEM);
+  sql.q_append(SPIDER_SQL_SELECT_STR, SPIDER_SQL_SELECT_LEN);
+  if (!query.group_by && query.distinct)
+    sql.q_append(SPIDER_SQL_DISTINCT_STR, SPIDER_SQL_DISTINCT_LEN);
+  for (partial_item = items; partial_item < end; partial_item++)
+  {
+    if (!first)
+    {
+      if (sql.reserve(SPIDER_SQL_COMMA_LEN))
+        DBUG_RETURN(HA_ERR_OUT_OF_MEM);
+      sql.q_append(SPIDER_SQL_COMMA_STR, SPIDER_SQL_COMMA_LEN);
+    }
+    first = FALSE;
+    if (partial_item->kind == SPIDER_PARTIAL_AVG_KIND)
+    {
+      /* avg() is sent as sum() and count() of its argument */
+      Item *arg = ((Item_sum *) partial_item->item)->get_arg(0);
+      if (sql.reserve(SPIDER_SQL_SUM_LEN))
+        DBUG_RETURN(HA_ERR_OUT_OF_MEM);
+      sql.q_append(SPIDER_SQL_SUM_STR, SPIDER_SQL_SUM_LEN);
+      if ((error_num = spider_db_print_item_type(arg, NULL, spider, &sql,
+        NULL, 0, dbton_id, FALSE, NULL)))
+        DBUG_RETURN(error_num);
+      if (sql.reserve(SPIDER_SQL_CLOSE_PAREN_LEN + SPIDER_SQL_COMMA_LEN +
+        SPIDER_SQL_COUNT_LEN))
+        DBUG_RETURN(HA_ERR_OUT_OF_MEM);
+      sql.q_append(SPIDER_SQL_CLOSE_PAREN_STR, SPIDER_SQL_CLOSE_PAREN_LEN);
+      sql.q_append(SPIDER_SQL_COMMA_STR, SPIDER_SQL_COMMA_LEN);
+      sql.q_append(SPIDER_SQL_COUNT_STR, SPIDER_SQL_COUNT_LEN);
+      if ((error_num = spider_db_print_item_type(arg, NULL, spider, &sql,
+        NULL, 0, dbton_id, FALSE, NULL)))
+        DBUG_RETURN(error_num);
+      if (sql.reserve(SPIDER_SQL_CLOSE_PAREN_LEN))
+        DBUG_RETURN(HA_ERR_OUT_OF_MEM);
+      sql.q_append(SPIDER_SQL_CLOSE_PAREN_STR, SPIDER_SQL_CLOSE_PAREN_LEN);
+    } else if ((error_num = spider_db_print_item_type(partial_item->item,
+      NULL, spider, &sql, NULL, 0, dbton_id, FALSE, NULL)))
+      DBUG_RETURN(error_num);
+  }
+  if (sql.reserve(SPIDER_SQL_FROM_LEN + SPIDER_SQL_DOT_LEN))
+    DBUG_RETURN(HA_ERR_OUT_OF_MEM);
+  sql.q_append(SPIDER_SQL_FROM_STR, SPIDER_SQL_FROM_LEN);
+  if (
+    (error_num = db_util->append_escaped_name_with_charset(&sql,
+      share->tgt_dbs[all_link_idx], share->tgt_dbs_lengths[all_link_idx],
+      system_charset_info))
+  )
+    DBUG_RETURN(error_num);
+  sql.q_append(SPIDER_SQL_DOT_STR, SPIDER_SQL_DOT_LEN);
+  if (
+    (error_num = db_util->append_escaped_name_with_charset(&sql,
+      share->tgt_table_names[all_link_idx],
+      share->tgt_table_names_lengths[all_link_idx], system_charset_info))
+  )
+    DBUG_RETURN(error_num);
+  if (query.where)
+  {
+    if (sql.reserve(SPIDER_SQL_WHERE_LEN))
+      DBUG_RETURN(HA_ERR_OUT_OF_MEM);
+    sql.q_append(SPIDER_SQL_WHERE_STR, SPIDER_SQL_WHERE_LEN);
+    if ((error_num = spider_db_print_item_type(query.where, NULL, spider,
+      &sql, NULL, 0, dbton_id, FALSE, NULL)))
+      DBUG_RETURN(error_num);
+  }
+  first = TRUE;
+  for (partial_item = items; partial_item < end; partial_item++)
+  {
+    if (!partial_item->group || !query.group_by)
+      continue;
+    if (sql.reserve(SPIDER_SQL_GROUP_LEN))
+      DBUG_RETURN(HA_ERR_OUT_OF_MEM);
+    if (first)
+      sql.q_append(SPIDER_SQL_GROUP_STR, SPIDER_SQL_GROUP_LEN);
+    else
+      sql.q_append(SPIDER_SQL_COMMA_STR, SPIDER_SQL_COMMA_LEN);
+    first = FALSE;
+    if ((error_num = spider_db_print_item_type(partial_item->item, NULL,
+      spider, &sql, NULL, 0, dbton_id, FALSE, NULL)))
+      DBUG_RETURN(error_num);
+  }
+  DBUG_RETURN(0);
+}
+
+int spider_partial_group_by_handler::search(
+  ha_spider *spider
+) {
+  int error_num, link_idx = spider->search_link_idx;
+  SPIDER_CONN *conn = spider->conns[link_idx];
+  SPIDER_DB_RESULT *res;
+  SPIDER_DB_ROW *row;
+  DBUG_ENTER("spider_partial_group_by_handler::search");
+  if ((error_num = make_sql(spider, conn->dbton_id)))
+    DBUG_RETURN(error_num);
+
+  pthread_mutex_assert_not_owner(&conn->mta_conn_mutex);
+  pthread_mutex_lock(&conn->mta_conn_mutex);
+  SPIDER_SET_FILE_POS(&conn->mta_conn_mutex_file_pos);
+  conn->need_mon = &spider->need_mons[link_idx];
+  DBUG_ASSERT(!conn->mta_conn_mutex_lock_already);
+  DBUG_ASSERT(!conn->mta_conn_mutex_unlock_later);
+  conn->mta_conn_mutex_lock_already = TRUE;
+  conn->mta_conn_mutex_unlock_later = TRUE;
+  spider_conn_set_timeout_from_share(conn, link_idx, trx->thd,
+    spider->share);
+  if (
+    !(error_num = spider_db_set_names(spider, conn, link_idx)) &&
+    spider_db_query(
+      conn,
+      sql.ptr(),
+      sql.length(),
+      -1,
+      &spider->need_mons[link_idx])
+  )
+    error_num = spider_db_errorno(conn);
+  if (!error_num)
+  {
+    st_spider_db_request_key request_key;
+    request_key.spider_thread_id = trx->spider_thread_id;
+    request_key.query_id = trx->thd->query_id;
+    request_key.handler = spider;
+    request_key.request_id = 1;
+    request_key.next = NULL;
+    if (
+      !(res = conn->db_conn->store_result(NULL, &request_key, &error_num)) &&
+      !error_num && !(error_num = spider_db_errorno(conn))
+    )
+      error_num = ER_QUERY_ON_FOREIGN_DATA_SOURCE;
+  }
+  DBUG_ASSERT(conn->mta_conn_mutex_lock_already);
+  DBUG_ASSERT(conn->mta_conn_mutex_unlock_later);
+  conn->mta_conn_mutex_lock_already = FALSE;
+  conn->mta_conn_mutex_unlock_later = FALSE;
+  SPIDER_CLEAR_FILE_POS(&conn->mta_conn_mutex_file_pos);
+  pthread_mutex_unlock(&conn->mta_conn_mutex);
+  if (error_num)
+    DBUG_RETURN(error_num);
+
+  while ((row = res->fetch_row()))
+  {
+    if ((error_num = add_row(spider, row)))
+      break;
+  }
+  res->free_result();
+  delete res;
+  DBUG_RETURN(error_num);
+}
+
+/*
+  Decode a row of the partial result of a partition into record[1] and add
+  it to the group with the same key.
+*/
+int spider_partial_group_by_handler::add_row(
+  ha_spider *spider,
+  SPIDER_DB_ROW *row
+) {
+  int error_num;
+  SPIDER_SHARE *share = spider->share;
+  my_ptrdiff_t ptr_diff = PTR_BYTE_DIFF(table->record[1], table->record[0]);
+  SPIDER_PARTIAL_ITEM *partial_item, *end = items + item_count;
+  DBUG_ENTER("spider_partial_group_by_handler::add_row");
+  memcpy(table->record[1], table->s->default_values, table->s->reclength);
+  for (partial_item = items; partial_item < end; partial_item++)
+  {
+    Field *field = partial_item->field;
+    if (partial_item->kind == SPIDER_PARTIAL_AVG_KIND)
+    {
+      SPIDER_PARTIAL_AVG *avg = &row_avgs[partial_item->avg_idx];
+      my_decimal count;
+      if (partial_item->item->result_type() == DECIMAL_RESULT)
+      {
+        if (row->is_null())
+          my_decimal_set_zero(&avg->dec_sum);
+        else
+          row->val_decimal(&avg->dec_sum, share->access_charset);
+      } else
+        avg->real_sum = row->is_null() ? 0 : row->val_real();
+      row->next();
+      row->val_decimal(&count, share->access_charset);
+      my_decimal2int(E_DEC_FATAL_ERROR, &count, FALSE, &avg->count);
+      row->next();
+      continue;
+    }
+    if ((error_num = spider_db_fetch_row(share, field, row, ptr_diff)))
+      DBUG_RETURN(error_num);
+    row->next();
+  }
+  DBUG_RETURN(add_group());
+}
+
+/*
+  Make the group key of the row in record[1] in key_buff and return its
+  hash value.
+*/
+my_hash_value_type spider_partial_group_by_handler::make_key()
+{
+  my_ptrdiff_t ptr_diff = PTR_BYTE_DIFF(table->record[1], table->record[0]);
+  uchar *key_pos = key_buff;
+  SPIDER_PARTIAL_ITEM *partial_item, *end = items + item_count;
+  DBUG_ENTER("spider_partial_group_by_handler::make_key");
+  for (partial_item = items; partial_item < end; partial_item++)
+  {
+    Field *field = partial_item->field;
+    if (!partial_item->group)
+      continue;
+    field->move_field_offset(ptr_diff);
+    field->make_sort_key_part(key_pos, field->sort_length());
+    field->move_field_offset(-ptr_diff);
+    key_pos += field->sort_length() + field->maybe_null();
+  }
+  DBUG_RETURN(my_calc_hash(&groups, key_buff, key_length));
+}
+
+/*
+  Add the row in record[1] to the group with the same key. When the groups
+  in memory have reached max_groups_size, the rows of the other groups are
+  spilled to disk and merged after the groups in memory have been read.
+*/
+int spider_partial_group_by_handler::add_group()
+{
+  my_hash_value_type hash_value = make_key();
+  uint reclength = table->s->reclength, roop_count;
+  ulonglong group_size = sizeof(SPIDER_PARTIAL_GROUP) + key_length +
+    reclength + sizeof(SPIDER_PARTIAL_AVG) * avg_count;
+  SPIDER_PARTIAL_GROUP *group;
+  DBUG_ENTER("spider_partial_group_by_handler::add_group");
+  if ((group = (SPIDER_PARTIAL_GROUP *) my_hash_search_using_hash_value(
+    &groups, hash_value, key_buff, key_length)))
+  {
+    merge_group(group);
+    DBUG_RETURN(0);
+  }
+  /* the groups of the last level are kept in memory regardless of size */
+  if (
+    spill_level < SPIDER_PARTIAL_SPILL_LEVELS &&
+    (spill_overflow || groups_size + group_size > max_groups_size)
+  ) {
+    /* the groups that are not in memory by now are never added to it */
+    spill_overflow = TRUE;
+    DBUG_RETURN(spill_group(&spills[spill_level][(hash_value >>
+      (32 - SPIDER_PARTIAL_SPILL_BITS * (spill_level + 1))) &
+      (SPIDER_PARTIAL_SPILL_PARTS - 1)]));
+  }
+  groups_size += group_size;
+  if (!(group = (SPIDER_PARTIAL_GROUP *) alloc_root(&groups_root,
+    sizeof(SPIDER_PARTIAL_GROUP) + key_length + reclength)))
+    DBUG_RETURN(HA_ERR_OUT_OF_MEM);
+  group->key = (uchar *) (group + 1);
+  group->key_length = key_length;
+  group->record = group->key + key_length;
+  group->avgs = NULL;
+  memcpy(group->key, key_buff, key_length);
+  memcpy(group->record, table->record[1], reclength);
+  if (avg_count)
+  {
+    if (!(group->avgs = (SPIDER_PARTIAL_AVG *) alloc_root(&groups_root,
+      sizeof(SPIDER_PARTIAL_AVG) * avg_count)))
+      DBUG_RETURN(HA_ERR_OUT_OF_MEM);
+    for (roop_count = 0; roop_count < avg_count; roop_count++)
+      new (&group->avgs[roop_count]) SPIDER_PARTIAL_AVG(row_avgs[roop_count]);
+  }
+  if (my_hash_insert(&groups, (uchar *) group))
+    DBUG_RETURN(HA_ERR_OUT_OF_MEM);
+  DBUG_RETURN(0);
+}
+
+/*
+  Write the row in record[1] and its averages to a spill file.
+*/
+int spider_partial_group_by_handler::spill_group(
+  SPIDER_PARTIAL_SPILL *spill
+) {
+  DBUG_ENTER("spider_partial_group_by_handler::spill_group");
+  if (
+    (
+      !my_b_inited(&spill->file) &&
+      open_cached_file(&spill->file, mysql_tmpdir,
+        SPIDER_PARTIAL_SPILL_PREFIX, DISK_BUFFER_SIZE, MYF(MY_WME))
+    ) ||
+    my_b_write(&spill->file, table->record[1], table->s->reclength) ||
+    (
+      avg_count &&
+      my_b_write(&spill->file, (uchar *) row_avgs,
+        sizeof(SPIDER_PARTIAL_AVG) * avg_count)
+    )
+  )
+    DBUG_RETURN(my_errno ? my_errno : HA_ERR_INTERNAL_ERROR);
+  spill->records++;
+  DBUG_RETURN(0);
+}
+
+/*
+  Replace the groups in memory with the groups of the next spill file. The
+  files of a level are read after the groups that were in memory while they
+  were written, so the deepest level that has rows is read first.
+*/
+int spider_partial_group_by_handler::load_spilled_groups()
+{
+  int error_num;
+  uint level = MY_MIN(spill_level, SPIDER_PARTIAL_SPILL_LEVELS - 1);
+  uint reclength = table->s->reclength, roop_count;
+  SPIDER_PARTIAL_SPILL *spill;
+  ha_rows rows;
+  DBUG_ENTER("spider_partial_group_by_handler::load_spilled_groups");
+  while (TRUE)
+  {
+    while (
+      spill_parts[level] < SPIDER_PARTIAL_SPILL_PARTS &&
+      !spills[level][spill_parts[level]].records
+    )
+      spill_parts[level]++;
+    if (spill_parts[level] < SPIDER_PARTIAL_SPILL_PARTS)
+      break;
+    spill_parts[level] = 0;
+    if (!level)
+      DBUG_RETURN(HA_ERR_END_OF_FILE);
+    level--;
+  }
+  spill = &spills[level][spill_parts[level]++];
+  DBUG_PRINT("info",("spider level=%u rows=%llu", level,
+    (ulonglong) spill->records));
+  if (reinit_io_cache(&spill->file, READ_CACHE, 0L, 0, 0))
+    DBUG_RETURN(my_errno ? my_errno : HA_ERR_INTERNAL_ERROR);
+  my_hash_reset(&groups);
+  free_root(&groups_root, MYF(MY_MARK_BLOCKS_FREE));
+  groups_size = 0;
+  spill_level = level + 1;
+  spill_overflow = FALSE;
+  for (rows = spill->records; rows; rows--)
+  {
+    if (
+      my_b_read(&spill->file, table->record[1], reclength) ||
+      (
+        avg_count &&
+        my_b_read(&spill->file, (uchar *) row_avgs,
+          sizeof(SPIDER_PARTIAL_AVG) * avg_count)
+      )
+    )
+      DBUG_RETURN(my_errno ? my_errno : HA_ERR_INTERNAL_ERROR);
+    for (roop_count = 0; roop_count < avg_count; roop_count++)
+      row_avgs[roop_count].dec_sum.fix_buffer_pointer();
+    if ((error_num = add_group()))
+      DBUG_RETURN(error_num);
+  }
+  /* the file is reused for the next partition of the level */
+  spill->records = 0;
+  if (reinit_io_cache(&spill->file, WRITE_CACHE, 0L, 0, 0))
+    DBUG_RETURN(my_errno ? my_errno : HA_ERR_INTERNAL_ERROR);
+  current_group = 0;
+  DBUG_RETURN(0);
+}
+
+/*
+  Merge the row in record[1] into the group. The fields are merged in
+  record[0].
+*/
+void spider_partial_group_by_handler::merge_group(
+  SPIDER_PARTIAL_GROUP *group
+) {
+  my_ptrdiff_t ptr_diff = PTR_BYTE_DIFF(table->record[1], table->record[0]);
+  uint reclength = table->s->reclength;
+  SPIDER_PARTIAL_ITEM *partial_item, *end = items + item_count;
+  DBUG_ENTER("spider_partial_group_by_handler::merge_group");
+  memcpy(table->record[0], group->record, reclength);
+  for (partial_item = items; partial_item < end; partial_item++)
+  {
+    Field *field = partial_item->field;
+    switch (partial_item->kind)
+    {
+      case SPIDER_PARTIAL_COUNT:
+        {
+          longlong count;
+          field->move_field_offset(ptr_diff);
+          count = field->val_int();
+          field->move_field_offset(-ptr_diff);
+          field->store(field->val_int() + count, FALSE);
+        }
+        break;
+      case SPIDER_PARTIAL_SUM:
+        if (field->is_null(ptr_diff))
+          break;
+        if (field->is_null())
+        {
+          memcpy(field->ptr, field->ptr + ptr_diff, field->pack_length());
+          field->set_notnull();
+        } else if (partial_item->item->result_type() == DECIMAL_RESULT)
+        {
+          my_decimal value_buff, row_value_buff, sum;
+          my_decimal *value = field->val_decimal(&value_buff), *row_value;
+          field->move_field_offset(ptr_diff);
+          row_value = field->val_decimal(&row_value_buff);
+          field->move_field_offset(-ptr_diff);
+          my_decimal_add(E_DEC_FATAL_ERROR, &sum, value, row_value);
+          field->store_decimal(&sum);
+        } else {
+          double row_value;
+          field->move_field_offset(ptr_diff);
+          row_value = field->val_real();
+          field->move_field_offset(-ptr_diff);
+          field->store(field->val_real() + row_value);
+        }
+        break;
+      case SPIDER_PARTIAL_MIN:
+      case SPIDER_PARTIAL_MAX:
+        if (field->is_null(ptr_diff))
+          break;
+        if (
+          field->is_null() ||
+          (partial_item->kind == SPIDER_PARTIAL_MIN ?
+            field->cmp(field->ptr + ptr_diff, field->ptr) < 0 :
+            field->cmp(field->ptr + ptr_diff, field->ptr) > 0)
+        ) {
+          memcpy(field->ptr, field->ptr + ptr_diff, field->pack_length());
+          field->set_notnull();
+        }
+        break;
+      case SPIDER_PARTIAL_AVG_KIND:
+        {
+          SPIDER_PARTIAL_AVG *avg = &group->avgs[partial_item->avg_idx];
+          SPIDER_PARTIAL_AVG *row_avg = &row_avgs[partial_item->avg_idx];
+          if (partial_item->item->result_type() == DECIMAL_RESULT)
+          {
+            my_decimal sum;
+            my_decimal_add(E_DEC_FATAL_ERROR, &sum, &avg->dec_sum,
+              &row_avg->dec_sum);
+            avg->dec_sum = sum;
+          } else
+            avg->real_sum += row_avg->real_sum;
+          avg->count += row_avg->count;
+        }
+        break;
+      default:
+        break;
+    }
+  }
+  memcpy(group->record, table->record[0], reclength);
+  DBUG_VOID_RETURN;
+}
+
+int spider_partial_group_by_handler::init_scan()
+{
+  int error_num;
+  uint roop_count;
+  Field **field = table->field;
+  DBUG_ENTER("spider_partial_group_by_handler::init_scan");
+  if (trx->thd->killed)
+  {
+    my_error(ER_QUERY_INTERRUPTED, MYF(0));
+    DBUG_RETURN(ER_QUERY_INTERRUPTED);
+  }
+
+  /* the fields of the temporary table follow the non const items */
+  key_length = 0;
+  for (roop_count = 0; roop_count < item_count; roop_count++)
+  {
+    DBUG_ASSERT(*field);
+    items[roop_count].field = *field++;
+    if (items[roop_count].group)
+      key_length += items[roop_count].field->sort_length() +
+        items[roop_count].field->maybe_null();
+  }
+  if (
+    !(key_buff = (uchar *) alloc_root(&mem_root, key_length + 1)) ||
+    !(spills = (SPIDER_PARTIAL_SPILL (*)[SPIDER_PARTIAL_SPILL_PARTS])
+      alloc_root(&mem_root, sizeof(*spills) * SPIDER_PARTIAL_SPILL_LEVELS)) ||
+    (
+      avg_count &&
+      !(row_avgs = (SPIDER_PARTIAL_AVG *) alloc_root(&mem_root,
+        sizeof(SPIDER_PARTIAL_AVG) * avg_count))
+    )
+  )
+    DBUG_RETURN(HA_ERR_OUT_OF_MEM);
+  memset(spills, 0, sizeof(*spills) * SPIDER_PARTIAL_SPILL_LEVELS);
+  for (roop_count = 0; roop_count < avg_count; roop_count++)
+    new (&row_avgs[roop_count]) SPIDER_PARTIAL_AVG();
+  if (my_hash_init(PSI_INSTRUMENT_ME, &groups, &my_charset_bin, 32, 0, 0,
+    (my_hash_get_key) spider_partial_group_get_key, 0, 0))
+    DBUG_RETURN(HA_ERR_OUT_OF_MEM);
+  groups_inited = TRUE;
+  groups_size = 0;
+
+  for (roop_count = 0; roop_count < spider_count; roop_count++)
+  {
+    if ((error_num = search(spiders[roop_count])))
+      DBUG_RETURN(error_num);
+  }
+  trx->partial_aggregate_count++;
+  current_group = 0;
+  DBUG_RETURN(0);
+}
+
+int spider_partial_group_by_handler::next_row()
+{
+  int error_num;
+  SPIDER_PARTIAL_GROUP *group;
+  SPIDER_PARTIAL_ITEM *partial_item, *end = items + item_count;
+  DBUG_ENTER("spider_partial_group_by_handler::next_row");
+  if (trx->thd->killed)
+  {
+    my_error(ER_QUERY_INTERRUPTED, MYF(0));
+    DBUG_RETURN(ER_QUERY_INTERRUPTED);
+  }
+  while (current_group >= groups.records)
+  {
+    if ((error_num = load_spilled_groups()))
+    {
+      if (error_num == HA_ERR_END_OF_FILE)
+        table->status = STATUS_NOT_FOUND;
+      DBUG_RETURN(error_num);
+    }
+  }
+  group = (SPIDER_PARTIAL_GROUP *) my_hash_element(&groups, current_group++);
+  memcpy(table->record[0], group->record, table->s->reclength);
+  for (partial_item = items; partial_item < end; partial_item++)
+  {
+    if (partial_item->kind != SPIDER_PARTIAL_AVG_KIND)
+      continue;
+    Field *field = partial_item->field;
+    SPIDER_PARTIAL_AVG *avg = &group->avgs[partial_item->avg_idx];
+    if (!avg->count)
+    {
+      field->set_null();
+      continue;
+    }
+    field->set_notnull();
+    if (partial_item->item->result_type() == DECIMAL_RESULT)
+    {
+      my_decimal count, value;
+      int2my_decimal(E_DEC_FATAL_ERROR, avg->count, FALSE, &count);
+      my_decimal_div(E_DEC_FATAL_ERROR, &value, &avg->dec_sum, &count,
+        ((Item_sum_avg *) partial_item->item)->prec_increment);
+      field->store_decimal(&value);
+    } else
+      field->store(avg->real_sum / avg->count);
+  }
+  DBUG_RETURN(0);
+}
+
+int spider_partial_group_by_handler::end_scan()
+{
+  DBUG_ENTER("spider_partial_group_by_handler::end_scan");
+  DBUG_RETURN(0);
+}
+
+static group_by_handler *spider_create_partial_group_by_handler(
+  THD *thd,
+  Query *query
+) {
+  spider_partial_group_by_handler *group_by_handler;
+  DBUG_ENTER("spider_create_partial_group_by_handler");
+  if (!spider_param_partial_aggregate(thd) || query->from->next_local)
+    DBUG_RETURN(NULL);
+  if (!(group_by_handler = new spider_partial_group_by_handler(thd, query)))
+    DBUG_RETURN(NULL);
+  if (group_by_handler->init())
+  {
+    DBUG_PRINT("info",("spider can not aggregate the partitions"));
+    delete group_by_handler;
+    DBUG_RETURN(NULL);
+  }
+  query->where = NULL;
+  query->group_by = NULL;
+  DBUG_RETURN(group_by_handler);
+}
+#endif
+
 group_by_handler *spider_create_group_by_handler(
   THD *thd,
   Query *query
@@ -1662,10 +2488,11 @@ group_by_handler *spider_create_group_by_handler(
       if (bits != 1)
       {
         DBUG_PRINT("info",("spider using multiple partitions is not supported by this feature yet"));
+        DBUG_RETURN(spider_create_partial_group_by_handler(thd, query));
 #else
         DBUG_PRINT("info",("spider partition is not supported by this feature yet"));
-#endif
         DBUG_RETURN(NULL);
+#endif
 #if defined(PARTITION_HAS_GET_CHILD_HANDLERS)
       }
 #endif
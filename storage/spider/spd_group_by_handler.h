@@ -37,6 +37,109 @@ class spider_group_by_handler: public group_by_handler
   int end_scan();
 };
 
+typedef struct st_spider_partial_avg
+{
+  my_decimal         dec_sum;
+  double             real_sum;
+  longlong           count;
+} SPIDER_PARTIAL_AVG;
+
+typedef struct st_spider_partial_group
+{
+  uchar              *key;
+  uint               key_length;
+  uchar              *record;
+  SPIDER_PARTIAL_AVG *avgs;
+} SPIDER_PARTIAL_GROUP;
+
+typedef struct st_spider_partial_item
+{
+  Item               *item;
+  Field              *field;
+  uint               kind;
+  bool               group;
+  uint               avg_idx;
+} SPIDER_PARTIAL_ITEM;
+
+/*
+  The groups that do not fit in memory are written to one of
+  SPIDER_PARTIAL_SPILL_PARTS files, selected by the next
+  SPIDER_PARTIAL_SPILL_BITS bits of the hash of the group key.
+*/
+#define SPIDER_PARTIAL_SPILL_BITS 4
+#define SPIDER_PARTIAL_SPILL_PARTS (1 << SPIDER_PARTIAL_SPILL_BITS)
+#define SPIDER_PARTIAL_SPILL_LEVELS 4
+
+typedef struct st_spider_partial_spill
+{
+  IO_CACHE           file;
+  ha_rows            records;
+} SPIDER_PARTIAL_SPILL;
+
+/*
+  Aggregates a table of several partitions in two phases. The rows of each
+  partition are aggregated by its remote server and the partial results are
+  merged by group on the local server.
+*/
+class spider_partial_group_by_handler: public group_by_handler
+{
+  Query query;
+  SPIDER_TRX *trx;
+  MEM_ROOT mem_root;
+  MEM_ROOT groups_root;
+  ha_spider **spiders;
+  uint spider_count;
+  SPIDER_PARTIAL_ITEM *items;
+  uint item_count;
+  uint avg_count;
+  uint key_length;
+  uchar *key_buff;
+  SPIDER_PARTIAL_AVG *row_avgs;
+  HASH groups;
+  bool groups_inited;
+  ulonglong groups_size;
+  ulonglong max_groups_size;
+  ulong current_group;
+  /* the partitions of the groups that are not in memory, by level */
+  SPIDER_PARTIAL_SPILL (*spills)[SPIDER_PARTIAL_SPILL_PARTS];
+  uint spill_parts[SPIDER_PARTIAL_SPILL_LEVELS];
+  uint spill_level;
+  bool spill_overflow;
+  spider_string sql;
+
+  int make_sql(
+    ha_spider *spider,
+    uint dbton_id
+  );
+  int search(
+    ha_spider *spider
+  );
+  int add_row(
+    ha_spider *spider,
+    SPIDER_DB_ROW *row
+  );
+  my_hash_value_type make_key();
+  int add_group();
+  int spill_group(
+    SPIDER_PARTIAL_SPILL *spill
+  );
+  int load_spilled_groups();
+  void merge_group(
+    SPIDER_PARTIAL_GROUP *group
+  );
+
+public:
+  spider_partial_group_by_handler(
+    THD *thd_arg,
+    Query *query_arg
+  );
+  ~spider_partial_group_by_handler();
+  bool init();
+  int init_scan();
+  int next_row();
+  int end_scan();
+};
+
 group_by_handler *spider_create_group_by_handler(
   THD *thd,
   Query *query
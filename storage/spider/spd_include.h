@@ -568,6 +568,14 @@ typedef struct st_spider_conn
   volatile
 #endif
     void             *quick_target;
+  /*
+    ha_spider whose query was sent without reading the result, and the
+    link index of the query in it
+  */
+  void               *async_target;
+  int                async_link_idx;
+  bool               async_send;        /* send the next query only */
+  bool               async_sent;
 #ifndef WITHOUT_SPIDER_BG_SEARCH
   volatile bool      bg_init;
   volatile bool      bg_break;
@@ -905,6 +913,7 @@ typedef struct st_spider_transaction
   ulonglong          direct_order_limit_count;
   ulonglong          direct_aggregate_count;
   ulonglong          parallel_search_count;
+  ulonglong          partial_aggregate_count;
 #if defined(HS_HAS_SQLCOM) && defined(HAVE_HANDLERSOCKET)
   ulonglong          hs_result_free_count;
 #endif
@@ -101,6 +101,17 @@ static int spider_parallel_search(THD *thd, SHOW_VAR *var, char *buff)
   DBUG_RETURN(error_num);
 }
 
+static int spider_partial_aggregate(THD *thd, SHOW_VAR *var, char *buff)
+{
+  int error_num = 0;
+  SPIDER_TRX *trx;
+  DBUG_ENTER("spider_partial_aggregate");
+  var->type = SHOW_LONGLONG;
+  if ((trx = spider_get_trx(thd, TRUE, &error_num)))
+    var->value = (char *) &trx->partial_aggregate_count;
+  DBUG_RETURN(error_num);
+}
+
 #if defined(HS_HAS_SQLCOM) && defined(HAVE_HANDLERSOCKET)
 static int spider_hs_result_free(THD *thd, SHOW_VAR *var, char *buff)
 {
@@ -136,6 +147,8 @@ struct st_mysql_show_var spider_status_variables[] =
     (char *) &spider_direct_aggregate, SHOW_SIMPLE_FUNC},
   {"Spider_parallel_search",
     (char *) &spider_parallel_search, SHOW_SIMPLE_FUNC},
+  {"Spider_partial_aggregate",
+    (char *) &spider_partial_aggregate, SHOW_SIMPLE_FUNC},
 #else
   {"Spider_direct_order_limit",
     (char *) &spider_direct_order_limit, SHOW_FUNC},
@@ -143,6 +156,8 @@ struct st_mysql_show_var spider_status_variables[] =
     (char *) &spider_direct_aggregate, SHOW_FUNC},
   {"Spider_parallel_search",
     (char *) &spider_parallel_search, SHOW_FUNC},
+  {"Spider_partial_aggregate",
+    (char *) &spider_partial_aggregate, SHOW_FUNC},
 #endif
 #if defined(HS_HAS_SQLCOM) && defined(HAVE_HANDLERSOCKET)
 #ifdef SPIDER_HAS_SHOW_SIMPLE_FUNC
@@ -2805,6 +2820,49 @@ int spider_param_skip_parallel_search(
     skip_parallel_search : THDVAR(thd, skip_parallel_search));
 }
 
+/*
+  FALSE: read the result of a search before the next partition is searched
+  TRUE:  send the searches of all partitions before reading the results
+ */
+static MYSQL_THDVAR_BOOL(
+  async_search, /* name */
+  PLUGIN_VAR_OPCMDARG, /* opt */
+  "Send the searches of all partitions to the remote servers before "
+  "reading their results", /* comment */
+  NULL, /* check */
+  NULL, /* update */
+  FALSE /* def */
+);
+
+bool spider_param_async_search(
+  THD *thd
+) {
+  DBUG_ENTER("spider_param_async_search");
+  DBUG_RETURN(THDVAR(thd, async_search));
+}
+
+/*
+  FALSE: a GROUP BY of several partitions is executed by the local server
+  TRUE:  aggregate each partition on its remote server and merge the
+         partial results
+ */
+static MYSQL_THDVAR_BOOL(
+  partial_aggregate, /* name */
+  PLUGIN_VAR_OPCMDARG, /* opt */
+  "Send partial aggregates of the partitions of a table to the remote "
+  "servers and merge them on the local server", /* comment */
+  NULL, /* check */
+  NULL, /* update */
+  FALSE /* def */
+);
+
+bool spider_param_partial_aggregate(
+  THD *thd
+) {
+  DBUG_ENTER("spider_param_partial_aggregate");
+  DBUG_RETURN(THDVAR(thd, partial_aggregate));
+}
+
 /*
  -1 :use table parameter
   0 :not send directly
@@ -3601,6 +3659,8 @@ static struct st_mysql_sys_var* spider_system_variables[] = {
   MYSQL_SYSVAR(error_write_mode),
   MYSQL_SYSVAR(skip_default_condition),
   MYSQL_SYSVAR(skip_parallel_search),
+  MYSQL_SYSVAR(async_search),
+  MYSQL_SYSVAR(partial_aggregate),
   MYSQL_SYSVAR(direct_order_limit),
   MYSQL_SYSVAR(read_only_mode),
 #ifdef HA_CAN_BULK_ACCESS
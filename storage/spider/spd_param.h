@@ -362,6 +362,12 @@ int spider_param_skip_parallel_search(
   THD *thd,
   int skip_parallel_search
 );
+bool spider_param_async_search(
+  THD *thd
+);
+bool spider_param_partial_aggregate(
+  THD *thd
+);
 longlong spider_param_direct_order_limit(
   THD *thd,
   longlong direct_order_limit
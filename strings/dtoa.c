@@ -2131,6 +2131,346 @@ static int quorem(Bigint *b, Bigint *S)
 }
 
 
+/*
+  Shortest digits by Grisu3.
+
+  Florian Loitsch, "Printing Floating-Point Numbers Quickly and Accurately
+  with Integers" [Proc. ACM SIGPLAN PLDI '10, pp. 233-243].
+
+  The number and the boundaries of its rounding interval are scaled by a
+  cached power of ten into 64-bit fixed point numbers, and the digits are
+  generated with integer arithmetic only. The imprecision of the scaling is
+  tracked, and whenever the result cannot be proven to be the shortest
+  (and closest among the shortest) representation, the caller falls back
+  to the bignum algorithm. This happens for about 0.5% of random doubles.
+
+  Boundaries themselves are never produced, so cases where dtoa() relies on
+  equality in its stopping tests (like 1e23) always take the fallback, and
+  the results of both algorithms are identical.
+*/
+
+/* A number f * 2^e, with a 64-bit significand */
+typedef struct Diy_fp
+{
+  ULLong f;
+  int e;
+} Diy_fp;
+
+/*
+  Normalized approximations of 10^k for k= -348, -340, ..., 340:
+  significand (rounded to nearest), binary exponent, decimal exponent.
+*/
+static const struct Cached_power
+{
+  ULLong f;
+  short e;
+  short k;
+} cached_powers[]=
+{
+  {0xfa8fd5a0081c0288ULL, -1220, -348},
+  {0xbaaee17fa23ebf76ULL, -1193, -340},
+  {0x8b16fb203055ac76ULL, -1166, -332},
+  {0xcf42894a5dce35eaULL, -1140, -324},
+  {0x9a6bb0aa55653b2dULL, -1113, -316},
+  {0xe61acf033d1a45dfULL, -1087, -308},
+  {0xab70fe17c79ac6caULL, -1060, -300},
+  {0xff77b1fcbebcdc4fULL, -1034, -292},
+  {0xbe5691ef416bd60cULL, -1007, -284},
+  {0x8dd01fad907ffc3cULL, -980, -276},
+  {0xd3515c2831559a83ULL, -954, -268},
+  {0x9d71ac8fada6c9b5ULL, -927, -260},
+  {0xea9c227723ee8bcbULL, -901, -252},
+  {0xaecc49914078536dULL, -874, -244},
+  {0x823c12795db6ce57ULL, -847, -236},
+  {0xc21094364dfb5637ULL, -821, -228},
+  {0x9096ea6f3848984fULL, -794, -220},
+  {0xd77485cb25823ac7ULL, -768, -212},
+  {0xa086cfcd97bf97f4ULL, -741, -204},
+  {0xef340a98172aace5ULL, -715, -196},
+  {0xb23867fb2a35b28eULL, -688, -188},
+  {0x84c8d4dfd2c63f3bULL, -661, -180},
+  {0xc5dd44271ad3cdbaULL, -635, -172},
+  {0x936b9fcebb25c996ULL, -608, -164},
+  {0xdbac6c247d62a584ULL, -582, -156},
+  {0xa3ab66580d5fdaf6ULL, -555, -148},
+  {0xf3e2f893dec3f126ULL, -529, -140},
+  {0xb5b5ada8aaff80b8ULL, -502, -132},
+  {0x87625f056c7c4a8bULL, -475, -124},
+  {0xc9bcff6034c13053ULL, -449, -116},
+  {0x964e858c91ba2655ULL, -422, -108},
+  {0xdff9772470297ebdULL, -396, -100},
+  {0xa6dfbd9fb8e5b88fULL, -369, -92},
+  {0xf8a95fcf88747d94ULL, -343, -84},
+  {0xb94470938fa89bcfULL, -316, -76},
+  {0x8a08f0f8bf0f156bULL, -289, -68},
+  {0xcdb02555653131b6ULL, -263, -60},
+  {0x993fe2c6d07b7facULL, -236, -52},
+  {0xe45c10c42a2b3b06ULL, -210, -44},
+  {0xaa242499697392d3ULL, -183, -36},
+  {0xfd87b5f28300ca0eULL, -157, -28},
+  {0xbce5086492111aebULL, -130, -20},
+  {0x8cbccc096f5088ccULL, -103, -12},
+  {0xd1b71758e219652cULL, -77, -4},
+  {0x9c40000000000000ULL, -50, 4},
+  {0xe8d4a51000000000ULL, -24, 12},
+  {0xad78ebc5ac620000ULL, 3, 20},
+  {0x813f3978f8940984ULL, 30, 28},
+  {0xc097ce7bc90715b3ULL, 56, 36},
+  {0x8f7e32ce7bea5c70ULL, 83, 44},
+  {0xd5d238a4abe98068ULL, 109, 52},
+  {0x9f4f2726179a2245ULL, 136, 60},
+  {0xed63a231d4c4fb27ULL, 162, 68},
+  {0xb0de65388cc8ada8ULL, 189, 76},
+  {0x83c7088e1aab65dbULL, 216, 84},
+  {0xc45d1df942711d9aULL, 242, 92},
+  {0x924d692ca61be758ULL, 269, 100},
+  {0xda01ee641a708deaULL, 295, 108},
+  {0xa26da3999aef774aULL, 322, 116},
+  {0xf209787bb47d6b85ULL, 348, 124},
+  {0xb454e4a179dd1877ULL, 375, 132},
+  {0x865b86925b9bc5c2ULL, 402, 140},
+  {0xc83553c5c8965d3dULL, 428, 148},
+  {0x952ab45cfa97a0b3ULL, 455, 156},
+  {0xde469fbd99a05fe3ULL, 481, 164},
+  {0xa59bc234db398c25ULL, 508, 172},
+  {0xf6c69a72a3989f5cULL, 534, 180},
+  {0xb7dcbf5354e9beceULL, 561, 188},
+  {0x88fcf317f22241e2ULL, 588, 196},
+  {0xcc20ce9bd35c78a5ULL, 614, 204},
+  {0x98165af37b2153dfULL, 641, 212},
+  {0xe2a0b5dc971f303aULL, 667, 220},
+  {0xa8d9d1535ce3b396ULL, 694, 228},
+  {0xfb9b7cd9a4a7443cULL, 720, 236},
+  {0xbb764c4ca7a44410ULL, 747, 244},
+  {0x8bab8eefb6409c1aULL, 774, 252},
+  {0xd01fef10a657842cULL, 800, 260},
+  {0x9b10a4e5e9913129ULL, 827, 268},
+  {0xe7109bfba19c0c9dULL, 853, 276},
+  {0xac2820d9623bf429ULL, 880, 284},
+  {0x80444b5e7aa7cf85ULL, 907, 292},
+  {0xbf21e44003acdd2dULL, 933, 300},
+  {0x8e679c2f5e44ff8fULL, 960, 308},
+  {0xd433179d9c8cb841ULL, 986, 316},
+  {0x9e19db92b4e31ba9ULL, 1013, 324},
+  {0xeb96bf6ebadf77d9ULL, 1039, 332},
+  {0xaf87023b9bf0ee6bULL, 1066, 340},
+};
+
+#define CACHED_POWERS_OFFSET 348 /* -cached_powers[0].k */
+#define CACHED_POWERS_STEP 8
+
+/*
+  The scaled number must have its binary exponent in this range, so that
+  its integral part fits in 32 bits and the fractional one can be multiplied
+  by 10 without overflow.
+*/
+#define GRISU_MIN_EXPONENT (-60)
+#define GRISU_MAX_EXPONENT (-32)
+
+/* Product of two Diy_fp, the significand is rounded to the upper 64 bits */
+
+static Diy_fp diy_fp_mult(Diy_fp x, Diy_fp y)
+{
+  Diy_fp r;
+  ULLong a= x.f >> 32, b= x.f & FFFFFFFF;
+  ULLong c= y.f >> 32, d= y.f & FFFFFFFF;
+  ULLong ac= a * c, bc= b * c, ad= a * d, bd= b * d;
+  ULLong tmp= (bd >> 32) + (ad & FFFFFFFF) + (bc & FFFFFFFF);
+  tmp+= 1U << 31;
+  r.f= ac + (ad >> 32) + (bc >> 32) + (tmp >> 32);
+  r.e= x.e + y.e + 64;
+  return r;
+}
+
+
+static Diy_fp diy_fp_normalize(Diy_fp x)
+{
+  while (!(x.f & 0xFFC0000000000000ULL))
+  {
+    x.f<<= 10;
+    x.e-= 10;
+  }
+  while (!(x.f & 0x8000000000000000ULL))
+  {
+    x.f<<= 1;
+    x.e-= 1;
+  }
+  return x;
+}
+
+
+/*
+  Round the last generated digit towards w (which is distance_high_w
+  below the upper end of the unsafe interval), and check that the result is
+  safe: inside the real rounding interval, and the closest to w among the
+  candidates of the same length. All quantities are scaled by 'unit', the
+  imprecision of the scaled numbers.
+*/
+
+static my_bool grisu_round_weed(char *buf, int len, ULLong distance_high_w,
+                                ULLong unsafe_interval, ULLong rest,
+                                ULLong ten_kappa, ULLong unit)
+{
+  ULLong small_distance= distance_high_w - unit;
+  ULLong big_distance= distance_high_w + unit;
+
+  while (rest < small_distance &&
+         unsafe_interval - rest >= ten_kappa &&
+         (rest + ten_kappa < small_distance ||
+          small_distance - rest >= rest + ten_kappa - small_distance))
+  {
+    buf[len - 1]--;
+    rest+= ten_kappa;
+  }
+
+  /* Could also have gone one step further: can't tell which is closer */
+  if (rest < big_distance &&
+      unsafe_interval - rest >= ten_kappa &&
+      (rest + ten_kappa < big_distance ||
+       big_distance - rest > rest + ten_kappa - big_distance))
+    return FALSE;
+
+  return 2 * unit <= rest && rest <= unsafe_interval - 4 * unit;
+}
+
+
+/*
+  Generate the shortest digits of the scaled number w, lying between
+  the scaled boundaries low and high.
+
+  @return FALSE if the digits could not be proven correct
+*/
+
+static my_bool grisu_digit_gen(Diy_fp low, Diy_fp w, Diy_fp high,
+                               char *buf, int *len, int *kappa)
+{
+  ULLong unit= 1;
+  ULLong too_low= low.f - unit, too_high= high.f + unit;
+  ULLong unsafe_interval= too_high - too_low;
+  int shift= -w.e;
+  ULLong one= (ULLong) 1 << shift;
+  ULong integrals= (ULong) (too_high >> shift);
+  ULLong fractionals= too_high & (one - 1);
+  ULong divisor= 1;
+  int digits= 1;
+
+  while (digits < 10 && integrals >= divisor * 10)
+  {
+    divisor*= 10;
+    digits++;
+  }
+  if (!integrals)
+    digits= 0;
+  *kappa= digits;
+  *len= 0;
+
+  while (*kappa > 0)
+  {
+    ULLong rest;
+    buf[(*len)++]= (char) ('0' + integrals / divisor);
+    integrals%= divisor;
+    (*kappa)--;
+    rest= ((ULLong) integrals << shift) + fractionals;
+    if (rest < unsafe_interval)
+      return grisu_round_weed(buf, *len, too_high - w.f, unsafe_interval,
+                              rest, (ULLong) divisor << shift, unit);
+    divisor/= 10;
+  }
+
+  for (;;)
+  {
+    fractionals*= 10;
+    unit*= 10;
+    unsafe_interval*= 10;
+    buf[(*len)++]= (char) ('0' + (fractionals >> shift));
+    fractionals&= one - 1;
+    (*kappa)--;
+    if (fractionals < unsafe_interval)
+      return grisu_round_weed(buf, *len, (too_high - w.f) * unit,
+                              unsafe_interval, fractionals, one, unit);
+    /* No double needs more than 17 digits */
+    if (*len >= 18)
+      return FALSE;
+  }
+}
+
+
+/*
+  Shortest digits of a finite positive double, without trailing zeros.
+
+  @param u        the number
+  @param buf      at least 18 bytes for the digits
+  @param[out] len number of digits
+  @param[out] decpt  position of the decimal point, as returned by dtoa()
+
+  @return FALSE if the digits could not be computed and dtoa() must
+          use the bignum algorithm
+*/
+
+static my_bool grisu3(U *u, char *buf, int *len, int *decpt)
+{
+  Diy_fp w, plus, minus;
+  Diy_fp c;
+  const struct Cached_power *cp;
+  int be= (int) ((word0(u) & Exp_mask) >> Exp_shift);
+  int k, kappa, idx;
+
+  w.f= ((ULLong) (word0(u) & Frac_mask) << 32) | word1(u);
+  if (be)
+  {
+    w.f|= (ULLong) Exp_msk1 << 32;
+    w.e= be - Bias - (P - 1);
+  }
+  else
+    w.e= 1 - Bias - (P - 1);
+
+  /*
+    Boundaries of the rounding interval: halfway to the neighbours.
+    The lower neighbour is closer when f is the smallest significand of
+    its binade.
+  */
+  plus.f= (w.f << 1) + 1;
+  plus.e= w.e - 1;
+  plus= diy_fp_normalize(plus);
+  if (w.f == ((ULLong) Exp_msk1 << 32) && be > 1)
+  {
+    minus.f= (w.f << 2) - 1;
+    minus.e= w.e - 2;
+  }
+  else
+  {
+    minus.f= (w.f << 1) - 1;
+    minus.e= w.e - 1;
+  }
+  minus.f<<= minus.e - plus.e;
+  minus.e= plus.e;
+  w= diy_fp_normalize(w);
+  DBUG_ASSERT(w.e == plus.e);
+
+  /* Pick c= 10^-k, so that w * c has its exponent in the target range */
+  k= (int) ceil((GRISU_MIN_EXPONENT - (w.e + 64) + 63) *
+                0.30102999566398114);
+  idx= (CACHED_POWERS_OFFSET + k - 1) / CACHED_POWERS_STEP + 1;
+  cp= &cached_powers[idx];
+  c.f= cp->f;
+  c.e= cp->e;
+
+  w= diy_fp_mult(w, c);
+  DBUG_ASSERT(w.e >= GRISU_MIN_EXPONENT && w.e <= GRISU_MAX_EXPONENT);
+  if (!grisu_digit_gen(diy_fp_mult(minus, c), w, diy_fp_mult(plus, c),
+                       buf, len, &kappa))
+    return FALSE;
+
+  while (*len > 1 && buf[*len - 1] == '0')
+  {
+    (*len)--;
+    kappa++;
+  }
+  *decpt= *len + kappa - cp->k;
+  return TRUE;
+}
+
+
 /*
    dtoa for IEEE arithmetic (dmg): convert double to ASCII string.
 
@@ -2245,7 +2585,33 @@ static char *dtoa(double dd, int mode, int ndigits, int *decpt, int *sign,
       *rve= res + 1;
     return res;
   }
-  
+
+#ifndef Honor_FLT_ROUNDS
+  /*
+    Modes 0, 4 and 5 produce the shortest string whenever it has no more
+    digits than requested. Try to get it without bignums first.
+    For denormals the floating-point estimate of modes 4 and 5 may return
+    more digits than the shortest, so leave them to the code below.
+  */
+  if (mode == 0 ||
+      ((mode == 4 || mode == 5) && (word0(&u) & Exp_mask)))
+  {
+    char digits[18];
+    int len;
+    if (grisu3(&u, digits, &len, decpt) &&
+        (mode == 0 || (mode == 4 ? len <= MY_MAX(ndigits, 1) :
+                                   len - *decpt <= ndigits)))
+    {
+      s= dtoa_alloc(len + 1, &alloc);
+      memcpy(s, digits, len);
+      s[len]= '\0';
+      if (rve)
+        *rve= s + len;
+      return s;
+    }
+  }
+#endif
+
 #ifdef Honor_FLT_ROUNDS
   if ((rounding= Flt_Rounds) >= 2)
   {
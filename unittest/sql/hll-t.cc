@@ -0,0 +1,152 @@
+/*
+   Copyright (c) 2021, MariaDB
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; version 2 of the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1335 USA */
+
+/*
+  Standalone tests of the HyperLogLog sketch used by APPROX_COUNT_DISTINCT()
+*/
+#include <my_global.h>
+#include <my_sys.h>
+#include <math.h>
+
+#include <tap.h>
+
+#include "sql_hll.h"
+
+static MEM_ROOT root;
+
+static ulonglong value_hash(ulonglong value)
+{
+  return Hyperloglog::mix(value ^ 0x9e3779b97f4a7c15ULL);
+}
+
+static void fill(Hyperloglog *sketch, ulonglong from, ulonglong to)
+{
+  for (ulonglong i= from; i < to; i++)
+    sketch->add_hash(value_hash(i));
+}
+
+
+static void test_accuracy()
+{
+  static const ulonglong counts[]= { 0, 1, 10, 1000, 50000, 1000000 };
+  for (uint precision= Hyperloglog::MIN_PRECISION;
+       precision <= Hyperloglog::MAX_PRECISION; precision+= 2)
+  {
+    Hyperloglog sketch;
+    sketch.init(&root, precision);
+    /* Allow four standard errors, plus rounding for tiny counts */
+    double error= 4 * 1.04 / sqrt((double) (1U << precision));
+    ulonglong added= 0;
+    for (uint i= 0; i < array_elements(counts); i++)
+    {
+      fill(&sketch, added, counts[i]);
+      added= counts[i];
+      ulonglong estimate= sketch.estimate();
+      ok(fabs((double) estimate - (double) counts[i]) <=
+         counts[i] * error + 1,
+         "precision %u: %llu distinct values estimated as %llu",
+         precision, counts[i], estimate);
+    }
+    /* Duplicates do not change the estimate */
+    ulonglong estimate= sketch.estimate();
+    fill(&sketch, 0, 1000);
+    ok(sketch.estimate() == estimate, "precision %u: duplicates ignored",
+       precision);
+  }
+}
+
+
+static void test_serialization()
+{
+  uchar buf[Hyperloglog::HEADER_SIZE + (1 << Hyperloglog::MAX_PRECISION)];
+  Hyperloglog sketch, copy;
+  sketch.init(&root, 14);
+  copy.init(&root, 14);
+
+  fill(&sketch, 0, 100);
+  size_t length= sketch.serialize(buf);
+  ok(length == sketch.serialized_length() &&
+     buf[0] == Hyperloglog::HLL_FORMAT_SPARSE, "small sketch is sparse");
+  ok(!copy.merge(buf, length) && copy.estimate() == sketch.estimate(),
+     "sparse sketch round trip");
+
+  fill(&sketch, 0, 100000);
+  length= sketch.serialize(buf);
+  ok(length == sketch.serialized_length() &&
+     buf[0] == Hyperloglog::HLL_FORMAT_DENSE, "large sketch is dense");
+  copy.clear();
+  ok(!copy.merge(buf, length) && copy.estimate() == sketch.estimate(),
+     "dense sketch round trip");
+
+  ok(copy.merge(buf, length - 1), "truncated sketch is rejected");
+  ok(copy.merge((const uchar *) "garbage", 7), "garbage is rejected");
+  buf[1]= Hyperloglog::MAX_PRECISION + 1;
+  ok(copy.merge(buf, length), "bad precision is rejected");
+}
+
+
+static void test_merge()
+{
+  uchar buf[Hyperloglog::HEADER_SIZE + (1 << Hyperloglog::MAX_PRECISION)];
+  Hyperloglog a, b, merged, direct;
+  a.init(&root, 14);
+  b.init(&root, 14);
+  merged.init(&root, 14);
+  direct.init(&root, 14);
+
+  fill(&a, 0, 60000);
+  fill(&b, 40000, 100000);
+  fill(&direct, 0, 100000);
+  merged.merge(buf, a.serialize(buf));
+  merged.merge(buf, b.serialize(buf));
+  ok(merged.estimate() == direct.estimate(),
+     "merge of overlapping sketches equals the sketch of the union");
+
+  /* Folding a fine sketch into a coarse one */
+  Hyperloglog coarse, coarse_direct;
+  coarse.init(&root, 10);
+  coarse_direct.init(&root, 10);
+  fill(&coarse_direct, 0, 100000);
+  coarse.merge(buf, direct.serialize(buf));
+  ok(coarse.estimate() == coarse_direct.estimate(),
+     "precision 14 sketch folded to precision 10");
+
+  /* Merging a coarse sketch lowers the precision */
+  merged.merge(buf, coarse_direct.serialize(buf));
+  ok(merged.precision() == 10 &&
+     merged.estimate() == coarse_direct.estimate(),
+     "merge lowers the precision");
+  merged.clear();
+  ok(merged.precision() == 14 && merged.estimate() == 0,
+     "clear restores the precision");
+}
+
+
+int main(int argc __attribute__((unused)),char *argv[])
+{
+  MY_INIT(argv[0]);
+  plan(8 * 7 + 7 + 4);
+
+  init_alloc_root(PSI_NOT_INSTRUMENTED, &root, 1024, 0, MYF(0));
+
+  test_accuracy();
+  test_serialization();
+  test_merge();
+
+  free_root(&root, MYF(0));
+  my_end(0);
+  return exit_status();
+}
@@ -0,0 +1,178 @@
+/* Copyright (c) 2021, MariaDB Corporation
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; version 2 of the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA */
+
+#include <tap.h>
+#include <my_global.h>
+#include <my_sys.h>
+#include <m_string.h>
+
+/*
+  Tests and a microbenchmark for my_gcvt() and my_fcvt().
+*/
+
+struct dtoa_case
+{
+  double value;
+  const char *gcvt;                     /* widest field, as for results */
+  const char *gcvt10;                   /* field width 10 */
+  const char *fcvt2;                    /* 2 decimals */
+};
+
+static struct dtoa_case cases[]=
+{
+  {0.1, "0.1", "0.1", "0.10"},
+  {1.0/3, "0.3333333333333333", "0.33333333", "0.33"},
+  {2.0/3, "0.6666666666666666", "0.66666667", "0.67"},
+  {1e23, "1e23", "1e23", "100000000000000000000000.00"},
+  {123456789012345680.0, "1.2345678901234568e17", "1.23457e17",
+   "123456789012345680.00"},
+  {5e-324, "5e-324", "4.941e-324", "0.00"},
+  {2.2250738585072014e-308, "2.2250738585072014e-308", "2.225e-308", "0.00"},
+  {-2.5, "-2.5", "-2.5", "-2.50"},
+  {1e15, "1e15", "1e15", "1000000000000000.00"},
+  {1e16, "1e16", "1e16", "10000000000000000.00"},
+  {0.0001, "0.0001", "0.0001", "0.00"},
+  {1e-15, "0.000000000000001", "1e-15", "0.00"},
+  {1e-16, "1e-16", "1e-16", "0.00"},
+  {9007199254740993.0, "9.007199254740992e15", "9.0072e15",
+   "9007199254740992.00"},
+  {3.14159265358979, "3.14159265358979", "3.14159265", "3.14"},
+  {-0.000123456789, "-0.000123456789", "-1.2346e-4", "-0.00"},
+  {29.99, "29.99", "29.99", "29.99"},
+  {4.35, "4.35", "4.35", "4.35"},
+  {0.0, "0", "0", "0.00"}
+};
+
+
+static ulonglong seed= 88172645463325252ULL;
+
+static ulonglong next_random()
+{
+  seed^= seed << 13;
+  seed^= seed >> 7;
+  seed^= seed << 17;
+  return seed;
+}
+
+
+/* A finite double, either of random bits or with few decimal digits */
+static double random_double(uint i)
+{
+  if (i & 1)
+  {
+    double d;
+    do
+    {
+      ulonglong bits= next_random();
+      memcpy(&d, &bits, sizeof(d));
+    } while (isnan(d) || isinf(d));
+    return d;
+  }
+  return (double) (longlong) (next_random() % 100000000) / 1000;
+}
+
+
+static void check_cases()
+{
+  char buff[FLOATING_POINT_BUFFER];
+  uint i;
+  int failed_gcvt= 0, failed_gcvt10= 0, failed_fcvt= 0;
+
+  for (i= 0; i < array_elements(cases); i++)
+  {
+    struct dtoa_case *c= &cases[i];
+    my_gcvt(c->value, MY_GCVT_ARG_DOUBLE, sizeof(buff) - 1, buff, NULL);
+    if (strcmp(buff, c->gcvt))
+    {
+      diag("my_gcvt(%.17g): '%s', expected '%s'", c->value, buff, c->gcvt);
+      failed_gcvt++;
+    }
+    my_gcvt(c->value, MY_GCVT_ARG_DOUBLE, 10, buff, NULL);
+    if (strcmp(buff, c->gcvt10))
+    {
+      diag("my_gcvt(%.17g, 10): '%s', expected '%s'",
+           c->value, buff, c->gcvt10);
+      failed_gcvt10++;
+    }
+    my_fcvt(c->value, 2, buff, NULL);
+    if (strcmp(buff, c->fcvt2))
+    {
+      diag("my_fcvt(%.17g, 2): '%s', expected '%s'", c->value, buff, c->fcvt2);
+      failed_fcvt++;
+    }
+  }
+  ok(failed_gcvt == 0, "my_gcvt()");
+  ok(failed_gcvt10 == 0, "my_gcvt() with a narrow field");
+  ok(failed_fcvt == 0, "my_fcvt()");
+}
+
+
+static void check_round_trip(uint count)
+{
+  char buff[FLOATING_POINT_BUFFER];
+  uint i, failed= 0;
+
+  for (i= 0; i < count; i++)
+  {
+    double d= random_double(i), d2;
+    size_t len= my_gcvt(d, MY_GCVT_ARG_DOUBLE, sizeof(buff) - 1, buff, NULL);
+    char *end= buff + len;
+    int error;
+    d2= my_strtod(buff, &end, &error);
+    if (d2 != d && failed++ < 10)
+      diag("%.17g printed as '%s' reads back as %.17g", d, buff, d2);
+  }
+  ok(failed == 0, "%u doubles survive my_gcvt() and my_strtod()", count);
+}
+
+
+static void benchmark(const char *name, uint count, my_bool fixed)
+{
+  char buff[FLOATING_POINT_BUFFER];
+  double *values= (double *) malloc(count * sizeof(double));
+  ulonglong start;
+  size_t total= 0;
+  uint i;
+
+  if (!values)
+    return;
+  for (i= 0; i < count; i++)
+    values[i]= random_double(i);
+
+  start= my_interval_timer();
+  for (i= 0; i < count; i++)
+    total+= fixed ? my_fcvt(values[i], 6, buff, NULL)
+                  : my_gcvt(values[i], MY_GCVT_ARG_DOUBLE,
+                            sizeof(buff) - 1, buff, NULL);
+  diag("%-8s %u values, %llu ns/value, %llu bytes", name, count,
+       (my_interval_timer() - start) / count, (ulonglong) total);
+  free(values);
+}
+
+
+int main(int argc __attribute__((unused)), char **argv)
+{
+  MY_INIT(argv[0]);
+  plan(4);
+
+  check_cases();
+  check_round_trip(1000000);
+
+  benchmark("my_gcvt", 1000000, FALSE);
+  benchmark("my_fcvt", 1000000, TRUE);
+
+  my_end(0);
+  return exit_status();
+}